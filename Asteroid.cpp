@@ -6,16 +6,26 @@
 
 #include <cassert>
 #include <cmath>
+#include <vector>
+#include <unordered_map>
 #include <algorithm>  // for min/max
 
 #include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/GlCallCounter.h"
+#include "ObjLibrary/MeshSimplifier.h"
 
 #include "CoordinateSystem.h"
+#include "DebugDraw.h"
 #include "PerlinNoiseField3.h"
+#include "RandomStream.h"
+#include "MeshCache.h"
+#include "AsteroidShape.h"
+#include "AsteroidLodMeshes.h"
 #include "Entity.h"
+#include "RenderQueue.h"
 
 using namespace ObjLibrary;
 namespace
@@ -28,12 +38,49 @@ namespace
 	const double NOISE_AMPLITUDE  = 1.0;
 	const double NOISE_OFFSET_MAX = 1.0e4;
 	const PerlinNoiseField3 NOISE(0.6f, (float)(NOISE_AMPLITUDE));
+	const unsigned int NOISE_OCTAVE_COUNT = 4;
+	const float NOISE_LACUNARITY = 2.0f;
+	const float NOISE_GAIN       = 0.5f;
 
+	const double LOD_FRACTIONS[Asteroid::LOD_COUNT] = { 1.0, 0.5, 0.25, 0.1 };
 
+	// change this when createModel changes, so old cached models are not used
+	const uint32_t MODEL_VERSION = 3;
 
-	double random01 ()
+	// projected radius (pixels) below which each level is replaced by the next
+	const double LOD_SWITCH_PIXELS[Asteroid::LOD_COUNT - 1] = { 60.0, 25.0, 10.0 };
+	const double LOD_HIDE_PIXELS = 0.5;
+	const double LOD_HYSTERESIS  = 0.15;  // fraction past a threshold needed to switch
+
+
+
+	// created the first time each base model is used, and never moved
+	const AsteroidLodMeshes& findLodMeshes (const ObjModel& base_model)
+	{
+		static std::unordered_map<const ObjModel*, AsteroidLodMeshes> lod_meshes;
+		auto iter = lod_meshes.find(&base_model);
+		if(iter == lod_meshes.end())
+		{
+			AsteroidLodMeshes meshes(base_model, Asteroid::createLodBaseModels(base_model));
+			iter = lod_meshes.insert(std::make_pair(&base_model, meshes)).first;
+		}
+		return iter->second;
+	}
+
+	//
+	//  Entity needs a DisplayList, but Asteroids draw their
+	//    shared LOD meshes instead.  They all share this empty one
+	//    rather than each compiling a full copy of its mesh.
+	//
+	const DisplayList& getPlaceholderDisplayList ()
 	{
-		return rand() / (RAND_MAX + 1.0);
+		static DisplayList placeholder;
+		if(!placeholder.isReady())
+		{
+			placeholder.begin();
+			placeholder.end();
+		}
+		return placeholder;
 	}
 
 }  // end of anonymous namespace
@@ -46,7 +93,7 @@ bool Asteroid :: isUnitSphere (const ObjLibrary::ObjModel& base_model)
 
 	for(unsigned int v = 0; v < base_model.getVertexCount(); v++)
 	{
-		const Vector3& vertex = base_model.getVertexPosition(v);
+		Vector3 vertex = base_model.getVertexPosition(v);
 
 		if(fabs(vertex.getNormSquared() - 1.0) > TOLERANCE)
 			return false;
@@ -64,10 +111,10 @@ double Asteroid :: calculateMass (double inner_radius,
 	return PI * outer_radius * outer_radius * inner_radius * DENSITY / 6.0;
 }
 
-ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjModel& base_model,
-                                                       double inner_radius,
-                                                       double outer_radius,
-                                                       ObjLibrary::Vector3 random_noise_offset)
+ObjLibrary::ObjModel Asteroid :: createModel (const ObjLibrary::ObjModel& base_model,
+                                              double inner_radius,
+                                              double outer_radius,
+                                              ObjLibrary::Vector3 random_noise_offset)
 {
 	assert(isUnitSphere(base_model));
 
@@ -75,26 +122,209 @@ ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjMode
 	double radius_average    = (outer_radius + inner_radius) * 0.5;
 	double radius_half_range = (outer_radius - inner_radius) * 0.5;
 
-	for(unsigned int v = 0; v < model.getVertexCount(); v++)
+	PerlinNoiseField3::Octaves octaves = getNoiseOctaves(calculateVertexSpacing(base_model),
+	                                                     inner_radius, outer_radius);
+
+	// sample the noise for every vertex at once so the batch kernel can be used
+	unsigned int vertex_count = model.getVertexCount();
+	std::vector<float> v_noise_x(vertex_count);
+	std::vector<float> v_noise_y(vertex_count);
+	std::vector<float> v_noise_z(vertex_count);
+	std::vector<float> v_noise  (vertex_count);
+	std::vector<float> v_gradient_x(vertex_count);
+	std::vector<float> v_gradient_y(vertex_count);
+	std::vector<float> v_gradient_z(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+	{
+		Vector3 offset_vertex = model.getVertexPosition(v) + random_noise_offset;
+		v_noise_x[v] = (float)(offset_vertex.x);
+		v_noise_y[v] = (float)(offset_vertex.y);
+		v_noise_z[v] = (float)(offset_vertex.z);
+	}
+	NOISE.fbmNoiseWithGradientBatch(v_noise_x.data(), v_noise_y.data(), v_noise_z.data(),
+	                                vertex_count, octaves, v_noise.data(),
+	                                v_gradient_x.data(), v_gradient_y.data(), v_gradient_z.data());
+
+	// one smooth normal per vertex, replacing the sphere normals
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+		for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+			for(unsigned int c = 0; c < model.getFaceVertexCount(m, f); c++)
+				model.setFaceVertexNormal(m, f, c, model.getFaceVertexIndex(m, f, c));
+	model.setNormalCount(vertex_count);
+
+	for(unsigned int v = 0; v < vertex_count; v++)
 	{
-		const Vector3& old_vertex = model.getVertexPosition(v);
+		Vector3 old_vertex = model.getVertexPosition(v);
 		assert(!old_vertex.isZero());
 		//assert(old_vertex.isUnit());  // tolerances are too tight, so skip
 
-		Vector3 offset_vertex = old_vertex + random_noise_offset;
-		double noise = NOISE.perlinNoise((float)(offset_vertex.x),
-		                                 (float)(offset_vertex.y),
-		                                 (float)(offset_vertex.z));
+		double noise = v_noise[v];
 		assert(noise >= -1.0);
 		assert(noise <=  1.0);
 
 		double new_radius = radius_average + noise * radius_half_range;
 		Vector3 new_vertex = old_vertex.getCopyWithNorm(new_radius);
 		model.setVertexPosition(v, new_vertex);
+
+		//
+		//  The surface is new_radius(u) * u for unit vectors u,
+		//    so its normal is u - grad(new_radius) / new_radius,
+		//    where grad is the gradient along the unit sphere.
+		//    That is the noise gradient without the part along u.
+		//
+		Vector3 direction = old_vertex.getNormalized();
+		Vector3 gradient(v_gradient_x[v], v_gradient_y[v], v_gradient_z[v]);
+		Vector3 surface_gradient = gradient - direction * gradient.dotProduct(direction);
+		Vector3 normal = direction - surface_gradient * (radius_half_range / new_radius);
+		assert(!normal.isZero());
+		model.setNormalVector(v, normal);
 	}
+	model.validate();
 
 	// don't check invariant in helper function
-	return model.getDisplayList();
+	return model;
+}
+
+ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjModel& base_model,
+                                                       double inner_radius,
+                                                       double outer_radius,
+                                                       ObjLibrary::Vector3 random_noise_offset)
+{
+	assert(isUnitSphere(base_model));
+
+	return createModel(base_model, inner_radius, outer_radius, random_noise_offset).getDisplayList();
+}
+
+std::vector<ObjLibrary::ObjModel> Asteroid :: createLodObjModels (const ObjLibrary::ObjModel& base_model,
+                                                                  double inner_radius,
+                                                                  double outer_radius,
+                                                                  ObjLibrary::Vector3 random_noise_offset)
+{
+	assert(isUnitSphere(base_model));
+
+	ObjModel model = createModel(base_model, inner_radius, outer_radius, random_noise_offset);
+	std::vector<double> v_fractions(LOD_FRACTIONS, LOD_FRACTIONS + LOD_COUNT);
+	std::vector<ObjModel> v_lod_models = MeshSimplifier::createLodChain(model, v_fractions);
+	assert(v_lod_models.size() == LOD_COUNT);
+	return v_lod_models;
+}
+
+std::vector<ObjLibrary::ObjModel> Asteroid :: createLodBaseModels (const ObjLibrary::ObjModel& base_model)
+{
+	assert(isUnitSphere(base_model));
+
+	// the simplifier only removes vertexes, so the rest stay on the sphere
+	std::vector<double> v_fractions(LOD_FRACTIONS, LOD_FRACTIONS + LOD_COUNT);
+	std::vector<ObjModel> v_lod_models = MeshSimplifier::createLodChain(base_model, v_fractions);
+	assert(v_lod_models.size() == LOD_COUNT);
+	return v_lod_models;
+}
+
+std::vector<ObjLibrary::ObjModel> Asteroid :: createIcosphereLodObjModels (
+                                          const std::vector<ObjLibrary::ObjModel>& v_base_levels,
+                                          double inner_radius,
+                                          double outer_radius,
+                                          ObjLibrary::Vector3 random_noise_offset)
+{
+	assert(v_base_levels.size() == LOD_COUNT);
+
+	std::vector<ObjModel> v_lod_models;
+	v_lod_models.reserve(LOD_COUNT);
+	for(unsigned int i = 0; i < LOD_COUNT; i++)
+	{
+		assert(isUnitSphere(v_base_levels[i]));
+		v_lod_models.push_back(createModel(v_base_levels[i], inner_radius, outer_radius,
+		                                   random_noise_offset));
+	}
+	return v_lod_models;
+}
+
+Asteroid::RandomParameters Asteroid :: chooseRandomParameters (RandomStream& r_random)
+{
+	RandomParameters parameters;
+	parameters.m_noise_offset  = r_random.randomSphereVector() * NOISE_OFFSET_MAX;
+	parameters.m_rotation_axis = r_random.randomUnitVector();
+	double rate_a = r_random.random01();
+	double rate_b = r_random.random01();
+	parameters.m_rotation_rate = std::min(rate_a, rate_b) * ROTATION_RATE_MAX;  // mostly rotate slowly
+	for(unsigned int i = 0; i < ROTATION_STEP_COUNT; i++)
+		parameters.ma_rotation_angles[i] = r_random.random2(0.0, TWO_PI);
+	return parameters;
+}
+
+uint64_t Asteroid :: getModelCacheKey (uint64_t base_model_hash,
+                                     double inner_radius,
+                                     double outer_radius,
+                                     const ObjLibrary::Vector3& random_noise_offset)
+{
+	const float NOISE_SETTINGS[4] = { NOISE.getGridSize(), NOISE.getAmplitude(),
+	                                  NOISE_LACUNARITY, NOISE_GAIN };
+	const unsigned int NOISE_HASH_MODE = NOISE.getHashMode();
+	unsigned int a_noise_seeds[PerlinNoiseField3::SEED_COUNT];
+	NOISE.getSeeds(a_noise_seeds);
+
+	uint64_t key = MeshCache::HASH_START;
+	key = MeshCache::hashBytes(key, &MODEL_VERSION,       sizeof(MODEL_VERSION));
+	key = MeshCache::hashBytes(key, &base_model_hash,     sizeof(base_model_hash));
+	key = MeshCache::hashBytes(key, &inner_radius,        sizeof(inner_radius));
+	key = MeshCache::hashBytes(key, &outer_radius,        sizeof(outer_radius));
+	key = MeshCache::hashBytes(key, &random_noise_offset, sizeof(random_noise_offset));
+	key = MeshCache::hashBytes(key, NOISE_SETTINGS,       sizeof(NOISE_SETTINGS));
+	key = MeshCache::hashBytes(key, &NOISE_OCTAVE_COUNT,  sizeof(NOISE_OCTAVE_COUNT));
+	key = MeshCache::hashBytes(key, &NOISE_HASH_MODE,     sizeof(NOISE_HASH_MODE));
+	key = MeshCache::hashBytes(key, a_noise_seeds,        sizeof(a_noise_seeds));
+	return key;
+}
+
+const PerlinNoiseField3& Asteroid :: getNoiseField ()
+{
+	return NOISE;
+}
+
+double Asteroid :: calculateVertexSpacing (const ObjLibrary::ObjModel& base_model)
+{
+	assert(isUnitSphere(base_model));
+
+	// interior edges are counted twice, but that does not change the average
+	double length_sum = 0.0;
+	unsigned int edge_count = 0;
+	for(unsigned int m = 0; m < base_model.getMeshCount(); m++)
+		for(unsigned int f = 0; f < base_model.getFaceCount(m); f++)
+		{
+			unsigned int corner_count = base_model.getFaceVertexCount(m, f);
+			for(unsigned int c = 0; c < corner_count; c++)
+			{
+				unsigned int vertex0 = base_model.getFaceVertexIndex(m, f, c);
+				unsigned int vertex1 = base_model.getFaceVertexIndex(m, f, (c + 1) % corner_count);
+				length_sum += base_model.getVertexPosition(vertex0).getDistance(
+				              base_model.getVertexPosition(vertex1));
+				edge_count++;
+			}
+		}
+
+	if(edge_count == 0)
+		return 0.0;
+	return length_sum / edge_count;
+}
+
+PerlinNoiseField3::Octaves Asteroid :: getNoiseOctaves (double vertex_spacing,
+                                                        double inner_radius,
+                                                        double outer_radius)
+{
+	assert(vertex_spacing >= 0.0);
+	assert(inner_radius >= 0.0);
+	assert(inner_radius <= outer_radius);
+
+	double radius_average    = (outer_radius + inner_radius) * 0.5;
+	double radius_half_range = (outer_radius - inner_radius) * 0.5;
+
+	PerlinNoiseField3::Octaves octaves(NOISE_OCTAVE_COUNT, NOISE_LACUNARITY, NOISE_GAIN);
+	octaves.m_min_grid_size = (float)(vertex_spacing);
+	if(radius_half_range > 0.0)
+		octaves.m_min_amplitude = (float)(vertex_spacing * radius_average / radius_half_range);
+	else
+		octaves.m_min_amplitude = (float)(NOISE_AMPLITUDE);  // noise has no effect
+	return octaves;
 }
 
 
@@ -103,44 +333,83 @@ Asteroid :: Asteroid ()
 		: Entity()
 		, m_inner_radius(0.0)
 		, m_random_noise_offset()
+		, m_shape()
 		, m_rotation_axis(Vector3(1.0, 0.0, 0.0))
 		, m_rotation_rate(0.0)
+		, mp_lod_meshes(nullptr)
+		, m_lod(0)
+		, m_is_lod_hidden(false)
 {
 	assert(!isInitialized());
 	assert(invariant());
 }
 
-static Vector3 g_noise_offset;  // to copy value out of parameter into member field initialized after
 Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
                       const ObjLibrary::Vector3& velocity,
                       double inner_radius,
                       double outer_radius,
+                      const ObjLibrary::ObjModel& base_model,
+                      RandomStream& r_random)
+		: Asteroid(position, velocity, inner_radius, outer_radius,
+		           chooseRandomParameters(r_random), base_model)
+{
+	assert(isInitialized());
+	assert(invariant());
+}
+
+Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
+                      const ObjLibrary::Vector3& velocity,
+                      double inner_radius,
+                      double outer_radius,
+                      const RandomParameters& parameters,
                       const ObjLibrary::ObjModel& base_model)
+		: Asteroid(position, velocity, inner_radius, outer_radius, parameters, base_model,
+		           createModel(base_model, inner_radius, outer_radius,
+		                       parameters.m_noise_offset))
+{
+	assert(isInitialized());
+	assert(invariant());
+}
+
+Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
+                      const ObjLibrary::Vector3& velocity,
+                      double inner_radius,
+                      double outer_radius,
+                      const RandomParameters& parameters,
+                      const ObjLibrary::ObjModel& base_model,
+                      const ObjLibrary::ObjModel& model)
 		: Entity(position,
 		         velocity,
 		         calculateMass(inner_radius, outer_radius),
 		         outer_radius,
-		         createDisplayList(base_model,
-		                           inner_radius,
-		                           outer_radius,
-		                           g_noise_offset = Vector3::getRandomSphereVector() * NOISE_OFFSET_MAX),
+		         getPlaceholderDisplayList(),
 		         1.0)
 		, m_inner_radius(inner_radius)
-		, m_random_noise_offset(g_noise_offset)  // copy from value set above
-		, m_rotation_axis(Vector3::getRandomUnitVector())
-		, m_rotation_rate(std::min(random01(), random01()) * ROTATION_RATE_MAX)  // mostly rotate slowly
+		, m_random_noise_offset(parameters.m_noise_offset)
+		, m_shape(base_model, inner_radius, outer_radius, model)
+		, m_rotation_axis(parameters.m_rotation_axis)
+		, m_rotation_rate(parameters.m_rotation_rate)
+		, mp_lod_meshes(&findLodMeshes(base_model))
+		, m_lod(0)
+		, m_is_lod_hidden(false)
 {
 	assert(inner_radius >= 0.0);
 	assert(inner_radius <= outer_radius);
 	assert(isUnitSphere(base_model));
+	assert(model.getVertexCount() == base_model.getVertexCount());
+	assert(mp_lod_meshes->getLodCount() == LOD_COUNT);
 
 	// rotate randomly
-	m_coords.rotateAroundForward(random01() * TWO_PI);
-	m_coords.rotateAroundUp     (random01() * TWO_PI);
-	m_coords.rotateAroundRight  (random01() * TWO_PI);
-	m_coords.rotateAroundForward(random01() * TWO_PI);
-	m_coords.rotateAroundUp     (random01() * TWO_PI);
-	m_coords.rotateAroundRight  (random01() * TWO_PI);
+	for(unsigned int i = 0; i < ROTATION_STEP_COUNT; i++)
+	{
+		double angle = parameters.ma_rotation_angles[i];
+		switch(i % 3)
+		{
+		case 0: m_coords.rotateAroundForward(angle); break;
+		case 1: m_coords.rotateAroundUp     (angle); break;
+		case 2: m_coords.rotateAroundRight  (angle); break;
+		}
+	}
 
 	assert(isInitialized());
 	assert(invariant());
@@ -148,27 +417,54 @@ Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
 
 
 
-void Asteroid :: drawAxes (double length) const
+unsigned int Asteroid :: getLodTriangleCount () const
 {
 	assert(isInitialized());
 
+	if(m_is_lod_hidden)
+		return 0;
+	return mp_lod_meshes->getTriangleCount(m_lod);
+}
+
+void Asteroid :: draw () const
+{
+	assert(isInitialized());
+
+	if(m_is_lod_hidden)
+		return;
+
+	double a_matrix[16];
+	calculateDrawMatrix(a_matrix);
+
 	glPushMatrix();
-		m_coords.applyDrawTransformations();
-
-		glBegin(GL_LINES);
-			glColor3d(1.0, 0.0, 0.0);
-			glVertex3d(0.0, 0.0, 0.0);
-			glVertex3d(length, 0.0, 0.0);
-			glColor3d(0.0, 1.0, 0.0);
-			glVertex3d(0.0, 0.0, 0.0);
-			glVertex3d(0.0, length, 0.0);
-			glColor3d(0.0, 0.0, 1.0);
-			glVertex3d(0.0, 0.0, 0.0);
-			glVertex3d(0.0, 0.0, length);
-		glEnd();
+		glMultMatrixd(a_matrix);
+		mp_lod_meshes->draw(m_shape, m_lod);
 	glPopMatrix();
 }
 
+void Asteroid :: addToRenderQueue (RenderQueue& r_queue,
+                                   const ObjLibrary::Vector3& camera_position) const
+{
+	assert(isInitialized());
+
+	if(m_is_lod_hidden)
+		return;
+
+	double a_matrix[16];
+	calculateDrawMatrix(a_matrix);
+	double depth = camera_position.getDistance(getPosition());
+	mp_lod_meshes->addToRenderQueue(r_queue, m_shape, m_lod, a_matrix, depth);
+}
+
+void Asteroid :: drawAxes (DebugDraw& r_debug_draw,
+                          double length) const
+{
+	assert(isInitialized());
+	assert(length >= 0.0);
+
+	r_debug_draw.addAxes(m_coords, length);
+}
+
 
 
 void Asteroid :: updatePhysics (double delta_time,
@@ -187,11 +483,55 @@ void Asteroid :: updatePhysics (double delta_time,
 
 
 
+void Asteroid :: updateLod (const ObjLibrary::Vector3& camera_position,
+                            double pixels_per_radian)
+{
+	assert(isInitialized());
+	assert(pixels_per_radian > 0.0);
+
+	// small-angle estimate of the radius in pixels
+	double distance = camera_position.getDistance(getPosition());
+	double projected_radius;
+	if(distance > getRadius())
+		projected_radius = getRadius() * pixels_per_radian / distance;
+	else
+		projected_radius = LOD_SWITCH_PIXELS[0] * 2.0;  // camera is inside
+
+	if(m_is_lod_hidden)
+	{
+		if(projected_radius > LOD_HIDE_PIXELS * (1.0 + LOD_HYSTERESIS))
+			m_is_lod_hidden = false;
+	}
+	else
+	{
+		if(projected_radius < LOD_HIDE_PIXELS * (1.0 - LOD_HYSTERESIS))
+			m_is_lod_hidden = true;
+	}
+
+	while(m_lod + 1 < LOD_COUNT &&
+	      projected_radius < LOD_SWITCH_PIXELS[m_lod] * (1.0 - LOD_HYSTERESIS))
+	{
+		m_lod++;
+	}
+	while(m_lod > 0 &&
+	      projected_radius > LOD_SWITCH_PIXELS[m_lod - 1] * (1.0 + LOD_HYSTERESIS))
+	{
+		m_lod--;
+	}
+
+	assert(invariant());
+}
+
+
+
 bool Asteroid :: invariant () const
 {
 	if(m_inner_radius < 0.0) return false;
 	if(m_inner_radius > getRadius()) return false;
 	if(!m_rotation_axis.isUnit()) return false;
 	if(m_rotation_rate < 0.0) return false;
+	if(isInitialized() && mp_lod_meshes == nullptr) return false;
+	if(isInitialized() && !m_shape.isInitialized()) return false;
+	if(m_lod >= LOD_COUNT) return false;
 	return true;
 }
@@ -7,13 +7,21 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
+#include <vector>
 
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
 
 #include "CoordinateSystem.h"
+#include "DebugDraw.h"
+#include "PerlinNoiseField3.h"
+#include "RandomStream.h"
+#include "AsteroidShape.h"
+#include "AsteroidLodMeshes.h"
 #include "Entity.h"
+#include "RenderQueue.h"
 
 
 
@@ -34,14 +42,71 @@
 //    a higher-polygon sphere for the base model will produce a
 //    higher-polygon asteroid.
 //
+//  Each Asteroid has several levels of detail (LODs), with
+//    level 0 being the full model.  Before drawing, updateLod
+//    should be called to choose a level based on how large
+//    the Asteroid appears on the screen.  An Asteroid that
+//    would cover less than a pixel is not drawn at all.  The
+//    levels are simplified from the base model, as by
+//    createLodBaseModels, and shared by all the Asteroids made
+//    from it in an AsteroidLodMeshes.  Each Asteroid only
+//    stores its AsteroidShape, which is expanded into a shared
+//    buffer each time it is drawn.  The meshes can be sorted by
+//    material with other Asteroids in a RenderQueue.
+//
+//  An Asteroid can be created in two stages, so that many can
+//    be created at once on several threads.  First,
+//    chooseRandomParameters makes the random choices from a
+//    RandomStream for that Asteroid.  Then createModel builds
+//    the model, which does not use OpenGL and can be run on any
+//    thread.  Finally, the Asteroid is constructed from the
+//    parameters and model on the thread with the OpenGL
+//    context, which uploads the shared levels of detail the
+//    first time each base model is used.
+//
 //  Class Invariant:
 //    <1> m_inner_radius >= 0.0
 //    <2> m_inner_radius <= getRadius()
 //    <3> m_rotation_axis.isUnit()
 //    <4> m_rotation_rate >= 0.0
+//    <5> !isInitialized() || mp_lod_meshes != nullptr
+//    <6> m_lod < LOD_COUNT
+//    <7> !isInitialized() || m_shape.isInitialized()
 //
 class Asteroid : public Entity
 {
+public:
+//
+//  LOD_COUNT
+//
+//  The number of levels of detail for each Asteroid.  Level 0
+//    is the full model.
+//
+	static const unsigned int LOD_COUNT = 4;
+
+//
+//  ROTATION_STEP_COUNT
+//
+//  The number of random rotations used to choose the starting
+//    orientation of an Asteroid.
+//
+	static const unsigned int ROTATION_STEP_COUNT = 6;
+
+	//
+	//  RandomParameters
+	//
+	//  A record to store the random choices for one Asteroid,
+	//    apart from its position, velocity, and radii.
+	//
+	struct RandomParameters
+	{
+		ObjLibrary::Vector3 m_noise_offset;
+		ObjLibrary::Vector3 m_rotation_axis;
+		double m_rotation_rate;
+		// around forward, up, right, forward, up, right
+		double ma_rotation_angles[ROTATION_STEP_COUNT];
+	};
+
 public:
 //
 //  Class Function: isUnitSphere
@@ -75,6 +140,30 @@ public:
 	static double calculateMass (double inner_radius,
 	                             double outer_radius);
 
+//
+//  Class Function: createModel
+//
+//  Purpose: To create the deformed ObjModel for an Asteroid.
+//  Parameter(s):
+//    <1> base_model: The base ObjModel that wil be modified to
+//                    produce the asteroid
+//    <2> inner_radius: The inner asteroid radius
+//    <3> outer_radius: The outer asteroid radius
+//    <4> random_noise_offset: The offset for the Perlin noise
+//  Preconditions:
+//    <1> isUnitSphere(base_model)
+//  Returns: A copy of base_model with the vertexes positioned
+//           based on Perlin noise and the inner and outer
+//           radii.  Each vertex has one normal vector, which
+//           is calculated exactly from the noise gradient.
+//  Side Effect: N/A
+//
+	static ObjLibrary::ObjModel createModel (
+	                   const ObjLibrary::ObjModel& base_model,
+	                   double inner_radius,
+	                   double outer_radius,
+	                   ObjLibrary::Vector3 random_noise_offset);
+
 //
 //  Class Function: createDisplayList
 //
@@ -98,6 +187,185 @@ public:
 	                   double outer_radius,
 	                   ObjLibrary::Vector3 random_noise_offset);
 
+//
+//  Class Function: createLodObjModels
+//
+//  Purpose: To create the ObjModels for each level of detail
+//           of an Asteroid without uploading them to OpenGL.
+//  Parameter(s):
+//    <1> base_model: The base ObjModel that wil be modified to
+//                    produce the asteroid
+//    <2> inner_radius: The inner asteroid radius
+//    <3> outer_radius: The outer asteroid radius
+//    <4> random_noise_offset: The offset for the Perlin noise
+//  Preconditions:
+//    <1> isUnitSphere(base_model)
+//  Returns: A vector of LOD_COUNT ObjModels.  Element 0 is the
+//           model createModel would return, and each later
+//           element is the deformed model simplified to fewer
+//           triangles (50%, 25%, and 10%).  Asteroids do not
+//           use these, because their levels of detail are
+//           shared; see createLodBaseModels.
+//  Side Effect: N/A.  This function does not use OpenGL or
+//               any shared state, so it can be called on
+//               several threads at once.
+//
+	static std::vector<ObjLibrary::ObjModel> createLodObjModels (
+	                   const ObjLibrary::ObjModel& base_model,
+	                   double inner_radius,
+	                   double outer_radius,
+	                   ObjLibrary::Vector3 random_noise_offset);
+
+//
+//  Class Function: createLodBaseModels
+//
+//  Purpose: To create a simplified base model for each level
+//           of detail.  Asteroids share these levels, with the
+//           vertexes moved as in their AsteroidShapes, and
+//           renderers that deform the base model themselves
+//           use them too.
+//  Parameter(s):
+//    <1> base_model: The base ObjModel
+//  Preconditions:
+//    <1> isUnitSphere(base_model)
+//  Returns: A vector of LOD_COUNT ObjModels.  Element 0 is
+//           base_model, and each later element is base_model
+//           simplified to the same fraction of the triangles as
+//           createLodObjModels uses.  Each element is still a
+//           unit sphere.  Because the sphere is simplified
+//           before it is deformed, the levels are not exactly
+//           the same as those from createLodObjModels.
+//  Side Effect: N/A
+//
+	static std::vector<ObjLibrary::ObjModel> createLodBaseModels (
+	                   const ObjLibrary::ObjModel& base_model);
+
+//
+//  Class Function: createIcosphereLodObjModels
+//
+//  Purpose: To create an ObjModel for each level of detail of
+//           an Asteroid by deforming a separate sphere for each
+//           level, instead of simplifying one model.
+//  Parameter(s):
+//    <1> v_base_levels: The unit spheres for each level, such
+//                       as from createIcosphereLevels
+//    <2> inner_radius: The inner asteroid radius
+//    <3> outer_radius: The outer asteroid radius
+//    <4> random_noise_offset: The offset for the Perlin noise
+//  Preconditions:
+//    <1> v_base_levels.size() == LOD_COUNT
+//    <2> isUnitSphere(v_base_levels[i]) for all i
+//  Returns: A vector of LOD_COUNT ObjModels.  Element i is
+//           v_base_levels[i] deformed as by createModel, so
+//           the levels have different vertexes but the same
+//           overall shape.  The finer noise octaves are
+//           skipped on the coarser levels.
+//  Side Effect: N/A.  This function does not use OpenGL or
+//               any shared state, so it can be called on
+//               several threads at once.  The models cannot be
+//               stored in a MeshCache because their vertexes
+//               differ.
+//
+	static std::vector<ObjLibrary::ObjModel> createIcosphereLodObjModels (
+	                   const std::vector<ObjLibrary::ObjModel>& v_base_levels,
+	                   double inner_radius,
+	                   double outer_radius,
+	                   ObjLibrary::Vector3 random_noise_offset);
+
+//
+//  Class Function: chooseRandomParameters
+//
+//  Purpose: To make the random choices for a new Asteroid.
+//  Parameter(s):
+//    <1> r_random: The RandomStream to choose with
+//  Preconditions: N/A
+//  Returns: A noise offset, rotation axis, rotation rate, and
+//           starting orientation chosen from r_random.
+//  Side Effect: r_random is advanced.  It is always advanced
+//               by the same amount, so values taken from it
+//               afterwards do not depend on the choices made.
+//
+	static RandomParameters chooseRandomParameters (RandomStream& r_random);
+
+//
+//  Class Function: getModelCacheKey
+//
+//  Purpose: To calculate the MeshCache key for the model
+//           createModel would create.
+//  Parameter(s):
+//    <1> base_model_hash: The hash of the base model, as
+//                         returned by MeshCache::hashModel
+//    <2> inner_radius: The inner asteroid radius
+//    <3> outer_radius: The outer asteroid radius
+//    <4> random_noise_offset: The offset for the Perlin noise
+//  Preconditions: N/A
+//  Returns: A hash of the parameters and of the settings used
+//           to deform the model, including the noise seeds and
+//           hash mode.
+//  Side Effect: N/A
+//
+	static uint64_t getModelCacheKey (uint64_t base_model_hash,
+	                                  double inner_radius,
+	                                  double outer_radius,
+	                                  const ObjLibrary::Vector3& random_noise_offset);
+
+//
+//  Class Function: getNoiseField
+//
+//  Purpose: To retrieve the Perlin noise field used to deform
+//           Asteroid models.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The PerlinNoiseField3 used by createModel.  A
+//           renderer that deforms the base model itself must
+//           use the same grid size and amplitude, and the
+//           octaves from getNoiseOctaves.
+//  Side Effect: N/A
+//
+	static const PerlinNoiseField3& getNoiseField ();
+
+//
+//  Class Function: calculateVertexSpacing
+//
+//  Purpose: To determine the average distance between
+//           neighbouring vertexes in a base model.
+//  Parameter(s):
+//    <1> base_model: The base ObjModel
+//  Preconditions:
+//    <1> isUnitSphere(base_model)
+//  Returns: The average length of the face edges in
+//           base_model.  If base_model has no faces, 0.0 is
+//           returned.
+//  Side Effect: N/A
+//
+	static double calculateVertexSpacing (const ObjLibrary::ObjModel& base_model);
+
+//
+//  Class Function: getNoiseOctaves
+//
+//  Purpose: To determine the fractal noise octaves used to
+//           deform a base model.
+//  Parameter(s):
+//    <1> vertex_spacing: The vertex spacing of the base
+//                        model, as returned by
+//                        calculateVertexSpacing
+//    <2> inner_radius: The inner asteroid radius
+//    <3> outer_radius: The outer asteroid radius
+//  Preconditions:
+//    <1> vertex_spacing >= 0.0
+//    <2> inner_radius >= 0.0
+//    <3> inner_radius <= outer_radius
+//  Returns: The octaves for getNoiseField().fbmNoise.  Octaves
+//           with a grid size smaller than the vertex spacing
+//           are skipped, as are octaves that would move the
+//           vertexes less than the vertex spacing (scaled to
+//           the asteroid size).  The mesh could not show them.
+//  Side Effect: N/A
+//
+	static PerlinNoiseField3::Octaves getNoiseOctaves (double vertex_spacing,
+	                                                   double inner_radius,
+	                                                   double outer_radius);
+
 public:
 //
 //  Default Constructor
@@ -123,6 +391,8 @@ public:
 //    <4> outer_radius: The outer asteroid radius
 //    <5> base_model: The base ObjModel that wil be modified to
 //                    produce the asteroid
+//    <6> r_random: The RandomStream to make the random choices
+//                  with
 //  Preconditions: N/A
 //    <1> inner_radius >= 0.0
 //    <2> inner_radius <= outer_radius
@@ -134,33 +404,273 @@ public:
 //               radius always in the interval
 //               [inner_radius, outer_radius].  The new Asteroid
 //               has a random orientation and rotational
-//               velocity.
+//               velocity.  r_random is advanced as by
+//               chooseRandomParameters.
 //
 	Asteroid (const ObjLibrary::Vector3& position,
 	          const ObjLibrary::Vector3& velocity,
 	          double inner_radius,
 	          double outer_radius,
+	          const ObjLibrary::ObjModel& base_model,
+	          RandomStream& r_random);
+
+//
+//  Constructor
+//
+//  Purpose: To create an asteroid with the specified random
+//           parameters.
+//  Parameter(s):
+//    <1> position: The position of the asteroid origin
+//    <2> velocity: The velocity of the asteroid
+//    <3> inner_radius: The inner asteroid radius
+//    <4> outer_radius: The outer asteroid radius
+//    <5> parameters: The random choices for the asteroid
+//    <6> base_model: The base ObjModel that wil be modified to
+//                    produce the asteroid
+//  Preconditions: N/A
+//    <1> inner_radius >= 0.0
+//    <2> inner_radius <= outer_radius
+//    <3> isUnitSphere(base_model)
+//  Returns: N/A
+//  Side Effect: A new Asteroid is created as by the constructor
+//               above, except that parameters are used instead
+//               of random values.
+//
+	Asteroid (const ObjLibrary::Vector3& position,
+	          const ObjLibrary::Vector3& velocity,
+	          double inner_radius,
+	          double outer_radius,
+	          const RandomParameters& parameters,
 	          const ObjLibrary::ObjModel& base_model);
 
+//
+//  Constructor
+//
+//  Purpose: To create an asteroid from a model that has
+//           already been built.
+//  Parameter(s):
+//    <1> position: The position of the asteroid origin
+//    <2> velocity: The velocity of the asteroid
+//    <3> inner_radius: The inner asteroid radius
+//    <4> outer_radius: The outer asteroid radius
+//    <5> parameters: The random choices for the asteroid
+//    <6> base_model: The base ObjModel the model was made from
+//    <7> model: The deformed model
+//  Preconditions: N/A
+//    <1> inner_radius >= 0.0
+//    <2> inner_radius <= outer_radius
+//    <3> isUnitSphere(base_model)
+//    <4> model was returned by createModel with base_model,
+//        inner_radius, outer_radius, and
+//        parameters.m_noise_offset
+//    <5> base_model is not changed or destroyed while this
+//        Asteroid exists
+//  Returns: N/A
+//  Side Effect: A new Asteroid is created as by the constructor
+//               above, but nothing needs to be calculated.
+//               Only the vertex radii and normals of model are
+//               kept, as an AsteroidShape that refers to
+//               base_model.  If this is the first Asteroid made
+//               from base_model, the shared levels of detail
+//               are created and uploaded to OpenGL.
+//
+	Asteroid (const ObjLibrary::Vector3& position,
+	          const ObjLibrary::Vector3& velocity,
+	          double inner_radius,
+	          double outer_radius,
+	          const RandomParameters& parameters,
+	          const ObjLibrary::ObjModel& base_model,
+	          const ObjLibrary::ObjModel& model);
+
 	Asteroid (const Asteroid& to_copy) = default;
 	~Asteroid () = default;
 	Asteroid& operator= (const Asteroid& to_copy) = default;
 
+//
+//  getInnerRadius
+//
+//  Purpose: To determine the inner radius of this Asteroid.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The inner radius.  Every vertex of the Asteroid
+//           model is at least this far from its origin.
+//  Side Effect: N/A
+//
+	double getInnerRadius () const
+	{
+		assert(isInitialized());
+
+		return m_inner_radius;
+	}
+
+//
+//  getNoiseOffset
+//
+//  Purpose: To determine the offset into the Perlin noise field
+//           used to deform this Asteroid.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The noise offset passed to createModel.
+//  Side Effect: N/A
+//
+	const ObjLibrary::Vector3& getNoiseOffset () const
+	{
+		assert(isInitialized());
+
+		return m_random_noise_offset;
+	}
+
+//
+//  getShape
+//
+//  Purpose: To retrieve the compact shape of this Asteroid.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The radius and normal of each vertex of the full
+//           model, relative to the base model.  This can be
+//           expanded to vertex positions for collision
+//           checking.
+//  Side Effect: N/A
+//
+	const AsteroidShape& getShape () const
+	{
+		assert(isInitialized());
+
+		return m_shape;
+	}
+
+//
+//  getLodMeshes
+//
+//  Purpose: To retrieve the levels of detail this Asteroid is
+//           drawn with.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The AsteroidLodMeshes shared by all Asteroids made
+//           from the same base model.
+//  Side Effect: N/A
+//
+	const AsteroidLodMeshes& getLodMeshes () const
+	{
+		assert(isInitialized());
+		assert(mp_lod_meshes != nullptr);
+
+		return *mp_lod_meshes;
+	}
+
+//
+//  getLod
+//
+//  Purpose: To determine which level of detail this Asteroid
+//           is currently drawn at.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The current level of detail, with 0 being the most
+//           detailed.
+//  Side Effect: N/A
+//
+	unsigned int getLod () const
+	{
+		assert(isInitialized());
+
+		return m_lod;
+	}
+
+//
+//  isLodHidden
+//
+//  Purpose: To determine if this Asteroid is currently too
+//           small on the screen to be drawn.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: Whether this Asteroid will be skipped by draw.
+//  Side Effect: N/A
+//
+	bool isLodHidden () const
+	{
+		assert(isInitialized());
+
+		return m_is_lod_hidden;
+	}
+
+//
+//  getLodTriangleCount
+//
+//  Purpose: To determine how many triangles are drawn for this
+//           Asteroid at its current level of detail.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The number of triangles drawn by draw.  If this
+//           Asteroid is hidden, 0 is returned.
+//  Side Effect: N/A
+//
+	unsigned int getLodTriangleCount () const;
+
+//
+//  draw
+//
+//  Purpose: To display this Asteroid at its current level of
+//           detail.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: This Asteroid is displayed using the shared
+//               mesh for its current level of detail, with the
+//               vertexes expanded from its AsteroidShape.  If it
+//               is hidden, nothing is displayed.
+//
+	virtual void draw () const;
+
+//
+//  addToRenderQueue
+//
+//  Purpose: To add this Asteroid at its current level of detail
+//           to a RenderQueue instead of drawing it immediately.
+//  Parameter(s):
+//    <1> r_queue: The RenderQueue
+//    <2> camera_position: The position of the camera
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The vertexes for the current level of detail
+//               are expanded into a stream buffer, as by
+//               AsteroidLodMeshes::addToRenderQueue.  Each mesh
+//               is added to r_queue with its Material, the
+//               transformation for this Asteroid, and the
+//               distance from camera_position.  If this
+//               Asteroid is hidden, there is no effect.
+//               AsteroidLodMeshes::clearStreamBuffers must not
+//               be called until r_queue is drawn.
+//
+	void addToRenderQueue (RenderQueue& r_queue,
+	                       const ObjLibrary::Vector3& camera_position) const;
+
 //
 //  drawAxes
 //
 //  Purpose: To display the XYZ axes of the local coordinate
 //           system for this Asteroid.
 //  Parameter(s):
-//    <1> length: The length of the axes
+//    <1> r_debug_draw: The DebugDraw to add the axes to
+//    <2> length: The length of the axes
 //  Preconditions:
 //    <1> isInitialized()
 //    <2> length >= 0.0
 //  Returns: N/A
-//  Side Effect: The current orientation of this Asteroid is
-//               displayed.
+//  Side Effect: Lines showing the current orientation of this
+//               Asteroid are added to r_debug_draw.  They are
+//               displayed when r_debug_draw is flushed.
 //
-	void drawAxes (double length) const;
+	void drawAxes (DebugDraw& r_debug_draw,
+	               double length) const;
 
 //
 //  updatePhysics
@@ -180,6 +690,32 @@ public:
 	virtual void updatePhysics (double delta_time,
 	                            const Entity& black_hole);
 
+//
+//  updateLod
+//
+//  Purpose: To choose the level of detail for this Asteroid
+//           based on its size on the screen.
+//  Parameter(s):
+//    <1> camera_position: The position of the camera
+//    <2> pixels_per_radian: The number of pixels on the screen
+//                           per radian of view angle, near the
+//                           view center
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> pixels_per_radian > 0.0
+//  Returns: N/A
+//  Side Effect: The projected radius of this Asteroid in pixels
+//               is estimated and used to choose its level of
+//               detail.  A level only changes once the size is
+//               a margin past the switching threshold, so an
+//               Asteroid near a threshold does not flicker
+//               between levels.  If the projected radius is
+//               below about half a pixel, this Asteroid is
+//               hidden.
+//
+	void updateLod (const ObjLibrary::Vector3& camera_position,
+	                double pixels_per_radian);
+
 private:
 //
 //  invariant
@@ -195,8 +731,12 @@ private:
 private:
 	double m_inner_radius;
 	ObjLibrary::Vector3 m_random_noise_offset;
+	AsteroidShape m_shape;
 	ObjLibrary::Vector3 m_rotation_axis;
 	double m_rotation_rate;
+	const AsteroidLodMeshes* mp_lod_meshes;
+	unsigned int m_lod;
+	bool m_is_lod_hidden;
 };
 
 
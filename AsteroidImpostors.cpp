@@ -0,0 +1,433 @@
+//
+//  AsteroidImpostors.cpp
+//
+
+#include "GetGlutWithShaders.h"  // must be first
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>  // for sscanf
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/GlCallCounter.h"
+
+#include "Asteroid.h"
+#include "AsteroidImpostors.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	// extra space around each Asteroid so linear filtering does not reach the next tile
+	const double TILE_MARGIN = 1.05;
+
+	const float ALPHA_THRESHOLD = 0.5f;
+
+	const unsigned int REFRESH_MAX_DEFAULT   = 32;
+	const double       REFRESH_ANGLE_DEFAULT = 0.1;  // radians
+
+	Vector3 toLocal (const Vector3& world,
+	                 const Asteroid& asteroid)
+	{
+		return Vector3(world.dotProduct(asteroid.getForward()),
+		               world.dotProduct(asteroid.getUp()),
+		               world.dotProduct(asteroid.getRight()));
+	}
+}
+
+
+
+bool AsteroidImpostors :: isSupported ()
+{
+	const char* version = (const char*)(glGetString(GL_VERSION));
+	if(version == nullptr)
+		return false;
+
+	int major = 0;
+	int minor = 0;
+	if(sscanf(version, "%d.%d", &major, &minor) != 2)
+		return false;
+	return major >= 3;
+}
+
+
+
+AsteroidImpostors :: AsteroidImpostors ()
+		: m_framebuffer(0)
+		, m_atlas_texture(0)
+		, m_depth_renderbuffer(0)
+		, m_tile_size(0)
+		, m_tiles_per_side(0)
+		, m_refresh_max(REFRESH_MAX_DEFAULT)
+		, m_refresh_angle(REFRESH_ANGLE_DEFAULT)
+		, m_refresh_cos(cos(REFRESH_ANGLE_DEFAULT))
+		, mv_slots()
+		, m_slot_for_id()
+		, m_next_free_slot(0)
+		, m_clock_hand(0)
+		, m_frame(1)
+		, mv_refreshes()
+		, mv_vertexes()
+{
+	assert(!isInitialized());
+	assert(invariant());
+}
+
+AsteroidImpostors :: ~AsteroidImpostors ()
+{
+	if(!DisplayList::isDisabledForExit())
+		destroy();
+}
+
+
+
+void AsteroidImpostors :: init (unsigned int tile_size,
+                                unsigned int tiles_per_side)
+{
+	assert(isSupported());
+	assert(tile_size > 0);
+	assert(tiles_per_side > 0);
+
+	destroy();
+
+	m_tile_size      = tile_size;
+	m_tiles_per_side = tiles_per_side;
+	mv_slots.resize(getSlotCount());
+	invalidateAll();
+
+	GLsizei atlas_size = (GLsizei)(tile_size * tiles_per_side);
+
+	glGenTextures(1, &m_atlas_texture);
+	glBindTexture(GL_TEXTURE_2D, m_atlas_texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlas_size, atlas_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &m_depth_renderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depth_renderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, atlas_size, atlas_size);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLint previous_framebuffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_atlas_texture, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth_renderbuffer);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+
+	if(status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		cerr << "Error creating asteroid impostor framebuffer: status 0x" << hex << status << dec << endl;
+		destroy();
+	}
+
+	assert(invariant());
+}
+
+void AsteroidImpostors :: setRefreshMax (unsigned int refresh_max)
+{
+	m_refresh_max = refresh_max;
+
+	assert(invariant());
+}
+
+void AsteroidImpostors :: setRefreshAngle (double radians)
+{
+	assert(radians > 0.0);
+
+	m_refresh_angle = radians;
+	m_refresh_cos   = cos(radians);
+
+	assert(invariant());
+}
+
+void AsteroidImpostors :: invalidateAll ()
+{
+	for(unsigned int i = 0; i < mv_slots.size(); i++)
+	{
+		mv_slots[i].m_is_assigned = false;
+		mv_slots[i].m_last_frame  = 0;
+	}
+	m_slot_for_id.clear();
+	m_next_free_slot = 0;
+	m_clock_hand     = 0;
+	mv_refreshes.clear();
+	mv_vertexes.clear();
+
+	assert(invariant());
+}
+
+void AsteroidImpostors :: clearQuads ()
+{
+	mv_refreshes.clear();
+	mv_vertexes.clear();
+	m_frame++;
+
+	assert(invariant());
+}
+
+bool AsteroidImpostors :: add (unsigned int id,
+                               const Asteroid& asteroid,
+                               const ObjLibrary::Vector3& camera_position,
+                               const ObjLibrary::Vector3& camera_up)
+{
+	assert(isInitialized());
+	assert(asteroid.isInitialized());
+	assert(!asteroid.isLodHidden());
+	assert(camera_position != asteroid.getPosition());
+
+	// same axes as gluLookAt from the camera, so the tile matches the quad
+	Vector3 to_camera = (camera_position - asteroid.getPosition()).getNormalized();
+	Vector3 side = (-to_camera).crossProduct(camera_up);
+	if(side.isZero())
+		side = (-to_camera).crossProduct(asteroid.getForward());
+	if(side.isZero())
+		side = (-to_camera).crossProduct(asteroid.getUp());
+	side.normalize();
+	Vector3 up = side.crossProduct(-to_camera);
+
+	Vector3 local_direction = toLocal(to_camera, asteroid);
+	Vector3 local_up        = toLocal(up,        asteroid);
+
+	unsigned int slot_index;
+	bool is_refresh;
+	unordered_map<unsigned int, unsigned int>::const_iterator found = m_slot_for_id.find(id);
+	if(found != m_slot_for_id.end())
+	{
+		slot_index = found->second;
+		const Slot& slot = mv_slots[slot_index];
+		is_refresh = slot.m_local_direction.dotProduct(local_direction) < m_refresh_cos ||
+		             slot.m_local_up       .dotProduct(local_up)        < m_refresh_cos;
+
+		// an old image is better than nothing
+		if(mv_refreshes.size() >= m_refresh_max)
+			is_refresh = false;
+	}
+	else
+	{
+		if(mv_refreshes.size() >= m_refresh_max)
+			return false;
+		if(!allocateSlot(id, slot_index))
+			return false;
+		is_refresh = true;
+	}
+
+	Slot& slot = mv_slots[slot_index];
+	slot.m_last_frame = m_frame;
+	if(is_refresh)
+	{
+		slot.m_local_direction = local_direction;
+		slot.m_local_up        = local_up;
+
+		Refresh refresh;
+		refresh.m_slot          = slot_index;
+		refresh.mp_asteroid     = &asteroid;
+		refresh.m_eye_direction = to_camera;
+		refresh.m_up            = up;
+		mv_refreshes.push_back(refresh);
+	}
+
+	// quad is drawn with the axes the tile was rendered with, rotated with the Asteroid
+	Vector3 tile_side = (asteroid.getForward() * slot.m_local_up.x +
+	                     asteroid.getUp()      * slot.m_local_up.y +
+	                     asteroid.getRight()   * slot.m_local_up.z).crossProduct(to_camera);
+	if(tile_side.isZero())
+		tile_side = side;
+	tile_side.normalize();
+	Vector3 tile_up = to_camera.crossProduct(tile_side);
+
+	double half_size = asteroid.getRadius() * TILE_MARGIN;
+	Vector3 centre = asteroid.getPosition();
+	Vector3 across = tile_side * half_size;
+	Vector3 above  = tile_up   * half_size;
+
+	float tile_fraction = 1.0f / m_tiles_per_side;
+	float s0 = (slot_index % m_tiles_per_side) * tile_fraction;
+	float t0 = (slot_index / m_tiles_per_side) * tile_fraction;
+	float s1 = s0 + tile_fraction;
+	float t1 = t0 + tile_fraction;
+
+	const Vector3 A_CORNERS[4] =
+	{
+		centre - across - above,
+		centre + across - above,
+		centre + across + above,
+		centre - across + above,
+	};
+	const float A_S[4] = { s0, s1, s1, s0 };
+	const float A_T[4] = { t0, t0, t1, t1 };
+	for(unsigned int c = 0; c < 4; c++)
+	{
+		QuadVertex vertex;
+		vertex.m_x = (float)(A_CORNERS[c].x);
+		vertex.m_y = (float)(A_CORNERS[c].y);
+		vertex.m_z = (float)(A_CORNERS[c].z);
+		vertex.m_s = A_S[c];
+		vertex.m_t = A_T[c];
+		mv_vertexes.push_back(vertex);
+	}
+
+	assert(invariant());
+	return true;
+}
+
+void AsteroidImpostors :: draw ()
+{
+	assert(isInitialized());
+
+	renderTiles();
+
+	if(mv_vertexes.empty())
+		return;
+
+	glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT | GL_COLOR_BUFFER_BIT);
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, m_atlas_texture);
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+		// depth writes work because the edges are cut off instead of blended
+		glEnable(GL_ALPHA_TEST);
+		glAlphaFunc(GL_GREATER, ALPHA_THRESHOLD);
+
+		glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+			GLsizei stride = sizeof(QuadVertex);
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+			glVertexPointer  (3, GL_FLOAT, stride, &(mv_vertexes[0].m_x));
+			glTexCoordPointer(2, GL_FLOAT, stride, &(mv_vertexes[0].m_s));
+
+			glDrawArrays(GL_QUADS, 0, (GLsizei)(mv_vertexes.size()));
+		glPopClientAttrib();
+	glPopAttrib();
+}
+
+
+
+bool AsteroidImpostors :: allocateSlot (unsigned int id,
+                                        unsigned int& r_slot)
+{
+	assert(m_slot_for_id.find(id) == m_slot_for_id.end());
+
+	unsigned int slot_count = getSlotCount();
+	if(m_next_free_slot < slot_count)
+	{
+		r_slot = m_next_free_slot;
+		m_next_free_slot++;
+	}
+	else
+	{
+		// clock sweep for a tile not drawn this frame, so long-unused tiles go first
+		bool is_found = false;
+		for(unsigned int i = 0; i < slot_count && !is_found; i++)
+		{
+			unsigned int index = m_clock_hand;
+			m_clock_hand = (m_clock_hand + 1) % slot_count;
+			if(mv_slots[index].m_last_frame != m_frame)
+			{
+				r_slot   = index;
+				is_found = true;
+			}
+		}
+		if(!is_found)
+			return false;
+
+		assert(mv_slots[r_slot].m_is_assigned);
+		m_slot_for_id.erase(mv_slots[r_slot].m_id);
+	}
+
+	Slot& slot = mv_slots[r_slot];
+	slot.m_is_assigned = true;
+	slot.m_id          = id;
+	m_slot_for_id[id]  = r_slot;
+	return true;
+}
+
+void AsteroidImpostors :: renderTiles ()
+{
+	if(mv_refreshes.empty())
+		return;
+
+	GLint previous_framebuffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+
+	glPushAttrib(GL_VIEWPORT_BIT | GL_SCISSOR_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_ENABLE_BIT);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glEnable(GL_SCISSOR_TEST);
+	glEnable(GL_DEPTH_TEST);
+	glDepthMask(GL_TRUE);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+	for(unsigned int i = 0; i < mv_refreshes.size(); i++)
+	{
+		const Refresh& refresh = mv_refreshes[i];
+		assert(refresh.mp_asteroid != nullptr);
+		const Asteroid& asteroid = *refresh.mp_asteroid;
+
+		GLint x = (GLint)((refresh.m_slot % m_tiles_per_side) * m_tile_size);
+		GLint y = (GLint)((refresh.m_slot / m_tiles_per_side) * m_tile_size);
+		glViewport(x, y, m_tile_size, m_tile_size);
+		glScissor (x, y, m_tile_size, m_tile_size);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// orthographic is close enough for a distant Asteroid
+		double half_size = asteroid.getRadius() * TILE_MARGIN;
+		glMatrixMode(GL_PROJECTION);
+		glLoadIdentity();
+		glOrtho(-half_size, half_size, -half_size, half_size, 0.0, half_size * 2.0);
+
+		const Vector3& centre = asteroid.getPosition();
+		Vector3 eye = centre + refresh.m_eye_direction * half_size;
+		glMatrixMode(GL_MODELVIEW);
+		glLoadIdentity();
+		gluLookAt(eye.x,          eye.y,          eye.z,
+		          centre.x,       centre.y,       centre.z,
+		          refresh.m_up.x, refresh.m_up.y, refresh.m_up.z);
+
+		asteroid.draw();
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+	glPopAttrib();
+}
+
+void AsteroidImpostors :: destroy ()
+{
+	if(m_framebuffer != 0)
+		glDeleteFramebuffers(1, &m_framebuffer);
+	if(m_depth_renderbuffer != 0)
+		glDeleteRenderbuffers(1, &m_depth_renderbuffer);
+	if(m_atlas_texture != 0)
+		glDeleteTextures(1, &m_atlas_texture);
+	m_framebuffer        = 0;
+	m_depth_renderbuffer = 0;
+	m_atlas_texture      = 0;
+}
+
+bool AsteroidImpostors :: invariant () const
+{
+	if(mv_slots.size() != getSlotCount()) return false;
+	if(m_slot_for_id.size() > mv_slots.size()) return false;
+	if(mv_vertexes.size() % 4 != 0) return false;
+	if(m_refresh_angle <= 0.0) return false;
+	return true;
+}
@@ -0,0 +1,336 @@
+//
+//  AsteroidImpostors.h
+//
+//  A module to draw distant asteroids as textured quads.
+//
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Asteroid.h"
+
+
+
+//
+//  AsteroidImpostors
+//
+//  A class to draw distant Asteroids as impostors: camera-
+//    facing quads textured with an image of the Asteroid.  The
+//    images are stored as square tiles in one atlas texture,
+//    which is rendered to through a framebuffer object.  All
+//    the quads are drawn with a single glDrawArrays call.
+//
+//  Each Asteroid is deformed differently from its unit-sphere
+//    base model, so each one drawn as an impostor is given its
+//    own tile.  A tile is rendered at the current level of
+//    detail of the Asteroid, from the direction of the camera.
+//    It is only re-rendered when the direction to the camera
+//    or the camera up vector, measured in the local
+//    coordinates of the Asteroid, turns by more than the
+//    refresh angle.  At most getRefreshMax() tiles are rendered
+//    each frame, and the rest wait for a later frame.
+//
+//  When all the tiles are in use, the tile that has gone the
+//    longest without being drawn is reused.  If every tile was
+//    drawn this frame, add fails and the caller should draw the
+//    Asteroid normally.
+//
+//  This requires OpenGL 3.0 for framebuffer objects.  Use
+//    isSupported to check before calling init.
+//
+//  An AsteroidImpostors cannot be copied because it owns a
+//    framebuffer object and texture.
+//
+//  Class Invariant:
+//    <1> mv_slots.size() == getSlotCount()
+//    <2> m_slot_for_id.size() <= mv_slots.size()
+//    <3> mv_vertexes.size() % 4 == 0
+//    <4> m_refresh_angle > 0.0
+//
+class AsteroidImpostors
+{
+public:
+//
+//  Class Function: isSupported
+//
+//  Purpose: To determine if the current OpenGL context can
+//           render impostors.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> An OpenGL context is current
+//  Returns: Whether the OpenGL version is at least 3.0.
+//  Side Effect: N/A
+//
+	static bool isSupported ();
+
+public:
+	AsteroidImpostors ();
+	AsteroidImpostors (const AsteroidImpostors& to_copy) = delete;
+	~AsteroidImpostors ();
+	AsteroidImpostors& operator= (const AsteroidImpostors& to_copy) = delete;
+
+//
+//  isInitialized
+//
+//  Purpose: To determine if this AsteroidImpostors can draw.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the atlas and framebuffer object were
+//           created successfully.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{	return m_framebuffer != 0;	}
+
+//
+//  getTileSize
+//
+//  Purpose: To determine the size of each tile in the atlas.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The width and height of a tile in pixels.
+//  Side Effect: N/A
+//
+	unsigned int getTileSize () const
+	{	return m_tile_size;	}
+
+//
+//  getSlotCount
+//
+//  Purpose: To determine how many tiles the atlas holds.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of Asteroids that can have an impostor
+//           at once.
+//  Side Effect: N/A
+//
+	unsigned int getSlotCount () const
+	{	return m_tiles_per_side * m_tiles_per_side;	}
+
+//
+//  getQuadCount
+//
+//  Purpose: To determine how many impostors will be drawn.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of Asteroids added since clearQuads was
+//           last called.
+//  Side Effect: N/A
+//
+	unsigned int getQuadCount () const
+	{	return (unsigned int)(mv_vertexes.size() / 4);	}
+
+//
+//  getRefreshCount
+//
+//  Purpose: To determine how many tiles are rendered this
+//           frame.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of tiles rendered, or to be rendered by
+//           draw, since clearQuads was last called.
+//  Side Effect: N/A
+//
+	unsigned int getRefreshCount () const
+	{	return (unsigned int)(mv_refreshes.size());	}
+
+//
+//  getRefreshMax
+//
+//  Purpose: To determine the most tiles that will be rendered
+//           in a frame.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The maximum number of tiles rendered per frame.
+//  Side Effect: N/A
+//
+	unsigned int getRefreshMax () const
+	{	return m_refresh_max;	}
+
+//
+//  getRefreshAngle
+//
+//  Purpose: To determine how far the view of an Asteroid may
+//           turn before its tile is rendered again.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The refresh angle in radians.
+//  Side Effect: N/A
+//
+	double getRefreshAngle () const
+	{	return m_refresh_angle;	}
+
+//
+//  init
+//
+//  Purpose: To create the atlas texture and framebuffer object.
+//  Parameter(s):
+//    <1> tile_size: The width and height of each tile in pixels
+//    <2> tiles_per_side: The number of tiles in each row and
+//                        column of the atlas
+//  Preconditions:
+//    <1> isSupported()
+//    <2> tile_size > 0
+//    <3> tiles_per_side > 0
+//  Returns: N/A
+//  Side Effect: An atlas of tiles_per_side * tiles_per_side
+//               tiles is created.  Any existing impostors are
+//               removed.  If the framebuffer object is not
+//               complete, an error message is printed and this
+//               AsteroidImpostors is left uninitialized.
+//
+	void init (unsigned int tile_size,
+	           unsigned int tiles_per_side);
+
+//
+//  setRefreshMax
+//
+//  Purpose: To change the most tiles rendered in a frame.
+//  Parameter(s):
+//    <1> refresh_max: The new maximum
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: At most refresh_max tiles will be rendered each
+//               frame.  If refresh_max is 0, no new Asteroids
+//               can be added.
+//
+	void setRefreshMax (unsigned int refresh_max);
+
+//
+//  setRefreshAngle
+//
+//  Purpose: To change how far the view of an Asteroid may turn
+//           before its tile is rendered again.
+//  Parameter(s):
+//    <1> radians: The new refresh angle
+//  Preconditions:
+//    <1> radians > 0.0
+//  Returns: N/A
+//  Side Effect: The refresh angle is set to radians.
+//
+	void setRefreshAngle (double radians);
+
+//
+//  invalidateAll
+//
+//  Purpose: To forget all the tiles.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: Every tile is marked as unused.  This should be
+//               called when the Asteroids are replaced, because
+//               they are identified by number.
+//
+	void invalidateAll ();
+
+//
+//  clearQuads
+//
+//  Purpose: To start a new frame.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: There are no impostors to draw and no tiles
+//               waiting to be rendered.  The tiles are kept.
+//
+	void clearQuads ();
+
+//
+//  add
+//
+//  Purpose: To add an Asteroid to be drawn as an impostor.
+//  Parameter(s):
+//    <1> id: A number identifying the Asteroid, such as its
+//            index
+//    <2> asteroid: The Asteroid
+//    <3> camera_position: The camera position
+//    <4> camera_up: The up vector for the camera
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> asteroid.isInitialized()
+//    <3> !asteroid.isLodHidden()
+//    <4> camera_position != asteroid.getPosition()
+//  Returns: Whether asteroid will be drawn as an impostor.  If
+//           false is returned, the caller should draw asteroid
+//           some other way.
+//  Side Effect: A quad is added for asteroid, and its tile is
+//               marked to be rendered if it is new or out of
+//               date.  asteroid is not copied, so it must not be
+//               changed or destroyed until draw is called.
+//
+	bool add (unsigned int id,
+	          const Asteroid& asteroid,
+	          const ObjLibrary::Vector3& camera_position,
+	          const ObjLibrary::Vector3& camera_up);
+
+//
+//  draw
+//
+//  Purpose: To draw all the impostors.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The tiles marked by add are rendered into the
+//               atlas, and then all the quads are drawn with one
+//               draw call, using the current modelview and
+//               projection matrixes for the camera.  The
+//               current framebuffer, viewport, and matrixes are
+//               restored.
+//
+	void draw ();
+
+private:
+	struct Slot
+	{
+		bool m_is_assigned;
+		unsigned int m_id;
+		unsigned int m_last_frame;
+		ObjLibrary::Vector3 m_local_direction;
+		ObjLibrary::Vector3 m_local_up;
+	};
+
+	struct Refresh
+	{
+		unsigned int m_slot;
+		const Asteroid* mp_asteroid;
+		ObjLibrary::Vector3 m_eye_direction;
+		ObjLibrary::Vector3 m_up;
+	};
+
+	struct QuadVertex
+	{
+		float m_x, m_y, m_z;
+		float m_s, m_t;
+	};
+
+	bool allocateSlot (unsigned int id,
+	                   unsigned int& r_slot);
+	void renderTiles ();
+	void destroy ();
+	bool invariant () const;
+
+private:
+	unsigned int m_framebuffer;
+	unsigned int m_atlas_texture;
+	unsigned int m_depth_renderbuffer;
+	unsigned int m_tile_size;
+	unsigned int m_tiles_per_side;
+
+	unsigned int m_refresh_max;
+	double m_refresh_angle;
+	double m_refresh_cos;
+
+	std::vector<Slot> mv_slots;
+	std::unordered_map<unsigned int, unsigned int> m_slot_for_id;
+	unsigned int m_next_free_slot;
+	unsigned int m_clock_hand;
+	unsigned int m_frame;
+
+	std::vector<Refresh> mv_refreshes;
+	std::vector<QuadVertex> mv_vertexes;
+};
@@ -0,0 +1,317 @@
+//
+//  AsteroidLodMeshes.cpp
+//
+
+#include "GetGlutWithShaders.h"  // must be first
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "ObjLibrary/GlCallCounter.h"
+#include "ObjLibrary/Vector2.h"
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/ObjVbo.h"
+#include "ObjLibrary/MeshWithShader.h"
+#include "ObjLibrary/VertexDataFormat.h"
+
+#include "AsteroidShape.h"
+#include "RenderQueue.h"
+#include "AsteroidLodMeshes.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int FORMAT = VertexDataFormat::POSITION_TEXTURE_COORDINATE_NORMAL;
+	const unsigned int FLOATS_PER_VERTEX = 8;
+
+	//
+	//  StreamBuffer
+	//
+	//  A record to store a vertex buffer and the meshes that
+	//    draw from it for one asteroid in a RenderQueue.
+	//
+	struct StreamBuffer
+	{
+		ObjVbo<float> m_vertexes;
+		vector<MeshWithShader> mv_meshes;
+	};
+
+	// a deque, so the meshes referred to by a RenderQueue do not move when it grows
+	deque<StreamBuffer> gv_stream_buffers;
+	unsigned int g_stream_buffers_used = 0;
+
+	ObjVbo<float> g_immediate_buffer;
+	vector<float> gv_expanded;
+
+	void fillBuffer (ObjVbo<float>& r_buffer, const vector<float>& v_data)
+	{
+		assert(!v_data.empty());
+
+		// replacing orphans the old data, so we don't wait for the last draw to finish
+		if(r_buffer.isEmpty())
+			r_buffer = ObjVbo<float>(GL_ARRAY_BUFFER, GL_STREAM_DRAW,
+			                         (unsigned int)(v_data.size()), v_data.data());
+		else
+			r_buffer.replace((unsigned int)(v_data.size()), v_data.data());
+		ObjVbo<float>::bindNone(GL_ARRAY_BUFFER);
+	}
+
+}  // end of anonymous namespace
+
+
+
+void AsteroidLodMeshes :: clearStreamBuffers ()
+{
+	g_stream_buffers_used = 0;
+}
+
+
+
+AsteroidLodMeshes :: AsteroidLodMeshes ()
+		: mp_base_model(nullptr)
+		, mv_lods()
+{
+	assert(!isInitialized());
+	assert(invariant());
+}
+
+AsteroidLodMeshes :: AsteroidLodMeshes (const ObjLibrary::ObjModel& base_model,
+                                        const std::vector<ObjLibrary::ObjModel>& v_lod_base_models)
+		: mp_base_model(&base_model)
+		, mv_lods(v_lod_base_models.size())
+{
+	assert(!v_lod_base_models.empty());
+
+	for(unsigned int lod = 0; lod < v_lod_base_models.size(); lod++)
+	{
+		const ObjModel& model = v_lod_base_models[lod];
+		assert(model.getVertexCount() == base_model.getVertexCount());
+		assert(model.getMeshCount()   == base_model.getMeshCount());
+		Lod& r_lod = mv_lods[lod];
+		r_lod.m_index_count = 0;
+
+		// one drawn vertex for each (vertex, texture coordinates) pair used
+		unordered_map<uint64_t, unsigned int> vertex_numbers;
+		for(unsigned int m = 0; m < model.getMeshCount(); m++)
+		{
+			if(model.getFaceCount(m) == 0)
+				continue;
+
+			vector<unsigned int> v_indexes;
+			for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+			{
+				unsigned int corner_count = model.getFaceVertexCount(m, f);
+				vector<unsigned int> v_corners(corner_count);
+				for(unsigned int c = 0; c < corner_count; c++)
+				{
+					unsigned int vertex             = model.getFaceVertexIndex(m, f, c);
+					unsigned int texture_coordinate = model.getFaceVertexTextureCoordinates(m, f, c);
+					uint64_t key = ((uint64_t)(vertex) << 32) | texture_coordinate;
+
+					auto iter = vertex_numbers.find(key);
+					if(iter == vertex_numbers.end())
+					{
+						unsigned int number = (unsigned int)(r_lod.mv_shape_vertexes.size());
+						iter = vertex_numbers.insert(make_pair(key, number)).first;
+						r_lod.mv_shape_vertexes.push_back(vertex);
+
+						// flip texture coordinates the same way as ObjModel
+						if(texture_coordinate != ObjModel::NO_TEXTURE_COORDINATES)
+						{
+							Vector2 coordinates = model.getTextureCoordinate(texture_coordinate);
+							r_lod.mv_texture_coordinates.push_back(       (float)(coordinates.x));
+							r_lod.mv_texture_coordinates.push_back(1.0f - (float)(coordinates.y));
+						}
+						else
+						{
+							r_lod.mv_texture_coordinates.push_back(0.0f);
+							r_lod.mv_texture_coordinates.push_back(0.0f);
+						}
+					}
+					v_corners[c] = iter->second;
+				}
+
+				// triangle fans, as ObjModel draws them
+				for(unsigned int c = 2; c < corner_count; c++)
+				{
+					v_indexes.push_back(v_corners[0]);
+					v_indexes.push_back(v_corners[c - 1]);
+					v_indexes.push_back(v_corners[c]);
+				}
+			}
+			if(v_indexes.empty())
+				continue;
+
+			r_lod.mv_index_buffers.push_back(ObjVbo<unsigned int>(GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW,
+			                                                      (unsigned int)(v_indexes.size()),
+			                                                      v_indexes.data()));
+			if(base_model.isMeshMaterial(m))
+				r_lod.mvp_materials.push_back(base_model.getMeshMaterial(m));
+			else
+				r_lod.mvp_materials.push_back(nullptr);  // draws with the current state
+			r_lod.m_index_count += (unsigned int)(v_indexes.size());
+		}
+	}
+	ObjVbo<unsigned int>::bindNone(GL_ELEMENT_ARRAY_BUFFER);
+
+	assert(isInitialized());
+	assert(invariant());
+}
+
+
+
+unsigned int AsteroidLodMeshes :: getTriangleCount (unsigned int lod) const
+{
+	assert(isInitialized());
+	assert(lod < getLodCount());
+
+	return mv_lods[lod].m_index_count / 3;
+}
+
+size_t AsteroidLodMeshes :: getMemoryUsed () const
+{
+	size_t bytes = sizeof(AsteroidLodMeshes) + mv_lods.capacity() * sizeof(Lod);
+	for(unsigned int lod = 0; lod < mv_lods.size(); lod++)
+	{
+		const Lod& lod_data = mv_lods[lod];
+		bytes += lod_data.mv_shape_vertexes     .capacity() * sizeof(unsigned int);
+		bytes += lod_data.mv_texture_coordinates.capacity() * sizeof(float);
+		bytes += lod_data.mv_index_buffers      .capacity() * sizeof(ObjVbo<unsigned int>);
+		bytes += lod_data.mvp_materials         .capacity() * sizeof(const Material*);
+		bytes += lod_data.m_index_count * sizeof(unsigned int);
+	}
+	return bytes;
+}
+
+void AsteroidLodMeshes :: draw (const AsteroidShape& shape,
+                                unsigned int lod) const
+{
+	assert(isInitialized());
+	assert(shape.isInitialized());
+	assert(&shape.getBaseModel() == mp_base_model);
+	assert(lod < getLodCount());
+
+	const Lod& lod_data = mv_lods[lod];
+	if(lod_data.mv_index_buffers.empty())
+		return;
+
+	fillBuffer(g_immediate_buffer, expandVertexes(shape, lod));
+
+	// same as ModelWithShader::drawMeshes
+	if(Material::isMaterialActive())
+		Material::deactivate();
+	assert(!Material::isMaterialActive());
+
+	for(unsigned int i = 0; i < lod_data.mv_index_buffers.size(); i++)
+	{
+		MeshWithShader mesh(GL_TRIANGLES, FORMAT, g_immediate_buffer, lod_data.mv_index_buffers[i]);
+		const Material* p_material = lod_data.mvp_materials[i];
+		unsigned int pass_count = 1;
+		if(p_material != nullptr && p_material->isSeperateSpecular())
+			pass_count = 2;
+
+		for(unsigned int pass = 0; pass < pass_count; pass++)
+		{
+			if(p_material != nullptr)
+			{
+				if(pass == 0)
+					p_material->activate();
+				else
+					p_material->activateSeperateSpecular();
+			}
+
+			mesh.draw();
+
+			if(p_material != nullptr)
+				Material::deactivate();
+		}
+	}
+
+	assert(!Material::isMaterialActive());
+}
+
+void AsteroidLodMeshes :: addToRenderQueue (RenderQueue& r_queue,
+                                            const AsteroidShape& shape,
+                                            unsigned int lod,
+                                            const double a_matrix[],
+                                            double depth) const
+{
+	assert(isInitialized());
+	assert(shape.isInitialized());
+	assert(&shape.getBaseModel() == mp_base_model);
+	assert(lod < getLodCount());
+	assert(a_matrix != nullptr);
+
+	const Lod& lod_data = mv_lods[lod];
+	if(lod_data.mv_index_buffers.empty())
+		return;
+
+	if(g_stream_buffers_used == gv_stream_buffers.size())
+		gv_stream_buffers.push_back(StreamBuffer());
+	StreamBuffer& r_stream = gv_stream_buffers[g_stream_buffers_used];
+	g_stream_buffers_used++;
+
+	fillBuffer(r_stream.m_vertexes, expandVertexes(shape, lod));
+
+	r_stream.mv_meshes.clear();
+	for(unsigned int i = 0; i < lod_data.mv_index_buffers.size(); i++)
+		r_stream.mv_meshes.push_back(MeshWithShader(GL_TRIANGLES, FORMAT, r_stream.m_vertexes,
+		                                            lod_data.mv_index_buffers[i]));
+
+	// added after the vector is filled, so the meshes don't move
+	for(unsigned int i = 0; i < r_stream.mv_meshes.size(); i++)
+		r_queue.add(r_stream.mv_meshes[i], lod_data.mvp_materials[i], a_matrix, depth);
+}
+
+
+
+const std::vector<float>& AsteroidLodMeshes :: expandVertexes (const AsteroidShape& shape,
+                                                               unsigned int lod) const
+{
+	assert(isInitialized());
+	assert(shape.isInitialized());
+	assert(lod < getLodCount());
+	assert(VertexDataFormat::getComponentCount(FORMAT) == FLOATS_PER_VERTEX);
+
+	const Lod& lod_data = mv_lods[lod];
+	unsigned int vertex_count = (unsigned int)(lod_data.mv_shape_vertexes.size());
+	gv_expanded.resize(vertex_count * FLOATS_PER_VERTEX);
+
+	float* p_vertex = gv_expanded.data();
+	for(unsigned int i = 0; i < vertex_count; i++)
+	{
+		unsigned int shape_vertex = lod_data.mv_shape_vertexes[i];
+		Vector3 position = shape.getVertexPosition(shape_vertex);
+		Vector3 normal   = shape.getVertexNormal  (shape_vertex);
+
+		p_vertex[0] = (float)(position.x);
+		p_vertex[1] = (float)(position.y);
+		p_vertex[2] = (float)(position.z);
+		p_vertex[3] = lod_data.mv_texture_coordinates[i * 2 + 0];
+		p_vertex[4] = lod_data.mv_texture_coordinates[i * 2 + 1];
+		p_vertex[5] = (float)(normal.x);
+		p_vertex[6] = (float)(normal.y);
+		p_vertex[7] = (float)(normal.z);
+		p_vertex += FLOATS_PER_VERTEX;
+	}
+	return gv_expanded;
+}
+
+bool AsteroidLodMeshes :: invariant () const
+{
+	if(isInitialized() != (mp_base_model != nullptr)) return false;
+	for(unsigned int lod = 0; lod < mv_lods.size(); lod++)
+	{
+		const Lod& lod_data = mv_lods[lod];
+		if(lod_data.mv_texture_coordinates.size() != lod_data.mv_shape_vertexes.size() * 2) return false;
+		if(lod_data.mvp_materials.size() != lod_data.mv_index_buffers.size()) return false;
+	}
+	return true;
+}
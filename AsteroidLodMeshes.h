@@ -0,0 +1,267 @@
+//
+//  AsteroidLodMeshes.h
+//
+//  A module to store the levels of detail that are shared by
+//    all the asteroids made from one base model.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/ObjVbo.h"
+
+#include "AsteroidShape.h"
+#include "RenderQueue.h"
+
+
+
+//
+//  AsteroidLodMeshes
+//
+//  A class to store the parts of each level of detail that are
+//    the same for every asteroid made from one base model: the
+//    triangles, the texture coordinates, and the Materials.
+//    The levels are simplified from the base model, so each
+//    drawn vertex is a base model vertex with a texture
+//    coordinate pair.  The position and normal for each vertex
+//    come from the AsteroidShape being drawn, so an asteroid
+//    does not need any geometry of its own.
+//
+//  The expanded vertexes are written into stream buffers shared
+//    by all asteroids.  Asteroids drawn immediately use a
+//    single buffer, which is replaced for each one.  Asteroids
+//    added to a RenderQueue each need a buffer until the queue
+//    is drawn, so they use a pool of buffers that is reused
+//    every frame.  clearStreamBuffers must be called before
+//    the RenderQueue is filled again.
+//
+//  Class Invariant:
+//    <1> isInitialized() == (mp_base_model != nullptr)
+//    <2> mv_lods[i].mv_texture_coordinates.size() ==
+//        mv_lods[i].mv_shape_vertexes.size() * 2 for all i
+//    <3> mv_lods[i].mvp_materials.size() ==
+//        mv_lods[i].mv_index_buffers.size() for all i
+//
+class AsteroidLodMeshes
+{
+public:
+//
+//  Class Function: clearStreamBuffers
+//
+//  Purpose: To make the stream buffers used for RenderQueues
+//           available again.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The stream buffers are marked as unused, so
+//               they will be refilled by later calls to
+//               addToRenderQueue.  Any RenderQueue items added
+//               before this call must not be drawn afterwards.
+//
+	static void clearStreamBuffers ();
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an AsteroidLodMeshes without
+//           initializing it.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new AsteroidLodMeshes is created.  It is not
+//               initialized.
+//
+	AsteroidLodMeshes ();
+
+//
+//  Constructor
+//
+//  Purpose: To create an AsteroidLodMeshes for a base model.
+//  Parameter(s):
+//    <1> base_model: The unit-sphere base model
+//    <2> v_lod_base_models: The levels of detail of base_model
+//  Preconditions:
+//    <1> !v_lod_base_models.empty()
+//    <2> Each element of v_lod_base_models is base_model with
+//        some of its faces replaced by fewer faces using the
+//        same vertexes, such as from
+//        Asteroid::createLodBaseModels
+//    <3> base_model is not changed or destroyed while this
+//        AsteroidLodMeshes exists
+//  Returns: N/A
+//  Side Effect: A new AsteroidLodMeshes is created with the
+//               triangles and texture coordinates of each
+//               element of v_lod_base_models.  The triangles
+//               are uploaded to OpenGL.
+//
+	AsteroidLodMeshes (const ObjLibrary::ObjModel& base_model,
+	                   const std::vector<ObjLibrary::ObjModel>& v_lod_base_models);
+
+	AsteroidLodMeshes (const AsteroidLodMeshes& to_copy) = default;
+	~AsteroidLodMeshes () = default;
+	AsteroidLodMeshes& operator= (const AsteroidLodMeshes& to_copy) = default;
+
+//
+//  isInitialized
+//
+//  Purpose: To determine whether this AsteroidLodMeshes has
+//           been initialized.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this AsteroidLodMeshes has been
+//           initialized.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{	return mp_base_model != nullptr;	}
+
+//
+//  getLodCount
+//
+//  Purpose: To determine the number of levels of detail in
+//           this AsteroidLodMeshes.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of levels of detail.
+//  Side Effect: N/A
+//
+	unsigned int getLodCount () const
+	{	return (unsigned int)(mv_lods.size());	}
+
+//
+//  getTriangleCount
+//
+//  Purpose: To determine the number of triangles in a level of
+//           detail.
+//  Parameter(s):
+//    <1> lod: Which level of detail
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> lod < getLodCount()
+//  Returns: The number of triangles drawn for level lod.
+//  Side Effect: N/A
+//
+	unsigned int getTriangleCount (unsigned int lod) const;
+
+//
+//  getMemoryUsed
+//
+//  Purpose: To determine how much memory this AsteroidLodMeshes
+//           uses.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The size of this AsteroidLodMeshes in bytes,
+//           including the vertex references, texture
+//           coordinates, and indexes.  The indexes are
+//           counted once, even though they are stored in
+//           buffer objects.  The stream buffers are not
+//           included.
+//  Side Effect: N/A
+//
+	size_t getMemoryUsed () const;
+
+//
+//  draw
+//
+//  Purpose: To display an asteroid shape at a level of detail.
+//  Parameter(s):
+//    <1> shape: The asteroid shape
+//    <2> lod: Which level of detail
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> shape.isInitialized()
+//    <3> &shape.getBaseModel() is the base model for this
+//        AsteroidLodMeshes
+//    <4> lod < getLodCount()
+//  Returns: N/A
+//  Side Effect: The vertexes of level lod are expanded from
+//               shape into the shared stream buffer and drawn
+//               with the current transformation, each mesh
+//               with its Material.
+//
+	void draw (const AsteroidShape& shape,
+	           unsigned int lod) const;
+
+//
+//  addToRenderQueue
+//
+//  Purpose: To add an asteroid shape at a level of detail to a
+//           RenderQueue.
+//  Parameter(s):
+//    <1> r_queue: The RenderQueue
+//    <2> shape: The asteroid shape
+//    <3> lod: Which level of detail
+//    <4> a_matrix: The column-major transformation matrix for
+//                  the asteroid, as 16 values
+//    <5> depth: The distance from the camera to the asteroid
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> shape.isInitialized()
+//    <3> &shape.getBaseModel() is the base model for this
+//        AsteroidLodMeshes
+//    <4> lod < getLodCount()
+//    <5> a_matrix != nullptr
+//  Returns: N/A
+//  Side Effect: The vertexes of level lod are expanded from
+//               shape into an unused stream buffer, and each
+//               mesh is added to r_queue with its Material.
+//               The stream buffer is used until
+//               clearStreamBuffers is called.
+//
+	void addToRenderQueue (RenderQueue& r_queue,
+	                       const AsteroidShape& shape,
+	                       unsigned int lod,
+	                       const double a_matrix[],
+	                       double depth) const;
+
+private:
+//
+//  Lod
+//
+//  A record to store one level of detail.  Drawn vertex i is
+//    vertex mv_shape_vertexes[i] of the base model, with
+//    texture coordinates mv_texture_coordinates[i * 2] and
+//    mv_texture_coordinates[i * 2 + 1].  There is one index
+//    buffer for each mesh with faces.
+//
+	struct Lod
+	{
+		std::vector<unsigned int> mv_shape_vertexes;
+		std::vector<float> mv_texture_coordinates;
+		std::vector<ObjLibrary::ObjVbo<unsigned int> > mv_index_buffers;
+		std::vector<const ObjLibrary::Material*> mvp_materials;
+		unsigned int m_index_count;
+	};
+
+//
+//  expandVertexes
+//
+//  Purpose: To calculate the vertex data for an asteroid shape
+//           at a level of detail.
+//  Parameter(s):
+//    <1> shape: The asteroid shape
+//    <2> lod: Which level of detail
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> shape.isInitialized()
+//    <3> lod < getLodCount()
+//  Returns: The vertex data, in the
+//           POSITION_TEXTURE_COORDINATE_NORMAL format.  The
+//           vector is shared, so it is only valid until the
+//           next call.
+//  Side Effect: N/A
+//
+	const std::vector<float>& expandVertexes (const AsteroidShape& shape,
+	                                          unsigned int lod) const;
+
+	bool invariant () const;
+
+private:
+	const ObjLibrary::ObjModel* mp_base_model;
+	std::vector<Lod> mv_lods;
+};
@@ -0,0 +1,160 @@
+//
+//  AsteroidShape.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/ObjModel.h"
+
+#include "AsteroidShape.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double QUANTIZE_MAX        = 65535.0;
+	const double NORMAL_QUANTIZE_MAX = 32767.0;
+
+}  // end of anonymous namespace
+
+
+
+AsteroidShape :: AsteroidShape ()
+		: mp_base_model(nullptr)
+		, m_inner_radius(0.0f)
+		, m_outer_radius(0.0f)
+		, mv_radii()
+		, mv_normals()
+{
+	assert(!isInitialized());
+	assert(invariant());
+}
+
+AsteroidShape :: AsteroidShape (const ObjLibrary::ObjModel& base_model,
+                                double inner_radius,
+                                double outer_radius,
+                                const ObjLibrary::ObjModel& deformed_model)
+		: mp_base_model(&base_model)
+		, m_inner_radius((float)(inner_radius))
+		, m_outer_radius((float)(outer_radius))
+		, mv_radii(deformed_model.getVertexCount())
+		, mv_normals(deformed_model.getVertexCount() * 3)
+{
+	assert(inner_radius >= 0.0);
+	assert(inner_radius <= outer_radius);
+	assert(deformed_model.getVertexCount() == base_model.getVertexCount());
+	assert(deformed_model.getNormalCount() == deformed_model.getVertexCount());
+
+	double range = (double)(m_outer_radius) - m_inner_radius;
+	for(unsigned int v = 0; v < mv_radii.size(); v++)
+	{
+		double radius = deformed_model.getVertexPosition(v).getNorm();
+		double fraction = 0.0;
+		if(range > 0.0)
+			fraction = (radius - m_inner_radius) / range;
+		if(fraction < 0.0)
+			fraction = 0.0;
+		else if(fraction > 1.0)
+			fraction = 1.0;
+		mv_radii[v] = (uint16_t)(fraction * QUANTIZE_MAX + 0.5);
+
+		Vector3 normal = deformed_model.getNormalVector(v).getNormalized();
+		mv_normals[v * 3 + 0] = (int16_t)(floor(normal.x * NORMAL_QUANTIZE_MAX + 0.5));
+		mv_normals[v * 3 + 1] = (int16_t)(floor(normal.y * NORMAL_QUANTIZE_MAX + 0.5));
+		mv_normals[v * 3 + 2] = (int16_t)(floor(normal.z * NORMAL_QUANTIZE_MAX + 0.5));
+	}
+
+	assert(isInitialized());
+	assert(invariant());
+}
+
+
+
+const ObjLibrary::ObjModel& AsteroidShape :: getBaseModel () const
+{
+	assert(isInitialized());
+
+	return *mp_base_model;
+}
+
+double AsteroidShape :: getVertexRadius (unsigned int vertex) const
+{
+	assert(isInitialized());
+	assert(vertex < getVertexCount());
+
+	double range = (double)(m_outer_radius) - m_inner_radius;
+	return m_inner_radius + mv_radii[vertex] * (range / QUANTIZE_MAX);
+}
+
+ObjLibrary::Vector3 AsteroidShape :: getVertexPosition (unsigned int vertex) const
+{
+	assert(isInitialized());
+	assert(vertex < getVertexCount());
+
+	return mp_base_model->getVertexPosition(vertex).getCopyWithNorm(getVertexRadius(vertex));
+}
+
+ObjLibrary::Vector3 AsteroidShape :: getVertexNormal (unsigned int vertex) const
+{
+	assert(isInitialized());
+	assert(vertex < getVertexCount());
+
+	Vector3 normal(mv_normals[vertex * 3 + 0],
+	               mv_normals[vertex * 3 + 1],
+	               mv_normals[vertex * 3 + 2]);
+	if(normal.isZero())
+		return mp_base_model->getVertexPosition(vertex).getNormalized();
+	return normal.getNormalized();
+}
+
+size_t AsteroidShape :: getMemoryUsed () const
+{
+	return sizeof(AsteroidShape) + mv_radii.capacity()   * sizeof(uint16_t)
+	                             + mv_normals.capacity() * sizeof(int16_t);
+}
+
+void AsteroidShape :: expandPositions (std::vector<ObjLibrary::Vector3>& rv_positions) const
+{
+	assert(isInitialized());
+
+	rv_positions.resize(getVertexCount());
+	for(unsigned int v = 0; v < getVertexCount(); v++)
+		rv_positions[v] = getVertexPosition(v);
+}
+
+void AsteroidShape :: expandModel (ObjLibrary::ObjModel& r_model) const
+{
+	assert(isInitialized());
+	assert(r_model.getVertexCount() == getVertexCount());
+
+	unsigned int vertex_count = getVertexCount();
+	r_model.setNormalCount(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+	{
+		r_model.setVertexPosition(v, getVertexPosition(v));
+		r_model.setNormalVector(v, getVertexNormal(v));
+	}
+
+	// one normal per vertex, as in Asteroid::createModel
+	for(unsigned int m = 0; m < r_model.getMeshCount(); m++)
+		for(unsigned int f = 0; f < r_model.getFaceCount(m); f++)
+			for(unsigned int c = 0; c < r_model.getFaceVertexCount(m, f); c++)
+				r_model.setFaceVertexNormal(m, f, c, r_model.getFaceVertexIndex(m, f, c));
+	r_model.validate();
+}
+
+
+
+bool AsteroidShape :: invariant () const
+{
+	if(isInitialized() != (mp_base_model != nullptr)) return false;
+	if(isInitialized() && mv_radii.size() != mp_base_model->getVertexCount()) return false;
+	if(mv_normals.size() != mv_radii.size() * 3) return false;
+	if(m_inner_radius < 0.0f) return false;
+	if(m_inner_radius > m_outer_radius) return false;
+	return true;
+}
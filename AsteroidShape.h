@@ -0,0 +1,250 @@
+//
+//  AsteroidShape.h
+//
+//  A module to store the shape of an asteroid compactly.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/ObjModel.h"
+
+
+
+//
+//  AsteroidShape
+//
+//  A class to represent the surface of an asteroid as one
+//    radius and one normal for each vertex of a shared
+//    unit-sphere base model.  Each radius is stored as a 16-bit
+//    fraction of the way from the inner radius to the outer
+//    radius, so the error is at most (outer - inner) / 131070.
+//    Each normal is stored as 3 signed 16-bit components.  The
+//    normals are the ones in the deformed model, so they are
+//    the exact noise normals from Asteroid::createModel.  The
+//    base model is not copied.
+//
+//  The full vertex positions and normals can be expanded on
+//    demand, for collision checking or to draw.  The expanding
+//    functions write into a vector or ObjModel supplied by the
+//    caller, so the same buffer can be reused for many
+//    asteroids.
+//
+//  Class Invariant:
+//    <1> isInitialized() == (mp_base_model != nullptr)
+//    <2> !isInitialized() || mv_radii.size() ==
+//                            mp_base_model->getVertexCount()
+//    <3> mv_normals.size() == mv_radii.size() * 3
+//    <4> m_inner_radius >= 0.0f
+//    <5> m_inner_radius <= m_outer_radius
+//
+class AsteroidShape
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an AsteroidShape without initializing
+//           it.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new AsteroidShape is created.  It is not
+//               initialized.
+//
+	AsteroidShape ();
+
+//
+//  Constructor
+//
+//  Purpose: To create an AsteroidShape from a deformed model.
+//  Parameter(s):
+//    <1> base_model: The unit-sphere model the asteroid was
+//                    made from
+//    <2> inner_radius: The inner asteroid radius
+//    <3> outer_radius: The outer asteroid radius
+//    <4> deformed_model: The asteroid model
+//  Preconditions:
+//    <1> inner_radius >= 0.0
+//    <2> inner_radius <= outer_radius
+//    <3> deformed_model.getVertexCount() ==
+//        base_model.getVertexCount()
+//    <4> Each vertex in deformed_model is the matching vertex
+//        in base_model scaled to a radius in
+//        [inner_radius, outer_radius]
+//    <5> deformed_model.getNormalCount() ==
+//        deformed_model.getVertexCount()
+//    <6> base_model is not changed or destroyed while this
+//        AsteroidShape exists
+//  Returns: N/A
+//  Side Effect: A new AsteroidShape is created with the vertex
+//               radii of deformed_model.  Normal i in
+//               deformed_model is stored as the normal for
+//               vertex i, as in Asteroid::createModel.  It
+//               refers to base_model.
+//
+	AsteroidShape (const ObjLibrary::ObjModel& base_model,
+	               double inner_radius,
+	               double outer_radius,
+	               const ObjLibrary::ObjModel& deformed_model);
+
+	AsteroidShape (const AsteroidShape& to_copy) = default;
+	~AsteroidShape () = default;
+	AsteroidShape& operator= (const AsteroidShape& to_copy) = default;
+
+//
+//  isInitialized
+//
+//  Purpose: To determine whether this AsteroidShape has been
+//           initialized.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this AsteroidShape has been initialized.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{	return mp_base_model != nullptr;	}
+
+//
+//  getBaseModel
+//
+//  Purpose: To retrieve the base model for this AsteroidShape.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The unit-sphere model this AsteroidShape deforms.
+//  Side Effect: N/A
+//
+	const ObjLibrary::ObjModel& getBaseModel () const;
+
+//
+//  getVertexCount
+//
+//  Purpose: To determine the number of vertexes in this
+//           AsteroidShape.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of vertexes, or 0 if this AsteroidShape
+//           is not initialized.
+//  Side Effect: N/A
+//
+	unsigned int getVertexCount () const
+	{	return (unsigned int)(mv_radii.size());	}
+
+//
+//  getVertexRadius
+//
+//  Purpose: To determine the distance from the asteroid origin
+//           to a vertex.
+//  Parameter(s):
+//    <1> vertex: Which vertex
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> vertex < getVertexCount()
+//  Returns: The radius of vertex vertex.
+//  Side Effect: N/A
+//
+	double getVertexRadius (unsigned int vertex) const;
+
+//
+//  getVertexPosition
+//
+//  Purpose: To determine the position of a vertex.
+//  Parameter(s):
+//    <1> vertex: Which vertex
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> vertex < getVertexCount()
+//  Returns: The position of vertex vertex in local
+//           coordinates.
+//  Side Effect: N/A
+//
+	ObjLibrary::Vector3 getVertexPosition (unsigned int vertex) const;
+
+//
+//  getVertexNormal
+//
+//  Purpose: To determine the surface normal at a vertex.
+//  Parameter(s):
+//    <1> vertex: Which vertex
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> vertex < getVertexCount()
+//  Returns: The unit normal for vertex vertex in local
+//           coordinates.
+//  Side Effect: N/A
+//
+	ObjLibrary::Vector3 getVertexNormal (unsigned int vertex) const;
+
+//
+//  getMemoryUsed
+//
+//  Purpose: To determine how much memory this AsteroidShape
+//           uses.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The size of this AsteroidShape in bytes, including
+//           the radii and normals but not the shared base
+//           model.
+//  Side Effect: N/A
+//
+	size_t getMemoryUsed () const;
+
+//
+//  expandPositions
+//
+//  Purpose: To calculate the positions of all the vertexes.
+//  Parameter(s):
+//    <1> rv_positions: A vector to fill with the positions
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: rv_positions is set to contain
+//               getVertexCount() elements, with the position of
+//               each vertex in local coordinates.  Memory
+//               already allocated for rv_positions is reused.
+//
+	void expandPositions (std::vector<ObjLibrary::Vector3>& rv_positions) const;
+
+//
+//  expandModel
+//
+//  Purpose: To rebuild the full asteroid model.
+//  Parameter(s):
+//    <1> r_model: The model to write to
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> r_model is a copy of getBaseModel() or was last
+//        written by expandModel
+//  Returns: N/A
+//  Side Effect: The vertexes of r_model are moved to the
+//               positions for this AsteroidShape.  r_model is
+//               given one normal per vertex, set to the stored
+//               normal, so the normals are the same as from
+//               Asteroid::createModel and as when the Asteroid
+//               is drawn.
+//
+	void expandModel (ObjLibrary::ObjModel& r_model) const;
+
+private:
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	const ObjLibrary::ObjModel* mp_base_model;
+	float m_inner_radius;
+	float m_outer_radius;
+	std::vector<uint16_t> mv_radii;
+	std::vector<int16_t> mv_normals;
+};
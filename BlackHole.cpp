@@ -9,11 +9,17 @@
 #include "GetGlut.h"
 
 #include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/GlCallCounter.h"
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
 
 using namespace ObjLibrary;
+namespace
+{
+	const unsigned int SPHERE_SLICES = 40;
+	const unsigned int SPHERE_STACKS = 30;
+}
 
 
 
@@ -49,7 +55,9 @@ void BlackHole :: draw () const
 	glPushMatrix();
 		m_coords.applyDrawTransformations();
 		glColor3f(0.0f, 0.0f, 0.0f);
-		glutSolidSphere(getRadius(), 40, 30);
+		// GLU instead of glutSolidSphere so this also works without a GLUT window
+		static GLUquadric* p_quadric = gluNewQuadric();
+		gluSphere(p_quadric, getRadius(), SPHERE_SLICES, SPHERE_STACKS);
 	glPopMatrix();
 
 	// draw accretion disk - has to be last because of transparency
@@ -6,6 +6,7 @@
 
 #include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/GlCallCounter.h"
 
 #include "CoordinateSystem.h"
 
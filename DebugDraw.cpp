@@ -0,0 +1,165 @@
+//
+//  DebugDraw.cpp
+//
+
+#include <cassert>
+#include <mutex>
+#include <vector>
+
+#include "GetGlut.h"
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/GlCallCounter.h"
+
+#include "CoordinateSystem.h"
+#include "DebugDraw.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+DebugDraw :: DebugDraw ()
+		: m_mutex()
+		, mv_vertexes()
+		, mv_drawing()
+{
+	assert(invariant());
+}
+
+
+
+unsigned int DebugDraw :: getLineCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (unsigned int)(mv_vertexes.size() / 2);
+}
+
+void DebugDraw :: flush ()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		mv_drawing.swap(mv_vertexes);
+		mv_vertexes.clear();
+	}
+
+	if(!mv_drawing.empty())
+	{
+		GLsizei stride = sizeof(Vertex);
+
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(3, GL_FLOAT, stride, &(mv_drawing[0].m_x));
+		glColorPointer (3, GL_FLOAT, stride, &(mv_drawing[0].m_red));
+
+		glDrawArrays(GL_LINES, 0, (GLsizei)(mv_drawing.size()));
+
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+	}
+	mv_drawing.clear();  // keeps the memory for next frame
+}
+
+void DebugDraw :: clear ()
+{
+	lock_guard<mutex> lock(m_mutex);
+	mv_vertexes.clear();
+
+	assert(invariant());
+}
+
+void DebugDraw :: addLine (const ObjLibrary::Vector3& start,
+                           const ObjLibrary::Vector3& end,
+                           const ObjLibrary::Vector3& colour)
+{
+	addLine(start, end, colour, colour);
+}
+
+void DebugDraw :: addLine (const ObjLibrary::Vector3& start,
+                           const ObjLibrary::Vector3& end,
+                           const ObjLibrary::Vector3& start_colour,
+                           const ObjLibrary::Vector3& end_colour)
+{
+	Vertex start_vertex = createVertex(start, start_colour);
+	Vertex end_vertex   = createVertex(end,   end_colour);
+
+	lock_guard<mutex> lock(m_mutex);
+	mv_vertexes.push_back(start_vertex);
+	mv_vertexes.push_back(end_vertex);
+
+	assert(invariant());
+}
+
+void DebugDraw :: addLineStrip (const std::vector<ObjLibrary::Vector3>& v_points,
+                                const std::vector<ObjLibrary::Vector3>& v_colours)
+{
+	assert(v_colours.size() == v_points.size());
+
+	if(v_points.size() < 2)
+		return;
+
+	// convert before locking so other threads wait less
+	vector<Vertex> v_strip;
+	v_strip.reserve((v_points.size() - 1) * 2);
+	Vertex previous = createVertex(v_points[0], v_colours[0]);
+	for(unsigned int i = 1; i < v_points.size(); i++)
+	{
+		Vertex current = createVertex(v_points[i], v_colours[i]);
+		v_strip.push_back(previous);
+		v_strip.push_back(current);
+		previous = current;
+	}
+
+	lock_guard<mutex> lock(m_mutex);
+	mv_vertexes.insert(mv_vertexes.end(), v_strip.begin(), v_strip.end());
+
+	assert(invariant());
+}
+
+void DebugDraw :: addAxes (const CoordinateSystem& coords,
+                           double length)
+{
+	assert(length >= 0.0);
+
+	static const Vector3 RED  (1.0, 0.0, 0.0);
+	static const Vector3 GREEN(0.0, 1.0, 0.0);
+	static const Vector3 BLUE (0.0, 0.0, 1.0);
+
+	// local X, Y, and Z are forward, up, and right
+	const Vector3& origin = coords.getPosition();
+	Vertex a_vertexes[6] =
+	{
+		createVertex(origin,                               RED),
+		createVertex(origin + coords.getForward() * length, RED),
+		createVertex(origin,                               GREEN),
+		createVertex(origin + coords.getUp()      * length, GREEN),
+		createVertex(origin,                               BLUE),
+		createVertex(origin + coords.getRight()   * length, BLUE),
+	};
+
+	lock_guard<mutex> lock(m_mutex);
+	mv_vertexes.insert(mv_vertexes.end(), a_vertexes, a_vertexes + 6);
+
+	assert(invariant());
+}
+
+
+
+DebugDraw::Vertex DebugDraw :: createVertex (const ObjLibrary::Vector3& position,
+                                             const ObjLibrary::Vector3& colour)
+{
+	Vertex vertex;
+	vertex.m_x     = (float)(position.x);
+	vertex.m_y     = (float)(position.y);
+	vertex.m_z     = (float)(position.z);
+	vertex.m_red   = (float)(colour.x);
+	vertex.m_green = (float)(colour.y);
+	vertex.m_blue  = (float)(colour.z);
+	return vertex;
+}
+
+bool DebugDraw :: invariant () const
+{
+	// the caller must hold the lock
+	if(mv_vertexes.size() % 2 != 0) return false;
+	return true;
+}
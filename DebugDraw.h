@@ -0,0 +1,163 @@
+//
+//  DebugDraw.h
+//
+//  A module to collect debugging lines and draw them all at
+//    once.
+//
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "CoordinateSystem.h"
+
+
+
+//
+//  DebugDraw
+//
+//  A class to collect coloured line segments over a frame and
+//    draw them with a single glDrawArrays call.  Drawing the
+//    same lines with glBegin/glEnd would need a function call
+//    per vertex and per colour.
+//
+//  The vertexes are stored in world coordinates as floats in
+//    one interleaved array, and drawn from client memory with
+//    the fixed-function vertex and colour arrays.
+//
+//  Lines can be added from several threads at once, such as
+//    physics workers.  Each add function locks the buffer once,
+//    so a line strip is cheaper to add in one call than as
+//    separate lines.  flush must only be called from the thread
+//    with the OpenGL context.
+//
+//  A DebugDraw cannot be copied because it contains a mutex.
+//
+//  Class Invariant:
+//    <1> mv_vertexes.size() % 2 == 0
+//
+class DebugDraw
+{
+public:
+	DebugDraw ();
+	DebugDraw (const DebugDraw& to_copy) = delete;
+	~DebugDraw () = default;
+	DebugDraw& operator= (const DebugDraw& to_copy) = delete;
+
+//
+//  getLineCount
+//
+//  Purpose: To determine how many lines are waiting to be
+//           drawn.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of line segments added since the last
+//           call to flush or clear.
+//  Side Effect: N/A
+//
+	unsigned int getLineCount () const;
+
+//
+//  flush
+//
+//  Purpose: To draw all the lines and remove them.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The lines are drawn with the current modelview
+//               and projection matrixes, which should only
+//               contain the camera transformation.  The lines
+//               are then removed.
+//
+	void flush ();
+
+//
+//  clear
+//
+//  Purpose: To remove all lines without drawing them.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All lines are removed.
+//
+	void clear ();
+
+//
+//  addLine
+//
+//  Purpose: To add a line segment.
+//  Parameter(s):
+//    <1> start: The start of the line
+//    <2> end: The end of the line
+//    <3> colour: The colour of the line
+//    <3> start_colour: The colour at start
+//    <4> end_colour: The colour at end
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A line is added from start to end.  If two
+//               colours are specified, the colour is blended
+//               along the line.
+//
+	void addLine (const ObjLibrary::Vector3& start,
+	              const ObjLibrary::Vector3& end,
+	              const ObjLibrary::Vector3& colour);
+	void addLine (const ObjLibrary::Vector3& start,
+	              const ObjLibrary::Vector3& end,
+	              const ObjLibrary::Vector3& start_colour,
+	              const ObjLibrary::Vector3& end_colour);
+
+//
+//  addLineStrip
+//
+//  Purpose: To add a connected series of line segments.
+//  Parameter(s):
+//    <1> v_points: The points to connect
+//    <2> v_colours: The colour at each point
+//  Precondition(s):
+//    <1> v_colours.size() == v_points.size()
+//  Returns: N/A
+//  Side Effect: A line is added from each point to the next,
+//               the same as GL_LINE_STRIP would draw.  If there
+//               are fewer than 2 points, there is no effect.
+//
+	void addLineStrip (const std::vector<ObjLibrary::Vector3>& v_points,
+	                   const std::vector<ObjLibrary::Vector3>& v_colours);
+
+//
+//  addAxes
+//
+//  Purpose: To add the local axes of a coordinate system.
+//  Parameter(s):
+//    <1> coords: The coordinate system
+//    <2> length: The length of the axes
+//  Precondition(s):
+//    <1> length >= 0.0
+//  Returns: N/A
+//  Side Effect: Red, green, and blue lines are added along the
+//               local X, Y, and Z axes of coords, as they are
+//               drawn after
+//               CoordinateSystem::applyDrawTransformations.
+//
+	void addAxes (const CoordinateSystem& coords,
+	              double length);
+
+private:
+	struct Vertex
+	{
+		float m_x, m_y, m_z;
+		float m_red, m_green, m_blue;
+	};
+
+	static Vertex createVertex (const ObjLibrary::Vector3& position,
+	                            const ObjLibrary::Vector3& colour);
+
+	bool invariant () const;
+
+private:
+	mutable std::mutex m_mutex;
+	std::vector<Vertex> mv_vertexes;
+	std::vector<Vertex> mv_drawing;  // swapped in by flush so adding can continue
+};
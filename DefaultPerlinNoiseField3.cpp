@@ -0,0 +1,170 @@
+//
+//  DefaultPerlinNoiseField3.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <climits>
+
+#include "PermutationTable.h"
+#include "DefaultPerlinNoiseField3.h"
+
+using namespace std;
+namespace
+{
+	const PermutationTable& TABLE = DefaultPerlinNoiseField3::TABLE;
+
+	// same as PerlinNoiseField3::fade
+	inline float fade (float n)
+	{
+		return (1 - cos(n * 3.14159265f)) * 0.5f;
+	}
+
+	inline unsigned int interpolate (unsigned int v0,
+	                                 unsigned int v1,
+	                                 float fraction)
+	{
+		return (unsigned int)(v0 * (1.0f - fraction)) +
+		       (unsigned int)(v1 *         fraction );
+	}
+
+	inline float interpolate (float v0,
+	                          float v1,
+	                          float fraction)
+	{
+		return (v0 * (1.0f - fraction)) +
+		       (v1 *         fraction );
+	}
+
+	// dot product of the lattice vector and (dx, dy, dz)
+	inline float latticeDot (int x, int y, int z,
+	                         float dx, float dy, float dz)
+	{
+		unsigned int hash = TABLE.hash(x, y, z);
+		return TABLE.ma_gradient_x[hash] * dx +
+		       TABLE.ma_gradient_y[hash] * dy +
+		       TABLE.ma_gradient_z[hash] * dz;
+	}
+
+}  // end of anonymous namespace
+
+
+
+DefaultPerlinNoiseField3 :: DefaultPerlinNoiseField3 ()
+		: m_grid_size(1.0f)
+		, m_amplitude(1.0f)
+{
+	assert(invariant());
+}
+
+DefaultPerlinNoiseField3 :: DefaultPerlinNoiseField3 (float grid_size,
+                                                      float amplitude)
+		: m_grid_size(grid_size)
+		, m_amplitude(amplitude)
+{
+	assert(grid_size > 0.0f);
+
+	assert(invariant());
+}
+
+
+
+float DefaultPerlinNoiseField3 :: getGridSize () const
+{
+	return m_grid_size;
+}
+
+float DefaultPerlinNoiseField3 :: getAmplitude () const
+{
+	return m_amplitude;
+}
+
+float DefaultPerlinNoiseField3 :: valueNoise (float x, float y, float z) const
+{
+	int x0 = (int)(floor(x / m_grid_size));
+	int y0 = (int)(floor(y / m_grid_size));
+	int z0 = (int)(floor(z / m_grid_size));
+	int x1 = x0 + 1;
+	int y1 = y0 + 1;
+	int z1 = z0 + 1;
+
+	float x_fade = fade(x / m_grid_size - x0);
+	float y_fade = fade(y / m_grid_size - y0);
+	float z_fade = fade(z / m_grid_size - z0);
+
+	unsigned int value00 = interpolate(TABLE.ma_values[TABLE.hash(x0, y0, z0)],
+	                                   TABLE.ma_values[TABLE.hash(x0, y0, z1)], z_fade);
+	unsigned int value01 = interpolate(TABLE.ma_values[TABLE.hash(x0, y1, z0)],
+	                                   TABLE.ma_values[TABLE.hash(x0, y1, z1)], z_fade);
+	unsigned int value10 = interpolate(TABLE.ma_values[TABLE.hash(x1, y0, z0)],
+	                                   TABLE.ma_values[TABLE.hash(x1, y0, z1)], z_fade);
+	unsigned int value11 = interpolate(TABLE.ma_values[TABLE.hash(x1, y1, z0)],
+	                                   TABLE.ma_values[TABLE.hash(x1, y1, z1)], z_fade);
+	unsigned int value0  = interpolate(value00, value01, y_fade);
+	unsigned int value1  = interpolate(value10, value11, y_fade);
+	unsigned int value   = interpolate(value0,  value1,  x_fade);
+
+	return (((float)(value) / UINT_MAX) * 2.0f - 1.0f) * m_amplitude;
+}
+
+float DefaultPerlinNoiseField3 :: perlinNoise (float x, float y, float z) const
+{
+	int x0 = (int)(floor(x / m_grid_size));
+	int y0 = (int)(floor(y / m_grid_size));
+	int z0 = (int)(floor(z / m_grid_size));
+	int x1 = x0 + 1;
+	int y1 = y0 + 1;
+	int z1 = z0 + 1;
+
+	float x_frac = x / m_grid_size - x0;
+	float y_frac = y / m_grid_size - y0;
+	float z_frac = z / m_grid_size - z0;
+
+	float x_fade = fade(x_frac);
+	float y_fade = fade(y_frac);
+	float z_fade = fade(z_frac);
+
+	// directions are corner - point
+	float value000 = latticeDot(x0, y0, z0,      - x_frac,      - y_frac,      - z_frac);
+	float value001 = latticeDot(x0, y0, z1,      - x_frac,      - y_frac, 1.0f - z_frac);
+	float value010 = latticeDot(x0, y1, z0,      - x_frac, 1.0f - y_frac,      - z_frac);
+	float value011 = latticeDot(x0, y1, z1,      - x_frac, 1.0f - y_frac, 1.0f - z_frac);
+	float value100 = latticeDot(x1, y0, z0, 1.0f - x_frac,      - y_frac,      - z_frac);
+	float value101 = latticeDot(x1, y0, z1, 1.0f - x_frac,      - y_frac, 1.0f - z_frac);
+	float value110 = latticeDot(x1, y1, z0, 1.0f - x_frac, 1.0f - y_frac,      - z_frac);
+	float value111 = latticeDot(x1, y1, z1, 1.0f - x_frac, 1.0f - y_frac, 1.0f - z_frac);
+
+	float value00 = interpolate(value000, value001, z_fade);
+	float value01 = interpolate(value010, value011, z_fade);
+	float value10 = interpolate(value100, value101, z_fade);
+	float value11 = interpolate(value110, value111, z_fade);
+	float value0  = interpolate(value00,  value01,  y_fade);
+	float value1  = interpolate(value10,  value11,  y_fade);
+	float value   = interpolate(value0,   value1,   x_fade);
+
+	return value * m_amplitude;
+}
+
+
+
+void DefaultPerlinNoiseField3 :: setGridSize (float grid_size)
+{
+	assert(grid_size > 0.0f);
+
+	m_grid_size = grid_size;
+
+	assert(invariant());
+}
+
+void DefaultPerlinNoiseField3 :: setAmplitude (float amplitude)
+{
+	m_amplitude = amplitude;
+
+	assert(invariant());
+}
+
+bool DefaultPerlinNoiseField3 :: invariant () const
+{
+	if(m_grid_size <= 0.0f) return false;
+	return true;
+}
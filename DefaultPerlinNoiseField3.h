@@ -0,0 +1,70 @@
+//
+//  DefaultPerlinNoiseField3.h
+//
+//  A module to calculate 3D noise with the default seeds and a
+//    permutation table calculated at compile time.
+//
+
+#pragma once
+
+#include "PermutationTable.h"
+#include "PerlinNoiseField3.h"
+
+
+
+//
+//  DefaultPerlinNoiseField3
+//
+//  A class to calculate 3D value noise and Perlin noise for the
+//    default seeds with the permutation hash.  The results are
+//    the same as a PerlinNoiseField3 with the default seeds and
+//    PerlinNoiseField3::HASH_PERMUTATION, within
+//    PerlinNoiseField3::BATCH_TOLERANCE * getAmplitude().
+//
+//  The permutation table is a constant expression, so it is
+//    calculated by the compiler and stored with the program
+//    instead of being built when the field is created.  Each
+//    DefaultPerlinNoiseField3 only stores a grid size and an
+//    amplitude, and the noise is calculated in float instead of
+//    with double-precision Vector3s.
+//
+//  Class Invariant:
+//    <1> m_grid_size > 0.0f
+//
+class DefaultPerlinNoiseField3
+{
+public:
+	static constexpr PermutationTable TABLE =
+			PermutationTable::create(PerlinNoiseField3::DEFAULT_SEED_X1,
+			                         PerlinNoiseField3::DEFAULT_SEED_X2,
+			                         PerlinNoiseField3::DEFAULT_SEED_Y1,
+			                         PerlinNoiseField3::DEFAULT_SEED_Y2,
+			                         PerlinNoiseField3::DEFAULT_SEED_Z1,
+			                         PerlinNoiseField3::DEFAULT_SEED_Z2,
+			                         PerlinNoiseField3::DEFAULT_SEED_Q0,
+			                         PerlinNoiseField3::DEFAULT_SEED_Q1,
+			                         PerlinNoiseField3::DEFAULT_SEED_Q2);
+
+public:
+	DefaultPerlinNoiseField3 ();
+	DefaultPerlinNoiseField3 (float grid_size,
+	                          float amplitude);
+	DefaultPerlinNoiseField3 (const DefaultPerlinNoiseField3& to_copy) = default;
+	~DefaultPerlinNoiseField3 () = default;
+	DefaultPerlinNoiseField3& operator= (const DefaultPerlinNoiseField3& to_copy) = default;
+
+	float getGridSize () const;
+	float getAmplitude () const;
+	float valueNoise (float x, float y, float z) const;
+	float perlinNoise (float x, float y, float z) const;
+
+	void setGridSize (float grid_size);
+	void setAmplitude (float amplitude);
+
+private:
+	bool invariant () const;
+
+private:
+	float m_grid_size;
+	float m_amplitude;
+};
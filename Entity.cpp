@@ -9,6 +9,7 @@
 #include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/GlCallCounter.h"
 
 #include "Gravity.h"
 #include "CoordinateSystem.h"
@@ -57,12 +58,22 @@ void Entity :: draw () const
 {
 	assert(isInitialized());
 
-	glPushMatrix();
-		m_coords.applyDrawTransformations();
-		glScaled(m_scaling_factor, m_scaling_factor, m_scaling_factor);
-		assert(m_display_list.isReady());
-		m_display_list.draw();
-	glPopMatrix();
+	drawDisplayList(m_display_list);
+}
+
+void Entity :: calculateDrawMatrix (double a_matrix[]) const
+{
+	assert(isInitialized());
+	assert(a_matrix != nullptr);
+
+	m_coords.calculateOrientationMatrix(a_matrix);
+	for(unsigned int i = 0; i < 12; i++)
+		a_matrix[i] *= m_scaling_factor;
+
+	const Vector3& position = m_coords.getPosition();
+	a_matrix[12] = position.x;
+	a_matrix[13] = position.y;
+	a_matrix[14] = position.z;
 }
 
 
@@ -124,6 +135,20 @@ void Entity :: updatePhysics (double delta_time,
 
 
 
+void Entity :: drawDisplayList (const ObjLibrary::DisplayList& display_list) const
+{
+	assert(isInitialized());
+	assert(display_list.isReady());
+
+	glPushMatrix();
+		m_coords.applyDrawTransformations();
+		glScaled(m_scaling_factor, m_scaling_factor, m_scaling_factor);
+		display_list.draw();
+	glPopMatrix();
+}
+
+
+
 bool Entity :: invariant () const
 {
 	if(m_mass <= 0.0) return false;
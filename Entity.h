@@ -234,6 +234,24 @@ public:
 //
 	virtual void draw () const;
 
+//
+//  calculateDrawMatrix
+//
+//  Purpose: To calculate the transformation used to draw this
+//           Entity.
+//  Parameter(s):
+//    <1> a_matrix: An array of 16 values to fill in
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> a_matrix != nullptr
+//  Returns: N/A
+//  Side Effect: a_matrix is set to the column-major matrix
+//               that moves the model to the position,
+//               orientation, and scale of this Entity.  This is
+//               the same transformation drawDisplayList uses.
+//
+	void calculateDrawMatrix (double a_matrix[]) const;
+
 //
 //  setVelocity
 //
@@ -307,6 +325,23 @@ protected:
 		assert(invariant());
 	}
 
+//
+//  drawDisplayList
+//
+//  Purpose: To display the specified DisplayList at the
+//           position, orientation, and scale of this Entity.
+//  Parameter(s):
+//    <1> display_list: The DisplayList to draw
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> display_list.isReady()
+//  Returns: N/A
+//  Side Effect: display_list is displayed with the
+//               transformations for this Entity.
+//
+	void drawDisplayList (
+	           const ObjLibrary::DisplayList& display_list) const;
+
 private:
 //
 //  invariant
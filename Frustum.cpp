@@ -0,0 +1,230 @@
+//
+//  Frustum.cpp
+//
+
+#include <cassert>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define FRUSTUM_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
+#include "GetGlut.h"
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/GlCallCounter.h"
+
+#include "Frustum.h"
+
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int MATRIX_SIZE = 16;
+
+	// row i of a column-major 4x4 matrix
+	double getRowElement (const double a_matrix[], unsigned int row, unsigned int column)
+	{
+		assert(row < 4);
+		assert(column < 4);
+		return a_matrix[column * 4 + row];
+	}
+}
+
+
+
+Frustum :: Frustum ()
+{
+	// everything is visible
+	for(unsigned int i = 0; i < PLANE_COUNT; i++)
+		setPlane(i, 1.0, 0.0, 0.0, HUGE_VAL);
+
+	assert(invariant());
+}
+
+Frustum :: Frustum (const double a_clip_matrix[])
+{
+	assert(a_clip_matrix != nullptr);
+
+	init(a_clip_matrix);
+
+	assert(invariant());
+}
+
+
+
+bool Frustum :: isSphereVisible (const Vector3& center,
+                                 double radius) const
+{
+	assert(radius >= 0.0);
+
+	for(unsigned int i = 0; i < PLANE_COUNT; i++)
+	{
+		double distance = ma_normal_x[i] * center.x +
+		                  ma_normal_y[i] * center.y +
+		                  ma_normal_z[i] * center.z +
+		                  ma_distance[i];
+		if(distance < -radius)
+			return false;
+	}
+	return true;
+}
+
+unsigned int Frustum :: calculateSphereVisibility (const float a_x[],
+                                                   const float a_y[],
+                                                   const float a_z[],
+                                                   const float a_radius[],
+                                                   unsigned int count,
+                                                   bool a_is_visible[]) const
+{
+	assert(a_x          != nullptr || count == 0);
+	assert(a_y          != nullptr || count == 0);
+	assert(a_z          != nullptr || count == 0);
+	assert(a_radius     != nullptr || count == 0);
+	assert(a_is_visible != nullptr || count == 0);
+
+	unsigned int visible_count = 0;
+	unsigned int i = 0;
+
+#ifdef FRUSTUM_USE_SSE
+	// 4 spheres at a time against each plane
+	const __m128 ZERO = _mm_setzero_ps();
+	for( ; i + 4 <= count; i += 4)
+	{
+		__m128 x      = _mm_loadu_ps(a_x      + i);
+		__m128 y      = _mm_loadu_ps(a_y      + i);
+		__m128 z      = _mm_loadu_ps(a_z      + i);
+		__m128 radius = _mm_loadu_ps(a_radius + i);
+
+		__m128 is_inside = _mm_cmpge_ps(radius, ZERO);  // all true, as radii are non-negative
+		for(unsigned int p = 0; p < PLANE_COUNT; p++)
+		{
+			__m128 distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(ma_normal_x[p])),
+			                             _mm_mul_ps(y, _mm_set1_ps(ma_normal_y[p])));
+			distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(ma_normal_z[p])));
+			distance = _mm_add_ps(distance, _mm_set1_ps(ma_distance[p]));
+			distance = _mm_add_ps(distance, radius);
+			is_inside = _mm_and_ps(is_inside, _mm_cmpge_ps(distance, ZERO));
+		}
+
+		int mask = _mm_movemask_ps(is_inside);
+		for(unsigned int k = 0; k < 4; k++)
+		{
+			a_is_visible[i + k] = ((mask >> k) & 0x1) != 0;
+			if(a_is_visible[i + k])
+				visible_count++;
+		}
+	}
+#endif
+
+	// any remaining spheres
+	for( ; i < count; i++)
+	{
+		assert(a_radius[i] >= 0.0f);
+
+		a_is_visible[i] = true;
+		for(unsigned int p = 0; p < PLANE_COUNT; p++)
+		{
+			float distance = ma_normal_x[p] * a_x[i] +
+			                 ma_normal_y[p] * a_y[i] +
+			                 ma_normal_z[p] * a_z[i] +
+			                 ma_distance[p] + a_radius[i];
+			if(distance < 0.0f)
+			{
+				a_is_visible[i] = false;
+				break;
+			}
+		}
+		if(a_is_visible[i])
+			visible_count++;
+	}
+
+	return visible_count;
+}
+
+
+
+void Frustum :: init (const double a_clip_matrix[])
+{
+	assert(a_clip_matrix != nullptr);
+
+	//
+	//  Gribb and Hartmann's method: a point is inside the
+	//    frustum if -w <= x, y, z <= w after being multiplied
+	//    by the clip matrix, so each plane is row 3 plus or
+	//    minus one of the other rows.
+	//
+
+	for(unsigned int axis = 0; axis < 3; axis++)
+	{
+		double a_plus [4];
+		double a_minus[4];
+		for(unsigned int c = 0; c < 4; c++)
+		{
+			double w = getRowElement(a_clip_matrix, 3, c);
+			double v = getRowElement(a_clip_matrix, axis, c);
+			a_plus [c] = w + v;
+			a_minus[c] = w - v;
+		}
+		setPlane(axis * 2 + 0, a_plus [0], a_plus [1], a_plus [2], a_plus [3]);
+		setPlane(axis * 2 + 1, a_minus[0], a_minus[1], a_minus[2], a_minus[3]);
+	}
+
+	assert(invariant());
+}
+
+void Frustum :: initFromOpenGL ()
+{
+	double a_projection[MATRIX_SIZE];
+	double a_modelview [MATRIX_SIZE];
+	glGetDoublev(GL_PROJECTION_MATRIX, a_projection);
+	glGetDoublev(GL_MODELVIEW_MATRIX,  a_modelview);
+
+	// clip = projection * modelview
+	double a_clip[MATRIX_SIZE];
+	for(unsigned int c = 0; c < 4; c++)
+		for(unsigned int r = 0; r < 4; r++)
+		{
+			double sum = 0.0;
+			for(unsigned int k = 0; k < 4; k++)
+				sum += a_projection[k * 4 + r] * a_modelview[c * 4 + k];
+			a_clip[c * 4 + r] = sum;
+		}
+
+	init(a_clip);
+
+	assert(invariant());
+}
+
+
+
+void Frustum :: setPlane (unsigned int index,
+                          double x, double y, double z, double distance)
+{
+	assert(index < PLANE_COUNT);
+
+	double length = sqrt(x * x + y * y + z * z);
+	if(length <= 0.0)
+	{
+		// degenerate matrix, so never cull against this plane
+		x        = 1.0;
+		length   = 1.0;
+		distance = HUGE_VAL;
+	}
+
+	ma_normal_x[index] = (float)(x / length);
+	ma_normal_y[index] = (float)(y / length);
+	ma_normal_z[index] = (float)(z / length);
+	ma_distance[index] = (float)(distance / length);
+}
+
+bool Frustum :: invariant () const
+{
+	for(unsigned int i = 0; i < PLANE_COUNT; i++)
+	{
+		double length_squared = ma_normal_x[i] * ma_normal_x[i] +
+		                        ma_normal_y[i] * ma_normal_y[i] +
+		                        ma_normal_z[i] * ma_normal_z[i];
+		if(fabs(length_squared - 1.0) > 1.0e-4) return false;
+	}
+	return true;
+}
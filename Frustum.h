@@ -0,0 +1,138 @@
+//
+//  Frustum.h
+//
+//  A module to represent the view frustum of a camera.
+//
+
+#pragma once
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  Frustum
+//
+//  A class to represent the view frustum of a camera as 6
+//    planes (left, right, bottom, top, near, far).  The planes
+//    are extracted from the combined projection and modelview
+//    matrix, so the frustum is in world coordinates if the
+//    modelview matrix only holds the camera transformation.
+//    Each plane is stored as a unit normal pointing into the
+//    frustum and a distance, so a point is inside a plane if
+//    normal.dot(point) + distance >= 0.
+//
+//  Spheres can be tested one at a time, or many at once with
+//    calculateSphereVisibility.  The batch test uses SSE when
+//    it is available.  It takes arrays of floats, so the caller
+//    can reuse the same arrays every frame.
+//
+//  Class Invariant:
+//    <1> ma_normal_x[i]^2 + ma_normal_y[i]^2 + ma_normal_z[i]^2
+//        == 1.0 (within rounding error) for every plane i
+//
+class Frustum
+{
+public:
+	static const unsigned int PLANE_COUNT = 6;
+
+public:
+	Frustum ();
+	Frustum (const double a_clip_matrix[]);
+	Frustum (const Frustum& to_copy) = default;
+	~Frustum () = default;
+	Frustum& operator= (const Frustum& to_copy) = default;
+
+//
+//  isSphereVisible
+//
+//  Purpose: To determine if the specified sphere is at least
+//           partly inside this Frustum.
+//  Parameter(s):
+//    <1> center: The center of the sphere
+//    <2> radius: The radius of the sphere
+//  Precondition(s):
+//    <1> radius >= 0.0
+//  Returns: Whether the sphere is not entirely outside any of
+//           the planes.  A sphere near a corner of the frustum
+//           may be reported as visible when it is not.
+//  Side Effect: N/A
+//
+	bool isSphereVisible (const ObjLibrary::Vector3& center,
+	                      double radius) const;
+
+//
+//  calculateSphereVisibility
+//
+//  Purpose: To determine which of a group of spheres are at
+//           least partly inside this Frustum.
+//  Parameter(s):
+//    <1> a_x
+//    <2> a_y
+//    <3> a_z: The centers of the spheres
+//    <4> a_radius: The radii of the spheres
+//    <5> count: The number of spheres
+//    <6> a_is_visible: An array to fill in with the results
+//  Precondition(s):
+//    <1> a_x != nullptr || count == 0
+//    <2> a_y != nullptr || count == 0
+//    <3> a_z != nullptr || count == 0
+//    <4> a_radius != nullptr || count == 0
+//    <5> a_is_visible != nullptr || count == 0
+//    <6> All the arrays have at least count elements
+//    <7> a_radius[i] >= 0.0f for all i < count
+//  Returns: The number of spheres that are visible.
+//  Side Effect: Element i of a_is_visible is set to
+//               isSphereVisible for sphere i.
+//
+	unsigned int calculateSphereVisibility (const float a_x[],
+	                                        const float a_y[],
+	                                        const float a_z[],
+	                                        const float a_radius[],
+	                                        unsigned int count,
+	                                        bool a_is_visible[]) const;
+
+//
+//  init
+//
+//  Purpose: To set this Frustum from the specified combined
+//           projection and modelview matrix.
+//  Parameter(s):
+//    <1> a_clip_matrix: The matrix, in the column-major order
+//                       used by OpenGL
+//  Precondition(s):
+//    <1> a_clip_matrix != nullptr
+//    <2> a_clip_matrix has 16 elements
+//  Returns: N/A
+//  Side Effect: This Frustum is set to the volume that
+//               a_clip_matrix maps into the unit cube.
+//
+	void init (const double a_clip_matrix[]);
+
+//
+//  initFromOpenGL
+//
+//  Purpose: To set this Frustum from the current OpenGL
+//           projection and modelview matrixes.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This Frustum is set to the volume currently
+//               visible to the camera.  If the modelview matrix
+//               holds only the camera transformation, this
+//               Frustum is in world coordinates.
+//
+	void initFromOpenGL ();
+
+private:
+	void setPlane (unsigned int index,
+	               double x, double y, double z, double distance);
+	bool invariant () const;
+
+private:
+	// structure-of-arrays so the batch test can load 4 at a time
+	float ma_normal_x[PLANE_COUNT];
+	float ma_normal_y[PLANE_COUNT];
+	float ma_normal_z[PLANE_COUNT];
+	float ma_distance[PLANE_COUNT];
+};
@@ -0,0 +1,59 @@
+//
+//  GetGlutWithShaders.h
+//
+//  A header file in import OpenGL, GLU, and GLUT with the
+//    functions newer than OpenGL 1.1, such as buffer objects,
+//    vertex array objects, and shaders.  Use this file instead
+//    of GetGlut.h in any file that needs those functions.
+//
+//  On Linux, the newer functions are declared by the system
+//    headers if GL_GLEXT_PROTOTYPES is defined first.  This
+//    means that this file must be included before GetGlut.h
+//    or any other file that includes <GL/gl.h>.
+//
+//  On Windows, the newer functions must be loaded at run time.
+//    GlExtensions.h declares the ones this program uses, and
+//    loadGlExtensions() must be called after the GLUT window
+//    is created.  No other library is needed.  On Mac OSX, the
+//    functions are always available.
+//
+
+#ifndef GET_GLUT_WITH_SHADERS_H
+#define GET_GLUT_WITH_SHADERS_H
+
+// stop GetGlut.h from including the headers again
+#ifndef GET_GLUT_H
+#define GET_GLUT_H
+#endif
+
+
+
+// Windows
+#if defined(_WIN32) || defined(__WIN32__)
+#include "freeglut.h"
+#include "GlExtensions.h"
+
+// Mac OSX
+#elif defined(__APPLE__) || defined(__MACH__)
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl.h>
+#include <OpenGL/glext.h>
+#include <GLUT/glut.h>
+
+// Unix, Linux, and others
+#else
+#if defined(__gl_h_) && !defined(GL_GLEXT_PROTOTYPES)
+#error "GetGlutWithShaders.h must be included before GetGlut.h or <GL/gl.h>"
+#endif
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <GL/glu.h>
+#include <GL/glut.h>
+#endif
+
+
+
+#endif
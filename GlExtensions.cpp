@@ -0,0 +1,56 @@
+//
+//  GlExtensions.cpp
+//
+
+#include "GetGlutWithShaders.h"  // includes GlExtensions.h on Windows
+
+#if defined(_WIN32) || defined(__WIN32__)
+
+#include <cstdint>
+
+using namespace std;
+namespace
+{
+	// some drivers return small numbers instead of nullptr on failure
+	bool isValidProc (PROC p_proc)
+	{
+		intptr_t value = (intptr_t)(p_proc);
+		return value != 0 && value != 1 && value != 2 && value != 3 && value != -1;
+	}
+
+	template <typename FUNCTION>
+	bool loadFunction (FUNCTION& rp_function, const char* name)
+	{
+		PROC p_proc = wglGetProcAddress(name);
+		if(!isValidProc(p_proc))
+		{
+			rp_function = nullptr;
+			return false;
+		}
+		rp_function = (FUNCTION)(p_proc);
+		return true;
+	}
+
+}  // end of anonymous namespace
+
+
+
+#define GL_EXTENSION_DEFINE(RETURN_TYPE, NAME, PARAMETERS) \
+	RETURN_TYPE (APIENTRY* NAME) PARAMETERS = nullptr;
+GL_EXTENSION_FUNCTIONS(GL_EXTENSION_DEFINE)
+#undef GL_EXTENSION_DEFINE
+
+
+
+bool loadGlExtensions ()
+{
+	bool is_all_loaded = true;
+#define GL_EXTENSION_LOAD(RETURN_TYPE, NAME, PARAMETERS) \
+	if(!loadFunction(NAME, #NAME)) \
+		is_all_loaded = false;
+	GL_EXTENSION_FUNCTIONS(GL_EXTENSION_LOAD)
+#undef GL_EXTENSION_LOAD
+	return is_all_loaded;
+}
+
+#endif  // Windows
@@ -0,0 +1,150 @@
+//
+//  GlExtensions.h
+//
+//  A module to load the OpenGL functions newer than OpenGL 1.1
+//    on Windows, where opengl32.lib only exports OpenGL 1.1.
+//    The newer functions are found at run time with
+//    wglGetProcAddress.  This does the same job as GLEW, but
+//    only for the functions this program uses, so nothing
+//    beyond freeglut has to be installed.
+//
+//  This file is included by GetGlutWithShaders.h on Windows,
+//    and should not be included directly.  On other platforms,
+//    it declares nothing.
+//
+//  To use another OpenGL function newer than 1.1, add it to
+//    GL_EXTENSION_FUNCTIONS, and add any constants it needs
+//    below.  The values are the same as in glext.h.
+//
+
+#pragma once
+
+#if defined(_WIN32) || defined(__WIN32__)
+
+#include <cstddef>  // for ptrdiff_t
+
+
+
+typedef char      GLchar;
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+
+// OpenGL 1.2
+#define GL_TEXTURE_WRAP_R        0x8072
+#define GL_CLAMP_TO_BORDER       0x812D
+#define GL_CLAMP_TO_EDGE         0x812F
+#define GL_DEPTH_COMPONENT24     0x81A6
+
+// OpenGL 1.3 and 1.4
+#define GL_TEXTURE0              0x84C0
+#define GL_MIRRORED_REPEAT       0x8370
+
+// OpenGL 1.5
+#define GL_ARRAY_BUFFER          0x8892
+#define GL_ELEMENT_ARRAY_BUFFER  0x8893
+#define GL_STREAM_DRAW           0x88E0
+#define GL_STATIC_DRAW           0x88E4
+#define GL_DYNAMIC_DRAW          0x88E8
+
+// OpenGL 2.0
+#define GL_FRAGMENT_SHADER       0x8B30
+#define GL_VERTEX_SHADER         0x8B31
+#define GL_COMPILE_STATUS        0x8B81
+#define GL_LINK_STATUS           0x8B82
+#define GL_INFO_LOG_LENGTH       0x8B84
+
+// OpenGL 3.0
+#define GL_TEXTURE_2D_ARRAY      0x8C1A
+#define GL_FRAMEBUFFER_BINDING   0x8CA6
+#define GL_FRAMEBUFFER_COMPLETE  0x8CD5
+#define GL_COLOR_ATTACHMENT0     0x8CE0
+#define GL_DEPTH_ATTACHMENT      0x8D00
+#define GL_FRAMEBUFFER           0x8D40
+#define GL_RENDERBUFFER          0x8D41
+
+// OpenGL 4.0
+#define GL_DRAW_INDIRECT_BUFFER  0x8F3F
+
+
+
+//
+//  GL_EXTENSION_FUNCTIONS
+//
+//  The functions to load, as FUNCTION(return type, name,
+//    parameter list).  Each one becomes a function pointer with
+//    the same name as the OpenGL function, so calls to it look
+//    the same as on other platforms.
+//
+#define GL_EXTENSION_FUNCTIONS(FUNCTION) \
+	FUNCTION(void,   glActiveTexture,           (GLenum texture)) \
+	FUNCTION(void,   glAttachShader,            (GLuint program, GLuint shader)) \
+	FUNCTION(void,   glBindAttribLocation,      (GLuint program, GLuint index, const GLchar* name)) \
+	FUNCTION(void,   glBindBuffer,              (GLenum target, GLuint buffer)) \
+	FUNCTION(void,   glBindFramebuffer,         (GLenum target, GLuint framebuffer)) \
+	FUNCTION(void,   glBindRenderbuffer,        (GLenum target, GLuint renderbuffer)) \
+	FUNCTION(void,   glBindVertexArray,         (GLuint array)) \
+	FUNCTION(void,   glBufferData,              (GLenum target, GLsizeiptr size, const void* data, GLenum usage)) \
+	FUNCTION(void,   glBufferSubData,           (GLenum target, GLintptr offset, GLsizeiptr size, const void* data)) \
+	FUNCTION(GLenum, glCheckFramebufferStatus,  (GLenum target)) \
+	FUNCTION(void,   glCompileShader,           (GLuint shader)) \
+	FUNCTION(GLuint, glCreateProgram,           ()) \
+	FUNCTION(GLuint, glCreateShader,            (GLenum type)) \
+	FUNCTION(void,   glDeleteBuffers,           (GLsizei n, const GLuint* buffers)) \
+	FUNCTION(void,   glDeleteFramebuffers,      (GLsizei n, const GLuint* framebuffers)) \
+	FUNCTION(void,   glDeleteProgram,           (GLuint program)) \
+	FUNCTION(void,   glDeleteRenderbuffers,     (GLsizei n, const GLuint* renderbuffers)) \
+	FUNCTION(void,   glDeleteShader,            (GLuint shader)) \
+	FUNCTION(void,   glDeleteVertexArrays,      (GLsizei n, const GLuint* arrays)) \
+	FUNCTION(void,   glDisableVertexAttribArray, (GLuint index)) \
+	FUNCTION(void,   glDrawElementsInstanced,   (GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instance_count)) \
+	FUNCTION(void,   glDrawElementsInstancedBaseVertex, (GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instance_count, GLint base_vertex)) \
+	FUNCTION(void,   glEnableVertexAttribArray, (GLuint index)) \
+	FUNCTION(void,   glFramebufferRenderbuffer, (GLenum target, GLenum attachment, GLenum renderbuffer_target, GLuint renderbuffer)) \
+	FUNCTION(void,   glFramebufferTexture2D,    (GLenum target, GLenum attachment, GLenum texture_target, GLuint texture, GLint level)) \
+	FUNCTION(void,   glGenBuffers,              (GLsizei n, GLuint* buffers)) \
+	FUNCTION(void,   glGenFramebuffers,         (GLsizei n, GLuint* framebuffers)) \
+	FUNCTION(void,   glGenRenderbuffers,        (GLsizei n, GLuint* renderbuffers)) \
+	FUNCTION(void,   glGenVertexArrays,         (GLsizei n, GLuint* arrays)) \
+	FUNCTION(void,   glGenerateMipmap,          (GLenum target)) \
+	FUNCTION(void,   glGetProgramInfoLog,       (GLuint program, GLsizei buffer_size, GLsizei* length, GLchar* info_log)) \
+	FUNCTION(void,   glGetProgramiv,            (GLuint program, GLenum name, GLint* values)) \
+	FUNCTION(void,   glGetShaderInfoLog,        (GLuint shader, GLsizei buffer_size, GLsizei* length, GLchar* info_log)) \
+	FUNCTION(void,   glGetShaderiv,             (GLuint shader, GLenum name, GLint* values)) \
+	FUNCTION(GLint,  glGetUniformLocation,      (GLuint program, const GLchar* name)) \
+	FUNCTION(void,   glLinkProgram,             (GLuint program)) \
+	FUNCTION(void,   glMultiDrawElementsIndirect, (GLenum mode, GLenum type, const void* indirect, GLsizei draw_count, GLsizei stride)) \
+	FUNCTION(void,   glRenderbufferStorage,     (GLenum target, GLenum internal_format, GLsizei width, GLsizei height)) \
+	FUNCTION(void,   glShaderSource,            (GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)) \
+	FUNCTION(void,   glTexImage3D,              (GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels)) \
+	FUNCTION(void,   glTexSubImage3D,           (GLenum target, GLint level, GLint x_offset, GLint y_offset, GLint z_offset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels)) \
+	FUNCTION(void,   glUniform1f,               (GLint location, GLfloat value)) \
+	FUNCTION(void,   glUniform1i,               (GLint location, GLint value)) \
+	FUNCTION(void,   glUseProgram,              (GLuint program)) \
+	FUNCTION(void,   glVertexAttribDivisor,     (GLuint index, GLuint divisor)) \
+	FUNCTION(void,   glVertexAttribIPointer,    (GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer)) \
+	FUNCTION(void,   glVertexAttribPointer,     (GLuint index, GLint size, GLenum type, GLboolean is_normalized, GLsizei stride, const void* pointer))
+
+#define GL_EXTENSION_DECLARE(RETURN_TYPE, NAME, PARAMETERS) \
+	extern RETURN_TYPE (APIENTRY* NAME) PARAMETERS;
+GL_EXTENSION_FUNCTIONS(GL_EXTENSION_DECLARE)
+#undef GL_EXTENSION_DECLARE
+
+
+
+//
+//  loadGlExtensions
+//
+//  Purpose: To load the OpenGL functions newer than OpenGL 1.1.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> An OpenGL context is current
+//  Returns: Whether every function was found.
+//  Side Effect: Each function in GL_EXTENSION_FUNCTIONS is set
+//               to the function for the current OpenGL
+//               context.  Functions the driver does not
+//               provide are set to nullptr, so check the
+//               OpenGL version before using them.
+//
+bool loadGlExtensions ();
+
+#endif  // Windows
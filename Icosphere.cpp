@@ -0,0 +1,241 @@
+//
+//  Icosphere.cpp
+//
+
+#include "Icosphere.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/ObjModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double PI     = 3.1415926535897932384626433832795;
+	const double TWO_PI = PI * 2.0;
+	const double GOLDEN_RATIO = 1.6180339887498948482045868343656;
+	const double POLE_TOLERANCE = 1.0e-12;  // squared distance from the Y axis
+	const unsigned int NO_INDEX = 0xFFFFFFFFu;
+
+	const unsigned int ICOSAHEDRON_VERTEX_COUNT   = 12;
+	const unsigned int ICOSAHEDRON_TRIANGLE_COUNT = 20;
+
+	const double ICOSAHEDRON_VERTEXES[ICOSAHEDRON_VERTEX_COUNT][3] =
+	{
+		{ -1.0,  GOLDEN_RATIO, 0.0 }, { 1.0,  GOLDEN_RATIO, 0.0 },
+		{ -1.0, -GOLDEN_RATIO, 0.0 }, { 1.0, -GOLDEN_RATIO, 0.0 },
+		{ 0.0, -1.0,  GOLDEN_RATIO }, { 0.0, 1.0,  GOLDEN_RATIO },
+		{ 0.0, -1.0, -GOLDEN_RATIO }, { 0.0, 1.0, -GOLDEN_RATIO },
+		{  GOLDEN_RATIO, 0.0, -1.0 }, {  GOLDEN_RATIO, 0.0, 1.0 },
+		{ -GOLDEN_RATIO, 0.0, -1.0 }, { -GOLDEN_RATIO, 0.0, 1.0 },
+	};
+
+	// counterclockwise from outside
+	const unsigned int ICOSAHEDRON_TRIANGLES[ICOSAHEDRON_TRIANGLE_COUNT][3] =
+	{
+		{ 0, 11,  5 }, { 0,  5,  1 }, {  0,  1,  7 }, {  0,  7, 10 }, { 0, 10, 11 },
+		{ 1,  5,  9 }, { 5, 11,  4 }, { 11, 10,  2 }, { 10,  7,  6 }, { 7,  1,  8 },
+		{ 3,  9,  4 }, { 3,  4,  2 }, {  3,  2,  6 }, {  3,  6,  8 }, { 3,  8,  9 },
+		{ 4,  9,  5 }, { 2,  4, 11 }, {  6,  2, 10 }, {  8,  6,  7 }, { 9,  8,  1 },
+	};
+
+
+
+	// the vertex halfway along an edge, created the first time it is needed
+	unsigned int getMidpoint (unsigned int vertex0,
+	                          unsigned int vertex1,
+	                          vector<Vector3>& rv_positions,
+	                          unordered_map<uint64_t, unsigned int>& r_midpoints)
+	{
+		uint64_t key = (vertex0 < vertex1) ?
+		               ((uint64_t)(vertex0) << 32) | vertex1 :
+		               ((uint64_t)(vertex1) << 32) | vertex0;
+
+		unordered_map<uint64_t, unsigned int>::iterator found = r_midpoints.find(key);
+		if(found != r_midpoints.end())
+			return found->second;
+
+		unsigned int midpoint = (unsigned int)(rv_positions.size());
+		rv_positions.push_back((rv_positions[vertex0] + rv_positions[vertex1]).getNormalized());
+		r_midpoints[key] = midpoint;
+		return midpoint;
+	}
+
+	double calculateU (const Vector3& position)
+	{
+		return atan2(-position.z, position.x) / TWO_PI + 0.5;
+	}
+
+	double calculateV (const Vector3& position)
+	{
+		double y = position.y;
+		if(y > 1.0)
+			y = 1.0;
+		else if(y < -1.0)
+			y = -1.0;
+		return asin(y) / PI + 0.5;
+	}
+
+	bool isPole (const Vector3& position)
+	{
+		return position.x * position.x + position.z * position.z < POLE_TOLERANCE;
+	}
+
+}  // end of anonymous namespace
+
+
+
+unsigned int getIcosphereVertexCount (unsigned int subdivisions)
+{
+	assert(subdivisions <= ICOSPHERE_SUBDIVISIONS_MAX);
+
+	return 10 * (1u << (subdivisions * 2)) + 2;
+}
+
+unsigned int getIcosphereTriangleCount (unsigned int subdivisions)
+{
+	assert(subdivisions <= ICOSPHERE_SUBDIVISIONS_MAX);
+
+	return 20 * (1u << (subdivisions * 2));
+}
+
+ObjLibrary::ObjModel createIcosphere (unsigned int subdivisions)
+{
+	assert(subdivisions <= ICOSPHERE_SUBDIVISIONS_MAX);
+
+	unsigned int vertex_count   = getIcosphereVertexCount  (subdivisions);
+	unsigned int triangle_count = getIcosphereTriangleCount(subdivisions);
+
+	vector<Vector3> v_positions;
+	v_positions.reserve(vertex_count);
+	for(unsigned int v = 0; v < ICOSAHEDRON_VERTEX_COUNT; v++)
+	{
+		const double* a_vertex = ICOSAHEDRON_VERTEXES[v];
+		v_positions.push_back(Vector3(a_vertex[0], a_vertex[1], a_vertex[2]).getNormalized());
+	}
+	vector<unsigned int> v_triangles(ICOSAHEDRON_TRIANGLES[0],
+	                                 ICOSAHEDRON_TRIANGLES[0] + ICOSAHEDRON_TRIANGLE_COUNT * 3);
+
+	// split each triangle into 4, sharing the new vertexes along each edge
+	for(unsigned int s = 0; s < subdivisions; s++)
+	{
+		unordered_map<uint64_t, unsigned int> midpoints;
+		midpoints.reserve(v_triangles.size() / 2);  // each edge is in 2 triangles
+		vector<unsigned int> v_split;
+		v_split.reserve(v_triangles.size() * 4);
+		for(unsigned int t = 0; t < v_triangles.size(); t += 3)
+		{
+			unsigned int a = v_triangles[t + 0];
+			unsigned int b = v_triangles[t + 1];
+			unsigned int c = v_triangles[t + 2];
+			unsigned int ab = getMidpoint(a, b, v_positions, midpoints);
+			unsigned int bc = getMidpoint(b, c, v_positions, midpoints);
+			unsigned int ca = getMidpoint(c, a, v_positions, midpoints);
+
+			unsigned int a_split[12] = { a, ab, ca,   b, bc, ab,   c, ca, bc,   ab, bc, ca };
+			v_split.insert(v_split.end(), a_split, a_split + 12);
+		}
+		v_triangles.swap(v_split);
+	}
+	assert(v_positions.size() == vertex_count);
+	assert(v_triangles.size() == triangle_count * 3);
+
+	ObjModel model;
+	model.setVertexCount(vertex_count);
+	model.setNormalCount(vertex_count);
+	model.setTextureCoordinateCount(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+	{
+		const Vector3& position = v_positions[v];
+		model.setVertexPosition(v, position);
+		model.setNormalVector(v, position);
+		model.setTextureCoordinate(v, calculateU(position), calculateV(position));
+	}
+
+	// texture coordinates that differ from the vertex's own
+	vector<unsigned int> v_wrapped(vertex_count, NO_INDEX);
+
+	unsigned int mesh = model.addMesh();
+	for(unsigned int t = 0; t < v_triangles.size(); t += 3)
+	{
+		const unsigned int* a_corners = v_triangles.data() + t;
+		double a_u[3];
+		bool a_is_pole[3];
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			a_u[c]       = model.getTextureCoordinateU(a_corners[c]);
+			a_is_pole[c] = isPole(v_positions[a_corners[c]]);
+		}
+
+		// across the seam, move the small values past 1
+		double u_min = 1.0;
+		double u_max = 0.0;
+		for(unsigned int c = 0; c < 3; c++)
+			if(!a_is_pole[c])
+			{
+				if(a_u[c] < u_min) u_min = a_u[c];
+				if(a_u[c] > u_max) u_max = a_u[c];
+			}
+		bool is_wrapped = u_max - u_min > 0.5;
+
+		double u_sum = 0.0;
+		unsigned int u_count = 0;
+		for(unsigned int c = 0; c < 3; c++)
+			if(!a_is_pole[c])
+			{
+				if(is_wrapped && a_u[c] < 0.5)
+					a_u[c] += 1.0;
+				u_sum += a_u[c];
+				u_count++;
+			}
+
+		unsigned int face = model.addFace(mesh);
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			unsigned int vertex = a_corners[c];
+			unsigned int texture_coordinates = vertex;
+			if(a_is_pole[c])
+			{
+				// a pole has every longitude, so use the middle of the triangle
+				double u = (u_count > 0) ? u_sum / u_count : 0.5;
+				texture_coordinates = model.addTextureCoordinate(u, model.getTextureCoordinateV(vertex));
+			}
+			else if(is_wrapped && a_u[c] >= 1.0)
+			{
+				if(v_wrapped[vertex] == NO_INDEX)
+				{
+					v_wrapped[vertex] = model.addTextureCoordinate(a_u[c],
+					                                               model.getTextureCoordinateV(vertex));
+				}
+				texture_coordinates = v_wrapped[vertex];
+			}
+			model.addFaceVertex(mesh, face, vertex, texture_coordinates, vertex);
+		}
+	}
+
+	model.validate();
+	assert(model.isValid());
+	return model;
+}
+
+std::vector<ObjLibrary::ObjModel> createIcosphereLevels (unsigned int subdivisions,
+                                                        unsigned int level_count)
+{
+	assert(subdivisions <= ICOSPHERE_SUBDIVISIONS_MAX);
+	assert(level_count > 0);
+
+	vector<ObjModel> v_levels;
+	v_levels.reserve(level_count);
+	for(unsigned int i = 0; i < level_count; i++)
+	{
+		unsigned int level_subdivisions = (i < subdivisions) ? subdivisions - i : 0;
+		v_levels.push_back(createIcosphere(level_subdivisions));
+	}
+	return v_levels;
+}
@@ -0,0 +1,89 @@
+//
+//  Icosphere.h
+//
+//  A module to generate unit spheres made of triangles.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/ObjModel.h"
+
+
+
+//
+//  ICOSPHERE_SUBDIVISIONS_MAX
+//
+//  The largest number of subdivisions createIcosphere allows.
+//    At this level, an icosphere has 20 * 4^8 = 1310720
+//    triangles.
+//
+const unsigned int ICOSPHERE_SUBDIVISIONS_MAX = 8;
+
+//
+//  getIcosphereVertexCount
+//  getIcosphereTriangleCount
+//
+//  Purpose: To determine the size of an icosphere.
+//  Parameter(s):
+//    <1> subdivisions: The number of times the icosahedron is
+//                      subdivided
+//  Precondition(s):
+//    <1> subdivisions <= ICOSPHERE_SUBDIVISIONS_MAX
+//  Returns: The number of vertexes (10 * 4^subdivisions + 2) or
+//           triangles (20 * 4^subdivisions) in the icosphere
+//           createIcosphere would return.
+//  Side Effect: N/A
+//
+
+unsigned int getIcosphereVertexCount (unsigned int subdivisions);
+unsigned int getIcosphereTriangleCount (unsigned int subdivisions);
+
+//
+//  createIcosphere
+//
+//  Purpose: To generate a unit sphere by subdividing an
+//           icosahedron.
+//  Parameter(s):
+//    <1> subdivisions: The number of times to split each
+//                      triangle into 4
+//  Precondition(s):
+//    <1> subdivisions <= ICOSPHERE_SUBDIVISIONS_MAX
+//  Returns: An ObjModel with one mesh of triangles, wound
+//           counterclockwise when seen from outside.  Each
+//           vertex is shared by all the triangles that touch
+//           it, and is its own normal.  The triangles are all
+//           close to the same size, unlike on a latitude-
+//           longitude sphere.  Texture coordinates use the same
+//           longitude-latitude mapping as a UV sphere, with
+//           extra coordinates only where the triangles cross
+//           the seam or touch a pole.  The mesh has no
+//           material, so addMaterialLibrary and setMeshMaterial
+//           should be called to give it one.
+//  Side Effect: N/A
+//
+
+ObjLibrary::ObjModel createIcosphere (unsigned int subdivisions);
+
+//
+//  createIcosphereLevels
+//
+//  Purpose: To generate icospheres for several levels of
+//           detail.
+//  Parameter(s):
+//    <1> subdivisions: The number of subdivisions for the most
+//                      detailed level
+//    <2> level_count: The number of levels
+//  Precondition(s):
+//    <1> subdivisions <= ICOSPHERE_SUBDIVISIONS_MAX
+//    <2> level_count > 0
+//  Returns: A vector of level_count ObjModels, with element i
+//           created with subdivisions - i subdivisions, or 0
+//           if that would be negative.  Each level has a
+//           quarter of the triangles of the level before it.
+//  Side Effect: N/A
+//
+
+std::vector<ObjLibrary::ObjModel> createIcosphereLevels (unsigned int subdivisions,
+                                                        unsigned int level_count);
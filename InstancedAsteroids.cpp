@@ -0,0 +1,807 @@
+//
+//  InstancedAsteroids.cpp
+//
+
+#include "GetGlutWithShaders.h"  // must be first
+
+#include <cassert>
+#include <cstdio>  // for sscanf
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/GlCallCounter.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/ObjVbo.h"
+#include "ObjLibrary/MeshWithShader.h"
+#include "ObjLibrary/VertexDataFormat.h"
+#include "ObjLibrary/WeldedMesh.h"
+
+#include "PermutationTable.h"
+#include "PerlinNoiseField3.h"
+#include "Asteroid.h"
+#include "InstancedAsteroids.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int MATRIX_SIZE = 16;
+
+	// chosen to avoid the locations NVIDIA aliases with gl_Vertex,
+	//   gl_Normal, gl_Color, and gl_MultiTexCoord0
+	const unsigned int TRANSFORM_LOCATION    =  4;  // 4 locations for a mat4
+	const unsigned int RADII_LOCATION        =  9;
+	const unsigned int NOISE_OFFSET_LOCATION = 10;
+
+	const unsigned int RADII_OFFSET        = MATRIX_SIZE;
+	const unsigned int NOISE_OFFSET_OFFSET = MATRIX_SIZE + 2;
+
+	// same layout as DrawElementsIndirectCommand in the OpenGL specification
+	const unsigned int COMMAND_INDEX_COUNT    = 0;
+	const unsigned int COMMAND_INSTANCE_COUNT = 1;
+	const unsigned int COMMAND_FIRST_INDEX    = 2;
+	const unsigned int COMMAND_BASE_VERTEX    = 3;
+	const unsigned int COMMAND_FIRST_INSTANCE = 4;
+	const unsigned int COMMAND_SIZE           = 5;
+
+	//
+	//  The noise functions are the same as in PerlinNoiseField3.
+	//    The constants they use are written in front of this by
+	//    createVertexShaderSource, so they always match the C++
+	//    noise field.  GLSL unsigned integers wrap around the
+	//    same way as in C++.
+	//
+	const char* VERTEX_SHADER_BODY =
+		"uniform float u_vertex_spacing;\n"
+		"\n"
+		"in mat4 a_transform;\n"
+		"in vec2 a_radii;  // inner, outer\n"
+		"in vec3 a_noise_offset;\n"
+		"\n"
+		"const float PI = 3.14159265;\n"
+		"\n"
+		"#ifdef HASH_PERMUTATION\n"
+		"\n"
+		"// same as PermutationTable::hash\n"
+		"vec3 lattice (ivec3 cell)\n"
+		"{\n"
+		"	int hash = PERMUTATION[PERMUTATION[PERMUTATION[cell.x & 255] + (cell.y & 255)] + (cell.z & 255)];\n"
+		"	return vec3(GRADIENT_X[hash], GRADIENT_Y[hash], GRADIENT_Z[hash]);\n"
+		"}\n"
+		"\n"
+		"#else\n"
+		"\n"
+		"uint pseudorandom (ivec3 cell)\n"
+		"{\n"
+		"	uvec3 u = uvec3(cell);\n"
+		"	uint n = SEED_X1 * u.x + SEED_Y1 * u.y + SEED_Z1 * u.z;\n"
+		"	uint quad_term = SEED_Q2 * n * n + SEED_Q1 * n + SEED_Q0;\n"
+		"	return quad_term + SEED_X2 * u.x + SEED_Y2 * u.y + SEED_Z2 * u.z;\n"
+		"}\n"
+		"\n"
+		"float unsignedIntTo01 (uint n)\n"
+		"{\n"
+		"	return float(n) / 4294967295.0;\n"
+		"}\n"
+		"\n"
+		"vec3 lattice (ivec3 cell)\n"
+		"{\n"
+		"	// same as Vector3::getPseudorandomUnitVector\n"
+		"	float seed1 = unsignedIntTo01(pseudorandom(cell));\n"
+		"	float seed2 = unsignedIntTo01(pseudorandom(cell + ivec3(1)));\n"
+		"	float xy_angle = seed1 * 2.0 * PI;\n"
+		"	float z = seed2 * 2.0 - 1.0;\n"
+		"	float radius_xy = sqrt(max(1.0 - z * z, 0.0));\n"
+		"	return vec3(radius_xy * cos(xy_angle), radius_xy * sin(xy_angle), z);\n"
+		"}\n"
+		"\n"
+		"#endif\n"
+		"\n"
+		"float latticeValue (ivec3 cell0, vec3 frac, ivec3 corner)\n"
+		"{\n"
+		"	return dot(lattice(cell0 + corner), vec3(corner) - frac);\n"
+		"}\n"
+		"\n"
+		"float perlinNoise (vec3 position)\n"
+		"{\n"
+		"	vec3 scaled = position / NOISE_GRID_SIZE;\n"
+		"	vec3 cell_floor = floor(scaled);\n"
+		"	ivec3 cell0 = ivec3(cell_floor);\n"
+		"	vec3 frac = scaled - cell_floor;\n"
+		"	vec3 fade = (1.0 - cos(frac * PI)) * 0.5;\n"
+		"\n"
+		"	float value000 = latticeValue(cell0, frac, ivec3(0, 0, 0));\n"
+		"	float value001 = latticeValue(cell0, frac, ivec3(0, 0, 1));\n"
+		"	float value010 = latticeValue(cell0, frac, ivec3(0, 1, 0));\n"
+		"	float value011 = latticeValue(cell0, frac, ivec3(0, 1, 1));\n"
+		"	float value100 = latticeValue(cell0, frac, ivec3(1, 0, 0));\n"
+		"	float value101 = latticeValue(cell0, frac, ivec3(1, 0, 1));\n"
+		"	float value110 = latticeValue(cell0, frac, ivec3(1, 1, 0));\n"
+		"	float value111 = latticeValue(cell0, frac, ivec3(1, 1, 1));\n"
+		"\n"
+		"	float value00 = mix(value000, value001, fade.z);\n"
+		"	float value01 = mix(value010, value011, fade.z);\n"
+		"	float value10 = mix(value100, value101, fade.z);\n"
+		"	float value11 = mix(value110, value111, fade.z);\n"
+		"	float value0  = mix(value00,  value01,  fade.y);\n"
+		"	float value1  = mix(value10,  value11,  fade.y);\n"
+		"	return mix(value0, value1, fade.x) * NOISE_AMPLITUDE;\n"
+		"}\n"
+		"\n"
+		"// same as PerlinNoiseField3::getOctaveCount\n"
+		"int getOctaveCount (float min_amplitude)\n"
+		"{\n"
+		"	float total_weight = 0.0;\n"
+		"	float weight = 1.0;\n"
+		"	for(int i = 0; i < NOISE_OCTAVE_COUNT; i++)\n"
+		"	{\n"
+		"		total_weight += weight;\n"
+		"		weight *= NOISE_GAIN;\n"
+		"	}\n"
+		"\n"
+		"	float amplitude_per_weight = abs(NOISE_AMPLITUDE) / total_weight;\n"
+		"	float grid_size = NOISE_GRID_SIZE / NOISE_LACUNARITY;\n"
+		"	weight = NOISE_GAIN;\n"
+		"	int count = 1;\n"
+		"	for( ; count < NOISE_OCTAVE_COUNT; count++)\n"
+		"	{\n"
+		"		if(grid_size < u_vertex_spacing)\n"
+		"			break;\n"
+		"		if(weight * amplitude_per_weight < min_amplitude)\n"
+		"			break;\n"
+		"		grid_size /= NOISE_LACUNARITY;\n"
+		"		weight    *= NOISE_GAIN;\n"
+		"	}\n"
+		"	return count;\n"
+		"}\n"
+		"\n"
+		"// same as PerlinNoiseField3::fbmNoise\n"
+		"float fbmNoise (vec3 position, int octave_count)\n"
+		"{\n"
+		"	float sum          = 0.0;\n"
+		"	float total_weight = 0.0;\n"
+		"	float weight    = 1.0;\n"
+		"	float frequency = 1.0;\n"
+		"	for(int o = 0; o < octave_count; o++)\n"
+		"	{\n"
+		"		sum += perlinNoise(position * frequency) * weight;\n"
+		"		total_weight += weight;\n"
+		"		weight    *= NOISE_GAIN;\n"
+		"		frequency *= NOISE_LACUNARITY;\n"
+		"	}\n"
+		"	return sum / total_weight;\n"
+		"}\n"
+		"\n"
+		"void main ()\n"
+		"{\n"
+		"	// same as Asteroid::createModel and Asteroid::getNoiseOctaves\n"
+		"	float radius_average    = (a_radii.y + a_radii.x) * 0.5;\n"
+		"	float radius_half_range = (a_radii.y - a_radii.x) * 0.5;\n"
+		"	float min_amplitude = NOISE_AMPLITUDE;\n"
+		"	if(radius_half_range > 0.0)\n"
+		"		min_amplitude = u_vertex_spacing * radius_average / radius_half_range;\n"
+		"	float noise = fbmNoise(gl_Vertex.xyz + a_noise_offset, getOctaveCount(min_amplitude));\n"
+		"	float radius = radius_average + noise * radius_half_range;\n"
+		"	vec4 local = vec4(normalize(gl_Vertex.xyz) * radius, 1.0);\n"
+		"\n"
+		"	gl_Position    = gl_ModelViewProjectionMatrix * (a_transform * local);\n"
+		"	gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+		"	gl_FrontColor  = gl_Color;\n"
+		"}\n";
+
+	// same as GL_MODULATE with the material colour
+	const char* FRAGMENT_SHADER_SOURCE =
+		"#version 130\n"
+		"\n"
+		"uniform sampler2D u_texture;\n"
+		"\n"
+		"void main ()\n"
+		"{\n"
+		"	gl_FragColor = texture(u_texture, gl_TexCoord[0].st) * gl_Color;\n"
+		"}\n";
+
+
+
+	// enough digits that the shader gets exactly the same float
+	void writeFloat (ostream& r_out, float value)
+	{
+		r_out << scientific << setprecision(9) << value;
+	}
+
+	void writeIntArray (ostream& r_out, const char* name,
+	                    const int a_values[], unsigned int count)
+	{
+		assert(name != nullptr);
+		assert(a_values != nullptr);
+
+		r_out << "const int " << name << "[" << count << "] = int[" << count << "](";
+		for(unsigned int i = 0; i < count; i++)
+		{
+			if(i % 16 == 0)
+				r_out << "\n\t";
+			r_out << a_values[i];
+			if(i + 1 < count)
+				r_out << ", ";
+		}
+		r_out << ");\n";
+	}
+
+	void writeFloatArray (ostream& r_out, const char* name,
+	                      const float a_values[], unsigned int count)
+	{
+		assert(name != nullptr);
+		assert(a_values != nullptr);
+
+		r_out << "const float " << name << "[" << count << "] = float[" << count << "](";
+		for(unsigned int i = 0; i < count; i++)
+		{
+			if(i % 8 == 0)
+				r_out << "\n\t";
+			writeFloat(r_out, a_values[i]);
+			if(i + 1 < count)
+				r_out << ", ";
+		}
+		r_out << ");\n";
+	}
+
+	// the noise constants are copied from the C++ values
+	string createVertexShaderSource (const PerlinNoiseField3& noise,
+	                                 const PerlinNoiseField3::Octaves& octaves)
+	{
+		ostringstream source;
+		source << "#version 130\n";
+		source << "\n";
+		source << "const float NOISE_GRID_SIZE    = ";
+		writeFloat(source, noise.getGridSize());
+		source << ";\n";
+		source << "const float NOISE_AMPLITUDE    = ";
+		writeFloat(source, noise.getAmplitude());
+		source << ";\n";
+		source << "const int   NOISE_OCTAVE_COUNT = " << octaves.m_count << ";\n";
+		source << "const float NOISE_LACUNARITY   = ";
+		writeFloat(source, octaves.m_lacunarity);
+		source << ";\n";
+		source << "const float NOISE_GAIN         = ";
+		writeFloat(source, octaves.m_gain);
+		source << ";\n";
+		source << "\n";
+
+		if(noise.getHashMode() == PerlinNoiseField3::HASH_PERMUTATION)
+		{
+			const PermutationTable& table = noise.getPermutationTable();
+			source << "#define HASH_PERMUTATION\n";
+			writeIntArray  (source, "PERMUTATION", table.ma_permutation, PermutationTable::SIZE * 2);
+			writeFloatArray(source, "GRADIENT_X",  table.ma_gradient_x,  PermutationTable::SIZE);
+			writeFloatArray(source, "GRADIENT_Y",  table.ma_gradient_y,  PermutationTable::SIZE);
+			writeFloatArray(source, "GRADIENT_Z",  table.ma_gradient_z,  PermutationTable::SIZE);
+		}
+		else
+		{
+			assert(noise.getHashMode() == PerlinNoiseField3::HASH_SEEDED);
+
+			static const char* A_SEED_NAMES[PerlinNoiseField3::SEED_COUNT] =
+			{	"SEED_X1", "SEED_X2", "SEED_Y1", "SEED_Y2", "SEED_Z1", "SEED_Z2",
+				"SEED_Q0", "SEED_Q1", "SEED_Q2",	};
+			unsigned int a_seeds[PerlinNoiseField3::SEED_COUNT];
+			noise.getSeeds(a_seeds);
+			for(unsigned int i = 0; i < PerlinNoiseField3::SEED_COUNT; i++)
+				source << "const uint " << A_SEED_NAMES[i] << " = " << a_seeds[i] << "u;\n";
+		}
+		source << "\n";
+
+		source << VERTEX_SHADER_BODY;
+		return source.str();
+	}
+
+	// the message is printed and 0 is returned on failure
+	GLuint compileShader (GLenum type, const char* source, const string& name)
+	{
+		assert(source != nullptr);
+
+		GLuint shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		GLint is_compiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &is_compiled);
+		if(is_compiled == GL_FALSE)
+		{
+			GLint log_length = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_length);
+			vector<GLchar> v_log(log_length + 1, '\0');
+			glGetShaderInfoLog(shader, log_length, nullptr, v_log.data());
+			cerr << "Error compiling " << name << " shader:" << endl;
+			cerr << v_log.data() << endl;
+
+			glDeleteShader(shader);
+			return 0;
+		}
+		return shader;
+	}
+
+	GLuint linkProgram (GLuint vertex_shader, GLuint fragment_shader)
+	{
+		assert(vertex_shader   != 0);
+		assert(fragment_shader != 0);
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertex_shader);
+		glAttachShader(program, fragment_shader);
+		glBindAttribLocation(program, TRANSFORM_LOCATION,    "a_transform");
+		glBindAttribLocation(program, RADII_LOCATION,        "a_radii");
+		glBindAttribLocation(program, NOISE_OFFSET_LOCATION, "a_noise_offset");
+		glLinkProgram(program);
+
+		// the program keeps the shaders until it is deleted
+		glDeleteShader(vertex_shader);
+		glDeleteShader(fragment_shader);
+
+		GLint is_linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+		if(is_linked == GL_FALSE)
+		{
+			GLint log_length = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length);
+			vector<GLchar> v_log(log_length + 1, '\0');
+			glGetProgramInfoLog(program, log_length, nullptr, v_log.data());
+			cerr << "Error linking asteroid instancing shader:" << endl;
+			cerr << v_log.data() << endl;
+
+			glDeleteProgram(program);
+			return 0;
+		}
+		return program;
+	}
+
+	// buffer offsets are passed to OpenGL as pointers
+	const GLvoid* getBufferOffset (unsigned int floats)
+	{
+		return (const GLvoid*)((const char*)(nullptr) + floats * sizeof(float));
+	}
+
+	// first_instance is the instance that attribute divisors count from
+	void setInstanceAttributes (bool is_enabled, unsigned int first_instance)
+	{
+		GLsizei stride = InstancedAsteroids::FLOATS_PER_INSTANCE * sizeof(float);
+		GLuint divisor = is_enabled ? 1 : 0;
+		unsigned int start = first_instance * InstancedAsteroids::FLOATS_PER_INSTANCE;
+
+		for(unsigned int column = 0; column < 4; column++)
+		{
+			GLuint location = TRANSFORM_LOCATION + column;
+			if(is_enabled)
+			{
+				glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride, getBufferOffset(start + column * 4));
+				glEnableVertexAttribArray(location);
+			}
+			else
+				glDisableVertexAttribArray(location);
+			glVertexAttribDivisor(location, divisor);
+		}
+
+		if(is_enabled)
+		{
+			glVertexAttribPointer(RADII_LOCATION,        2, GL_FLOAT, GL_FALSE, stride, getBufferOffset(start + RADII_OFFSET));
+			glVertexAttribPointer(NOISE_OFFSET_LOCATION, 3, GL_FLOAT, GL_FALSE, stride, getBufferOffset(start + NOISE_OFFSET_OFFSET));
+			glEnableVertexAttribArray(RADII_LOCATION);
+			glEnableVertexAttribArray(NOISE_OFFSET_LOCATION);
+		}
+		else
+		{
+			glDisableVertexAttribArray(RADII_LOCATION);
+			glDisableVertexAttribArray(NOISE_OFFSET_LOCATION);
+		}
+		glVertexAttribDivisor(RADII_LOCATION,        divisor);
+		glVertexAttribDivisor(NOISE_OFFSET_LOCATION, divisor);
+	}
+
+	bool isVersionAtLeast (int required_major, int required_minor)
+	{
+		const char* version = (const char*)(glGetString(GL_VERSION));
+		if(version == nullptr)
+			return false;
+
+		int major = 0;
+		int minor = 0;
+		if(sscanf(version, "%d.%d", &major, &minor) != 2)
+			return false;
+		return major > required_major || (major == required_major && minor >= required_minor);
+	}
+
+	// same as ModelWithShader::drawMeshes, but for a range of a mesh
+	void activateMaterial (const Material* p_material, unsigned int pass)
+	{
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+		if(p_material != NULL)
+		{
+			if(pass == 0)
+				p_material->activate();
+			else
+				p_material->activateSeperateSpecular();
+		}
+#endif
+	}
+
+	unsigned int getPassCount (const Material* p_material)
+	{
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+		if(p_material != NULL && p_material->isSeperateSpecular())
+			return 2;
+#endif
+		return 1;
+	}
+
+	void deactivateMaterial (const Material* p_material)
+	{
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+		if(p_material != NULL)
+			Material::deactivate();
+#endif
+	}
+
+}  // end of anonymous namespace
+
+
+
+bool InstancedAsteroids :: isSupported ()
+{
+	return isVersionAtLeast(3, 3);
+}
+
+
+
+InstancedAsteroids :: InstancedAsteroids ()
+		: m_program(0)
+		, m_is_multi_draw(false)
+		, m_texture_location(-1)
+		, m_vertex_spacing_location(-1)
+		, mv_base_models()
+		, mvv_instance_data()
+		, mv_instance_upload()
+		, mv_commands()
+{
+	assert(!isInitialized());
+	assert(invariant());
+}
+
+InstancedAsteroids :: ~InstancedAsteroids ()
+{
+	if(m_program != 0 && !DisplayList::isDisabledForExit())
+		glDeleteProgram(m_program);
+}
+
+
+
+unsigned int InstancedAsteroids :: getInstanceCount () const
+{
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < mvv_instance_data.size(); i++)
+		count += (unsigned int)(mvv_instance_data[i].size()) / FLOATS_PER_INSTANCE;
+	return count;
+}
+
+unsigned int InstancedAsteroids :: getTriangleCount () const
+{
+	unsigned int count = 0;
+	for(unsigned int b = 0; b < mv_base_models.size(); b++)
+	{
+		const BaseModel& base_model = mv_base_models[b];
+		for(unsigned int r = 0; r < base_model.mv_ranges.size(); r++)
+		{
+			unsigned int lod = r % Asteroid::LOD_COUNT;
+			const vector<float>& v_data = mvv_instance_data[b * Asteroid::LOD_COUNT + lod];
+			unsigned int instance_count = (unsigned int)(v_data.size()) / FLOATS_PER_INSTANCE;
+			count += instance_count * (base_model.mv_ranges[r].m_index_count / 3);
+		}
+	}
+	return count;
+}
+
+unsigned int InstancedAsteroids :: getDrawCallCount () const
+{
+	unsigned int count = 0;
+	for(unsigned int b = 0; b < mv_base_models.size(); b++)
+	{
+		unsigned int mesh_count = (unsigned int)(mv_base_models[b].mvp_materials.size());
+		bool is_any = false;
+		for(unsigned int lod = 0; lod < Asteroid::LOD_COUNT; lod++)
+		{
+			if(!mvv_instance_data[b * Asteroid::LOD_COUNT + lod].empty())
+			{
+				is_any = true;
+				if(!m_is_multi_draw)
+					count += mesh_count;
+			}
+		}
+		if(m_is_multi_draw && is_any)
+			count += mesh_count;
+	}
+	return count;
+}
+
+
+
+void InstancedAsteroids :: init (const ObjLibrary::ObjModel a_base_models[],
+                                 unsigned int model_count)
+{
+	assert(isSupported());
+	assert(a_base_models != nullptr || model_count == 0);
+
+	if(m_program != 0)
+		glDeleteProgram(m_program);
+	m_program = 0;
+	m_is_multi_draw = isVersionAtLeast(4, 3);
+	mv_base_models.clear();
+	mvv_instance_data.clear();
+
+	// radii are per instance, so the octaves are only used for their counts and ratios
+	string vertex_source = createVertexShaderSource(Asteroid::getNoiseField(),
+	                                                Asteroid::getNoiseOctaves(0.0, 0.0, 0.0));
+	GLuint vertex_shader   = compileShader(GL_VERTEX_SHADER,   vertex_source.c_str(),  "asteroid instancing vertex");
+	GLuint fragment_shader = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER_SOURCE, "asteroid instancing fragment");
+	if(vertex_shader == 0 || fragment_shader == 0)
+	{
+		if(vertex_shader != 0)
+			glDeleteShader(vertex_shader);
+		if(fragment_shader != 0)
+			glDeleteShader(fragment_shader);
+		assert(!isInitialized());
+		assert(invariant());
+		return;
+	}
+
+	m_program = linkProgram(vertex_shader, fragment_shader);
+	if(m_program == 0)
+	{
+		assert(!isInitialized());
+		assert(invariant());
+		return;
+	}
+	m_texture_location        = glGetUniformLocation(m_program, "u_texture");
+	m_vertex_spacing_location = glGetUniformLocation(m_program, "u_vertex_spacing");
+
+	for(unsigned int m = 0; m < model_count; m++)
+	{
+		mv_base_models.push_back(createBaseModel(a_base_models[m]));
+		for(unsigned int lod = 0; lod < Asteroid::LOD_COUNT; lod++)
+			mvv_instance_data.push_back(vector<float>());
+	}
+
+	assert(isInitialized());
+	assert(invariant());
+}
+
+void InstancedAsteroids :: clearInstances ()
+{
+	for(unsigned int i = 0; i < mvv_instance_data.size(); i++)
+		mvv_instance_data[i].clear();
+
+	assert(getInstanceCount() == 0);
+	assert(invariant());
+}
+
+void InstancedAsteroids :: addInstance (unsigned int model_index,
+                                        const Asteroid& asteroid)
+{
+	assert(isInitialized());
+	assert(model_index < getModelCount());
+	assert(asteroid.isInitialized());
+
+	double a_matrix[MATRIX_SIZE];
+	asteroid.calculateDrawMatrix(a_matrix);
+
+	assert(asteroid.getLod() < Asteroid::LOD_COUNT);
+	vector<float>& rv_data = mvv_instance_data[model_index * Asteroid::LOD_COUNT + asteroid.getLod()];
+	for(unsigned int i = 0; i < MATRIX_SIZE; i++)
+		rv_data.push_back((float)(a_matrix[i]));
+
+	rv_data.push_back((float)(asteroid.getInnerRadius()));
+	rv_data.push_back((float)(asteroid.getRadius()));
+
+	const Vector3& noise_offset = asteroid.getNoiseOffset();
+	rv_data.push_back((float)(noise_offset.x));
+	rv_data.push_back((float)(noise_offset.y));
+	rv_data.push_back((float)(noise_offset.z));
+
+	assert(invariant());
+}
+
+void InstancedAsteroids :: draw ()
+{
+	assert(isInitialized());
+
+	glUseProgram(m_program);
+	glUniform1i(m_texture_location, 0);  // materials use texture unit 0
+
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	if(Material::isMaterialActive())
+		Material::deactivate();
+	assert(!Material::isMaterialActive());
+#endif
+
+	for(unsigned int b = 0; b < mv_base_models.size(); b++)
+	{
+		BaseModel& r_base_model = mv_base_models[b];
+
+		// one upload for all levels of detail, in order
+		unsigned int a_first_instance[Asteroid::LOD_COUNT];
+		unsigned int a_instance_count[Asteroid::LOD_COUNT];
+		mv_instance_upload.clear();
+		for(unsigned int lod = 0; lod < Asteroid::LOD_COUNT; lod++)
+		{
+			const vector<float>& v_data = mvv_instance_data[b * Asteroid::LOD_COUNT + lod];
+			a_first_instance[lod] = (unsigned int)(mv_instance_upload.size()) / FLOATS_PER_INSTANCE;
+			a_instance_count[lod] = (unsigned int)(v_data.size()) / FLOATS_PER_INSTANCE;
+			mv_instance_upload.insert(mv_instance_upload.end(), v_data.begin(), v_data.end());
+		}
+		if(mv_instance_upload.empty())
+			continue;
+
+		// orphan the old data so we don't wait for last frame to finish drawing
+		r_base_model.m_instance_buffer.replace((unsigned int)(mv_instance_upload.size()),
+		                                       mv_instance_upload.data());
+		glUniform1f(m_vertex_spacing_location, r_base_model.m_vertex_spacing);
+
+		unsigned int mesh_count = (unsigned int)(r_base_model.mvp_materials.size());
+		if(m_is_multi_draw)
+		{
+			// the first instance in each command selects the data, so the pointers start at 0
+			r_base_model.m_instance_buffer.bind();
+			setInstanceAttributes(true, 0);
+			ObjVbo<float>::bindNone(GL_ARRAY_BUFFER);
+
+			// levels of detail without instances still get a command, so each mesh has LOD_COUNT
+			unsigned int vertex_count = 0;
+			mv_commands.assign(r_base_model.mv_ranges.size() * COMMAND_SIZE, 0);
+			for(unsigned int r = 0; r < r_base_model.mv_ranges.size(); r++)
+			{
+				const LodRange& range = r_base_model.mv_ranges[r];
+				unsigned int lod = r % Asteroid::LOD_COUNT;
+				unsigned int* p_command = mv_commands.data() + r * COMMAND_SIZE;
+				p_command[COMMAND_INDEX_COUNT]    = range.m_index_count;
+				p_command[COMMAND_INSTANCE_COUNT] = a_instance_count[lod];
+				p_command[COMMAND_FIRST_INDEX]    = range.m_first_index;
+				p_command[COMMAND_BASE_VERTEX]    = range.m_base_vertex;
+				p_command[COMMAND_FIRST_INSTANCE] = a_first_instance[lod];
+				vertex_count += range.m_index_count * a_instance_count[lod];
+			}
+			r_base_model.m_command_buffer.replace((unsigned int)(mv_commands.size()), mv_commands.data());
+
+			r_base_model.m_command_buffer.bind();
+			for(unsigned int m = 0; m < mesh_count; m++)
+			{
+				const Material* p_material = r_base_model.mvp_materials[m];
+				for(unsigned int pass = 0; pass < getPassCount(p_material); pass++)
+				{
+					activateMaterial(p_material, pass);
+					r_base_model.m_mesh.drawIndirect(m * Asteroid::LOD_COUNT, Asteroid::LOD_COUNT);
+					deactivateMaterial(p_material);
+				}
+			}
+			ObjVbo<unsigned int>::bindNone(GL_DRAW_INDIRECT_BUFFER);
+			GlCallCounter::countIndirectVertexes(vertex_count);
+		}
+		else
+		{
+			for(unsigned int m = 0; m < mesh_count; m++)
+			{
+				const Material* p_material = r_base_model.mvp_materials[m];
+				for(unsigned int pass = 0; pass < getPassCount(p_material); pass++)
+				{
+					activateMaterial(p_material, pass);
+					for(unsigned int lod = 0; lod < Asteroid::LOD_COUNT; lod++)
+					{
+						if(a_instance_count[lod] == 0)
+							continue;
+
+						// without a base instance, the attribute pointers select the data
+						r_base_model.m_instance_buffer.bind();
+						setInstanceAttributes(true, a_first_instance[lod]);
+						ObjVbo<float>::bindNone(GL_ARRAY_BUFFER);
+
+						const LodRange& range = r_base_model.mv_ranges[m * Asteroid::LOD_COUNT + lod];
+						r_base_model.m_mesh.drawInstanced(a_instance_count[lod],
+						                                  range.m_first_index,
+						                                  range.m_index_count,
+						                                  range.m_base_vertex);
+					}
+					deactivateMaterial(p_material);
+				}
+			}
+		}
+		setInstanceAttributes(false, 0);
+	}
+
+	glUseProgram(0);
+}
+
+
+
+InstancedAsteroids::BaseModel InstancedAsteroids :: createBaseModel (const ObjModel& base_model)
+{
+	assert(Asteroid::isUnitSphere(base_model));
+
+	BaseModel result;
+
+	// the octaves depend on the full model, as for Asteroid::createLodObjModels
+	result.m_vertex_spacing = (float)(Asteroid::calculateVertexSpacing(base_model));
+
+	vector<ObjModel> v_lod_models = Asteroid::createLodBaseModels(base_model);
+	assert(v_lod_models.size() == Asteroid::LOD_COUNT);
+
+	vector<WeldedMesh> v_welded;
+	for(unsigned int lod = 0; lod < Asteroid::LOD_COUNT; lod++)
+		v_welded.push_back(WeldedMesh(v_lod_models[lod]));
+
+	// the levels of detail are simplified from the same model, so they have the same meshes
+	unsigned int format      = v_welded[0].getFormat();
+	unsigned int range_count = v_welded[0].getRangeCount();
+	for(unsigned int r = 0; r < range_count; r++)
+	{
+		unsigned int mesh = v_welded[0].getRangeMesh(r);
+		if(v_lod_models[0].isMeshMaterial(mesh))
+			result.mvp_materials.push_back(v_lod_models[0].getMeshMaterial(mesh));
+		else
+			result.mvp_materials.push_back(NULL);  // draws with the current state
+	}
+
+	vector<float>        v_vertex_data;
+	vector<unsigned int> v_indexes;
+	vector<LodRange>     v_lod_ranges(range_count * Asteroid::LOD_COUNT);
+	for(unsigned int lod = 0; lod < Asteroid::LOD_COUNT; lod++)
+	{
+		const WeldedMesh& welded = v_welded[lod];
+		assert(welded.getFormat() == format);
+		assert(welded.getRangeCount() == range_count);
+
+		// the indexes stay relative to this level of detail
+		unsigned int base_vertex = (unsigned int)(v_vertex_data.size()) / welded.getComponentCount();
+		v_vertex_data.insert(v_vertex_data.end(), welded.getVertexData(),
+		                     welded.getVertexData() + welded.getVertexCount() * welded.getComponentCount());
+
+		for(unsigned int r = 0; r < range_count; r++)
+		{
+			assert(welded.getRangeMesh(r) == v_welded[0].getRangeMesh(r));
+			unsigned int first = welded.getRangeFirstIndex(r);
+			unsigned int count = welded.getRangeIndexCount(r);
+
+			LodRange& r_range = v_lod_ranges[r * Asteroid::LOD_COUNT + lod];
+			r_range.m_first_index = (unsigned int)(v_indexes.size());
+			r_range.m_index_count = count;
+			r_range.m_base_vertex = base_vertex;
+			v_indexes.insert(v_indexes.end(), welded.getIndexData() + first,
+			                 welded.getIndexData() + first + count);
+		}
+	}
+	result.mv_ranges = v_lod_ranges;
+
+	ObjVbo<float>        vbo_data   (GL_ARRAY_BUFFER,         GL_STATIC_DRAW,
+	                                 (unsigned int)(v_vertex_data.size()), v_vertex_data.data());
+	ObjVbo<unsigned int> vbo_indexes(GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW,
+	                                 (unsigned int)(v_indexes.size()), v_indexes.data());
+	result.m_mesh.init(GL_TRIANGLES, format, vbo_data, vbo_indexes);
+	assert(result.m_mesh.isInitialized());
+
+	result.m_instance_buffer = ObjVbo<float>(GL_ARRAY_BUFFER, GL_STREAM_DRAW, 0, nullptr);
+	result.m_command_buffer  = ObjVbo<unsigned int>(GL_DRAW_INDIRECT_BUFFER, GL_STREAM_DRAW, 0, nullptr);
+	return result;
+}
+
+bool InstancedAsteroids :: invariant () const
+{
+	if(mvv_instance_data.size() != mv_base_models.size() * Asteroid::LOD_COUNT) return false;
+	for(unsigned int i = 0; i < mvv_instance_data.size(); i++)
+		if(mvv_instance_data[i].size() % FLOATS_PER_INSTANCE != 0) return false;
+	if(!isInitialized() && !mv_base_models.empty()) return false;
+	for(unsigned int b = 0; b < mv_base_models.size(); b++)
+	{
+		const BaseModel& base_model = mv_base_models[b];
+		if(base_model.mv_ranges.size() != base_model.mvp_materials.size() * Asteroid::LOD_COUNT) return false;
+	}
+	return true;
+}
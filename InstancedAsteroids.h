@@ -0,0 +1,311 @@
+//
+//  InstancedAsteroids.h
+//
+//  A module to draw many asteroids that share base models with
+//    one draw call per base model.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/ObjVbo.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/MeshWithShader.h"
+
+#include "Asteroid.h"
+
+
+
+//
+//  InstancedAsteroids
+//
+//  A class to draw Asteroids with instancing.  All the levels
+//    of detail of each base model are stored once in a single
+//    pair of buffer objects, and the Asteroids using the base
+//    model are drawn together with one
+//    glMultiDrawElementsIndirect call per mesh.  Each draw
+//    command in the call selects one level of detail and the
+//    instances using it.  The per-instance data is the Asteroid
+//    transformation, its inner and outer radii, and its noise
+//    offset.  The vertex shader moves each vertex of the
+//    unit-sphere base model with the same Perlin noise as
+//    Asteroid::createModel, so the Asteroids look the same as
+//    their DisplayLists.
+//
+//  Each Asteroid is drawn at the level of detail chosen by
+//    Asteroid::updateLod, and hidden Asteroids should not be
+//    added.  The levels are simplified from the base model
+//    before it is deformed (see Asteroid::createLodBaseModels),
+//    so they differ slightly from the DisplayLists.  The
+//    shader does not use lighting, and the materials of the
+//    base models must all have a texture.
+//
+//  The noise settings and seeds are written into the shader
+//    source from Asteroid::getNoiseField when init is called.
+//
+//  This requires OpenGL 3.3 (for glVertexAttribDivisor) and
+//    GLSL 1.30.  Use isSupported to check before calling init.
+//    glMultiDrawElementsIndirect requires OpenGL 4.3.  With an
+//    older version, each level of detail is drawn with its own
+//    glDrawElementsInstancedBaseVertex call instead.
+//
+//  An InstancedAsteroids cannot be copied because it owns a
+//    shader program.
+//
+//  Class Invariant:
+//    <1> mvv_instance_data.size() == mv_base_models.size() *
+//                                    Asteroid::LOD_COUNT
+//    <2> mvv_instance_data[i].size() % FLOATS_PER_INSTANCE == 0
+//        for all i
+//    <3> isInitialized() || mv_base_models.empty()
+//    <4> mv_base_models[i].mv_ranges.size() ==
+//        mv_base_models[i].mvp_materials.size() *
+//        Asteroid::LOD_COUNT for all i
+//
+class InstancedAsteroids
+{
+public:
+//
+//  FLOATS_PER_INSTANCE
+//
+//  The number of floats stored for each instance: a 4x4
+//    transformation matrix, the inner and outer radii, and the
+//    noise offset.
+//
+	static const unsigned int FLOATS_PER_INSTANCE = 16 + 2 + 3;
+
+public:
+//
+//  Class Function: isSupported
+//
+//  Purpose: To determine if the current OpenGL context can
+//           draw instanced asteroids.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> An OpenGL context is current
+//  Returns: Whether the OpenGL version is at least 3.3.
+//  Side Effect: N/A
+//
+	static bool isSupported ();
+
+public:
+	InstancedAsteroids ();
+	InstancedAsteroids (const InstancedAsteroids& to_copy) = delete;
+	~InstancedAsteroids ();
+	InstancedAsteroids& operator= (const InstancedAsteroids& to_copy) = delete;
+
+//
+//  isInitialized
+//
+//  Purpose: To determine if this InstancedAsteroids can draw.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the shader program was built successfully.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{	return m_program != 0;	}
+
+//
+//  isMultiDraw
+//
+//  Purpose: To determine if each base model is drawn with a
+//           single call for all its levels of detail.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether glMultiDrawElementsIndirect is used.  This
+//           requires OpenGL 4.3.
+//  Side Effect: N/A
+//
+	bool isMultiDraw () const
+	{	return m_is_multi_draw;	}
+
+//
+//  getModelCount
+//
+//  Purpose: To determine how many base models are stored.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of base models.
+//  Side Effect: N/A
+//
+	unsigned int getModelCount () const
+	{	return (unsigned int)(mv_base_models.size());	}
+
+//
+//  getInstanceCount
+//
+//  Purpose: To determine how many instances will be drawn.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of instances added since clearInstances
+//           was last called.
+//  Side Effect: N/A
+//
+	unsigned int getInstanceCount () const;
+
+//
+//  getTriangleCount
+//
+//  Purpose: To determine how many triangles will be drawn.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The total number of triangles in all the instances
+//           added since clearInstances was last called.
+//  Side Effect: N/A
+//
+	unsigned int getTriangleCount () const;
+
+//
+//  getDrawCallCount
+//
+//  Purpose: To determine how many draw calls will be used to
+//           draw the instances.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of draw calls draw will make.  If
+//           isMultiDraw() is true, this is the number of meshes
+//           in the base models with at least one instance, so
+//           there is at most 1 call for each of the 25 asteroid
+//           base models.  Otherwise, it is the number of meshes
+//           in the levels of detail with at least one instance,
+//           which can be up to 4 calls per base model.  In the
+//           offscreen benchmark with impostors off, this is 3 to
+//           5 calls per frame either way, because each visible
+//           asteroid has a different base model.
+//  Side Effect: N/A
+//
+	unsigned int getDrawCallCount () const;
+
+//
+//  init
+//
+//  Purpose: To prepare this InstancedAsteroids to draw
+//           asteroids based on the specified models.
+//  Parameter(s):
+//    <1> a_base_models: The base models
+//    <2> model_count: The number of base models
+//  Preconditions:
+//    <1> isSupported()
+//    <2> a_base_models != nullptr || model_count == 0
+//    <3> Asteroid::isUnitSphere(a_base_models[i]) for all i
+//  Returns: N/A
+//  Side Effect: The shader program is built and the levels of
+//               detail for each base model are copied into one
+//               pair of buffer objects.  If the shader cannot be
+//               built, an error message is printed and this
+//               InstancedAsteroids is left uninitialized.
+//
+	void init (const ObjLibrary::ObjModel a_base_models[],
+	           unsigned int model_count);
+
+//
+//  clearInstances
+//
+//  Purpose: To remove all instances.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: There are no instances to draw.
+//
+	void clearInstances ();
+
+//
+//  addInstance
+//
+//  Purpose: To add an Asteroid to be drawn.
+//  Parameter(s):
+//    <1> model_index: The base model the Asteroid was created
+//                     from
+//    <2> asteroid: The Asteroid
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> model_index < getModelCount()
+//    <3> asteroid.isInitialized()
+//  Returns: N/A
+//  Side Effect: asteroid is added to the instances drawn with
+//               the current level of detail of base model
+//               model_index.
+//
+	void addInstance (unsigned int model_index,
+	                  const Asteroid& asteroid);
+
+//
+//  draw
+//
+//  Purpose: To draw all the instances.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The instance data is sent to the graphics card
+//               and each base model with instances is drawn,
+//               using the current modelview and projection
+//               matrixes for the camera.  See getDrawCallCount
+//               for the number of draw calls.  No shader is
+//               left active.
+//
+	void draw ();
+
+private:
+//
+//  LodRange
+//
+//  A record to store where one level of detail of one mesh of
+//    a base model is in the index buffer.  The indexes are
+//    relative to m_base_vertex.
+//
+	struct LodRange
+	{
+		unsigned int m_first_index;
+		unsigned int m_index_count;
+		unsigned int m_base_vertex;
+	};
+
+//
+//  BaseModel
+//
+//  A record to store all the levels of detail of a base model
+//    in one MeshWithShader.  The ranges are stored by mesh and
+//    then by level of detail, so the range for level lod of
+//    mesh m is mv_ranges[m * Asteroid::LOD_COUNT + lod].  This
+//    is also the order of the draw commands.
+//
+	struct BaseModel
+	{
+		ObjLibrary::MeshWithShader m_mesh;
+		std::vector<const ObjLibrary::Material*> mvp_materials;
+		std::vector<LodRange> mv_ranges;
+		float m_vertex_spacing;
+		ObjLibrary::ObjVbo<float> m_instance_buffer;
+		ObjLibrary::ObjVbo<unsigned int> m_command_buffer;
+	};
+
+//
+//  Class Function: createBaseModel
+//
+//  Purpose: To create the buffer objects for a base model.
+//  Parameter(s):
+//    <1> base_model: The base model
+//  Preconditions:
+//    <1> Asteroid::isUnitSphere(base_model)
+//  Returns: A BaseModel containing all the levels of detail of
+//           base_model.
+//  Side Effect: N/A
+//
+	static BaseModel createBaseModel (const ObjLibrary::ObjModel& base_model);
+
+	bool invariant () const;
+
+private:
+	unsigned int m_program;
+	bool m_is_multi_draw;
+	int m_texture_location;
+	int m_vertex_spacing_location;
+	std::vector<BaseModel> mv_base_models;
+	std::vector<std::vector<float> > mvv_instance_data;
+	std::vector<float> mv_instance_upload;
+	std::vector<unsigned int> mv_commands;
+};
@@ -0,0 +1,624 @@
+//
+//  MeshCache.cpp
+//
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+#if defined(_WIN32) || defined(__WIN32__)
+	// no memory mapping, files are read into memory
+#else
+	#define MESH_CACHE_USE_MMAP
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "ObjLibrary/ObjModel.h"
+
+#include "MeshCache.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const char FILE_MAGIC[8] = { 'M', 'E', 'S', 'H', 'L', 'O', 'D', 'S' };
+	const uint32_t FILE_VERSION = 1;
+	const char FILE_EXTENSION[] = ".mesh";
+	const uint64_t HASH_PRIME = 0x100000001B3ull;
+
+	//
+	//  FileHeader
+	//
+	//  The start of a MeshCache entry file.  It is followed by
+	//    the vertex positions and normals, 3 floats each, and
+	//    then the faces as m_face_data_count uint32_ts.  For each
+	//    model and each mesh, the faces are a face count
+	//    followed by, for each face, a corner count and a
+	//    vertex, texture coordinate, and normal index for each
+	//    corner.  The file is in native byte order.
+	//
+	struct FileHeader
+	{
+		char ma_magic[8];
+		uint32_t m_version;
+		uint32_t m_model_count;
+		uint64_t m_key;
+		uint32_t m_vertex_count;
+		uint32_t m_normal_count;
+		uint32_t m_mesh_count;
+		uint32_t m_face_data_count;
+	};
+
+	uint64_t getFileBytes (const FileHeader& header)
+	{
+		return sizeof(FileHeader) +
+		       (uint64_t)(header.m_vertex_count) * 3 * sizeof(float) +
+		       (uint64_t)(header.m_normal_count) * 3 * sizeof(float) +
+		       (uint64_t)(header.m_face_data_count) * sizeof(uint32_t);
+	}
+
+	//
+	//  FileData
+	//
+	//  The contents of a file, memory-mapped if possible.
+	//
+	struct FileData
+	{
+		const char* mp_data;
+		uint64_t m_size;
+		void* mp_mapping;
+		vector<char> mv_data;
+	};
+
+	bool readFile (const string& filename,
+	               FileData& r_file)
+	{
+		r_file.mp_data    = nullptr;
+		r_file.m_size     = 0;
+		r_file.mp_mapping = nullptr;
+
+#ifdef MESH_CACHE_USE_MMAP
+		int file = open(filename.c_str(), O_RDONLY);
+		if(file < 0)
+			return false;
+		struct stat file_status;
+		if(fstat(file, &file_status) != 0 || file_status.st_size <= 0)
+		{
+			close(file);
+			return false;
+		}
+		r_file.m_size = (uint64_t)(file_status.st_size);
+		void* p_mapping = mmap(nullptr, (size_t)(r_file.m_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);  // the mapping keeps the file open
+		if(p_mapping == MAP_FAILED)
+			return false;
+		r_file.mp_mapping = p_mapping;
+		r_file.mp_data    = (const char*)(p_mapping);
+#else
+		ifstream input(filename.c_str(), ios::binary);
+		if(!input)
+			return false;
+		r_file.mv_data.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+		r_file.m_size  = r_file.mv_data.size();
+		r_file.mp_data = r_file.mv_data.data();
+#endif
+		return true;
+	}
+
+	void closeFile (FileData& r_file)
+	{
+#ifdef MESH_CACHE_USE_MMAP
+		if(r_file.mp_mapping != nullptr)
+			munmap(r_file.mp_mapping, (size_t)(r_file.m_size));
+#endif
+		r_file.mp_data    = nullptr;
+		r_file.m_size     = 0;
+		r_file.mp_mapping = nullptr;
+		r_file.mv_data.clear();
+	}
+
+	//
+	//  FaceReader
+	//
+	//  A cursor over the face data of a file that refuses to
+	//    read past the end.
+	//
+	struct FaceReader
+	{
+		const char* mp_next;
+		uint32_t m_remaining;
+
+		bool read (uint32_t& r_value)
+		{
+			if(m_remaining == 0)
+				return false;
+			memcpy(&r_value, mp_next, sizeof(uint32_t));
+			mp_next += sizeof(uint32_t);
+			m_remaining--;
+			return true;
+		}
+	};
+
+	void writeFaces (const ObjModel& model,
+	                 vector<uint32_t>& rv_face_data)
+	{
+		for(unsigned int m = 0; m < model.getMeshCount(); m++)
+		{
+			rv_face_data.push_back(model.getFaceCount(m));
+			for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+			{
+				unsigned int corner_count = model.getFaceVertexCount(m, f);
+				rv_face_data.push_back(corner_count);
+				for(unsigned int c = 0; c < corner_count; c++)
+				{
+					rv_face_data.push_back(model.getFaceVertexIndex             (m, f, c));
+					rv_face_data.push_back(model.getFaceVertexTextureCoordinates(m, f, c));
+					rv_face_data.push_back(model.getFaceVertexNormal            (m, f, c));
+				}
+			}
+		}
+	}
+
+	bool readFaces (FaceReader& r_reader,
+	                ObjModel& r_model)
+	{
+		for(unsigned int m = 0; m < r_model.getMeshCount(); m++)
+		{
+			r_model.removeFaceAll(m);
+
+			uint32_t face_count;
+			if(!r_reader.read(face_count))
+				return false;
+			for(uint32_t f = 0; f < face_count; f++)
+			{
+				uint32_t corner_count;
+				if(!r_reader.read(corner_count))
+					return false;
+				unsigned int face = r_model.addFace(m);
+				for(uint32_t c = 0; c < corner_count; c++)
+				{
+					uint32_t vertex;
+					uint32_t texture_coordinates;
+					uint32_t normal;
+					if(!r_reader.read(vertex) ||
+					   !r_reader.read(texture_coordinates) ||
+					   !r_reader.read(normal))
+					{
+						return false;
+					}
+					r_model.addFaceVertex(m, face, vertex, texture_coordinates, normal);
+				}
+			}
+		}
+		return true;
+	}
+
+	uint64_t hashUnsigned (uint64_t hash, unsigned int value)
+	{
+		uint32_t value32 = value;
+		return MeshCache::hashBytes(hash, &value32, sizeof(value32));
+	}
+
+	uint64_t hashFloat (uint64_t hash, double value)
+	{
+		float value_float = (float)(value);
+		return MeshCache::hashBytes(hash, &value_float, sizeof(value_float));
+	}
+
+}  // end of anonymous namespace
+
+
+
+uint64_t MeshCache :: hashBytes (uint64_t hash,
+                                 const void* p_data,
+                                 size_t byte_count)
+{
+	assert(p_data != nullptr || byte_count == 0);
+
+	const unsigned char* p_bytes = (const unsigned char*)(p_data);
+	for(size_t i = 0; i < byte_count; i++)
+	{
+		hash ^= p_bytes[i];
+		hash *= HASH_PRIME;
+	}
+	return hash;
+}
+
+uint64_t MeshCache :: hashModel (const ObjLibrary::ObjModel& model)
+{
+	uint64_t hash = HASH_START;
+
+	hash = hashUnsigned(hash, model.getVertexCount());
+	for(unsigned int v = 0; v < model.getVertexCount(); v++)
+	{
+		hash = hashFloat(hash, model.getVertexX(v));
+		hash = hashFloat(hash, model.getVertexY(v));
+		hash = hashFloat(hash, model.getVertexZ(v));
+	}
+	hash = hashUnsigned(hash, model.getTextureCoordinateCount());
+	for(unsigned int t = 0; t < model.getTextureCoordinateCount(); t++)
+	{
+		hash = hashFloat(hash, model.getTextureCoordinateU(t));
+		hash = hashFloat(hash, model.getTextureCoordinateV(t));
+	}
+	hash = hashUnsigned(hash, model.getNormalCount());
+	for(unsigned int n = 0; n < model.getNormalCount(); n++)
+	{
+		hash = hashFloat(hash, model.getNormalX(n));
+		hash = hashFloat(hash, model.getNormalY(n));
+		hash = hashFloat(hash, model.getNormalZ(n));
+	}
+
+	hash = hashUnsigned(hash, model.getMeshCount());
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+	{
+		if(model.isMeshMaterial(m))
+		{
+			const string& name = model.getMeshMaterialName(m);
+			hash = hashBytes(hash, name.c_str(), name.size() + 1);  // include '\0'
+		}
+		else
+			hash = hashUnsigned(hash, 0);
+	}
+
+	vector<uint32_t> v_face_data;
+	writeFaces(model, v_face_data);
+	hash = hashBytes(hash, v_face_data.data(), v_face_data.size() * sizeof(uint32_t));
+	return hash;
+}
+
+
+
+MeshCache :: MeshCache ()
+		: m_mutex()
+		, m_directory()
+		, m_byte_limit(0)
+		, mv_entries()
+		, m_total_bytes(0)
+		, m_use_count(0)
+{
+	assert(!isOpen());
+	assert(invariant());
+}
+
+
+
+bool MeshCache :: isOpen () const
+{
+	return m_byte_limit > 0;
+}
+
+unsigned int MeshCache :: getEntryCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (unsigned int)(mv_entries.size());
+}
+
+uint64_t MeshCache :: getTotalBytes () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_total_bytes;
+}
+
+
+
+bool MeshCache :: open (const std::string& directory,
+                        uint64_t byte_limit)
+{
+	assert(!isOpen());
+	assert(byte_limit > 0);
+
+	error_code error;
+	filesystem::create_directories(directory, error);
+	if(!filesystem::is_directory(directory, error))
+	{
+		cerr << "Could not create mesh cache directory \"" << directory << "\"" << endl;
+		return false;
+	}
+
+	struct FoundFile
+	{
+		uint64_t m_key;
+		uint64_t m_bytes;
+		filesystem::file_time_type m_time;
+	};
+	vector<FoundFile> v_found;
+	for(const filesystem::directory_entry& file : filesystem::directory_iterator(directory, error))
+	{
+		if(!file.is_regular_file(error) || file.path().extension() != FILE_EXTENSION)
+			continue;
+
+		string stem = file.path().stem().string();
+		char* p_end = nullptr;
+		uint64_t key = strtoull(stem.c_str(), &p_end, 16);
+		if(stem.size() != 16 || *p_end != '\0')
+			continue;
+
+		FoundFile found;
+		found.m_key   = key;
+		found.m_bytes = file.file_size(error);
+		found.m_time  = file.last_write_time(error);
+		v_found.push_back(found);
+	}
+
+	// oldest first, so the most recently used get the highest numbers
+	sort(v_found.begin(), v_found.end(), [] (const FoundFile& a, const FoundFile& b)
+	{
+		return a.m_time < b.m_time;
+	});
+
+	lock_guard<mutex> lock(m_mutex);
+	m_directory  = directory;
+	m_byte_limit = byte_limit;
+	for(unsigned int i = 0; i < v_found.size(); i++)
+	{
+		m_use_count++;
+		addEntry(v_found[i].m_key, v_found[i].m_bytes, m_use_count);
+	}
+	evict();
+
+	assert(isOpen());
+	assert(invariant());
+	return true;
+}
+
+bool MeshCache :: load (uint64_t key,
+                        const ObjLibrary::ObjModel& base_model,
+                        std::vector<ObjLibrary::ObjModel>& rv_models)
+{
+	if(!isOpen())
+		return false;
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		bool is_found = false;
+		for(unsigned int i = 0; i < mv_entries.size(); i++)
+			if(mv_entries[i].m_key == key)
+			{
+				m_use_count++;
+				mv_entries[i].m_last_used = m_use_count;
+				is_found = true;
+				break;
+			}
+		if(!is_found)
+			return false;
+	}
+
+	string filename = getFileName(key);
+	FileData file;
+	if(!readFile(filename, file))
+	{
+		// deleted by another process
+		lock_guard<mutex> lock(m_mutex);
+		removeEntry(key);
+		return false;
+	}
+
+	FileHeader header;
+	bool is_valid = file.m_size >= sizeof(header);
+	if(is_valid)
+	{
+		memcpy(&header, file.mp_data, sizeof(header));
+		is_valid = memcmp(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+		           header.m_version      == FILE_VERSION &&
+		           header.m_key          == key &&
+		           header.m_model_count  > 0 &&
+		           header.m_vertex_count == base_model.getVertexCount() &&
+		           header.m_mesh_count   == base_model.getMeshCount() &&
+		           getFileBytes(header)  == file.m_size;
+	}
+
+	vector<ObjModel> v_models;
+	if(is_valid)
+	{
+		const char* p_positions = file.mp_data + sizeof(header);
+		const char* p_normals   = p_positions + header.m_vertex_count * 3 * sizeof(float);
+		FaceReader faces;
+		faces.mp_next     = p_normals + header.m_normal_count * 3 * sizeof(float);
+		faces.m_remaining = header.m_face_data_count;
+
+		// set up one model and copy it, so the arrays are only converted once
+		ObjModel model = base_model;
+		float a_vector[3];
+		for(unsigned int v = 0; v < header.m_vertex_count; v++)
+		{
+			memcpy(a_vector, p_positions + v * sizeof(a_vector), sizeof(a_vector));
+			model.setVertexPosition(v, a_vector[0], a_vector[1], a_vector[2]);
+		}
+		model.setNormalCount(header.m_normal_count);
+		for(unsigned int n = 0; n < header.m_normal_count && is_valid; n++)
+		{
+			memcpy(a_vector, p_normals + n * sizeof(a_vector), sizeof(a_vector));
+			if(a_vector[0] == 0.0f && a_vector[1] == 0.0f && a_vector[2] == 0.0f)
+				is_valid = false;  // ObjModel does not allow zero normals
+			else
+				model.setNormalVector(n, a_vector[0], a_vector[1], a_vector[2]);
+		}
+
+		if(is_valid)
+			v_models.resize(header.m_model_count, model);
+		for(unsigned int i = 0; i < v_models.size() && is_valid; i++)
+		{
+			is_valid = readFaces(faces, v_models[i]);
+			if(is_valid)
+			{
+				v_models[i].validate();
+				is_valid = v_models[i].isValid();
+			}
+		}
+		if(faces.m_remaining != 0)
+			is_valid = false;
+	}
+	closeFile(file);
+
+	if(!is_valid)
+	{
+		cerr << "Discarding invalid mesh cache file \"" << filename << "\"" << endl;
+		error_code error;
+		filesystem::remove(filename, error);
+		lock_guard<mutex> lock(m_mutex);
+		removeEntry(key);
+		return false;
+	}
+
+	// keep the least recently used order for the next run
+	error_code error;
+	filesystem::last_write_time(filename, filesystem::file_time_type::clock::now(), error);
+
+	rv_models.swap(v_models);
+	return true;
+}
+
+bool MeshCache :: store (uint64_t key,
+                         const std::vector<ObjLibrary::ObjModel>& v_models)
+{
+	assert(!v_models.empty());
+
+	if(!isOpen())
+		return false;
+
+	const ObjModel& first = v_models[0];
+	FileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.m_version      = FILE_VERSION;
+	header.m_model_count  = (uint32_t)(v_models.size());
+	header.m_key          = key;
+	header.m_vertex_count = first.getVertexCount();
+	header.m_normal_count = first.getNormalCount();
+	header.m_mesh_count   = first.getMeshCount();
+
+	vector<float> v_positions(header.m_vertex_count * 3);
+	for(unsigned int v = 0; v < header.m_vertex_count; v++)
+	{
+		v_positions[v * 3 + 0] = (float)(first.getVertexX(v));
+		v_positions[v * 3 + 1] = (float)(first.getVertexY(v));
+		v_positions[v * 3 + 2] = (float)(first.getVertexZ(v));
+	}
+	vector<float> v_normals(header.m_normal_count * 3);
+	for(unsigned int n = 0; n < header.m_normal_count; n++)
+	{
+		v_normals[n * 3 + 0] = (float)(first.getNormalX(n));
+		v_normals[n * 3 + 1] = (float)(first.getNormalY(n));
+		v_normals[n * 3 + 2] = (float)(first.getNormalZ(n));
+	}
+	vector<uint32_t> v_face_data;
+	for(unsigned int i = 0; i < v_models.size(); i++)
+	{
+		assert(v_models[i].getVertexCount() == header.m_vertex_count);
+		assert(v_models[i].getNormalCount() == header.m_normal_count);
+		assert(v_models[i].getMeshCount()   == header.m_mesh_count);
+		writeFaces(v_models[i], v_face_data);
+	}
+	header.m_face_data_count = (uint32_t)(v_face_data.size());
+
+	// write to a temporary file, so a partial file is never loaded
+	string filename           = getFileName(key);
+	string temporary_filename = filename + ".tmp";
+	{
+		ofstream output(temporary_filename.c_str(), ios::binary);
+		if(!output)
+			return false;
+		output.write((const char*)(&header), sizeof(header));
+		output.write((const char*)(v_positions.data()), v_positions.size() * sizeof(float));
+		output.write((const char*)(v_normals.data()),   v_normals.size()   * sizeof(float));
+		output.write((const char*)(v_face_data.data()), v_face_data.size() * sizeof(uint32_t));
+		if(!output)
+		{
+			output.close();
+			remove(temporary_filename.c_str());
+			return false;
+		}
+	}
+	error_code error;
+	filesystem::rename(temporary_filename, filename, error);
+	if(error)
+	{
+		filesystem::remove(temporary_filename, error);
+		return false;
+	}
+
+	lock_guard<mutex> lock(m_mutex);
+	removeEntry(key);
+	m_use_count++;
+	addEntry(key, getFileBytes(header), m_use_count);
+	evict();
+
+	assert(invariant());
+	return true;
+}
+
+
+
+std::string MeshCache :: getFileName (uint64_t key) const
+{
+	char a_name[17];
+	snprintf(a_name, sizeof(a_name), "%016llx", (unsigned long long)(key));
+	return (filesystem::path(m_directory) / (string(a_name) + FILE_EXTENSION)).string();
+}
+
+void MeshCache :: addEntry (uint64_t key, uint64_t bytes, uint64_t last_used)
+{
+	Entry entry;
+	entry.m_key       = key;
+	entry.m_bytes     = bytes;
+	entry.m_last_used = last_used;
+	mv_entries.push_back(entry);
+	m_total_bytes += bytes;
+}
+
+void MeshCache :: removeEntry (uint64_t key)
+{
+	for(unsigned int i = 0; i < mv_entries.size(); i++)
+		if(mv_entries[i].m_key == key)
+		{
+			m_total_bytes -= mv_entries[i].m_bytes;
+			mv_entries[i] = mv_entries.back();
+			mv_entries.pop_back();
+			return;
+		}
+}
+
+void MeshCache :: evict ()
+{
+	if(m_total_bytes <= m_byte_limit)
+		return;
+
+	// most recently used first
+	sort(mv_entries.begin(), mv_entries.end(), [] (const Entry& a, const Entry& b)
+	{
+		return a.m_last_used > b.m_last_used;
+	});
+
+	// always keep the newest entry, even if it is over the limit by itself
+	while(mv_entries.size() > 1 && m_total_bytes > m_byte_limit)
+	{
+		error_code error;
+		filesystem::remove(getFileName(mv_entries.back().m_key), error);
+		m_total_bytes -= mv_entries.back().m_bytes;
+		mv_entries.pop_back();
+	}
+}
+
+bool MeshCache :: invariant () const
+{
+	// does not lock, so only call while m_mutex is held or from one thread
+	if(!isOpen() && !mv_entries.empty()) return false;
+
+	uint64_t total_bytes = 0;
+	for(unsigned int i = 0; i < mv_entries.size(); i++)
+		total_bytes += mv_entries[i].m_bytes;
+	if(total_bytes != m_total_bytes) return false;
+	return true;
+}
@@ -0,0 +1,223 @@
+//
+//  MeshCache.h
+//
+//  A module to store generated models on disk between runs.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/ObjModel.h"
+
+
+
+//
+//  MeshCache
+//
+//  A class to represent a directory of generated models, each
+//    stored under a 64-bit key.  The key should be a hash of
+//    everything the models were generated from, so a file
+//    never has to be checked against its inputs.  Each entry
+//    is a group of models (such as the levels of detail for one
+//    asteroid) made from the same base model.
+//
+//  The models in an entry share one array of vertex positions
+//    and one of normals, which are stored as floats.  Only the
+//    faces differ between them.  Everything else, such as the
+//    texture coordinates and materials, is taken from the base
+//    model when the entry is loaded.  Entry files are memory-
+//    mapped while they are read if the platform supports it.
+//
+//  The total size of the entry files is kept under a byte
+//    limit by deleting the least recently used entries.  The
+//    modification time of each file is set when it is used, so
+//    the order is kept between runs.
+//
+//  A MeshCache can be used by several threads at once.  Files
+//    that cannot be read are treated as missing and deleted.
+//
+//  Class Invariant:
+//    <1> isOpen() || mv_entries.empty()
+//    <2> m_total_bytes == the sum of the sizes in mv_entries
+//
+class MeshCache
+{
+public:
+//
+//  Class Function: hashBytes
+//
+//  Purpose: To add data to a hash.
+//  Parameter(s):
+//    <1> hash: The hash so far, or HASH_START
+//    <2> p_data: A pointer to the data
+//    <3> byte_count: The number of bytes of data
+//  Preconditions:
+//    <1> p_data != nullptr || byte_count == 0
+//  Returns: hash updated with the byte_count bytes at p_data,
+//           calculated with FNV-1a.
+//  Side Effect: N/A
+//
+	static const uint64_t HASH_START = 0xCBF29CE484222325ull;
+	static uint64_t hashBytes (uint64_t hash,
+	                           const void* p_data,
+	                           size_t byte_count);
+
+//
+//  Class Function: hashModel
+//
+//  Purpose: To calculate a hash for the contents of a model.
+//  Parameter(s):
+//    <1> model: The model
+//  Preconditions: N/A
+//  Returns: A hash of the vertexes, texture coordinates,
+//           normals, material names, and faces of model.
+//  Side Effect: N/A
+//
+	static uint64_t hashModel (const ObjLibrary::ObjModel& model);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a MeshCache that is not open.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new MeshCache is created.  Until open is
+//               called, nothing is loaded or stored.
+//
+	MeshCache ();
+
+	MeshCache (const MeshCache& to_copy) = delete;
+	~MeshCache () = default;
+	MeshCache& operator= (const MeshCache& to_copy) = delete;
+
+//
+//  isOpen
+//
+//  Purpose: To determine if this MeshCache has a directory.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether open has been called successfully.
+//  Side Effect: N/A
+//
+	bool isOpen () const;
+
+//
+//  getEntryCount
+//
+//  Purpose: To determine how many entries are in this
+//           MeshCache.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of entry files.
+//  Side Effect: N/A
+//
+	unsigned int getEntryCount () const;
+
+//
+//  getTotalBytes
+//
+//  Purpose: To determine how much disk space this MeshCache
+//           uses.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The total size of the entry files in bytes.
+//  Side Effect: N/A
+//
+	uint64_t getTotalBytes () const;
+
+//
+//  open
+//
+//  Purpose: To start using a directory for this MeshCache.
+//  Parameter(s):
+//    <1> directory: The directory to store entries in
+//    <2> byte_limit: The maximum total size of the entries
+//  Preconditions:
+//    <1> !isOpen()
+//    <2> byte_limit > 0
+//  Returns: Whether the directory could be used.
+//  Side Effect: directory is created if it does not exist and
+//               the existing entries in it are found.  If they
+//               are larger than byte_limit, the least recently
+//               used are deleted.  If the directory cannot be
+//               created, this MeshCache is not opened and an
+//               error message is printed.
+//
+	bool open (const std::string& directory,
+	           uint64_t byte_limit);
+
+//
+//  load
+//
+//  Purpose: To retrieve the models stored under a key.
+//  Parameter(s):
+//    <1> key: The key
+//    <2> base_model: The model the stored models were made from
+//    <3> rv_models: A vector to fill with the models
+//  Preconditions: N/A
+//  Returns: Whether an entry for key was found and read.
+//  Side Effect: If an entry for key is found, rv_models is set
+//               to copies of base_model with the stored
+//               vertexes, normals, and faces, and the entry is
+//               marked as most recently used.  If the entry is
+//               not valid for base_model, it is deleted.  If
+//               this MeshCache is not open, false is returned.
+//
+	bool load (uint64_t key,
+	           const ObjLibrary::ObjModel& base_model,
+	           std::vector<ObjLibrary::ObjModel>& rv_models);
+
+//
+//  store
+//
+//  Purpose: To add models to this MeshCache.
+//  Parameter(s):
+//    <1> key: The key
+//    <2> v_models: The models
+//  Preconditions:
+//    <1> !v_models.empty()
+//    <2> All models in v_models were made from the same base
+//        model by changing only their vertex positions,
+//        normals, and faces, and have the same vertexes and
+//        normals
+//  Returns: Whether the entry was written.
+//  Side Effect: An entry for key is written, replacing any
+//               existing entry for key.  Least recently used
+//               entries are then deleted until the total size
+//               is within the byte limit.  If this MeshCache is
+//               not open, nothing happens and false is
+//               returned.
+//
+	bool store (uint64_t key,
+	            const std::vector<ObjLibrary::ObjModel>& v_models);
+
+private:
+	struct Entry
+	{
+		uint64_t m_key;
+		uint64_t m_bytes;
+		uint64_t m_last_used;
+	};
+
+	std::string getFileName (uint64_t key) const;
+	void addEntry (uint64_t key, uint64_t bytes, uint64_t last_used);
+	void removeEntry (uint64_t key);
+	void evict ();
+	bool invariant () const;
+
+private:
+	mutable std::mutex m_mutex;
+	std::string m_directory;
+	uint64_t m_byte_limit;
+
+	// all guarded by m_mutex
+	std::vector<Entry> mv_entries;
+	uint64_t m_total_bytes;
+	uint64_t m_use_count;
+};
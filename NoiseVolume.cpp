@@ -0,0 +1,595 @@
+//
+//  NoiseVolume.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#if defined(_WIN32) || defined(__WIN32__)
+	// no memory mapping, files are read into memory
+#else
+	#define NOISE_VOLUME_USE_MMAP
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "ObjLibrary/Vector3.h"
+
+#include "PerlinNoiseField3.h"
+#include "NoiseVolume.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int BRICK_SAMPLES = NoiseVolume::BRICK_SIZE *
+	                                   NoiseVolume::BRICK_SIZE *
+	                                   NoiseVolume::BRICK_SIZE;
+	const float INT16_MAX_FLOAT = 32767.0f;
+
+	const char FILE_MAGIC[8] = { 'N', 'O', 'I', 'S', 'E', 'V', 'O', 'L' };
+	const uint32_t FILE_VERSION = 1;
+	const uint64_t DATA_ALIGNMENT = 4096;  // page size, so the samples can be mapped
+
+	//
+	//  FileHeader
+	//
+	//  The start of a NoiseVolume file.  It is written in the
+	//    native byte order, so files are not portable between
+	//    big- and little-endian machines.
+	//
+	struct FileHeader
+	{
+		char ma_magic[8];
+		uint32_t m_version;
+		uint32_t m_format;
+		uint32_t m_size_x;
+		uint32_t m_size_y;
+		uint32_t m_size_z;
+		uint32_t m_brick_size;
+		double m_origin_x;
+		double m_origin_y;
+		double m_origin_z;
+		float m_spacing;
+		float m_amplitude;
+		uint64_t m_data_offset;
+		uint64_t m_data_size;
+	};
+
+	unsigned int getSampleBytes (unsigned int format)
+	{
+		if(format == NoiseVolume::FORMAT_INT16)
+			return sizeof(int16_t);
+		else
+			return sizeof(float);
+	}
+
+	unsigned int getBrickCountAlong (unsigned int size)
+	{
+		return (size + NoiseVolume::BRICK_SIZE - 1) / NoiseVolume::BRICK_SIZE;
+	}
+
+	// finds the sample before coordinate and the fraction of the way to the next
+	void findCell (double coordinate,
+	               unsigned int size,
+	               unsigned int& r_index,
+	               float& r_fraction)
+	{
+		assert(size > 0);
+
+		if(size == 1 || coordinate <= 0.0)
+		{
+			r_index    = 0;
+			r_fraction = 0.0f;
+		}
+		else if(coordinate >= size - 1)
+		{
+			r_index    = size - 2;
+			r_fraction = 1.0f;
+		}
+		else
+		{
+			r_index    = (unsigned int)(coordinate);
+			r_fraction = (float)(coordinate - r_index);
+		}
+	}
+
+	unsigned int clampIndex (int index, unsigned int size)
+	{
+		if(index < 0)
+			return 0;
+		if((unsigned int)(index) >= size)
+			return size - 1;
+		return (unsigned int)(index);
+	}
+
+	// Catmull-Rom spline weights for samples -1, 0, 1, and 2
+	void calculateCubicWeights (float t, float a_weights[4])
+	{
+		float t2 = t * t;
+		float t3 = t2 * t;
+		a_weights[0] = (-t3 + 2.0f * t2 - t) * 0.5f;
+		a_weights[1] = (3.0f * t3 - 5.0f * t2 + 2.0f) * 0.5f;
+		a_weights[2] = (-3.0f * t3 + 4.0f * t2 + t) * 0.5f;
+		a_weights[3] = (t3 - t2) * 0.5f;
+	}
+
+}  // end of anonymous namespace
+
+
+
+NoiseVolume :: NoiseVolume ()
+		: m_size_x(0)
+		, m_size_y(0)
+		, m_size_z(0)
+		, m_bricks_x(0)
+		, m_bricks_y(0)
+		, m_bricks_z(0)
+		, m_origin()
+		, m_spacing(1.0f)
+		, m_amplitude(0.0f)
+		, m_format(FORMAT_FLOAT)
+		, mv_floats()
+		, mv_int16s()
+		, mp_floats(nullptr)
+		, mp_int16s(nullptr)
+		, mp_mapping(nullptr)
+		, m_mapping_size(0)
+{
+	assert(!isInitialized());
+	assert(invariant());
+}
+
+NoiseVolume :: ~NoiseVolume ()
+{
+	destroy();
+}
+
+
+
+const ObjLibrary::Vector3& NoiseVolume :: getOrigin () const
+{
+	assert(isInitialized());
+
+	return m_origin;
+}
+
+float NoiseVolume :: getSpacing () const
+{
+	assert(isInitialized());
+
+	return m_spacing;
+}
+
+float NoiseVolume :: getAmplitude () const
+{
+	assert(isInitialized());
+
+	return m_amplitude;
+}
+
+size_t NoiseVolume :: getMemoryUsed () const
+{
+	return (size_t)(getBrickCount()) * BRICK_SAMPLES * getSampleBytes(m_format);
+}
+
+float NoiseVolume :: getSample (unsigned int x,
+                                unsigned int y,
+                                unsigned int z) const
+{
+	assert(isInitialized());
+	assert(x < getSizeX());
+	assert(y < getSizeY());
+	assert(z < getSizeZ());
+
+	size_t index = getSampleIndex(x, y, z);
+	if(m_format == FORMAT_FLOAT)
+		return mp_floats[index];
+	else
+		return mp_int16s[index] * (m_amplitude / INT16_MAX_FLOAT);
+}
+
+float NoiseVolume :: sampleTrilinear (const ObjLibrary::Vector3& position) const
+{
+	assert(isInitialized());
+
+	Vector3 grid = (position - m_origin) / m_spacing;
+	unsigned int x0, y0, z0;
+	float x_frac, y_frac, z_frac;
+	findCell(grid.x, m_size_x, x0, x_frac);
+	findCell(grid.y, m_size_y, y0, y_frac);
+	findCell(grid.z, m_size_z, z0, z_frac);
+	unsigned int x1 = (m_size_x > 1) ? x0 + 1 : x0;
+	unsigned int y1 = (m_size_y > 1) ? y0 + 1 : y0;
+	unsigned int z1 = (m_size_z > 1) ? z0 + 1 : z0;
+
+	float value000 = getSample(x0, y0, z0);
+	float value001 = getSample(x0, y0, z1);
+	float value010 = getSample(x0, y1, z0);
+	float value011 = getSample(x0, y1, z1);
+	float value100 = getSample(x1, y0, z0);
+	float value101 = getSample(x1, y0, z1);
+	float value110 = getSample(x1, y1, z0);
+	float value111 = getSample(x1, y1, z1);
+
+	float value00 = value000 + (value001 - value000) * z_frac;
+	float value01 = value010 + (value011 - value010) * z_frac;
+	float value10 = value100 + (value101 - value100) * z_frac;
+	float value11 = value110 + (value111 - value110) * z_frac;
+	float value0  = value00  + (value01  - value00)  * y_frac;
+	float value1  = value10  + (value11  - value10)  * y_frac;
+	return value0 + (value1 - value0) * x_frac;
+}
+
+float NoiseVolume :: sampleTricubic (const ObjLibrary::Vector3& position) const
+{
+	assert(isInitialized());
+
+	Vector3 grid = (position - m_origin) / m_spacing;
+	unsigned int x0, y0, z0;
+	float x_frac, y_frac, z_frac;
+	findCell(grid.x, m_size_x, x0, x_frac);
+	findCell(grid.y, m_size_y, y0, y_frac);
+	findCell(grid.z, m_size_z, z0, z_frac);
+
+	float a_x_weights[4];
+	float a_y_weights[4];
+	float a_z_weights[4];
+	calculateCubicWeights(x_frac, a_x_weights);
+	calculateCubicWeights(y_frac, a_y_weights);
+	calculateCubicWeights(z_frac, a_z_weights);
+
+	unsigned int a_x[4];
+	unsigned int a_y[4];
+	unsigned int a_z[4];
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		a_x[i] = clampIndex((int)(x0) + (int)(i) - 1, m_size_x);
+		a_y[i] = clampIndex((int)(y0) + (int)(i) - 1, m_size_y);
+		a_z[i] = clampIndex((int)(z0) + (int)(i) - 1, m_size_z);
+	}
+
+	float value = 0.0f;
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		float value_x = 0.0f;
+		for(unsigned int j = 0; j < 4; j++)
+		{
+			float value_y = 0.0f;
+			for(unsigned int k = 0; k < 4; k++)
+				value_y += getSample(a_x[i], a_y[j], a_z[k]) * a_z_weights[k];
+			value_x += value_y * a_y_weights[j];
+		}
+		value += value_x * a_x_weights[i];
+	}
+	return value;
+}
+
+
+
+void NoiseVolume :: bake (const PerlinNoiseField3& field,
+                          const PerlinNoiseField3::Octaves& octaves,
+                          const ObjLibrary::Vector3& origin,
+                          float spacing,
+                          unsigned int size_x,
+                          unsigned int size_y,
+                          unsigned int size_z,
+                          unsigned int format,
+                          unsigned int thread_count)
+{
+	assert(spacing > 0.0f);
+	assert(size_x > 0);
+	assert(size_y > 0);
+	assert(size_z > 0);
+	assert(format == FORMAT_FLOAT || format == FORMAT_INT16);
+
+	destroy();
+
+	m_size_x   = size_x;
+	m_size_y   = size_y;
+	m_size_z   = size_z;
+	m_bricks_x = getBrickCountAlong(size_x);
+	m_bricks_y = getBrickCountAlong(size_y);
+	m_bricks_z = getBrickCountAlong(size_z);
+	m_origin    = origin;
+	m_spacing   = spacing;
+	m_amplitude = fabs(field.getAmplitude());
+	m_format    = format;
+
+	size_t sample_count = (size_t)(getBrickCount()) * BRICK_SAMPLES;
+	if(format == FORMAT_FLOAT)
+	{
+		mv_floats.resize(sample_count);
+		mp_floats = mv_floats.data();
+	}
+	else
+	{
+		mv_int16s.resize(sample_count);
+		mp_int16s = mv_int16s.data();
+	}
+
+	if(thread_count == 0)
+		thread_count = thread::hardware_concurrency();
+	if(thread_count == 0)
+		thread_count = 1;
+	if(thread_count > getBrickCount())
+		thread_count = getBrickCount();
+
+	// bricks are dealt out in turn, so each thread gets some of each region
+	vector<thread> v_threads;
+	for(unsigned int t = 1; t < thread_count; t++)
+		v_threads.push_back(thread(&NoiseVolume::bakeBricks, this,
+		                           std::cref(field), std::cref(octaves), t, thread_count));
+	bakeBricks(field, octaves, 0, thread_count);
+	for(unsigned int t = 0; t < v_threads.size(); t++)
+		v_threads[t].join();
+
+	assert(isInitialized());
+	assert(invariant());
+}
+
+bool NoiseVolume :: save (const std::string& filename) const
+{
+	assert(isInitialized());
+
+	FileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.m_version    = FILE_VERSION;
+	header.m_format     = m_format;
+	header.m_size_x     = m_size_x;
+	header.m_size_y     = m_size_y;
+	header.m_size_z     = m_size_z;
+	header.m_brick_size = BRICK_SIZE;
+	header.m_origin_x   = m_origin.x;
+	header.m_origin_y   = m_origin.y;
+	header.m_origin_z   = m_origin.z;
+	header.m_spacing    = m_spacing;
+	header.m_amplitude  = m_amplitude;
+	header.m_data_offset = DATA_ALIGNMENT;
+	header.m_data_size   = getMemoryUsed();
+	assert(sizeof(header) <= DATA_ALIGNMENT);
+
+	ofstream output(filename.c_str(), ios::binary);
+	if(!output)
+		return false;
+	output.write((const char*)(&header), sizeof(header));
+	vector<char> v_padding(DATA_ALIGNMENT - sizeof(header), 0);
+	output.write(v_padding.data(), v_padding.size());
+	if(m_format == FORMAT_FLOAT)
+		output.write((const char*)(mp_floats), header.m_data_size);
+	else
+		output.write((const char*)(mp_int16s), header.m_data_size);
+	return (bool)(output);
+}
+
+bool NoiseVolume :: load (const std::string& filename)
+{
+	destroy();
+
+	FileHeader header;
+	const char* p_file_data = nullptr;
+	uint64_t file_size = 0;
+	vector<char> v_file;
+
+#ifdef NOISE_VOLUME_USE_MMAP
+	int file = open(filename.c_str(), O_RDONLY);
+	if(file < 0)
+	{
+		cerr << "Could not open noise volume \"" << filename << "\"" << endl;
+		return false;
+	}
+	struct stat file_status;
+	if(fstat(file, &file_status) != 0 || file_status.st_size < (off_t)(sizeof(header)))
+	{
+		cerr << "Noise volume \"" << filename << "\" is too short" << endl;
+		close(file);
+		return false;
+	}
+	file_size = (uint64_t)(file_status.st_size);
+	void* p_mapping = mmap(nullptr, (size_t)(file_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);  // the mapping keeps the file open
+	if(p_mapping == MAP_FAILED)
+	{
+		cerr << "Could not map noise volume \"" << filename << "\"" << endl;
+		return false;
+	}
+	mp_mapping     = p_mapping;
+	m_mapping_size = (size_t)(file_size);
+	p_file_data = (const char*)(p_mapping);
+#else
+	ifstream input(filename.c_str(), ios::binary);
+	if(!input)
+	{
+		cerr << "Could not open noise volume \"" << filename << "\"" << endl;
+		return false;
+	}
+	v_file.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+	file_size = v_file.size();
+	if(file_size < sizeof(header))
+	{
+		cerr << "Noise volume \"" << filename << "\" is too short" << endl;
+		return false;
+	}
+	p_file_data = v_file.data();
+#endif
+
+	memcpy(&header, p_file_data, sizeof(header));
+	bool is_valid = memcmp(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+	                header.m_version    == FILE_VERSION &&
+	                header.m_brick_size == BRICK_SIZE &&
+	                (header.m_format == FORMAT_FLOAT || header.m_format == FORMAT_INT16) &&
+	                header.m_size_x > 0 && header.m_size_y > 0 && header.m_size_z > 0 &&
+	                header.m_spacing > 0.0f &&
+	                header.m_data_offset % DATA_ALIGNMENT == 0 &&
+	                header.m_data_offset <= file_size &&
+	                header.m_data_size   <= file_size - header.m_data_offset;
+	if(is_valid)
+	{
+		uint64_t expected_size = (uint64_t)(getBrickCountAlong(header.m_size_x)) *
+		                         getBrickCountAlong(header.m_size_y) *
+		                         getBrickCountAlong(header.m_size_z) *
+		                         BRICK_SAMPLES * getSampleBytes(header.m_format);
+		is_valid = header.m_data_size == expected_size;
+	}
+	if(!is_valid)
+	{
+		cerr << "\"" << filename << "\" is not a valid noise volume" << endl;
+		destroy();
+		return false;
+	}
+
+	m_size_x   = header.m_size_x;
+	m_size_y   = header.m_size_y;
+	m_size_z   = header.m_size_z;
+	m_bricks_x = getBrickCountAlong(m_size_x);
+	m_bricks_y = getBrickCountAlong(m_size_y);
+	m_bricks_z = getBrickCountAlong(m_size_z);
+	m_origin.set(header.m_origin_x, header.m_origin_y, header.m_origin_z);
+	m_spacing   = header.m_spacing;
+	m_amplitude = header.m_amplitude;
+	m_format    = header.m_format;
+
+	const char* p_samples = p_file_data + header.m_data_offset;
+	size_t sample_count = (size_t)(getBrickCount()) * BRICK_SAMPLES;
+	if(isMapped())
+	{
+		if(m_format == FORMAT_FLOAT)
+			mp_floats = (const float*)(p_samples);
+		else
+			mp_int16s = (const int16_t*)(p_samples);
+	}
+	else if(m_format == FORMAT_FLOAT)
+	{
+		mv_floats.resize(sample_count);
+		memcpy(mv_floats.data(), p_samples, header.m_data_size);
+		mp_floats = mv_floats.data();
+	}
+	else
+	{
+		mv_int16s.resize(sample_count);
+		memcpy(mv_int16s.data(), p_samples, header.m_data_size);
+		mp_int16s = mv_int16s.data();
+	}
+
+	assert(isInitialized());
+	assert(invariant());
+	return true;
+}
+
+void NoiseVolume :: destroy ()
+{
+#ifdef NOISE_VOLUME_USE_MMAP
+	if(mp_mapping != nullptr)
+		munmap(mp_mapping, m_mapping_size);
+#endif
+	mp_mapping     = nullptr;
+	m_mapping_size = 0;
+
+	mv_floats.clear();
+	mv_floats.shrink_to_fit();
+	mv_int16s.clear();
+	mv_int16s.shrink_to_fit();
+	mp_floats = nullptr;
+	mp_int16s = nullptr;
+
+	m_size_x   = 0;
+	m_size_y   = 0;
+	m_size_z   = 0;
+	m_bricks_x = 0;
+	m_bricks_y = 0;
+	m_bricks_z = 0;
+
+	assert(!isInitialized());
+	assert(invariant());
+}
+
+
+
+unsigned int NoiseVolume :: getBrickCount () const
+{
+	return m_bricks_x * m_bricks_y * m_bricks_z;
+}
+
+size_t NoiseVolume :: getSampleIndex (unsigned int x,
+                                      unsigned int y,
+                                      unsigned int z) const
+{
+	assert(x < m_bricks_x * BRICK_SIZE);
+	assert(y < m_bricks_y * BRICK_SIZE);
+	assert(z < m_bricks_z * BRICK_SIZE);
+
+	unsigned int brick = ((z / BRICK_SIZE) * m_bricks_y + (y / BRICK_SIZE)) * m_bricks_x + (x / BRICK_SIZE);
+	unsigned int local = ((z % BRICK_SIZE) * BRICK_SIZE + (y % BRICK_SIZE)) * BRICK_SIZE + (x % BRICK_SIZE);
+	return (size_t)(brick) * BRICK_SAMPLES + local;
+}
+
+void NoiseVolume :: bakeBricks (const PerlinNoiseField3& field,
+                                const PerlinNoiseField3::Octaves& octaves,
+                                unsigned int first_brick,
+                                unsigned int brick_step)
+{
+	assert(brick_step > 0);
+
+	float a_x[BRICK_SAMPLES];
+	float a_y[BRICK_SAMPLES];
+	float a_z[BRICK_SAMPLES];
+	float a_values[BRICK_SAMPLES];
+
+	for(unsigned int brick = first_brick; brick < getBrickCount(); brick += brick_step)
+	{
+		unsigned int brick_x =  brick % m_bricks_x;
+		unsigned int brick_y = (brick / m_bricks_x) % m_bricks_y;
+		unsigned int brick_z =  brick / m_bricks_x  / m_bricks_y;
+
+		// samples past the end of the volume are calculated too, but never used
+		for(unsigned int local = 0; local < BRICK_SAMPLES; local++)
+		{
+			unsigned int x = brick_x * BRICK_SIZE +  local % BRICK_SIZE;
+			unsigned int y = brick_y * BRICK_SIZE + (local / BRICK_SIZE) % BRICK_SIZE;
+			unsigned int z = brick_z * BRICK_SIZE +  local / BRICK_SIZE  / BRICK_SIZE;
+			a_x[local] = (float)(m_origin.x + x * m_spacing);
+			a_y[local] = (float)(m_origin.y + y * m_spacing);
+			a_z[local] = (float)(m_origin.z + z * m_spacing);
+		}
+		field.fbmNoiseBatch(a_x, a_y, a_z, BRICK_SAMPLES, octaves, a_values);
+
+		size_t start = (size_t)(brick) * BRICK_SAMPLES;
+		if(m_format == FORMAT_FLOAT)
+		{
+			for(unsigned int local = 0; local < BRICK_SAMPLES; local++)
+				mv_floats[start + local] = a_values[local];
+		}
+		else
+		{
+			float scale = (m_amplitude > 0.0f) ? INT16_MAX_FLOAT / m_amplitude : 0.0f;
+			for(unsigned int local = 0; local < BRICK_SAMPLES; local++)
+			{
+				float scaled = a_values[local] * scale;
+				if(scaled >  INT16_MAX_FLOAT) scaled =  INT16_MAX_FLOAT;
+				if(scaled < -INT16_MAX_FLOAT) scaled = -INT16_MAX_FLOAT;
+				mv_int16s[start + local] = (int16_t)(lround(scaled));
+			}
+		}
+	}
+}
+
+bool NoiseVolume :: invariant () const
+{
+	if(isInitialized() != (m_size_x > 0)) return false;
+	if(isInitialized() != (m_size_y > 0)) return false;
+	if(isInitialized() != (m_size_z > 0)) return false;
+	if(isInitialized() && m_spacing <= 0.0f) return false;
+	if(m_format != FORMAT_FLOAT && m_format != FORMAT_INT16) return false;
+	if(mp_mapping != nullptr && !isInitialized()) return false;
+	return true;
+}
@@ -0,0 +1,339 @@
+//
+//  NoiseVolume.h
+//
+//  A module to store noise precalculated on a 3D grid.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "PerlinNoiseField3.h"
+
+
+
+//
+//  NoiseVolume
+//
+//  A class to represent a region of a PerlinNoiseField3 baked
+//    into a 3D grid of samples.  Looking up a baked value is
+//    much faster than calculating the noise, which needs eight
+//    hashed lattice vectors per octave.
+//
+//  The samples are stored in bricks of BRICK_SIZE^3, so the
+//    eight (or 64) samples used for one lookup are usually
+//    close together in memory.  Each sample is a float or a
+//    16-bit integer scaled to the noise amplitude
+//    (FORMAT_INT16), which uses half the memory and has an
+//    error of at most getAmplitude() / 65534.
+//
+//  A NoiseVolume can be saved to a file.  When it is loaded
+//    again, the file is memory-mapped if the platform supports
+//    it, so only the parts that are sampled are read from disk
+//    and several processes can share the same pages.
+//    Otherwise, the file is read into memory.
+//
+//  Positions outside the baked region are clamped to it.
+//
+//  A NoiseVolume cannot be copied because it may own a memory
+//    mapping.
+//
+//  Class Invariant:
+//    <1> isInitialized() == (m_size_x > 0)
+//    <2> isInitialized() == (m_size_y > 0)
+//    <3> isInitialized() == (m_size_z > 0)
+//    <4> !isInitialized() || m_spacing > 0.0f
+//    <5> m_format == FORMAT_FLOAT || m_format == FORMAT_INT16
+//    <6> mp_mapping == nullptr || isInitialized()
+//
+class NoiseVolume
+{
+public:
+	static const unsigned int BRICK_SIZE   = 8;
+	static const unsigned int FORMAT_FLOAT = 0;
+	static const unsigned int FORMAT_INT16 = 1;
+
+public:
+	NoiseVolume ();
+	NoiseVolume (const NoiseVolume& to_copy) = delete;
+	~NoiseVolume ();
+	NoiseVolume& operator= (const NoiseVolume& to_copy) = delete;
+
+//
+//  isInitialized
+//
+//  Purpose: To determine if this NoiseVolume contains samples.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this NoiseVolume has been baked or loaded.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{	return m_size_x > 0;	}
+
+//
+//  isMapped
+//
+//  Purpose: To determine if the samples for this NoiseVolume
+//           are in a memory-mapped file.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the samples are memory-mapped.
+//  Side Effect: N/A
+//
+	bool isMapped () const
+	{	return mp_mapping != nullptr;	}
+
+//
+//  getSizeX
+//  getSizeY
+//  getSizeZ
+//
+//  Purpose: To determine the number of samples along each
+//           axis.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of samples, or 0 if this NoiseVolume is
+//           not initialized.
+//  Side Effect: N/A
+//
+	unsigned int getSizeX () const
+	{	return m_size_x;	}
+	unsigned int getSizeY () const
+	{	return m_size_y;	}
+	unsigned int getSizeZ () const
+	{	return m_size_z;	}
+
+//
+//  getOrigin
+//
+//  Purpose: To determine the position of the first sample.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The position of sample (0, 0, 0).
+//  Side Effect: N/A
+//
+	const ObjLibrary::Vector3& getOrigin () const;
+
+//
+//  getSpacing
+//
+//  Purpose: To determine the distance between samples.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The distance between neighbouring samples.
+//  Side Effect: N/A
+//
+	float getSpacing () const;
+
+//
+//  getFormat
+//
+//  Purpose: To determine how the samples are stored.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: FORMAT_FLOAT or FORMAT_INT16.
+//  Side Effect: N/A
+//
+	unsigned int getFormat () const
+	{	return m_format;	}
+
+//
+//  getAmplitude
+//
+//  Purpose: To determine the largest value that can be
+//           stored.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The amplitude of the noise that was baked.  Every
+//           sample is in [-getAmplitude(), getAmplitude()].
+//  Side Effect: N/A
+//
+	float getAmplitude () const;
+
+//
+//  getMemoryUsed
+//
+//  Purpose: To determine how much memory the samples use.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The size of the samples in bytes, including the
+//           padding at the end of partial bricks.
+//  Side Effect: N/A
+//
+	size_t getMemoryUsed () const;
+
+//
+//  getSample
+//
+//  Purpose: To retrieve one sample.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The sample indexes
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> x < getSizeX()
+//    <3> y < getSizeY()
+//    <4> z < getSizeZ()
+//  Returns: The noise value at sample (x, y, z).
+//  Side Effect: N/A
+//
+	float getSample (unsigned int x,
+	                 unsigned int y,
+	                 unsigned int z) const;
+
+//
+//  sampleTrilinear
+//
+//  Purpose: To look up the noise at a position by
+//           interpolating linearly between the 8 nearest
+//           samples.
+//  Parameter(s):
+//    <1> position: The position
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The interpolated noise value at position.  The
+//           value is continuous, but its derivative is not.
+//  Side Effect: N/A
+//
+	float sampleTrilinear (const ObjLibrary::Vector3& position) const;
+
+//
+//  sampleTricubic
+//
+//  Purpose: To look up the noise at a position by
+//           interpolating with Catmull-Rom splines between the
+//           64 nearest samples.
+//  Parameter(s):
+//    <1> position: The position
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The interpolated noise value at position.  The
+//           value and its derivative are continuous, and the
+//           value may overshoot the samples slightly.
+//  Side Effect: N/A
+//
+	float sampleTricubic (const ObjLibrary::Vector3& position) const;
+
+//
+//  bake
+//
+//  Purpose: To fill this NoiseVolume with fractal noise.
+//  Parameter(s):
+//    <1> field: The noise field
+//    <2> octaves: The octaves for PerlinNoiseField3::fbmNoise
+//    <3> origin: The position of the first sample
+//    <4> spacing: The distance between samples
+//    <5> size_x
+//    <6> size_y
+//    <7> size_z: The number of samples along each axis
+//    <8> format: How to store the samples
+//    <9> thread_count: How many threads to use, or 0 to use
+//                      one per hardware thread
+//  Preconditions:
+//    <1> spacing > 0.0f
+//    <2> size_x > 0
+//    <3> size_y > 0
+//    <4> size_z > 0
+//    <5> format == FORMAT_FLOAT || format == FORMAT_INT16
+//  Returns: N/A
+//  Side Effect: Any existing samples are discarded.  Then
+//               sample (x, y, z) is set to the fractal noise
+//               at origin + (x, y, z) * spacing.  Each thread
+//               bakes whole bricks with the batch noise
+//               functions.
+//
+	void bake (const PerlinNoiseField3& field,
+	           const PerlinNoiseField3::Octaves& octaves,
+	           const ObjLibrary::Vector3& origin,
+	           float spacing,
+	           unsigned int size_x,
+	           unsigned int size_y,
+	           unsigned int size_z,
+	           unsigned int format,
+	           unsigned int thread_count);
+
+//
+//  save
+//
+//  Purpose: To write this NoiseVolume to a file.
+//  Parameter(s):
+//    <1> filename: The file to write
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: Whether the file was written successfully.
+//  Side Effect: The header and samples are written to
+//               filename, replacing any existing file.  The
+//               samples start at a multiple of 4096 bytes so
+//               they can be memory-mapped.
+//
+	bool save (const std::string& filename) const;
+
+//
+//  load
+//
+//  Purpose: To read a NoiseVolume from a file.
+//  Parameter(s):
+//    <1> filename: The file to read
+//  Preconditions: N/A
+//  Returns: Whether the file was read successfully.
+//  Side Effect: Any existing samples are discarded.  If
+//               filename contains a valid NoiseVolume, this
+//               NoiseVolume is set to it.  The file is
+//               memory-mapped if possible.  Otherwise, this
+//               NoiseVolume is left uninitialized and an error
+//               message is printed.
+//
+	bool load (const std::string& filename);
+
+//
+//  destroy
+//
+//  Purpose: To discard the samples in this NoiseVolume.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The samples are freed or unmapped and this
+//               NoiseVolume is set to be uninitialized.
+//
+	void destroy ();
+
+private:
+	unsigned int getBrickCount () const;
+	size_t getSampleIndex (unsigned int x,
+	                       unsigned int y,
+	                       unsigned int z) const;
+	void bakeBricks (const PerlinNoiseField3& field,
+	                 const PerlinNoiseField3::Octaves& octaves,
+	                 unsigned int first_brick,
+	                 unsigned int brick_step);
+	bool invariant () const;
+
+private:
+	unsigned int m_size_x;
+	unsigned int m_size_y;
+	unsigned int m_size_z;
+	unsigned int m_bricks_x;
+	unsigned int m_bricks_y;
+	unsigned int m_bricks_z;
+	ObjLibrary::Vector3 m_origin;
+	float m_spacing;
+	float m_amplitude;
+	unsigned int m_format;
+
+	// samples are in these vectors, or in the mapping
+	std::vector<float>   mv_floats;
+	std::vector<int16_t> mv_int16s;
+	const float*   mp_floats;
+	const int16_t* mp_int16s;
+	void* mp_mapping;
+	size_t m_mapping_size;
+};
@@ -21,6 +21,7 @@
 #include <cstddef>	// for NULL
 
 #include "../GetGlut.h"
+#include "GlCallCounter.h"
 #include "DisplayList.h"
 
 using namespace ObjLibrary;
@@ -121,6 +122,7 @@ void DisplayList :: draw () const
 	assert(isReady());
 
 	glCallList(mp_data->m_list_id);
+	GlCallCounter::countListCall(mp_data->m_counts);
 }
 
 
@@ -164,6 +166,7 @@ void DisplayList :: begin ()
 	mp_data->m_list_id = glGenLists(1);
 
 	glNewList(mp_data->m_list_id, GL_COMPILE);
+	GlCallCounter::beginList();
 
 	assert(getState() == PARTIAL);
 }
@@ -174,6 +177,8 @@ void DisplayList :: end ()
 	assert(!isDisabledForExit());
 	assert(isPartial());
 
+	// stop recording first so glEndList is not counted as part of the list
+	mp_data->m_counts = GlCallCounter::endList();
 	glEndList();
 
 	assert(mp_data->m_usages == 0);
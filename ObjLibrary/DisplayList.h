@@ -22,6 +22,7 @@
 #ifndef OBJ_LIBRARY_DISPLAY_LIST_H
 #define OBJ_LIBRARY_DISPLAY_LIST_H
 
+#include "GlCallCounter.h"
 
 
 namespace ObjLibrary
@@ -353,12 +354,15 @@ private:
 	//    display list.  The list id and a usage count are
 	//    stored.  A special value of 0 usages is used to
 	//    indicate that the display list is only partially
-	//    specified.
+	//    specified.  The OpenGL calls compiled into the list
+	//    are also stored so they can be counted when it is
+	//    drawn.
 	//
 	struct InnerData
 	{
 		unsigned int m_list_id;
 		unsigned int m_usages;
+		GlCallCounts m_counts;
 	};
 
 private:
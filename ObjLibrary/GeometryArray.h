@@ -0,0 +1,625 @@
+//
+//  GeometryArray.h
+//
+//  A module to store packed arrays of 2D and 3D geometry
+//    values, such as vertex positions, in a chosen precision.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_GEOMETRY_ARRAY_H
+#define OBJ_LIBRARY_GEOMETRY_ARRAY_H
+
+#include <cassert>
+#include <vector>
+
+#include "ObjSettings.h"
+#include "Vector3.h"
+#include "Vector2.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  GeometryScalar
+//
+//  The type used to store model geometry.  This is float if
+//    OBJ_LIBRARY_FLOAT_GEOMETRY is defined and double
+//    otherwise.
+//
+#ifdef OBJ_LIBRARY_FLOAT_GEOMETRY
+	typedef float GeometryScalar;
+#else
+	typedef double GeometryScalar;
+#endif
+
+
+
+//
+//  GeometryArray3
+//
+//  A templated class to store an array of 3D values (such as
+//    positions or normals) packed together as x, y, z triples.
+//    Values are stored as type T, which should be float or
+//    double, but are set and retrieved as Vector3s.  The values
+//    for each element can also be retrieved as an array of 3
+//    Ts, which is suitable for passing directly to OpenGL.
+//
+template <typename T>
+class GeometryArray3
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new empty GeometryArray3.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new GeometryArray3 is created with no
+//               elements.
+//
+	GeometryArray3 ()
+			: mv_components()
+	{ }
+
+//
+//  size
+//
+//  Purpose: To determine the number of elements in this
+//           GeometryArray3.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of elements.
+//  Side Effect: N/A
+//
+	unsigned int size () const
+	{
+		return (unsigned int)(mv_components.size() / 3);
+	}
+
+//
+//  empty
+//
+//  Purpose: To determine if this GeometryArray3 contains no
+//           elements.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this GeometryArray3 is empty.
+//  Side Effect: N/A
+//
+	bool empty () const
+	{
+		return mv_components.empty();
+	}
+
+//
+//  getX
+//  getY
+//  getZ
+//
+//  Purpose: To determine the x/y/z component of the specified
+//           element.
+//  Parameter(s):
+//    <1> element: Which element
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: The x/y/z component of element element.
+//  Side Effect: N/A
+//
+	T getX (unsigned int element) const
+	{
+		assert(element < size());
+		return mv_components[element * 3 + 0];
+	}
+	T getY (unsigned int element) const
+	{
+		assert(element < size());
+		return mv_components[element * 3 + 1];
+	}
+	T getZ (unsigned int element) const
+	{
+		assert(element < size());
+		return mv_components[element * 3 + 2];
+	}
+
+//
+//  get
+//
+//  Purpose: To retrieve the specified element as a Vector3.
+//  Parameter(s):
+//    <1> element: Which element
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: Element element.
+//  Side Effect: N/A
+//
+	Vector3 get (unsigned int element) const
+	{
+		assert(element < size());
+
+		const T* a_element = getArray(element);
+		return Vector3(a_element[0], a_element[1], a_element[2]);
+	}
+
+//
+//  getArray
+//
+//  Purpose: To retrieve a pointer to the stored components of
+//           the specified element.
+//  Parameter(s):
+//    <1> element: Which element
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: A pointer to an array of 3 Ts holding the x, y, and
+//           z components of element element.  The pointer is
+//           invalidated if elements are added or removed.
+//  Side Effect: N/A
+//
+	const T* getArray (unsigned int element) const
+	{
+		assert(element < size());
+		return &(mv_components[element * 3]);
+	}
+
+//
+//  getData
+//
+//  Purpose: To retrieve a pointer to the stored components of
+//           all elements.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !empty()
+//  Returns: A pointer to an array of size() * 3 Ts holding the
+//           components of the elements in order.  The pointer
+//           is invalidated if elements are added or removed.
+//  Side Effect: N/A
+//
+	const T* getData () const
+	{
+		assert(!empty());
+		return &(mv_components[0]);
+	}
+
+//
+//  getByteCount
+//
+//  Purpose: To determine the amount of memory used to store the
+//           elements in this GeometryArray3.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of bytes of storage used by the
+//           elements.  This does not include unused capacity.
+//  Side Effect: N/A
+//
+	unsigned int getByteCount () const
+	{
+		return (unsigned int)(mv_components.size() * sizeof(T));
+	}
+
+//
+//  clear
+//
+//  Purpose: To remove all elements from this GeometryArray3.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This GeometryArray3 is set to contain no
+//               elements.
+//
+	void clear ()
+	{
+		mv_components.clear();
+	}
+
+//
+//  resize
+//
+//  Purpose: To change the number of elements in this
+//           GeometryArray3.
+//  Parameter(s):
+//    <1> count: The new number of elements
+//    <2> fill: The value for any added elements
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If count is less than size(), the elements at
+//               the end of this GeometryArray3 are removed.  If
+//               count is greater, elements with value fill are
+//               added to the end.
+//
+	void resize (unsigned int count, const Vector3& fill)
+	{
+		unsigned int old_size = size();
+		mv_components.resize(count * 3);
+		for(unsigned int i = old_size; i < count; i++)
+			set(i, fill);
+	}
+
+//
+//  set
+//
+//  Purpose: To change the value of the specified element.
+//  Parameter(s):
+//    <1> element: Which element
+//    <2> value: The new value
+//    <2> x
+//    <3> y
+//    <4> z: The components of the new value
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: N/A
+//  Side Effect: Element element is set to value / (x, y, z),
+//               converted to type T.
+//
+	void set (unsigned int element, const Vector3& value)
+	{
+		assert(element < size());
+		set(element, value.x, value.y, value.z);
+	}
+	void set (unsigned int element, double x, double y, double z)
+	{
+		assert(element < size());
+
+		mv_components[element * 3 + 0] = (T)(x);
+		mv_components[element * 3 + 1] = (T)(y);
+		mv_components[element * 3 + 2] = (T)(z);
+	}
+
+//
+//  setX
+//  setY
+//  setZ
+//
+//  Purpose: To change the x/y/z component of the specified
+//           element.
+//  Parameter(s):
+//    <1> element: Which element
+//    <2> value: The new value for the component
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: N/A
+//  Side Effect: The x/y/z component of element element is set
+//               to value, converted to type T.
+//
+	void setX (unsigned int element, double value)
+	{
+		assert(element < size());
+		mv_components[element * 3 + 0] = (T)(value);
+	}
+	void setY (unsigned int element, double value)
+	{
+		assert(element < size());
+		mv_components[element * 3 + 1] = (T)(value);
+	}
+	void setZ (unsigned int element, double value)
+	{
+		assert(element < size());
+		mv_components[element * 3 + 2] = (T)(value);
+	}
+
+//
+//  add
+//
+//  Purpose: To add an element to the end of this
+//           GeometryArray3.
+//  Parameter(s):
+//    <1> value: The value to add
+//    <1> x
+//    <2> y
+//    <3> z: The components of the value to add
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new element with value value / (x, y, z),
+//               converted to type T, is added to the end of
+//               this GeometryArray3.
+//
+	void add (const Vector3& value)
+	{
+		add(value.x, value.y, value.z);
+	}
+	void add (double x, double y, double z)
+	{
+		mv_components.push_back((T)(x));
+		mv_components.push_back((T)(y));
+		mv_components.push_back((T)(z));
+	}
+
+private:
+	std::vector<T> mv_components;
+};
+
+
+
+//
+//  GeometryArray2
+//
+//  A templated class to store an array of 2D values (such as
+//    texture coordinates) packed together as x, y pairs.  It is
+//    the same as GeometryArray3, except that there are only 2
+//    components and values are set and retrieved as Vector2s.
+//
+template <typename T>
+class GeometryArray2
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new empty GeometryArray2.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new GeometryArray2 is created with no
+//               elements.
+//
+	GeometryArray2 ()
+			: mv_components()
+	{ }
+
+//
+//  size
+//
+//  Purpose: To determine the number of elements in this
+//           GeometryArray2.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of elements.
+//  Side Effect: N/A
+//
+	unsigned int size () const
+	{
+		return (unsigned int)(mv_components.size() / 2);
+	}
+
+//
+//  empty
+//
+//  Purpose: To determine if this GeometryArray2 contains no
+//           elements.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this GeometryArray2 is empty.
+//  Side Effect: N/A
+//
+	bool empty () const
+	{
+		return mv_components.empty();
+	}
+
+//
+//  getX
+//  getY
+//
+//  Purpose: To determine the x/y component of the specified
+//           element.
+//  Parameter(s):
+//    <1> element: Which element
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: The x/y component of element element.
+//  Side Effect: N/A
+//
+	T getX (unsigned int element) const
+	{
+		assert(element < size());
+		return mv_components[element * 2 + 0];
+	}
+	T getY (unsigned int element) const
+	{
+		assert(element < size());
+		return mv_components[element * 2 + 1];
+	}
+
+//
+//  get
+//
+//  Purpose: To retrieve the specified element as a Vector2.
+//  Parameter(s):
+//    <1> element: Which element
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: Element element.
+//  Side Effect: N/A
+//
+	Vector2 get (unsigned int element) const
+	{
+		assert(element < size());
+		return Vector2(getX(element), getY(element));
+	}
+
+//
+//  getArray
+//
+//  Purpose: To retrieve a pointer to the stored components of
+//           the specified element.
+//  Parameter(s):
+//    <1> element: Which element
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: A pointer to an array of 2 Ts holding the x and y
+//           components of element element.  The pointer is
+//           invalidated if elements are added or removed.
+//  Side Effect: N/A
+//
+	const T* getArray (unsigned int element) const
+	{
+		assert(element < size());
+		return &(mv_components[element * 2]);
+	}
+
+//
+//  getData
+//
+//  Purpose: To retrieve a pointer to the stored components of
+//           all elements.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !empty()
+//  Returns: A pointer to an array of size() * 2 Ts holding the
+//           components of the elements in order.  The pointer
+//           is invalidated if elements are added or removed.
+//  Side Effect: N/A
+//
+	const T* getData () const
+	{
+		assert(!empty());
+		return &(mv_components[0]);
+	}
+
+//
+//  getByteCount
+//
+//  Purpose: To determine the amount of memory used to store the
+//           elements in this GeometryArray2.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of bytes of storage used by the
+//           elements.  This does not include unused capacity.
+//  Side Effect: N/A
+//
+	unsigned int getByteCount () const
+	{
+		return (unsigned int)(mv_components.size() * sizeof(T));
+	}
+
+//
+//  clear
+//
+//  Purpose: To remove all elements from this GeometryArray2.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This GeometryArray2 is set to contain no
+//               elements.
+//
+	void clear ()
+	{
+		mv_components.clear();
+	}
+
+//
+//  resize
+//
+//  Purpose: To change the number of elements in this
+//           GeometryArray2.
+//  Parameter(s):
+//    <1> count: The new number of elements
+//    <2> fill: The value for any added elements
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If count is less than size(), the elements at
+//               the end of this GeometryArray2 are removed.  If
+//               count is greater, elements with value fill are
+//               added to the end.
+//
+	void resize (unsigned int count, const Vector2& fill)
+	{
+		unsigned int old_size = size();
+		mv_components.resize(count * 2);
+		for(unsigned int i = old_size; i < count; i++)
+			set(i, fill);
+	}
+
+//
+//  set
+//
+//  Purpose: To change the value of the specified element.
+//  Parameter(s):
+//    <1> element: Which element
+//    <2> value: The new value
+//    <2> x
+//    <3> y: The components of the new value
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: N/A
+//  Side Effect: Element element is set to value / (x, y),
+//               converted to type T.
+//
+	void set (unsigned int element, const Vector2& value)
+	{
+		assert(element < size());
+		set(element, value.x, value.y);
+	}
+	void set (unsigned int element, double x, double y)
+	{
+		assert(element < size());
+
+		mv_components[element * 2 + 0] = (T)(x);
+		mv_components[element * 2 + 1] = (T)(y);
+	}
+
+//
+//  setX
+//  setY
+//
+//  Purpose: To change the x/y component of the specified
+//           element.
+//  Parameter(s):
+//    <1> element: Which element
+//    <2> value: The new value for the component
+//  Precondition(s):
+//    <1> element < size()
+//  Returns: N/A
+//  Side Effect: The x/y component of element element is set to
+//               value, converted to type T.
+//
+	void setX (unsigned int element, double value)
+	{
+		assert(element < size());
+		mv_components[element * 2 + 0] = (T)(value);
+	}
+	void setY (unsigned int element, double value)
+	{
+		assert(element < size());
+		mv_components[element * 2 + 1] = (T)(value);
+	}
+
+//
+//  add
+//
+//  Purpose: To add an element to the end of this
+//           GeometryArray2.
+//  Parameter(s):
+//    <1> value: The value to add
+//    <1> x
+//    <2> y: The components of the value to add
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new element with value value / (x, y),
+//               converted to type T, is added to the end of
+//               this GeometryArray2.
+//
+	void add (const Vector2& value)
+	{
+		add(value.x, value.y);
+	}
+	void add (double x, double y)
+	{
+		mv_components.push_back((T)(x));
+		mv_components.push_back((T)(y));
+	}
+
+private:
+	std::vector<T> mv_components;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,278 @@
+//
+//  GlCallCounter.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "ObjSettings.h"
+#include "GlCallCounter.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  Zones
+	//
+	//  A record to store all the zones.  It is created the
+	//    first time it is used, so zones can be added by
+	//    constructors of global objects.  It is never
+	//    destroyed, so destructors of global objects can still
+	//    make counted OpenGL calls.
+	//
+	struct Zones
+	{
+		vector<string> mv_names;
+		vector<GlCallCounts> mv_counts;
+		vector<GlCallCounts> mv_last_frame_counts;
+		vector<unsigned int> mv_stack;
+		bool m_is_recording_list;
+		GlCallCounts m_list_counts;
+
+		Zones ()
+				: mv_names(1, "other")
+				, mv_counts(1)
+				, mv_last_frame_counts(1)
+				, m_is_recording_list(false)
+		{
+			assert(mv_names.size() == GlCallCounter::ZONE_OTHER + 1);
+		}
+	};
+
+	Zones& getZones ()
+	{
+		static Zones* p_zones = new Zones();
+		return *p_zones;
+	}
+
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	GlCallCounts& getRecordTarget ()
+	{
+		Zones& zones = getZones();
+		if(zones.m_is_recording_list)
+			return zones.m_list_counts;
+		else if(zones.mv_stack.empty())
+			return zones.mv_counts[GlCallCounter::ZONE_OTHER];
+		else
+			return zones.mv_counts[zones.mv_stack.back()];
+	}
+#endif
+}
+
+
+
+GlCallCounts :: GlCallCounts ()
+		: m_call_count(0)
+		, m_draw_count(0)
+		, m_vertex_count(0)
+		, m_list_call_count(0)
+		, m_texture_bind_count(0)
+		, m_material_count(0)
+{
+}
+
+void GlCallCounts :: add (const GlCallCounts& other)
+{
+	m_call_count         += other.m_call_count;
+	m_draw_count         += other.m_draw_count;
+	m_vertex_count       += other.m_vertex_count;
+	m_list_call_count    += other.m_list_call_count;
+	m_texture_bind_count += other.m_texture_bind_count;
+	m_material_count     += other.m_material_count;
+}
+
+
+
+bool GlCallCounter :: isEnabled ()
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	return true;
+#else
+	return false;
+#endif
+}
+
+unsigned int GlCallCounter :: getZoneCount ()
+{
+	return (unsigned int)(getZones().mv_names.size());
+}
+
+const std::string& GlCallCounter :: getZoneName (unsigned int zone)
+{
+	assert(zone < getZoneCount());
+
+	return getZones().mv_names[zone];
+}
+
+unsigned int GlCallCounter :: getZone (const std::string& name)
+{
+	Zones& zones = getZones();
+	for(unsigned int i = 0; i < zones.mv_names.size(); i++)
+		if(zones.mv_names[i] == name)
+			return i;
+
+	zones.mv_names.push_back(name);
+	zones.mv_counts.push_back(GlCallCounts());
+	zones.mv_last_frame_counts.push_back(GlCallCounts());
+	return (unsigned int)(zones.mv_names.size() - 1);
+}
+
+unsigned int GlCallCounter :: getCurrentZone ()
+{
+	const Zones& zones = getZones();
+	if(zones.mv_stack.empty())
+		return ZONE_OTHER;
+	else
+		return zones.mv_stack.back();
+}
+
+void GlCallCounter :: pushZone (unsigned int zone)
+{
+	assert(zone < getZoneCount());
+
+	getZones().mv_stack.push_back(zone);
+}
+
+void GlCallCounter :: popZone ()
+{
+	assert(!getZones().mv_stack.empty());
+
+	getZones().mv_stack.pop_back();
+}
+
+const GlCallCounts& GlCallCounter :: getCounts (unsigned int zone)
+{
+	assert(zone < getZoneCount());
+
+	return getZones().mv_counts[zone];
+}
+
+const GlCallCounts& GlCallCounter :: getLastFrameCounts (unsigned int zone)
+{
+	assert(zone < getZoneCount());
+
+	return getZones().mv_last_frame_counts[zone];
+}
+
+GlCallCounts GlCallCounter :: getLastFrameTotal ()
+{
+	const Zones& zones = getZones();
+
+	GlCallCounts total;
+	for(unsigned int i = 0; i < zones.mv_last_frame_counts.size(); i++)
+		total.add(zones.mv_last_frame_counts[i]);
+	return total;
+}
+
+void GlCallCounter :: endFrame ()
+{
+	Zones& zones = getZones();
+	zones.mv_last_frame_counts.swap(zones.mv_counts);
+	for(unsigned int i = 0; i < zones.mv_counts.size(); i++)
+		zones.mv_counts[i] = GlCallCounts();
+}
+
+
+
+void GlCallCounter :: countCall ()
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	getRecordTarget().m_call_count += 1;
+#endif
+}
+
+void GlCallCounter :: countBegin ()
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	GlCallCounts& target = getRecordTarget();
+	target.m_call_count += 1;
+	target.m_draw_count += 1;
+#endif
+}
+
+void GlCallCounter :: countVertex ()
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	GlCallCounts& target = getRecordTarget();
+	target.m_call_count   += 1;
+	target.m_vertex_count += 1;
+#endif
+}
+
+void GlCallCounter :: countDraw (unsigned int vertex_count)
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	GlCallCounts& target = getRecordTarget();
+	target.m_call_count   += 1;
+	target.m_draw_count   += 1;
+	target.m_vertex_count += vertex_count;
+#endif
+}
+
+void GlCallCounter :: countIndirectVertexes (unsigned int vertex_count)
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	getRecordTarget().m_vertex_count += vertex_count;
+#endif
+}
+
+void GlCallCounter :: countTextureBind ()
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	GlCallCounts& target = getRecordTarget();
+	target.m_call_count         += 1;
+	target.m_texture_bind_count += 1;
+#endif
+}
+
+void GlCallCounter :: countMaterial ()
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	getRecordTarget().m_material_count += 1;
+#endif
+}
+
+void GlCallCounter :: countListCall (const GlCallCounts& list_counts)
+{
+#ifdef OBJ_LIBRARY_COUNT_GL_CALLS
+	GlCallCounts& target = getRecordTarget();
+	target.add(list_counts);
+	target.m_call_count      += 1;
+	target.m_list_call_count += 1;
+#endif
+}
+
+void GlCallCounter :: beginList ()
+{
+	Zones& zones = getZones();
+	assert(!zones.m_is_recording_list);
+
+	zones.m_is_recording_list = true;
+	zones.m_list_counts = GlCallCounts();
+}
+
+GlCallCounts GlCallCounter :: endList ()
+{
+	Zones& zones = getZones();
+	assert(zones.m_is_recording_list);
+
+	zones.m_is_recording_list = false;
+	return zones.m_list_counts;
+}
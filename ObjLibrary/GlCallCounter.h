@@ -0,0 +1,629 @@
+//
+//  GlCallCounter.h
+//
+//  A module to count the OpenGL calls made by the ObjLibrary.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_GL_CALL_COUNTER_H
+#define OBJ_LIBRARY_GL_CALL_COUNTER_H
+
+#include <string>
+
+#include "ObjSettings.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  GlCallCounts
+//
+//  A record to store how much work was sent to OpenGL.
+//
+//  Only OpenGL calls made in files that include
+//    GlCallCounter.h after the OpenGL headers are counted.
+//    Calls compiled into a display list are counted each time
+//    the list is drawn.
+//
+struct GlCallCounts
+{
+	unsigned int m_call_count;          // all counted OpenGL calls
+	unsigned int m_draw_count;          // glBegin/glEnd pairs and glDraw* calls
+	unsigned int m_vertex_count;        // vertexes submitted by those draws
+	unsigned int m_list_call_count;     // glCallList calls
+	unsigned int m_texture_bind_count;  // glBindTexture calls
+	unsigned int m_material_count;      // Material activations
+
+	GlCallCounts ();
+	void add (const GlCallCounts& other);
+};
+
+
+
+//
+//  GlCallCounter
+//
+//  A global service to count OpenGL calls each frame.  The
+//    counts are attributed to zones, which are named parts of
+//    the frame such as "skybox" or "overlay".  Client code
+//    selects a zone with pushZone and popZone (or a GlCallZone)
+//    around the drawing for that part of the frame.  Calls
+//    made outside any zone are counted in zone ZONE_OTHER.
+//
+//  At the end of each frame, client code calls endFrame.  The
+//    counts for the frame are then kept for display while the
+//    next frame is counted.
+//
+//  Calls made while a DisplayList is being compiled are not
+//    sent to OpenGL immediately, so they are not counted for
+//    the current frame.  Instead, the DisplayList remembers
+//    them and adds them each time it is drawn.  So the vertex
+//    count includes the vertexes inside display lists.
+//
+//  The calls are counted by macros at the end of this file.
+//    Each replaces an OpenGL function with one that counts the
+//    call and then makes it, so the counts cannot drift from
+//    the code.  Client code only has to select zones and call
+//    endFrame.
+//
+//  Counting is only performed if OBJ_LIBRARY_COUNT_GL_CALLS is
+//    #defined (see ObjSettings.h).  Otherwise, the OpenGL
+//    functions are not replaced, the counting functions do
+//    nothing, and all counts are always 0.
+//
+namespace GlCallCounter
+{
+
+//
+//  ZONE_OTHER
+//
+//  The zone for calls made when no zone has been pushed.  It is
+//    named "other".
+//
+const unsigned int ZONE_OTHER = 0;
+
+
+
+//
+//  isEnabled
+//
+//  Purpose: To determine if OpenGL calls are being counted.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether OBJ_LIBRARY_COUNT_GL_CALLS is #defined.
+//  Side Effect: N/A
+//
+
+bool isEnabled ();
+
+//
+//  getZoneCount
+//
+//  Purpose: To determine how many zones there are.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of zones, including ZONE_OTHER.
+//  Side Effect: N/A
+//
+
+unsigned int getZoneCount ();
+
+//
+//  getZoneName
+//
+//  Purpose: To determine the name of a zone.
+//  Parameter(s):
+//    <1> zone: Which zone
+//  Precondition(s):
+//    <1> zone < getZoneCount()
+//  Returns: The name of zone zone.
+//  Side Effect: N/A
+//
+
+const std::string& getZoneName (unsigned int zone);
+
+//
+//  getZone
+//
+//  Purpose: To determine the zone with the specified name.
+//  Parameter(s):
+//    <1> name: The zone name
+//  Precondition(s): N/A
+//  Returns: The index of the zone named name.
+//  Side Effect: If there is no zone named name, one is added.
+//               Zone names are case-sensitive.
+//
+
+unsigned int getZone (const std::string& name);
+
+//
+//  getCurrentZone
+//
+//  Purpose: To determine which zone calls are counted in.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The zone most recently pushed and not popped, or
+//           ZONE_OTHER if there is none.
+//  Side Effect: N/A
+//
+
+unsigned int getCurrentZone ();
+
+//
+//  pushZone
+//
+//  Purpose: To start counting calls in a zone.
+//  Parameter(s):
+//    <1> zone: Which zone
+//  Precondition(s):
+//    <1> zone < getZoneCount()
+//  Returns: N/A
+//  Side Effect: Calls are counted in zone zone until popZone
+//               is called.  The previous zone is remembered.
+//
+
+void pushZone (unsigned int zone);
+
+//
+//  popZone
+//
+//  Purpose: To stop counting calls in the current zone.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> A zone has been pushed and not popped
+//  Returns: N/A
+//  Side Effect: Calls are counted in the zone that was current
+//               before the matching call to pushZone.
+//
+
+void popZone ();
+
+//
+//  getCounts
+//
+//  Purpose: To determine the calls counted in a zone so far
+//           this frame.
+//  Parameter(s):
+//    <1> zone: Which zone
+//  Precondition(s):
+//    <1> zone < getZoneCount()
+//  Returns: The counts for zone zone since endFrame was last
+//           called.
+//  Side Effect: N/A
+//
+
+const GlCallCounts& getCounts (unsigned int zone);
+
+//
+//  getLastFrameCounts
+//
+//  Purpose: To determine the calls counted in a zone in the
+//           last complete frame.
+//  Parameter(s):
+//    <1> zone: Which zone
+//  Precondition(s):
+//    <1> zone < getZoneCount()
+//  Returns: The counts for zone zone between the last two
+//           calls to endFrame.
+//  Side Effect: N/A
+//
+
+const GlCallCounts& getLastFrameCounts (unsigned int zone);
+
+//
+//  getLastFrameTotal
+//
+//  Purpose: To determine the calls counted in all zones in the
+//           last complete frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The sum of getLastFrameCounts for every zone.
+//  Side Effect: N/A
+//
+
+GlCallCounts getLastFrameTotal ();
+
+//
+//  endFrame
+//
+//  Purpose: To mark the end of a frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The counts for this frame become the last frame
+//               counts, and the counts for every zone are reset
+//               to 0.  The zones are kept.
+//
+
+void endFrame ();
+
+//
+//  countCall
+//
+//  Purpose: To count an OpenGL call that does not draw
+//           anything.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A call is counted in the current zone.
+//
+
+void countCall ();
+
+//
+//  countBegin
+//
+//  Purpose: To count a call to glBegin.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A call and a draw are counted in the current
+//               zone.  The vertexes are counted by countVertex.
+//
+
+void countBegin ();
+
+//
+//  countVertex
+//
+//  Purpose: To count a call to glVertex*.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A call and a vertex are counted in the current
+//               zone.
+//
+
+void countVertex ();
+
+//
+//  countDraw
+//
+//  Purpose: To count a call to glDrawArrays, glDrawElements, or
+//           a similar function.
+//  Parameter(s):
+//    <1> vertex_count: The number of vertexes drawn, including
+//                      all instances
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A call and a draw of vertex_count vertexes are
+//               counted in the current zone.
+//
+
+void countDraw (unsigned int vertex_count);
+
+//
+//  countIndirectVertexes
+//
+//  Purpose: To count the vertexes drawn by an indirect draw
+//           call, such as glMultiDrawElementsIndirect.
+//  Parameter(s):
+//    <1> vertex_count: The number of vertexes drawn, including
+//                      all instances
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: vertex_count vertexes are counted in the
+//               current zone.  The call and the draw are
+//               counted when the call is made, but the
+//               vertexes are in a buffer object, so the caller
+//               must count them.
+//
+
+void countIndirectVertexes (unsigned int vertex_count);
+
+//
+//  countTextureBind
+//
+//  Purpose: To count a call to glBindTexture.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A call and a texture bind are counted in the
+//               current zone.
+//
+
+void countTextureBind ();
+
+//
+//  countMaterial
+//
+//  Purpose: To count a Material activation.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A Material activation is counted in the
+//               current zone.  The OpenGL calls it makes are
+//               counted separately.
+//
+
+void countMaterial ();
+
+//
+//  countListCall
+//
+//  Purpose: To count a call to glCallList.
+//  Parameter(s):
+//    <1> list_counts: The counts recorded when the list was
+//                     compiled
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The list call and everything in list_counts is
+//               counted in the current zone.  glCallList is not
+//               replaced by a macro, because only the
+//               DisplayList knows what was compiled into it.
+//
+
+void countListCall (const GlCallCounts& list_counts);
+
+//
+//  beginList
+//
+//  Purpose: To start recording the calls compiled into a
+//           display list.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> beginList has not been called without a matching
+//        call to endList
+//  Returns: N/A
+//  Side Effect: Calls are recorded for the list instead of
+//               being counted in a zone.
+//
+
+void beginList ();
+
+//
+//  endList
+//
+//  Purpose: To stop recording the calls compiled into a
+//           display list.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> beginList has been called without a matching call to
+//        endList
+//  Returns: The calls recorded since beginList was called.
+//  Side Effect: Calls are counted in the current zone again.
+//
+
+GlCallCounts endList ();
+
+}  // end of namespace GlCallCounter
+
+
+
+//
+//  GlCallZone
+//
+//  A class to count OpenGL calls in a zone for as long as it
+//    exists.  The constructor calls GlCallCounter::pushZone and
+//    the destructor calls GlCallCounter::popZone.
+//
+class GlCallZone
+{
+public:
+	GlCallZone (unsigned int zone)
+	{	GlCallCounter::pushZone(zone);	}
+	GlCallZone (const GlCallZone& to_copy) = delete;
+	~GlCallZone ()
+	{	GlCallCounter::popZone();	}
+	GlCallZone& operator= (const GlCallZone& to_copy) = delete;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif  // OBJ_LIBRARY_GL_CALL_COUNTER_H
+
+
+
+//
+//  The OpenGL functions are replaced after the OpenGL headers
+//    have declared them, so this part is outside the include
+//    guard.  A file that includes GlCallCounter.h before the
+//    OpenGL headers (such as through DisplayList.h) must
+//    include it again after them for its calls to be counted.
+//
+//  Each macro counts the call and then calls the function with
+//    the same name, which the preprocessor does not replace
+//    again.  The arguments are only evaluated once.  An
+//    OpenGL function that is not listed here is not counted,
+//    so add any new function the program uses.
+//
+#if defined(OBJ_LIBRARY_COUNT_GL_CALLS) && defined(GL_VERSION_1_1) && !defined(OBJ_LIBRARY_GL_CALLS_REPLACED)
+#define OBJ_LIBRARY_GL_CALLS_REPLACED
+
+namespace ObjLibrary
+{
+namespace GlCallCounter
+{
+	// the OpenGL function is passed in so it is only needed where it is used
+	template <typename FUNCTION>
+	inline void drawArrays (FUNCTION p_function, GLenum mode, GLint first, GLsizei count)
+	{
+		countDraw((unsigned int)(count));
+		p_function(mode, first, count);
+	}
+
+	template <typename FUNCTION>
+	inline void drawElements (FUNCTION p_function, GLenum mode, GLsizei count,
+	                          GLenum type, const GLvoid* indices)
+	{
+		countDraw((unsigned int)(count));
+		p_function(mode, count, type, indices);
+	}
+
+	template <typename FUNCTION>
+	inline void drawElementsInstanced (FUNCTION p_function, GLenum mode, GLsizei count,
+	                                   GLenum type, const GLvoid* indices, GLsizei instance_count)
+	{
+		countDraw((unsigned int)(count) * (unsigned int)(instance_count));
+		p_function(mode, count, type, indices, instance_count);
+	}
+
+	template <typename FUNCTION>
+	inline void drawElementsInstancedBaseVertex (FUNCTION p_function, GLenum mode, GLsizei count,
+	                                             GLenum type, const GLvoid* indices,
+	                                             GLsizei instance_count, GLint base_vertex)
+	{
+		countDraw((unsigned int)(count) * (unsigned int)(instance_count));
+		p_function(mode, count, type, indices, instance_count, base_vertex);
+	}
+
+	// the vertexes are counted by countIndirectVertexes
+	template <typename FUNCTION>
+	inline void multiDrawElementsIndirect (FUNCTION p_function, GLenum mode, GLenum type,
+	                                       const GLvoid* indirect, GLsizei draw_count, GLsizei stride)
+	{
+		countDraw(0);
+		p_function(mode, type, indirect, draw_count, stride);
+	}
+}  // end of namespace GlCallCounter
+}  // end of namespace ObjLibrary
+
+#define OBJ_LIBRARY_COUNTED_GL_CALL(NAME, ...) \
+	(ObjLibrary::GlCallCounter::countCall(), NAME(__VA_ARGS__))
+
+// draws
+#define glBegin(...)     (ObjLibrary::GlCallCounter::countBegin(),  glBegin(__VA_ARGS__))
+#define glVertex2d(...)  (ObjLibrary::GlCallCounter::countVertex(), glVertex2d(__VA_ARGS__))
+#define glVertex3d(...)  (ObjLibrary::GlCallCounter::countVertex(), glVertex3d(__VA_ARGS__))
+#define glVertex3dv(...) (ObjLibrary::GlCallCounter::countVertex(), glVertex3dv(__VA_ARGS__))
+#define glVertex3fv(...) (ObjLibrary::GlCallCounter::countVertex(), glVertex3fv(__VA_ARGS__))
+#define glDrawArrays(...)            ObjLibrary::GlCallCounter::drawArrays(glDrawArrays, __VA_ARGS__)
+#define glDrawElements(...)          ObjLibrary::GlCallCounter::drawElements(glDrawElements, __VA_ARGS__)
+#define glDrawElementsInstanced(...) ObjLibrary::GlCallCounter::drawElementsInstanced(glDrawElementsInstanced, __VA_ARGS__)
+#define glDrawElementsInstancedBaseVertex(...) \
+	ObjLibrary::GlCallCounter::drawElementsInstancedBaseVertex(glDrawElementsInstancedBaseVertex, __VA_ARGS__)
+#define glMultiDrawElementsIndirect(...) \
+	ObjLibrary::GlCallCounter::multiDrawElementsIndirect(glMultiDrawElementsIndirect, __VA_ARGS__)
+
+// textures
+#define glBindTexture(...) (ObjLibrary::GlCallCounter::countTextureBind(), glBindTexture(__VA_ARGS__))
+
+// everything else
+#define glActiveTexture(...)            OBJ_LIBRARY_COUNTED_GL_CALL(glActiveTexture, __VA_ARGS__)
+#define glAlphaFunc(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glAlphaFunc, __VA_ARGS__)
+#define glAttachShader(...)             OBJ_LIBRARY_COUNTED_GL_CALL(glAttachShader, __VA_ARGS__)
+#define glBindAttribLocation(...)       OBJ_LIBRARY_COUNTED_GL_CALL(glBindAttribLocation, __VA_ARGS__)
+#define glBindBuffer(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glBindBuffer, __VA_ARGS__)
+#define glBindFramebuffer(...)          OBJ_LIBRARY_COUNTED_GL_CALL(glBindFramebuffer, __VA_ARGS__)
+#define glBindRenderbuffer(...)         OBJ_LIBRARY_COUNTED_GL_CALL(glBindRenderbuffer, __VA_ARGS__)
+#define glBindVertexArray(...)          OBJ_LIBRARY_COUNTED_GL_CALL(glBindVertexArray, __VA_ARGS__)
+#define glBlendFunc(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glBlendFunc, __VA_ARGS__)
+#define glBufferData(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glBufferData, __VA_ARGS__)
+#define glBufferSubData(...)            OBJ_LIBRARY_COUNTED_GL_CALL(glBufferSubData, __VA_ARGS__)
+#define glCheckFramebufferStatus(...)   OBJ_LIBRARY_COUNTED_GL_CALL(glCheckFramebufferStatus, __VA_ARGS__)
+#define glClear(...)                    OBJ_LIBRARY_COUNTED_GL_CALL(glClear, __VA_ARGS__)
+#define glClearColor(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glClearColor, __VA_ARGS__)
+#define glColor3f(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(glColor3f, __VA_ARGS__)
+#define glColor4f(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(glColor4f, __VA_ARGS__)
+#define glColor4fv(...)                 OBJ_LIBRARY_COUNTED_GL_CALL(glColor4fv, __VA_ARGS__)
+#define glColor4ub(...)                 OBJ_LIBRARY_COUNTED_GL_CALL(glColor4ub, __VA_ARGS__)
+#define glColorPointer(...)             OBJ_LIBRARY_COUNTED_GL_CALL(glColorPointer, __VA_ARGS__)
+#define glCompileShader(...)            OBJ_LIBRARY_COUNTED_GL_CALL(glCompileShader, __VA_ARGS__)
+#define glCreateProgram()               OBJ_LIBRARY_COUNTED_GL_CALL(glCreateProgram)
+#define glCreateShader(...)             OBJ_LIBRARY_COUNTED_GL_CALL(glCreateShader, __VA_ARGS__)
+#define glDeleteBuffers(...)            OBJ_LIBRARY_COUNTED_GL_CALL(glDeleteBuffers, __VA_ARGS__)
+#define glDeleteFramebuffers(...)       OBJ_LIBRARY_COUNTED_GL_CALL(glDeleteFramebuffers, __VA_ARGS__)
+#define glDeleteLists(...)              OBJ_LIBRARY_COUNTED_GL_CALL(glDeleteLists, __VA_ARGS__)
+#define glDeleteProgram(...)            OBJ_LIBRARY_COUNTED_GL_CALL(glDeleteProgram, __VA_ARGS__)
+#define glDeleteRenderbuffers(...)      OBJ_LIBRARY_COUNTED_GL_CALL(glDeleteRenderbuffers, __VA_ARGS__)
+#define glDeleteShader(...)             OBJ_LIBRARY_COUNTED_GL_CALL(glDeleteShader, __VA_ARGS__)
+#define glDeleteTextures(...)           OBJ_LIBRARY_COUNTED_GL_CALL(glDeleteTextures, __VA_ARGS__)
+#define glDeleteVertexArrays(...)       OBJ_LIBRARY_COUNTED_GL_CALL(glDeleteVertexArrays, __VA_ARGS__)
+#define glDepthFunc(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glDepthFunc, __VA_ARGS__)
+#define glDepthMask(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glDepthMask, __VA_ARGS__)
+#define glDisable(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(glDisable, __VA_ARGS__)
+#define glDisableClientState(...)       OBJ_LIBRARY_COUNTED_GL_CALL(glDisableClientState, __VA_ARGS__)
+#define glDisableVertexAttribArray(...) OBJ_LIBRARY_COUNTED_GL_CALL(glDisableVertexAttribArray, __VA_ARGS__)
+#define glEnable(...)                   OBJ_LIBRARY_COUNTED_GL_CALL(glEnable, __VA_ARGS__)
+#define glEnableClientState(...)        OBJ_LIBRARY_COUNTED_GL_CALL(glEnableClientState, __VA_ARGS__)
+#define glEnableVertexAttribArray(...)  OBJ_LIBRARY_COUNTED_GL_CALL(glEnableVertexAttribArray, __VA_ARGS__)
+#define glEnd()                         OBJ_LIBRARY_COUNTED_GL_CALL(glEnd)
+#define glEndList()                     OBJ_LIBRARY_COUNTED_GL_CALL(glEndList)
+#define glFinish()                      OBJ_LIBRARY_COUNTED_GL_CALL(glFinish)
+#define glFramebufferRenderbuffer(...)  OBJ_LIBRARY_COUNTED_GL_CALL(glFramebufferRenderbuffer, __VA_ARGS__)
+#define glFramebufferTexture2D(...)     OBJ_LIBRARY_COUNTED_GL_CALL(glFramebufferTexture2D, __VA_ARGS__)
+#define glGenBuffers(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glGenBuffers, __VA_ARGS__)
+#define glGenFramebuffers(...)          OBJ_LIBRARY_COUNTED_GL_CALL(glGenFramebuffers, __VA_ARGS__)
+#define glGenLists(...)                 OBJ_LIBRARY_COUNTED_GL_CALL(glGenLists, __VA_ARGS__)
+#define glGenRenderbuffers(...)         OBJ_LIBRARY_COUNTED_GL_CALL(glGenRenderbuffers, __VA_ARGS__)
+#define glGenTextures(...)              OBJ_LIBRARY_COUNTED_GL_CALL(glGenTextures, __VA_ARGS__)
+#define glGenVertexArrays(...)          OBJ_LIBRARY_COUNTED_GL_CALL(glGenVertexArrays, __VA_ARGS__)
+#define glGenerateMipmap(...)           OBJ_LIBRARY_COUNTED_GL_CALL(glGenerateMipmap, __VA_ARGS__)
+#define glGetDoublev(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glGetDoublev, __VA_ARGS__)
+#define glGetIntegerv(...)              OBJ_LIBRARY_COUNTED_GL_CALL(glGetIntegerv, __VA_ARGS__)
+#define glGetProgramInfoLog(...)        OBJ_LIBRARY_COUNTED_GL_CALL(glGetProgramInfoLog, __VA_ARGS__)
+#define glGetProgramiv(...)             OBJ_LIBRARY_COUNTED_GL_CALL(glGetProgramiv, __VA_ARGS__)
+#define glGetShaderInfoLog(...)         OBJ_LIBRARY_COUNTED_GL_CALL(glGetShaderInfoLog, __VA_ARGS__)
+#define glGetShaderiv(...)              OBJ_LIBRARY_COUNTED_GL_CALL(glGetShaderiv, __VA_ARGS__)
+#define glGetString(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glGetString, __VA_ARGS__)
+#define glGetUniformLocation(...)       OBJ_LIBRARY_COUNTED_GL_CALL(glGetUniformLocation, __VA_ARGS__)
+#define glIsEnabled(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glIsEnabled, __VA_ARGS__)
+#define glIsTexture(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glIsTexture, __VA_ARGS__)
+#define glLinkProgram(...)              OBJ_LIBRARY_COUNTED_GL_CALL(glLinkProgram, __VA_ARGS__)
+#define glLoadIdentity()                OBJ_LIBRARY_COUNTED_GL_CALL(glLoadIdentity)
+#define glMaterialf(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glMaterialf, __VA_ARGS__)
+#define glMaterialfv(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glMaterialfv, __VA_ARGS__)
+#define glMatrixMode(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glMatrixMode, __VA_ARGS__)
+#define glMultMatrixd(...)              OBJ_LIBRARY_COUNTED_GL_CALL(glMultMatrixd, __VA_ARGS__)
+#define glNewList(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(glNewList, __VA_ARGS__)
+#define glNormal3dv(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glNormal3dv, __VA_ARGS__)
+#define glNormal3fv(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glNormal3fv, __VA_ARGS__)
+#define glNormalPointer(...)            OBJ_LIBRARY_COUNTED_GL_CALL(glNormalPointer, __VA_ARGS__)
+#define glOrtho(...)                    OBJ_LIBRARY_COUNTED_GL_CALL(glOrtho, __VA_ARGS__)
+#define glPixelStorei(...)              OBJ_LIBRARY_COUNTED_GL_CALL(glPixelStorei, __VA_ARGS__)
+#define glPopAttrib()                   OBJ_LIBRARY_COUNTED_GL_CALL(glPopAttrib)
+#define glPopClientAttrib()             OBJ_LIBRARY_COUNTED_GL_CALL(glPopClientAttrib)
+#define glPopMatrix()                   OBJ_LIBRARY_COUNTED_GL_CALL(glPopMatrix)
+#define glPushAttrib(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glPushAttrib, __VA_ARGS__)
+#define glPushClientAttrib(...)         OBJ_LIBRARY_COUNTED_GL_CALL(glPushClientAttrib, __VA_ARGS__)
+#define glPushMatrix()                  OBJ_LIBRARY_COUNTED_GL_CALL(glPushMatrix)
+#define glReadPixels(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glReadPixels, __VA_ARGS__)
+#define glRenderbufferStorage(...)      OBJ_LIBRARY_COUNTED_GL_CALL(glRenderbufferStorage, __VA_ARGS__)
+#define glRotated(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(glRotated, __VA_ARGS__)
+#define glScaled(...)                   OBJ_LIBRARY_COUNTED_GL_CALL(glScaled, __VA_ARGS__)
+#define glScissor(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(glScissor, __VA_ARGS__)
+#define glShadeModel(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glShadeModel, __VA_ARGS__)
+#define glShaderSource(...)             OBJ_LIBRARY_COUNTED_GL_CALL(glShaderSource, __VA_ARGS__)
+#define glTexCoord2d(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glTexCoord2d, __VA_ARGS__)
+#define glTexCoord3d(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glTexCoord3d, __VA_ARGS__)
+#define glTexCoordPointer(...)          OBJ_LIBRARY_COUNTED_GL_CALL(glTexCoordPointer, __VA_ARGS__)
+#define glTexEnvf(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(glTexEnvf, __VA_ARGS__)
+#define glTexEnvi(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(glTexEnvi, __VA_ARGS__)
+#define glTexImage2D(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glTexImage2D, __VA_ARGS__)
+#define glTexImage3D(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glTexImage3D, __VA_ARGS__)
+#define glTexParameterfv(...)           OBJ_LIBRARY_COUNTED_GL_CALL(glTexParameterfv, __VA_ARGS__)
+#define glTexParameteri(...)            OBJ_LIBRARY_COUNTED_GL_CALL(glTexParameteri, __VA_ARGS__)
+#define glTexSubImage3D(...)            OBJ_LIBRARY_COUNTED_GL_CALL(glTexSubImage3D, __VA_ARGS__)
+#define glTranslated(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glTranslated, __VA_ARGS__)
+#define glUniform1f(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glUniform1f, __VA_ARGS__)
+#define glUniform1i(...)                OBJ_LIBRARY_COUNTED_GL_CALL(glUniform1i, __VA_ARGS__)
+#define glUseProgram(...)               OBJ_LIBRARY_COUNTED_GL_CALL(glUseProgram, __VA_ARGS__)
+#define glVertexAttribDivisor(...)      OBJ_LIBRARY_COUNTED_GL_CALL(glVertexAttribDivisor, __VA_ARGS__)
+#define glVertexAttribIPointer(...)     OBJ_LIBRARY_COUNTED_GL_CALL(glVertexAttribIPointer, __VA_ARGS__)
+#define glVertexAttribPointer(...)      OBJ_LIBRARY_COUNTED_GL_CALL(glVertexAttribPointer, __VA_ARGS__)
+#define glViewport(...)                 OBJ_LIBRARY_COUNTED_GL_CALL(glViewport, __VA_ARGS__)
+
+// GLU functions count as one call, without the OpenGL calls they make
+#define gluLookAt(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(gluLookAt, __VA_ARGS__)
+#define gluPerspective(...)             OBJ_LIBRARY_COUNTED_GL_CALL(gluPerspective, __VA_ARGS__)
+#define gluSphere(...)                  OBJ_LIBRARY_COUNTED_GL_CALL(gluSphere, __VA_ARGS__)
+
+#endif  // counting OpenGL calls
@@ -32,6 +32,7 @@
 
 #include "Vector3.h"
 #include "ObjStringParsing.h"
+#include "GlCallCounter.h"
 #include "Texture.h"
 #include "TextureManager.h"
 #include "Material.h"
@@ -1338,6 +1339,7 @@ void Material :: activate () const
 		glDisable(GL_TEXTURE_2D);
 		break;
 	};
+	GlCallCounter::countMaterial();
 
 	g_is_material_active = true;
 	assert(isMaterialActive());
@@ -1376,6 +1378,7 @@ void Material :: activateSeperateSpecular () const
 	glMaterialfv(GL_FRONT, GL_DIFFUSE,   BLACK);
 	glMaterialfv(GL_FRONT, GL_SPECULAR,  a_specular);
 	glMaterialf (GL_FRONT, GL_SHININESS, (GLfloat)(m_specular_exponent));
+	GlCallCounter::countMaterial();
 
 	g_is_material_active = true;
 	assert(isMaterialActive());
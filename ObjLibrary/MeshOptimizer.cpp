@@ -0,0 +1,344 @@
+//
+//  MeshOptimizer.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "MeshOptimizer.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  The scoring constants from Forsyth's article.  The
+	//    cache size here is only for scoring; it does not
+	//    need to match the hardware.
+	//
+	const int    SCORING_CACHE_SIZE   = 32;
+	const double CACHE_DECAY_POWER    = 1.5;
+	const double LAST_TRIANGLE_SCORE  = 0.75;
+	const double VALENCE_BOOST_SCALE  = 2.0;
+	const double VALENCE_BOOST_POWER  = 0.5;
+
+	const int NOT_IN_CACHE = -1;
+	const unsigned int NO_TRIANGLE = 0xFFFFFFFF;
+
+	//
+	//  calculateVertexScore
+	//
+	//  Purpose: To calculate the score for a vertex.
+	//  Parameter(s):
+	//    <1> cache_position: The position of the vertex in the
+	//                        scoring cache, or NOT_IN_CACHE
+	//    <2> remaining_triangles: The number of triangles using
+	//                             the vertex that have not been
+	//                             drawn yet
+	//  Precondition(s):
+	//    <1> cache_position < SCORING_CACHE_SIZE
+	//  Returns: The score.  A vertex with no remaining
+	//           triangles has a score of -1.0.
+	//  Side Effect: N/A
+	//
+	double calculateVertexScore (int cache_position,
+	                             unsigned int remaining_triangles)
+	{
+		assert(cache_position < SCORING_CACHE_SIZE);
+
+		if(remaining_triangles == 0)
+			return -1.0;
+
+		double score = 0.0;
+		if(cache_position >= 0)
+		{
+			if(cache_position < 3)
+			{
+				// vertexes in the last triangle get a fixed score
+				//   to discourage strips that just flip back
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				const double SCALER = 1.0 / (SCORING_CACHE_SIZE - 3);
+				score = 1.0 - (cache_position - 3) * SCALER;
+				score = pow(score, CACHE_DECAY_POWER);
+			}
+		}
+
+		// boost vertexes with few triangles left to get rid of them
+		score += VALENCE_BOOST_SCALE * pow((double)(remaining_triangles), -VALENCE_BOOST_POWER);
+		return score;
+	}
+}
+
+
+
+double MeshOptimizer :: calculateAcmr (const vector<unsigned int>& v_indexes,
+                                       unsigned int cache_size)
+{
+	assert(v_indexes.size() % 3 == 0);
+	assert(cache_size > 0);
+
+	if(v_indexes.empty())
+		return 0.0;
+
+	// simulate a FIFO cache
+	vector<unsigned int> v_cache(cache_size, NO_TRIANGLE);
+	unsigned int next_slot = 0;
+	unsigned int miss_count = 0;
+
+	for(unsigned int i = 0; i < v_indexes.size(); i++)
+	{
+		bool is_hit = false;
+		for(unsigned int c = 0; c < cache_size; c++)
+			if(v_cache[c] == v_indexes[i])
+			{
+				is_hit = true;
+				break;
+			}
+
+		if(!is_hit)
+		{
+			miss_count++;
+			v_cache[next_slot] = v_indexes[i];
+			next_slot = (next_slot + 1) % cache_size;
+		}
+	}
+
+	return (double)(miss_count) / (double)(v_indexes.size() / 3);
+}
+
+vector<unsigned int> MeshOptimizer :: calculateTriangleOrder (const vector<unsigned int>& v_indexes,
+                                                              unsigned int first_index,
+                                                              unsigned int index_count,
+                                                              unsigned int vertex_count)
+{
+	assert(first_index % 3 == 0);
+	assert(index_count % 3 == 0);
+	assert(first_index + index_count <= v_indexes.size());
+
+	unsigned int triangle_count = index_count / 3;
+	vector<unsigned int> v_order;
+	v_order.reserve(triangle_count);
+	if(triangle_count == 0)
+		return v_order;
+
+	const unsigned int* a_indexes = &(v_indexes[first_index]);
+
+	//
+	//  Build the vertex-to-triangle adjacency as a compressed
+	//    array: the triangles for vertex v are at positions
+	//    v_adjacency_start[v] to v_adjacency_start[v + 1] - 1.
+	//
+
+	vector<unsigned int> v_adjacency_start(vertex_count + 1, 0);
+	for(unsigned int i = 0; i < index_count; i++)
+	{
+		assert(a_indexes[i] < vertex_count);
+		v_adjacency_start[a_indexes[i] + 1]++;
+	}
+	for(unsigned int v = 0; v < vertex_count; v++)
+		v_adjacency_start[v + 1] += v_adjacency_start[v];
+
+	vector<unsigned int> v_adjacency(index_count);
+	vector<unsigned int> v_remaining(vertex_count, 0);  // also used as fill position below
+	for(unsigned int t = 0; t < triangle_count; t++)
+		for(unsigned int k = 0; k < 3; k++)
+		{
+			unsigned int vertex = a_indexes[t * 3 + k];
+			v_adjacency[v_adjacency_start[vertex] + v_remaining[vertex]] = t;
+			v_remaining[vertex]++;
+		}
+
+	//
+	//  Calculate the starting scores
+	//
+
+	vector<int>    v_cache_position(vertex_count, NOT_IN_CACHE);
+	vector<double> v_vertex_score(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+		v_vertex_score[v] = calculateVertexScore(NOT_IN_CACHE, v_remaining[v]);
+
+	vector<double> v_triangle_score(triangle_count);
+	vector<bool>   v_is_drawn(triangle_count, false);
+	for(unsigned int t = 0; t < triangle_count; t++)
+		v_triangle_score[t] = v_vertex_score[a_indexes[t * 3 + 0]] +
+		                      v_vertex_score[a_indexes[t * 3 + 1]] +
+		                      v_vertex_score[a_indexes[t * 3 + 2]];
+
+	//
+	//  Draw the triangles one at a time.  After each, we only
+	//    have to look at triangles touching a vertex in the
+	//    cache to find the next best one.  If none of those are
+	//    left, we fall back to a scan over all triangles.
+	//
+
+	vector<unsigned int> v_cache;
+	v_cache.reserve(SCORING_CACHE_SIZE + 3);
+	unsigned int best_triangle = 0;
+	for(unsigned int t = 1; t < triangle_count; t++)
+		if(v_triangle_score[t] > v_triangle_score[best_triangle])
+			best_triangle = t;
+	unsigned int scan_start = 0;
+
+	while(best_triangle != NO_TRIANGLE)
+	{
+		assert(best_triangle < triangle_count);
+		assert(!v_is_drawn[best_triangle]);
+
+		v_is_drawn[best_triangle] = true;
+		v_order.push_back(best_triangle);
+
+		// remove the triangle from its vertexes' lists and move them to the front of the cache
+		vector<unsigned int> v_new_cache;
+		v_new_cache.reserve(SCORING_CACHE_SIZE + 3);
+		for(unsigned int k = 0; k < 3; k++)
+		{
+			unsigned int vertex = a_indexes[best_triangle * 3 + k];
+			unsigned int begin  = v_adjacency_start[vertex];
+			unsigned int end    = begin + v_remaining[vertex];
+			for(unsigned int a = begin; a < end; a++)
+				if(v_adjacency[a] == best_triangle)
+				{
+					v_adjacency[a] = v_adjacency[end - 1];
+					v_remaining[vertex]--;
+					break;
+				}
+			v_new_cache.push_back(vertex);
+		}
+		for(unsigned int c = 0; c < v_cache.size(); c++)
+		{
+			unsigned int vertex = v_cache[c];
+			if(vertex != v_new_cache[0] && vertex != v_new_cache[1] && vertex != v_new_cache[2])
+				v_new_cache.push_back(vertex);
+		}
+
+		// update scores for everything that was (or is) in the cache
+		for(unsigned int c = 0; c < v_new_cache.size(); c++)
+		{
+			unsigned int vertex = v_new_cache[c];
+			if(c < (unsigned int)(SCORING_CACHE_SIZE))
+				v_cache_position[vertex] = (int)(c);
+			else
+				v_cache_position[vertex] = NOT_IN_CACHE;
+
+			double new_score = calculateVertexScore(v_cache_position[vertex], v_remaining[vertex]);
+			double delta     = new_score - v_vertex_score[vertex];
+			v_vertex_score[vertex] = new_score;
+
+			unsigned int begin = v_adjacency_start[vertex];
+			unsigned int end   = begin + v_remaining[vertex];
+			for(unsigned int a = begin; a < end; a++)
+				v_triangle_score[v_adjacency[a]] += delta;
+		}
+		if(v_new_cache.size() > (unsigned int)(SCORING_CACHE_SIZE))
+			v_new_cache.resize(SCORING_CACHE_SIZE);
+		v_cache.swap(v_new_cache);
+
+		// find the best triangle touching the cache
+		best_triangle = NO_TRIANGLE;
+		double best_score = -1.0;
+		for(unsigned int c = 0; c < v_cache.size(); c++)
+		{
+			unsigned int vertex = v_cache[c];
+			unsigned int begin = v_adjacency_start[vertex];
+			unsigned int end   = begin + v_remaining[vertex];
+			for(unsigned int a = begin; a < end; a++)
+			{
+				unsigned int triangle = v_adjacency[a];
+				assert(!v_is_drawn[triangle]);
+				if(v_triangle_score[triangle] > best_score)
+				{
+					best_score    = v_triangle_score[triangle];
+					best_triangle = triangle;
+				}
+			}
+		}
+
+		// nothing touches the cache, so start somewhere new
+		if(best_triangle == NO_TRIANGLE)
+		{
+			while(scan_start < triangle_count && v_is_drawn[scan_start])
+				scan_start++;
+			for(unsigned int t = scan_start; t < triangle_count; t++)
+				if(!v_is_drawn[t] && v_triangle_score[t] > best_score)
+				{
+					best_score    = v_triangle_score[t];
+					best_triangle = t;
+				}
+		}
+	}
+
+	assert(v_order.size() == triangle_count);
+	return v_order;
+}
+
+void MeshOptimizer :: optimizeVertexCache (vector<unsigned int>& rv_indexes,
+                                           unsigned int first_index,
+                                           unsigned int index_count,
+                                           unsigned int vertex_count)
+{
+	assert(first_index % 3 == 0);
+	assert(index_count % 3 == 0);
+	assert(first_index + index_count <= rv_indexes.size());
+
+	vector<unsigned int> v_order = calculateTriangleOrder(rv_indexes, first_index, index_count, vertex_count);
+
+	vector<unsigned int> v_reordered(index_count);
+	for(unsigned int i = 0; i < v_order.size(); i++)
+	{
+		unsigned int old_start = first_index + v_order[i] * 3;
+		v_reordered[i * 3 + 0] = rv_indexes[old_start + 0];
+		v_reordered[i * 3 + 1] = rv_indexes[old_start + 1];
+		v_reordered[i * 3 + 2] = rv_indexes[old_start + 2];
+	}
+
+	for(unsigned int i = 0; i < index_count; i++)
+		rv_indexes[first_index + i] = v_reordered[i];
+}
+
+vector<unsigned int> MeshOptimizer :: calculateVertexFetchRemap (const vector<unsigned int>& v_indexes,
+                                                                 unsigned int vertex_count)
+{
+	static const unsigned int UNASSIGNED = 0xFFFFFFFF;
+
+	vector<unsigned int> v_remap(vertex_count, UNASSIGNED);
+	unsigned int next_index = 0;
+
+	for(unsigned int i = 0; i < v_indexes.size(); i++)
+	{
+		assert(v_indexes[i] < vertex_count);
+		if(v_remap[v_indexes[i]] == UNASSIGNED)
+		{
+			v_remap[v_indexes[i]] = next_index;
+			next_index++;
+		}
+	}
+
+	for(unsigned int v = 0; v < vertex_count; v++)
+		if(v_remap[v] == UNASSIGNED)
+		{
+			v_remap[v] = next_index;
+			next_index++;
+		}
+
+	assert(next_index == vertex_count);
+	return v_remap;
+}
@@ -0,0 +1,174 @@
+//
+//  MeshOptimizer.h
+//
+//  A module to reorder indexed triangle lists so that they draw
+//    faster on graphics hardware.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_MESH_OPTIMIZER_H
+#define OBJ_LIBRARY_MESH_OPTIMIZER_H
+
+#include <vector>
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  MeshOptimizer
+//
+//  A namespace to contain functions that optimize the order of
+//    triangles and vertexes in an indexed triangle list.
+//
+//  Graphics cards keep a small cache of recently transformed
+//    vertexes.  If a triangle uses a vertex that is still in
+//    the cache, the vertex does not have to be transformed
+//    again.  The number of vertexes transformed per triangle
+//    is called the average cache miss ratio (ACMR).  It is at
+//    most 3.0 and, for a typical closed mesh, can get down to
+//    about 0.6-0.7 with a good triangle order.
+//
+//  The triangle order is calculated with Tom Forsyth's "Linear-
+//    Speed Vertex Cache Optimisation" algorithm.  Each vertex
+//    is scored on how recently it was used and how many of its
+//    triangles are still waiting to be drawn, and the triangle
+//    with the highest total score is drawn next.  The algorithm
+//    does not depend on the exact cache size of the hardware.
+//
+//  Once the triangles are in order, the vertexes can be
+//    renumbered in the order they are first used.  This makes
+//    reading the vertex data more sequential.
+//
+//  In all these functions, an index list is a vector of vertex
+//    indexes, 3 per triangle.
+//
+namespace MeshOptimizer
+{
+//
+//  DEFAULT_CACHE_SIZE
+//
+//  The size of the simulated vertex cache used when calculating
+//    the ACMR.
+//
+	const unsigned int DEFAULT_CACHE_SIZE = 32;
+
+//
+//  calculateAcmr
+//
+//  Purpose: To calculate the average cache miss ratio for the
+//           specified index list.
+//  Parameter(s):
+//    <1> v_indexes: The index list
+//    <2> cache_size: The number of vertexes in the simulated
+//                    FIFO vertex cache
+//  Precondition(s):
+//    <1> v_indexes.size() % 3 == 0
+//    <2> cache_size > 0
+//  Returns: The average number of cache misses per triangle
+//           when v_indexes is drawn in order.  If there are no
+//           triangles, 0.0 is returned.
+//  Side Effect: N/A
+//
+	double calculateAcmr (
+	                const std::vector<unsigned int>& v_indexes,
+	                unsigned int cache_size = DEFAULT_CACHE_SIZE);
+
+//
+//  calculateTriangleOrder
+//
+//  Purpose: To calculate a good order for drawing the triangles
+//           in the specified part of an index list.
+//  Parameter(s):
+//    <1> v_indexes: The index list
+//    <2> first_index: The first index to reorder
+//    <3> index_count: The number of indexes to reorder
+//    <4> vertex_count: The number of vertexes referenced by
+//                      v_indexes
+//  Precondition(s):
+//    <1> first_index % 3 == 0
+//    <2> index_count % 3 == 0
+//    <3> first_index + index_count <= v_indexes.size()
+//    <4> Every index in the range is less than vertex_count
+//  Returns: A vector with one element per triangle in the
+//           range.  Element i is the triangle, counted from
+//           first_index / 3, that should be drawn i-th.
+//  Side Effect: N/A
+//
+	std::vector<unsigned int> calculateTriangleOrder (
+	                 const std::vector<unsigned int>& v_indexes,
+	                 unsigned int first_index,
+	                 unsigned int index_count,
+	                 unsigned int vertex_count);
+
+//
+//  optimizeVertexCache
+//
+//  Purpose: To reorder the triangles in the specified part of
+//           an index list to make better use of the vertex
+//           cache.
+//  Parameter(s):
+//    <1> rv_indexes: The index list
+//    <2> first_index: The first index to reorder
+//    <3> index_count: The number of indexes to reorder
+//    <4> vertex_count: The number of vertexes referenced by
+//                      rv_indexes
+//  Precondition(s):
+//    <1> first_index % 3 == 0
+//    <2> index_count % 3 == 0
+//    <3> first_index + index_count <= rv_indexes.size()
+//    <4> Every index in the range is less than vertex_count
+//  Returns: N/A
+//  Side Effect: The triangles in the range are reordered
+//               according to calculateTriangleOrder.  The
+//               vertexes of each triangle keep their original
+//               order, so the winding is unchanged.
+//
+	void optimizeVertexCache (
+	                       std::vector<unsigned int>& rv_indexes,
+	                       unsigned int first_index,
+	                       unsigned int index_count,
+	                       unsigned int vertex_count);
+
+//
+//  calculateVertexFetchRemap
+//
+//  Purpose: To calculate a new numbering for the vertexes in an
+//           index list so that they are stored in the order
+//           they are first used.
+//  Parameter(s):
+//    <1> v_indexes: The index list
+//    <2> vertex_count: The number of vertexes referenced by
+//                      v_indexes
+//  Precondition(s):
+//    <1> Every index in v_indexes is less than vertex_count
+//  Returns: A vector of vertex_count elements.  Element i is
+//           the new index for the vertex with old index i.
+//           Vertexes that are never used are numbered after
+//           all the used ones, in their original order.
+//  Side Effect: N/A
+//
+	std::vector<unsigned int> calculateVertexFetchRemap (
+	                 const std::vector<unsigned int>& v_indexes,
+	                 unsigned int vertex_count);
+
+}  // end of namespace MeshOptimizer
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,602 @@
+//
+//  MeshSimplifier.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <queue>
+#include <functional>	// for greater
+
+#include "Vector3.h"
+#include "ObjModel.h"
+#include "MeshSimplifier.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int NO_MESH = 0xFFFFFFFF;
+	const unsigned int SEAM    = 0xFFFFFFFE;
+
+	//
+	//  Quadric
+	//
+	//  A record to represent a symmetric 4x4 matrix used to
+	//    calculate the sum of squared distances from a point to
+	//    a set of planes.  Only the upper triangle is stored.
+	//
+	struct Quadric
+	{
+		double m_xx, m_xy, m_xz, m_xw;
+		double       m_yy, m_yz, m_yw;
+		double             m_zz, m_zw;
+		double                   m_ww;
+
+		Quadric ()
+				: m_xx(0.0), m_xy(0.0), m_xz(0.0), m_xw(0.0),
+				  m_yy(0.0), m_yz(0.0), m_yw(0.0),
+				  m_zz(0.0), m_zw(0.0),
+				  m_ww(0.0)
+		{ }
+
+		// plane is a*x + b*y + c*z + d = 0, scaled by weight
+		void addPlane (const Vector3& normal, double d, double weight)
+		{
+			double a = normal.x;
+			double b = normal.y;
+			double c = normal.z;
+			m_xx += weight * a * a;  m_xy += weight * a * b;  m_xz += weight * a * c;  m_xw += weight * a * d;
+			m_yy += weight * b * b;  m_yz += weight * b * c;  m_yw += weight * b * d;
+			m_zz += weight * c * c;  m_zw += weight * c * d;
+			m_ww += weight * d * d;
+		}
+
+		void add (const Quadric& other)
+		{
+			m_xx += other.m_xx;  m_xy += other.m_xy;  m_xz += other.m_xz;  m_xw += other.m_xw;
+			m_yy += other.m_yy;  m_yz += other.m_yz;  m_yw += other.m_yw;
+			m_zz += other.m_zz;  m_zw += other.m_zw;
+			m_ww += other.m_ww;
+		}
+
+		double evaluate (const Vector3& p) const
+		{
+			return       m_xx * p.x * p.x + 2.0 * m_xy * p.x * p.y + 2.0 * m_xz * p.x * p.z + 2.0 * m_xw * p.x
+			     +                              m_yy * p.y * p.y + 2.0 * m_yz * p.y * p.z + 2.0 * m_yw * p.y
+			     +                                                     m_zz * p.z * p.z + 2.0 * m_zw * p.z
+			     +                                                                              m_ww;
+		}
+	};
+
+	//
+	//  Triangle
+	//
+	//  A record to represent one triangle being simplified.
+	//    The corners store indexes into the original ObjModel.
+	//
+	struct Triangle
+	{
+		unsigned int ma_vertex[3];
+		unsigned int ma_texture_coordinate[3];
+		unsigned int ma_normal[3];
+		unsigned int m_mesh;
+		bool m_is_removed;
+	};
+
+	//
+	//  Collapse
+	//
+	//  A record to represent a possible collapse of vertex
+	//    m_from onto vertex m_to.  The versions are used to
+	//    tell if the vertexes have changed since the cost was
+	//    calculated.
+	//
+	struct Collapse
+	{
+		double m_cost;
+		unsigned int m_from;
+		unsigned int m_to;
+		unsigned int m_from_version;
+		unsigned int m_to_version;
+
+		bool operator> (const Collapse& other) const
+		{	return m_cost > other.m_cost;	}
+	};
+
+	typedef priority_queue<Collapse, vector<Collapse>, greater<Collapse> > CollapseQueue;
+
+
+
+	//
+	//  Simplifier
+	//
+	//  A class to hold the working state while one ObjModel is
+	//    simplified.
+	//
+	class Simplifier
+	{
+	public:
+		Simplifier (const ObjModel& model);
+		void simplify (unsigned int target_triangle_count);
+		ObjModel createModel (const ObjModel& model) const;
+
+	private:
+		void findLockedVertexes ();
+		void calculateQuadrics ();
+		void addCollapses (unsigned int vertex, CollapseQueue& r_queue) const;
+		bool isCollapseValid (unsigned int from, unsigned int to) const;
+		void collapse (unsigned int from, unsigned int to);
+		Vector3 getTriangleNormal (const Triangle& triangle) const;
+
+	private:
+		vector<Vector3> mv_positions;
+		vector<Triangle> mv_triangles;
+		vector<vector<unsigned int> > mvv_vertex_triangles;
+		vector<Quadric> mv_quadrics;
+		vector<bool> mv_is_locked;
+		vector<bool> mv_is_removed;
+		vector<unsigned int> mv_normals;  // the normal for each vertex, or SEAM if it has several
+		vector<unsigned int> mv_versions;
+		unsigned int m_triangle_count;
+	};
+
+	Simplifier :: Simplifier (const ObjModel& model)
+			: mv_positions(model.getVertexCount()),
+			  mv_triangles(),
+			  mvv_vertex_triangles(model.getVertexCount()),
+			  mv_quadrics(model.getVertexCount()),
+			  mv_is_locked(model.getVertexCount(), false),
+			  mv_is_removed(model.getVertexCount(), false),
+			  mv_normals(model.getVertexCount(), NO_MESH),
+			  mv_versions(model.getVertexCount(), 0),
+			  m_triangle_count(0)
+	{
+		for(unsigned int v = 0; v < model.getVertexCount(); v++)
+			mv_positions[v] = model.getVertexPosition(v);
+
+		// split faces into triangle fans
+		for(unsigned int m = 0; m < model.getMeshCount(); m++)
+			for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+				for(unsigned int v = 2; v < model.getFaceVertexCount(m, f); v++)
+				{
+					static const unsigned int CORNER_COUNT = 3;
+					unsigned int a_face_vertex[CORNER_COUNT] = { 0, v - 1, v };
+
+					Triangle triangle;
+					for(unsigned int c = 0; c < CORNER_COUNT; c++)
+					{
+						triangle.ma_vertex[c]             = model.getFaceVertexIndex             (m, f, a_face_vertex[c]);
+						triangle.ma_texture_coordinate[c] = model.getFaceVertexTextureCoordinates(m, f, a_face_vertex[c]);
+						triangle.ma_normal[c]             = model.getFaceVertexNormal            (m, f, a_face_vertex[c]);
+					}
+					triangle.m_mesh       = m;
+					triangle.m_is_removed = false;
+
+					unsigned int id = mv_triangles.size();
+					mv_triangles.push_back(triangle);
+					for(unsigned int c = 0; c < CORNER_COUNT; c++)
+					{
+						unsigned int vertex = triangle.ma_vertex[c];
+						mvv_vertex_triangles[vertex].push_back(id);
+
+						// smooth-shaded vertexes use the same normal at every corner
+						if(mv_normals[vertex] == NO_MESH)
+							mv_normals[vertex] = triangle.ma_normal[c];
+						else if(mv_normals[vertex] != triangle.ma_normal[c])
+							mv_normals[vertex] = SEAM;
+					}
+				}
+		m_triangle_count = mv_triangles.size();
+
+		findLockedVertexes();
+		calculateQuadrics();
+	}
+
+	void Simplifier :: findLockedVertexes ()
+	{
+		// texture seams and material boundaries
+		vector<unsigned int> v_texture_coordinate(mv_positions.size(), NO_MESH);
+		vector<unsigned int> v_mesh              (mv_positions.size(), NO_MESH);
+		for(unsigned int t = 0; t < mv_triangles.size(); t++)
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int vertex = mv_triangles[t].ma_vertex[c];
+				unsigned int texture_coordinate = mv_triangles[t].ma_texture_coordinate[c];
+
+				if(v_texture_coordinate[vertex] == NO_MESH)
+					v_texture_coordinate[vertex] = texture_coordinate;
+				else if(v_texture_coordinate[vertex] != texture_coordinate)
+					mv_is_locked[vertex] = true;
+
+				if(v_mesh[vertex] == NO_MESH)
+					v_mesh[vertex] = mv_triangles[t].m_mesh;
+				else if(v_mesh[vertex] != mv_triangles[t].m_mesh)
+					mv_is_locked[vertex] = true;
+			}
+
+		// open and non-manifold edges (not used by exactly 2 triangles)
+		map<pair<unsigned int, unsigned int>, unsigned int> edge_uses;
+		for(unsigned int t = 0; t < mv_triangles.size(); t++)
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int a = mv_triangles[t].ma_vertex[c];
+				unsigned int b = mv_triangles[t].ma_vertex[(c + 1) % 3];
+				if(a > b)
+					swap(a, b);
+				edge_uses[make_pair(a, b)]++;
+			}
+		for(map<pair<unsigned int, unsigned int>, unsigned int>::const_iterator it = edge_uses.begin();
+		    it != edge_uses.end(); ++it)
+		{
+			if(it->second != 2)
+			{
+				mv_is_locked[it->first.first]  = true;
+				mv_is_locked[it->first.second] = true;
+			}
+		}
+	}
+
+	void Simplifier :: calculateQuadrics ()
+	{
+		for(unsigned int t = 0; t < mv_triangles.size(); t++)
+		{
+			const Triangle& triangle = mv_triangles[t];
+			const Vector3& p0 = mv_positions[triangle.ma_vertex[0]];
+			const Vector3& p1 = mv_positions[triangle.ma_vertex[1]];
+			const Vector3& p2 = mv_positions[triangle.ma_vertex[2]];
+
+			Vector3 cross = (p1 - p0).crossProduct(p2 - p0);
+			double double_area = cross.getNorm();
+			if(double_area <= 0.0)
+				continue;  // degenerate triangles have no plane
+
+			// weight by area so small triangles do not dominate
+			Vector3 normal = cross / double_area;
+			double d = -normal.dotProduct(p0);
+			for(unsigned int c = 0; c < 3; c++)
+				mv_quadrics[triangle.ma_vertex[c]].addPlane(normal, d, double_area * 0.5);
+		}
+	}
+
+	void Simplifier :: simplify (unsigned int target_triangle_count)
+	{
+		CollapseQueue queue;
+		for(unsigned int v = 0; v < mv_positions.size(); v++)
+			addCollapses(v, queue);
+
+		while(m_triangle_count > target_triangle_count && !queue.empty())
+		{
+			Collapse best = queue.top();
+			queue.pop();
+
+			// skip out-of-date collapses
+			if(mv_is_removed[best.m_from] || mv_is_removed[best.m_to])
+				continue;
+			if(best.m_from_version != mv_versions[best.m_from] ||
+			   best.m_to_version   != mv_versions[best.m_to])
+			{
+				continue;
+			}
+			if(!isCollapseValid(best.m_from, best.m_to))
+				continue;
+
+			collapse(best.m_from, best.m_to);
+
+			// the target vertex and its neighbours have new costs
+			addCollapses(best.m_to, queue);
+			const vector<unsigned int>& v_neighbour_triangles = mvv_vertex_triangles[best.m_to];
+			for(unsigned int i = 0; i < v_neighbour_triangles.size(); i++)
+			{
+				const Triangle& triangle = mv_triangles[v_neighbour_triangles[i]];
+				for(unsigned int c = 0; c < 3; c++)
+					if(triangle.ma_vertex[c] != best.m_to)
+						addCollapses(triangle.ma_vertex[c], queue);
+			}
+		}
+	}
+
+	void Simplifier :: addCollapses (unsigned int vertex, CollapseQueue& r_queue) const
+	{
+		assert(vertex < mv_positions.size());
+
+		if(mv_is_removed[vertex] || mv_is_locked[vertex])
+			return;
+
+		const vector<unsigned int>& v_triangles = mvv_vertex_triangles[vertex];
+		for(unsigned int i = 0; i < v_triangles.size(); i++)
+		{
+			const Triangle& triangle = mv_triangles[v_triangles[i]];
+			assert(!triangle.m_is_removed);
+
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int to = triangle.ma_vertex[c];
+				if(to == vertex)
+					continue;
+
+				Quadric combined = mv_quadrics[vertex];
+				combined.add(mv_quadrics[to]);
+
+				Collapse collapse;
+				collapse.m_cost         = combined.evaluate(mv_positions[to]);
+				collapse.m_from         = vertex;
+				collapse.m_to           = to;
+				collapse.m_from_version = mv_versions[vertex];
+				collapse.m_to_version   = mv_versions[to];
+				r_queue.push(collapse);
+			}
+		}
+	}
+
+	bool Simplifier :: isCollapseValid (unsigned int from, unsigned int to) const
+	{
+		assert(from < mv_positions.size());
+		assert(to   < mv_positions.size());
+		assert(!mv_is_locked[from]);
+
+		//
+		//  Link condition: the only vertexes adjacent to both
+		//    ends of the edge must be the ones opposite it in
+		//    the triangles being removed.  Otherwise, the
+		//    collapse would pinch the surface.
+		//
+
+		vector<unsigned int> v_from_neighbours;
+		unsigned int shared_triangle_count = 0;
+		const vector<unsigned int>& v_from_triangles = mvv_vertex_triangles[from];
+		for(unsigned int i = 0; i < v_from_triangles.size(); i++)
+		{
+			const Triangle& triangle = mv_triangles[v_from_triangles[i]];
+			bool is_shared = false;
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				if(triangle.ma_vertex[c] == to)
+					is_shared = true;
+				else if(triangle.ma_vertex[c] != from)
+					v_from_neighbours.push_back(triangle.ma_vertex[c]);
+			}
+			if(is_shared)
+				shared_triangle_count++;
+		}
+		if(shared_triangle_count == 0)
+			return false;  // no longer an edge
+
+		vector<unsigned int> v_common;
+		const vector<unsigned int>& v_to_triangles = mvv_vertex_triangles[to];
+		for(unsigned int i = 0; i < v_to_triangles.size(); i++)
+		{
+			const Triangle& triangle = mv_triangles[v_to_triangles[i]];
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int vertex = triangle.ma_vertex[c];
+				if(vertex == from || vertex == to)
+					continue;
+				for(unsigned int j = 0; j < v_from_neighbours.size(); j++)
+					if(v_from_neighbours[j] == vertex)
+					{
+						bool is_known = false;
+						for(unsigned int k = 0; k < v_common.size(); k++)
+							if(v_common[k] == vertex)
+								is_known = true;
+						if(!is_known)
+							v_common.push_back(vertex);
+						break;
+					}
+			}
+		}
+		if(v_common.size() != shared_triangle_count)
+			return false;
+
+		//
+		//  Do not flip or flatten any triangle that is moved
+		//
+
+		for(unsigned int i = 0; i < v_from_triangles.size(); i++)
+		{
+			const Triangle& triangle = mv_triangles[v_from_triangles[i]];
+			if(triangle.ma_vertex[0] == to || triangle.ma_vertex[1] == to || triangle.ma_vertex[2] == to)
+				continue;  // will be removed
+
+			Vector3 old_normal = getTriangleNormal(triangle);
+			Triangle moved = triangle;
+			for(unsigned int c = 0; c < 3; c++)
+				if(moved.ma_vertex[c] == from)
+					moved.ma_vertex[c] = to;
+			Vector3 new_normal = getTriangleNormal(moved);
+
+			if(new_normal.isZero())
+				return false;
+			if(!old_normal.isZero() && old_normal.dotProduct(new_normal) <= 0.0)
+				return false;
+		}
+
+		return true;
+	}
+
+	void Simplifier :: collapse (unsigned int from, unsigned int to)
+	{
+		assert(from < mv_positions.size());
+		assert(to   < mv_positions.size());
+		assert(!mv_is_locked[from]);
+
+		// find the texture coordinates and normal used by the target in a triangle being removed
+		unsigned int to_texture_coordinate = ObjModel::NO_TEXTURE_COORDINATES;
+		unsigned int to_normal             = ObjModel::NO_NORMAL;
+		const vector<unsigned int>& v_from_triangles = mvv_vertex_triangles[from];
+		for(unsigned int i = 0; i < v_from_triangles.size(); i++)
+		{
+			const Triangle& triangle = mv_triangles[v_from_triangles[i]];
+			for(unsigned int c = 0; c < 3; c++)
+				if(triangle.ma_vertex[c] == to)
+				{
+					to_texture_coordinate = triangle.ma_texture_coordinate[c];
+					to_normal             = triangle.ma_normal[c];
+				}
+		}
+
+		// a faceted vertex has a normal per face, so its corners keep them
+		bool is_move_normal = (mv_normals[from] != SEAM);
+
+		vector<unsigned int>& rv_to_triangles = mvv_vertex_triangles[to];
+		for(unsigned int i = 0; i < v_from_triangles.size(); i++)
+		{
+			unsigned int t = v_from_triangles[i];
+			Triangle& r_triangle = mv_triangles[t];
+
+			bool is_shared = r_triangle.ma_vertex[0] == to ||
+			                 r_triangle.ma_vertex[1] == to ||
+			                 r_triangle.ma_vertex[2] == to;
+			if(is_shared)
+			{
+				// remove triangle from all other vertexes
+				r_triangle.m_is_removed = true;
+				m_triangle_count--;
+				for(unsigned int c = 0; c < 3; c++)
+				{
+					unsigned int vertex = r_triangle.ma_vertex[c];
+					if(vertex == from)
+						continue;
+					vector<unsigned int>& rv_triangles = mvv_vertex_triangles[vertex];
+					for(unsigned int j = 0; j < rv_triangles.size(); j++)
+						if(rv_triangles[j] == t)
+						{
+							rv_triangles[j] = rv_triangles.back();
+							rv_triangles.pop_back();
+							break;
+						}
+				}
+			}
+			else
+			{
+				// move the corner
+				for(unsigned int c = 0; c < 3; c++)
+					if(r_triangle.ma_vertex[c] == from)
+					{
+						r_triangle.ma_vertex[c]             = to;
+						r_triangle.ma_texture_coordinate[c] = to_texture_coordinate;
+						if(is_move_normal)
+							r_triangle.ma_normal[c] = to_normal;
+					}
+				rv_to_triangles.push_back(t);
+			}
+		}
+
+		mvv_vertex_triangles[from].clear();
+		mv_is_removed[from] = true;
+		mv_quadrics[to].add(mv_quadrics[from]);
+		mv_versions[to]++;
+	}
+
+	Vector3 Simplifier :: getTriangleNormal (const Triangle& triangle) const
+	{
+		const Vector3& p0 = mv_positions[triangle.ma_vertex[0]];
+		const Vector3& p1 = mv_positions[triangle.ma_vertex[1]];
+		const Vector3& p2 = mv_positions[triangle.ma_vertex[2]];
+		return (p1 - p0).crossProduct(p2 - p0);
+	}
+
+	ObjModel Simplifier :: createModel (const ObjModel& model) const
+	{
+		ObjModel result = model;
+		for(unsigned int m = 0; m < result.getMeshCount(); m++)
+			result.removeFaceAll(m);
+
+		for(unsigned int t = 0; t < mv_triangles.size(); t++)
+		{
+			const Triangle& triangle = mv_triangles[t];
+			if(triangle.m_is_removed)
+				continue;
+
+			unsigned int face = result.addFace(triangle.m_mesh);
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				result.addFaceVertex(triangle.m_mesh, face,
+				                     triangle.ma_vertex[c],
+				                     triangle.ma_texture_coordinate[c],
+				                     triangle.ma_normal[c]);
+			}
+		}
+
+		result.validate();
+		return result;
+	}
+
+}  // end of anonymous namespace
+
+
+
+unsigned int MeshSimplifier :: getTriangleCount (const ObjModel& model)
+{
+	unsigned int count = 0;
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+		for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+		{
+			unsigned int face_vertex_count = model.getFaceVertexCount(m, f);
+			if(face_vertex_count >= 3)
+				count += face_vertex_count - 2;
+		}
+	return count;
+}
+
+ObjModel MeshSimplifier :: simplify (const ObjModel& model, double fraction)
+{
+	assert(model.isValid());
+	assert(fraction > 0.0);
+	assert(fraction <= 1.0);
+
+	unsigned int target = (unsigned int)(getTriangleCount(model) * fraction + 0.5);
+
+	Simplifier simplifier(model);
+	simplifier.simplify(target);
+	return simplifier.createModel(model);
+}
+
+vector<ObjModel> MeshSimplifier :: createLodChain (const ObjModel& model,
+                                                   const vector<double>& v_fractions)
+{
+	assert(model.isValid());
+	assert(!v_fractions.empty());
+
+	unsigned int original_count = getTriangleCount(model);
+
+	vector<ObjModel> v_levels;
+	v_levels.reserve(v_fractions.size());
+	for(unsigned int i = 0; i < v_fractions.size(); i++)
+	{
+		assert(v_fractions[i] > 0.0);
+		assert(v_fractions[i] <= 1.0);
+		assert(i == 0 || v_fractions[i] <= v_fractions[i - 1]);
+
+		if(v_fractions[i] >= 1.0)
+			v_levels.push_back(model);
+		else
+		{
+			const ObjModel& previous = v_levels.empty() ? model : v_levels.back();
+			unsigned int target = (unsigned int)(original_count * v_fractions[i] + 0.5);
+
+			Simplifier simplifier(previous);
+			simplifier.simplify(target);
+			v_levels.push_back(simplifier.createModel(previous));
+		}
+	}
+
+	assert(v_levels.size() == v_fractions.size());
+	return v_levels;
+}
@@ -0,0 +1,139 @@
+//
+//  MeshSimplifier.h
+//
+//  A module to reduce the number of triangles in an ObjModel
+//    using quadric error metrics.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_MESH_SIMPLIFIER_H
+#define OBJ_LIBRARY_MESH_SIMPLIFIER_H
+
+#include <vector>
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+
+
+
+//
+//  MeshSimplifier
+//
+//  A namespace to contain functions that create simplified
+//    versions of an ObjModel, such as for levels of detail.
+//
+//  Simplification is done with the quadric error metric of
+//    Garland and Heckbert ("Surface Simplification Using
+//    Quadric Error Metrics", 1997).  Each vertex accumulates
+//    the planes of the triangles around it, and the edge whose
+//    collapse moves the surface the least is collapsed first.
+//    Edges are collapsed onto one of their existing vertexes
+//    (a "half-edge collapse"), so every texture coordinate in
+//    the result comes from the original model.
+//
+//  The following are never moved:
+//    <1> Vertexes on a texture seam (used with more than one
+//        texture coordinate pair)
+//    <2> Vertexes on a material boundary (used by more than
+//        one mesh)
+//    <3> Vertexes on a hole or other open edge in the surface
+//  As a result, texture seams and material boundaries keep
+//    their original shape.  Collapses that would flip a
+//    triangle over or make the surface non-manifold are also
+//    refused, so the simplifier may stop above the requested
+//    triangle count.
+//
+//  Faces with more than 3 vertexes are split into triangle fans
+//    first, the same way they are drawn.  If a vertex uses the
+//    same normal at every corner, as on a smooth-shaded model,
+//    corners moved from it take the normal of the vertex they
+//    are moved to.  Otherwise, each corner keeps its original
+//    normal, which preserves flat shading on faceted models.
+//    Point sets and polylines are copied unchanged.
+//
+namespace MeshSimplifier
+{
+//
+//  getTriangleCount
+//
+//  Purpose: To determine the number of triangles that the
+//           faces of the specified ObjModel are drawn as.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//  Precondition(s): N/A
+//  Returns: The number of triangles in model, counting a face
+//           with n vertexes as n - 2 triangles.
+//  Side Effect: N/A
+//
+	unsigned int getTriangleCount (const ObjModel& model);
+
+//
+//  simplify
+//
+//  Purpose: To create a simplified copy of the specified
+//           ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel to simplify
+//    <2> fraction: The fraction of the triangles to keep
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> fraction > 0.0
+//    <3> fraction <= 1.0
+//  Returns: A copy of model with about fraction as many
+//           triangles.  All faces in the copy are triangles.
+//           The copy has the same vertex positions, texture
+//           coordinates, normals, and materials as model.  Some
+//           of the vertexes may be unused.
+//  Side Effect: N/A
+//
+	ObjModel simplify (const ObjModel& model, double fraction);
+
+//
+//  createLodChain
+//
+//  Purpose: To create a sequence of progressively simplified
+//           copies of the specified ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel to simplify
+//    <2> v_fractions: The fraction of the triangles to keep at
+//                     each level of detail
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> !v_fractions.empty()
+//    <3> Each element of v_fractions is in (0.0, 1.0]
+//    <4> v_fractions is in decreasing order
+//  Returns: A vector with one ObjModel per element of
+//           v_fractions.  Element i has about v_fractions[i] as
+//           many triangles as model.  If a fraction is 1.0, that
+//           element is an unchanged copy of model.  Each level
+//           is simplified from the previous one, so the levels
+//           are consistent with each other.
+//  Side Effect: N/A
+//
+	std::vector<ObjModel> createLodChain (
+	                        const ObjModel& model,
+	                        const std::vector<double>& v_fractions);
+
+}  // end of namespace MeshSimplifier
+
+}  // end of namespace ObjLibrary
+
+#endif
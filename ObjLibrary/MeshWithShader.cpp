@@ -0,0 +1,307 @@
+//
+//  MeshWithShader.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstddef>	// for NULL
+
+#include "ObjSettings.h"
+#include "../GetGlutWithShaders.h"
+
+#include "DisplayList.h"
+#include "GlCallCounter.h"
+#include "VertexDataFormat.h"
+#include "ObjVbo.h"
+#include "MeshWithShader.h"
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	#include "ObjVao.h"
+#endif
+
+using namespace ObjLibrary;
+namespace
+{
+	// buffer offsets are passed to OpenGL as pointers
+	const GLvoid* getBufferOffset (unsigned int bytes)
+	{
+		return (const GLvoid*)((const char*)(NULL) + bytes);
+	}
+}
+
+
+
+MeshWithShader :: MeshWithShader ()
+		: m_primitive(GL_TRIANGLES)
+		, m_format(VertexDataFormat::POSITION_ONLY)
+		, m_vbo_data()
+		, m_vbo_indexes()
+{
+	assert(invariant());
+}
+
+MeshWithShader :: MeshWithShader (unsigned int primitive,
+                                  unsigned int format,
+                                  const ObjVbo<float>& vbo_data,
+                                  const ObjVbo<unsigned int>& vbo_indexes)
+		: m_primitive(GL_TRIANGLES)
+		, m_format(VertexDataFormat::POSITION_ONLY)
+		, m_vbo_data()
+		, m_vbo_indexes()
+{
+	assert(format < VertexDataFormat::COUNT);
+	assert(!vbo_data.isEmpty());
+	assert(!vbo_indexes.isEmpty());
+	assert(vbo_data.getElementCount() % VertexDataFormat::getComponentCount(format) == 0);
+
+	init(primitive, format, vbo_data, vbo_indexes);
+
+	assert(invariant());
+}
+
+
+
+bool MeshWithShader :: isInitialized () const
+{
+	return !m_vbo_data.isEmpty();
+}
+
+unsigned int MeshWithShader :: getPrimitive () const
+{
+	assert(isInitialized());
+
+	return m_primitive;
+}
+
+unsigned int MeshWithShader :: getFormat () const
+{
+	assert(isInitialized());
+
+	return m_format;
+}
+
+unsigned int MeshWithShader :: getVertexCount () const
+{
+	assert(isInitialized());
+
+	return m_vbo_data.getElementCount() / VertexDataFormat::getComponentCount(m_format);
+}
+
+unsigned int MeshWithShader :: getIndexCount () const
+{
+	assert(isInitialized());
+
+	return m_vbo_indexes.getElementCount();
+}
+
+const ObjVbo<float>& MeshWithShader :: getVertexBuffer () const
+{
+	assert(isInitialized());
+
+	return m_vbo_data;
+}
+
+const ObjVbo<unsigned int>& MeshWithShader :: getIndexBuffer () const
+{
+	assert(isInitialized());
+
+	return m_vbo_indexes;
+}
+
+void MeshWithShader :: draw () const
+{
+	assert(isInitialized());
+	assert(!DisplayList::isDisabledForExit());
+
+	bindArrays();
+	glDrawElements(m_primitive, m_vbo_indexes.getElementCount(), GL_UNSIGNED_INT, getBufferOffset(0));
+	unbindArrays();
+}
+
+void MeshWithShader :: drawInstanced (unsigned int instance_count) const
+{
+	assert(isInitialized());
+	assert(!DisplayList::isDisabledForExit());
+
+	if(instance_count == 0)
+		return;
+
+	bindArrays();
+	glDrawElementsInstanced(m_primitive, m_vbo_indexes.getElementCount(), GL_UNSIGNED_INT,
+	                        getBufferOffset(0), instance_count);
+	unbindArrays();
+}
+
+void MeshWithShader :: drawInstanced (unsigned int instance_count,
+                                      unsigned int first_index,
+                                      unsigned int index_count,
+                                      int base_vertex) const
+{
+	assert(isInitialized());
+	assert(!DisplayList::isDisabledForExit());
+	assert(first_index + index_count <= getIndexCount());
+
+	if(instance_count == 0)
+		return;
+
+	bindArrays();
+	glDrawElementsInstancedBaseVertex(m_primitive, index_count, GL_UNSIGNED_INT,
+	                                  getBufferOffset(first_index * sizeof(unsigned int)),
+	                                  instance_count, base_vertex);
+	unbindArrays();
+}
+
+void MeshWithShader :: drawIndirect (unsigned int first_command,
+                                     unsigned int command_count) const
+{
+	assert(isInitialized());
+	assert(!DisplayList::isDisabledForExit());
+
+	static const unsigned int COMMAND_SIZE = 5 * sizeof(unsigned int);
+
+	if(command_count == 0)
+		return;
+
+	bindArrays();
+	glMultiDrawElementsIndirect(m_primitive, GL_UNSIGNED_INT,
+	                            getBufferOffset(first_command * COMMAND_SIZE),
+	                            command_count, COMMAND_SIZE);
+	unbindArrays();
+}
+
+
+
+void MeshWithShader :: init (unsigned int primitive,
+                             unsigned int format,
+                             const ObjVbo<float>& vbo_data,
+                             const ObjVbo<unsigned int>& vbo_indexes)
+{
+	assert(format < VertexDataFormat::COUNT);
+	assert(!vbo_data.isEmpty());
+	assert(!vbo_indexes.isEmpty());
+	assert(vbo_data.getElementCount() % VertexDataFormat::getComponentCount(format) == 0);
+	assert(!DisplayList::isDisabledForExit());
+
+	m_primitive   = primitive;
+	m_format      = format;
+	m_vbo_data    = vbo_data;
+	m_vbo_indexes = vbo_indexes;
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	using namespace VertexDataFormat;
+
+	GLsizei stride = getStride(m_format);
+
+	m_vao.init();
+	m_vao.bind();
+
+	m_vbo_data.bind();
+	glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, stride, getBufferOffset(0));
+	glEnableVertexAttribArray(POSITION_LOCATION);
+	if(isTextureCoordinates(m_format))
+	{
+		glVertexAttribPointer(TEXTURE_COORDINATE_LOCATION, 2, GL_FLOAT, GL_FALSE, stride,
+		                      getBufferOffset(getTextureCoordinateOffset(m_format)));
+		glEnableVertexAttribArray(TEXTURE_COORDINATE_LOCATION);
+	}
+	if(isNormals(m_format))
+	{
+		glVertexAttribPointer(NORMAL_LOCATION, 3, GL_FLOAT, GL_FALSE, stride,
+		                      getBufferOffset(getNormalOffset(m_format)));
+		glEnableVertexAttribArray(NORMAL_LOCATION);
+	}
+
+	// the element array binding is part of the vertex array object
+	m_vbo_indexes.bind();
+
+	ObjVao::bindNone();  // we don't want to accidentally change it elsewhere
+	ObjVbo<float>::bindNone(GL_ARRAY_BUFFER);
+#endif
+
+	assert(invariant());
+}
+
+void MeshWithShader :: makeEmpty ()
+{
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	m_vao.makeEmpty();
+#endif
+	m_vbo_data   .makeEmpty();
+	m_vbo_indexes.makeEmpty();
+
+	assert(!isInitialized());
+	assert(invariant());
+}
+
+
+
+void MeshWithShader :: bindArrays () const
+{
+	assert(isInitialized());
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	// the vertex array object remembers everything set up in init
+	m_vao.bind();
+#else
+	using namespace VertexDataFormat;
+
+	GLsizei stride = getStride(m_format);
+
+	m_vbo_data.bind();
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, stride, getBufferOffset(0));
+	if(isTextureCoordinates(m_format))
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, stride, getBufferOffset(getTextureCoordinateOffset(m_format)));
+	}
+	if(isNormals(m_format))
+	{
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, stride, getBufferOffset(getNormalOffset(m_format)));
+	}
+
+	m_vbo_indexes.bind();
+#endif
+}
+
+void MeshWithShader :: unbindArrays () const
+{
+	assert(isInitialized());
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	ObjVao::bindNone();
+#else
+	using namespace VertexDataFormat;
+
+	// leave the client state as we found it
+	if(isNormals(m_format))
+		glDisableClientState(GL_NORMAL_ARRAY);
+	if(isTextureCoordinates(m_format))
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	ObjVbo<unsigned int>::bindNone(GL_ELEMENT_ARRAY_BUFFER);
+	ObjVbo<float>::bindNone(GL_ARRAY_BUFFER);
+#endif
+}
+
+bool MeshWithShader :: invariant () const
+{
+	if(m_vbo_data.isEmpty() != m_vbo_indexes.isEmpty()) return false;
+	if(!m_vbo_data.isEmpty() && m_format >= VertexDataFormat::COUNT) return false;
+	return true;
+}
@@ -0,0 +1,364 @@
+//
+//  MeshWithShader.h
+//
+//  A module to store a mesh in OpenGL buffer objects.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_MESH_WITH_SHADER_H
+#define OBJ_LIBRARY_MESH_WITH_SHADER_H
+
+#include "ObjSettings.h"
+#include "ObjVbo.h"
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	#include "ObjVao.h"
+#endif
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  MeshWithShader
+//
+//  A class to store a mesh as a buffer object of interleaved
+//    vertex data and a buffer object of vertex indexes.  The
+//    vertex data is in one of the formats in VertexDataFormat.
+//    The mesh can be drawn with a single glDrawElements call,
+//    so the vertexes do not have to be sent to the graphics
+//    card each time, as they are with the immediate-mode
+//    drawing in ObjModel.
+//
+//  If OBJ_LIBRARY_SHADER_DISPLAY is #defined, the vertex data
+//    is supplied as generic vertex attributes, recorded in a
+//    vertex array object, for use with a shader.  The vertex
+//    positions use POSITION_LOCATION, the texture coordinates
+//    use TEXTURE_COORDINATE_LOCATION, and the normals use
+//    NORMAL_LOCATION.  The shader must be activated before
+//    draw() is called.
+//
+//  Otherwise, the vertex data is supplied as the fixed-function
+//    vertex, texture coordinate, and normal arrays, so the mesh
+//    is drawn with the current material, lighting, and
+//    transformations, exactly like the same faces drawn with
+//    ObjModel::draw().  This only needs OpenGL 1.5.
+//
+//  A MeshWithShader can be copied cheaply: the copies refer to
+//    the same buffer objects.
+//
+//  Class Invariant:
+//    <1> m_vbo_data.isEmpty() == m_vbo_indexes.isEmpty()
+//    <2> m_vbo_data.isEmpty() ||
+//        m_format < VertexDataFormat::COUNT
+//
+class MeshWithShader
+{
+public:
+//
+//  POSITION_LOCATION
+//  TEXTURE_COORDINATE_LOCATION
+//  NORMAL_LOCATION
+//
+//  The vertex attribute locations used for the vertex data
+//    when OBJ_LIBRARY_SHADER_DISPLAY is #defined.
+//
+	static const unsigned int POSITION_LOCATION           = 0;
+	static const unsigned int TEXTURE_COORDINATE_LOCATION = 1;
+	static const unsigned int NORMAL_LOCATION             = 2;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an uninitialized MeshWithShader.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new MeshWithShader is created.  It contains
+//               no buffer objects and cannot be drawn.
+//
+	MeshWithShader ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a MeshWithShader for the specified
+//           buffer objects.
+//  Parameter(s):
+//    <1> primitive: The OpenGL primitive type to draw
+//    <2> format: The VertexDataFormat of vbo_data
+//    <3> vbo_data: The interleaved vertex data
+//    <4> vbo_indexes: The vertex indexes
+//  Precondition(s):
+//    <1> format < VertexDataFormat::COUNT
+//    <2> !vbo_data.isEmpty()
+//    <3> !vbo_indexes.isEmpty()
+//    <4> vbo_data.getElementCount() is a multiple of
+//        VertexDataFormat::getComponentCount(format)
+//  Returns: N/A
+//  Side Effect: A new MeshWithShader is created that draws
+//               vbo_indexes as primitive primitive.
+//
+	MeshWithShader (unsigned int primitive,
+	                unsigned int format,
+	                const ObjVbo<float>& vbo_data,
+	                const ObjVbo<unsigned int>& vbo_indexes);
+
+	MeshWithShader (const MeshWithShader& original) = default;
+	~MeshWithShader () = default;
+	MeshWithShader& operator= (const MeshWithShader& original) = default;
+
+//
+//  isInitialized
+//
+//  Purpose: To determine if this MeshWithShader has been
+//           initialized.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this MeshWithShader contains buffer
+//           objects and can be drawn.
+//  Side Effect: N/A
+//
+	bool isInitialized () const;
+
+//
+//  getPrimitive
+//  getFormat
+//  getVertexCount
+//  getIndexCount
+//
+//  Purpose: To determine the OpenGL primitive type, the
+//           VertexDataFormat, the number of vertexes, or the
+//           number of indexes.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The requested value.
+//  Side Effect: N/A
+//
+	unsigned int getPrimitive () const;
+	unsigned int getFormat () const;
+	unsigned int getVertexCount () const;
+	unsigned int getIndexCount () const;
+
+//
+//  getVertexBuffer
+//  getIndexBuffer
+//
+//  Purpose: To retrieve the buffer object for the vertex data
+//           or for the indexes.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The buffer object.
+//  Side Effect: N/A
+//
+	const ObjVbo<float>& getVertexBuffer () const;
+	const ObjVbo<unsigned int>& getIndexBuffer () const;
+
+//
+//  draw
+//
+//  Purpose: To draw this MeshWithShader.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//  Returns: N/A
+//  Side Effect: This MeshWithShader is drawn.  If
+//               OBJ_LIBRARY_SHADER_DISPLAY is #defined, the
+//               current shader is used.  Otherwise, the current
+//               fixed-function state is used.  In either case,
+//               no vertex array object, array buffer, or
+//               element array buffer is left bound.
+//
+	void draw () const;
+
+//
+//  drawInstanced
+//
+//  Purpose: To draw several instances of this MeshWithShader
+//           with a single draw call.
+//  Parameter(s):
+//    <1> instance_count: The number of instances to draw
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//  Returns: N/A
+//  Side Effect: This MeshWithShader is drawn instance_count
+//               times using glDrawElementsInstanced, which
+//               requires OpenGL 3.1.  The current shader must
+//               use gl_InstanceID or per-instance vertex
+//               attributes to tell the instances apart.  The
+//               vertex data is supplied in the same way as for
+//               draw, and any per-instance attributes must be
+//               set up by the caller.  If instance_count is 0,
+//               there is no effect.
+//
+	void drawInstanced (unsigned int instance_count) const;
+
+//
+//  drawInstanced
+//
+//  Purpose: To draw several instances of part of this
+//           MeshWithShader with a single draw call.
+//  Parameter(s):
+//    <1> instance_count: The number of instances to draw
+//    <2> first_index: The first index to draw
+//    <3> index_count: The number of indexes to draw
+//    <4> base_vertex: The value added to each index
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> first_index + index_count <= getIndexCount()
+//  Returns: N/A
+//  Side Effect: Indexes first_index to first_index +
+//               index_count - 1 of this MeshWithShader are
+//               drawn instance_count times using
+//               glDrawElementsInstancedBaseVertex, which
+//               requires OpenGL 3.2.  Otherwise, this is the
+//               same as drawInstanced above.
+//
+	void drawInstanced (unsigned int instance_count,
+	                    unsigned int first_index,
+	                    unsigned int index_count,
+	                    int base_vertex) const;
+
+//
+//  drawIndirect
+//
+//  Purpose: To draw several parts of this MeshWithShader, each
+//           with its own number of instances, with a single
+//           draw call.
+//  Parameter(s):
+//    <1> first_command: The first draw command to use
+//    <2> command_count: The number of draw commands to use
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> A buffer object containing at least first_command +
+//        command_count draw commands is bound to
+//        GL_DRAW_INDIRECT_BUFFER
+//  Returns: N/A
+//  Side Effect: This MeshWithShader is drawn using
+//               glMultiDrawElementsIndirect, which requires
+//               OpenGL 4.3.  Each draw command is 5 unsigned
+//               ints: the index count, the instance count, the
+//               first index, the base vertex, and the first
+//               instance for per-instance attributes.  Commands
+//               with an instance count of 0 draw nothing.
+//               Otherwise, this is the same as drawInstanced.
+//
+	void drawIndirect (unsigned int first_command,
+	                   unsigned int command_count) const;
+
+//
+//  init
+//
+//  Purpose: To initialize this MeshWithShader with the
+//           specified buffer objects.
+//  Parameter(s):
+//    <1> primitive: The OpenGL primitive type to draw
+//    <2> format: The VertexDataFormat of vbo_data
+//    <3> vbo_data: The interleaved vertex data
+//    <4> vbo_indexes: The vertex indexes
+//  Precondition(s):
+//    <1> format < VertexDataFormat::COUNT
+//    <2> !vbo_data.isEmpty()
+//    <3> !vbo_indexes.isEmpty()
+//    <4> vbo_data.getElementCount() is a multiple of
+//        VertexDataFormat::getComponentCount(format)
+//    <5> !DisplayList::isDisabledForExit()
+//  Returns: N/A
+//  Side Effect: This MeshWithShader is set to draw vbo_indexes
+//               as primitive primitive.
+//
+	void init (unsigned int primitive,
+	           unsigned int format,
+	           const ObjVbo<float>& vbo_data,
+	           const ObjVbo<unsigned int>& vbo_indexes);
+
+//
+//  makeEmpty
+//
+//  Purpose: To remove the buffer objects from this
+//           MeshWithShader.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This MeshWithShader is set to be uninitialized.
+//               Any buffer objects no longer referred to are
+//               deleted.
+//
+	void makeEmpty ();
+
+private:
+//
+//  bindArrays
+//
+//  Purpose: To prepare the vertex data for drawing.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The vertex array object, or the buffer objects
+//               and fixed-function arrays, are bound.
+//
+	void bindArrays () const;
+
+//
+//  unbindArrays
+//
+//  Purpose: To undo the effects of bindArrays.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: No vertex array object, array buffer, or
+//               element array buffer is left bound, and the
+//               client state is as it was before bindArrays.
+//
+	void unbindArrays () const;
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	unsigned int m_primitive;
+	unsigned int m_format;
+	ObjVbo<float> m_vbo_data;
+	ObjVbo<unsigned int> m_vbo_indexes;
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	ObjVao m_vao;
+#endif
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
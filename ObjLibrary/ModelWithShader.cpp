@@ -0,0 +1,210 @@
+//
+//  ModelWithShader.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstddef>	// for NULL
+#include <vector>
+
+#include "ObjSettings.h"
+#include "../GetGlutWithShaders.h"
+
+#include "DisplayList.h"
+#include "Material.h"
+#include "MeshWithShader.h"
+#include "ModelWithShader.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+ModelWithShader :: ModelWithShader ()
+		: mv_materials()
+		, mv_meshes()
+{
+	assert(invariant());
+}
+
+
+
+bool ModelWithShader :: isReady () const
+{
+	return true;
+}
+
+bool ModelWithShader :: isEmpty () const
+{
+	return mv_meshes.empty();
+}
+
+unsigned int ModelWithShader :: getMaterialCount () const
+{
+	return mv_materials.size();
+}
+
+const ModelWithShader::MaterialType& ModelWithShader :: getMaterial (unsigned int material) const
+{
+	assert(material < getMaterialCount());
+
+	return mv_materials[material];
+}
+
+unsigned int ModelWithShader :: getMeshCount () const
+{
+	return mv_meshes.size();
+}
+
+unsigned int ModelWithShader :: getMeshMaterial (unsigned int mesh) const
+{
+	assert(mesh < getMeshCount());
+
+	return mv_meshes[mesh].m_material;
+}
+
+const MeshWithShader& ModelWithShader :: getMesh (unsigned int mesh) const
+{
+	assert(mesh < getMeshCount());
+
+	return mv_meshes[mesh].m_mesh;
+}
+
+unsigned int ModelWithShader :: getIndexCountTotal () const
+{
+	unsigned int total = 0;
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+		total += mv_meshes[i].m_mesh.getIndexCount();
+	return total;
+}
+
+void ModelWithShader :: draw () const
+{
+	assert(isReady());
+	assert(!DisplayList::isDisabledForExit());
+
+	drawMeshes(1, false);
+}
+
+void ModelWithShader :: drawInstanced (unsigned int instance_count) const
+{
+	assert(isReady());
+	assert(!DisplayList::isDisabledForExit());
+
+	if(instance_count == 0)
+		return;
+
+	drawMeshes(instance_count, true);
+}
+
+
+
+unsigned int ModelWithShader :: addMaterial (const MaterialType& material)
+{
+	mv_materials.push_back(material);
+
+	assert(invariant());
+	return mv_materials.size() - 1;
+}
+
+void ModelWithShader :: addMesh (unsigned int material,
+                                 const MeshWithShader& mesh)
+{
+	assert(material < getMaterialCount());
+	assert(mesh.isInitialized());
+
+	MeshAndMaterial mesh_and_material;
+	mesh_and_material.m_material = material;
+	mesh_and_material.m_mesh     = mesh;
+	mv_meshes.push_back(mesh_and_material);
+
+	assert(invariant());
+}
+
+void ModelWithShader :: makeEmpty ()
+{
+	mv_materials.clear();
+	mv_meshes.clear();
+
+	assert(isEmpty());
+	assert(invariant());
+}
+
+
+
+void ModelWithShader :: drawMeshes (unsigned int instance_count,
+                                     bool is_instanced) const
+{
+	assert(isReady());
+	assert(!DisplayList::isDisabledForExit());
+	assert(is_instanced || instance_count == 1);
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+	{
+		if(is_instanced)
+			mv_meshes[i].m_mesh.drawInstanced(instance_count);
+		else
+			mv_meshes[i].m_mesh.draw();
+	}
+#else
+	if(Material::isMaterialActive())
+		Material::deactivate();
+	assert(!Material::isMaterialActive());
+
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+	{
+		const MeshWithShader& mesh = mv_meshes[i].m_mesh;
+		const Material* p_material = mv_materials[mv_meshes[i].m_material];
+		unsigned int pass_count = 1;
+		if(p_material != NULL && p_material->isSeperateSpecular())
+			pass_count = 2;
+
+		// same as ObjModel::drawMeshMaterial
+		for(unsigned int pass = 0; pass < pass_count; pass++)
+		{
+			if(p_material != NULL)
+			{
+				if(pass == 0)
+					p_material->activate();
+				else
+					p_material->activateSeperateSpecular();
+			}
+
+			if(is_instanced)
+				mesh.drawInstanced(instance_count);
+			else
+				mesh.draw();
+
+			if(p_material != NULL)
+				Material::deactivate();
+		}
+	}
+
+	assert(!Material::isMaterialActive());
+#endif
+}
+
+bool ModelWithShader :: invariant () const
+{
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+	{
+		if(mv_meshes[i].m_material >= mv_materials.size()) return false;
+		if(!mv_meshes[i].m_mesh.isInitialized()) return false;
+	}
+	return true;
+}
@@ -0,0 +1,331 @@
+//
+//  ModelWithShader.h
+//
+//  A module to store a complete model, with materials, in
+//    OpenGL buffer objects.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_MODEL_WITH_SHADER_H
+#define OBJ_LIBRARY_MODEL_WITH_SHADER_H
+
+#include <vector>
+
+#include "ObjSettings.h"
+#include "Material.h"
+#include "MeshWithShader.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  ModelWithShader
+//
+//  A class to store a model as a list of materials and a list
+//    of MeshWithShaders, each drawn with one of the materials.
+//    A ModelWithShader is normally created with
+//    ObjModel::getModelWithShader and can be used in place of
+//    the DisplayList from ObjModel::getDisplayList.
+//
+//  If OBJ_LIBRARY_SHADER_DISPLAY is #defined, the materials are
+//    stored as MaterialForShaders.  Drawing does not activate
+//    them; the caller must activate a shader and set its
+//    material values for each mesh, using getMeshMaterial and
+//    getMaterial.
+//
+//  Otherwise, the materials are stored as pointers to
+//    Materials, which are activated and deactivated around each
+//    mesh in the same way as ObjModel::draw().  A NULL material
+//    means to draw with the current OpenGL state.  The
+//    Materials are not copied, so they must not be destroyed
+//    while the ModelWithShader is in use.  This is not a
+//    problem for Materials loaded with an ObjModel, which are
+//    kept by MtlLibraryManager.
+//
+//  A ModelWithShader can be copied cheaply: the copies refer to
+//    the same buffer objects.
+//
+//  Class Invariant:
+//    <1> mv_meshes[i].m_material < mv_materials.size() for all
+//        i
+//    <2> mv_meshes[i].m_mesh.isInitialized() for all i
+//
+class ModelWithShader
+{
+public:
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	typedef MaterialForShader MaterialType;
+#else
+	typedef const Material* MaterialType;
+#endif
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty ModelWithShader.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ModelWithShader is created with no
+//               materials and no meshes.
+//
+	ModelWithShader ();
+
+	ModelWithShader (const ModelWithShader& original) = default;
+	~ModelWithShader () = default;
+	ModelWithShader& operator= (const ModelWithShader& original) = default;
+
+//
+//  isReady
+//
+//  Purpose: To determine if this ModelWithShader can be drawn.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether every mesh in this ModelWithShader can be
+//           drawn.  This is always true, because meshes cannot
+//           be added unless they are initialized.
+//  Side Effect: N/A
+//
+	bool isReady () const;
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this ModelWithShader contains no
+//           meshes.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether there are no meshes.
+//  Side Effect: N/A
+//
+	bool isEmpty () const;
+
+//
+//  getMaterialCount
+//
+//  Purpose: To determine the number of materials in this
+//           ModelWithShader.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of materials.
+//  Side Effect: N/A
+//
+	unsigned int getMaterialCount () const;
+
+//
+//  getMaterial
+//
+//  Purpose: To retrieve the specified material.
+//  Parameter(s):
+//    <1> material: Which material
+//  Precondition(s):
+//    <1> material < getMaterialCount()
+//  Returns: Material material.
+//  Side Effect: N/A
+//
+	const MaterialType& getMaterial (unsigned int material) const;
+
+//
+//  getMeshCount
+//
+//  Purpose: To determine the number of meshes in this
+//           ModelWithShader.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of meshes.
+//  Side Effect: N/A
+//
+	unsigned int getMeshCount () const;
+
+//
+//  getMeshMaterial
+//
+//  Purpose: To determine which material the specified mesh is
+//           drawn with.
+//  Parameter(s):
+//    <1> mesh: Which mesh
+//  Precondition(s):
+//    <1> mesh < getMeshCount()
+//  Returns: The index of the material for mesh mesh.
+//  Side Effect: N/A
+//
+	unsigned int getMeshMaterial (unsigned int mesh) const;
+
+//
+//  getMesh
+//
+//  Purpose: To retrieve the specified mesh.
+//  Parameter(s):
+//    <1> mesh: Which mesh
+//  Precondition(s):
+//    <1> mesh < getMeshCount()
+//  Returns: Mesh mesh.
+//  Side Effect: N/A
+//
+	const MeshWithShader& getMesh (unsigned int mesh) const;
+
+//
+//  getIndexCountTotal
+//
+//  Purpose: To determine the total number of indexes drawn for
+//           this ModelWithShader.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The sum of the index counts of all the meshes.
+//           For a model of triangles, this is 3 times the
+//           number of triangles.
+//  Side Effect: N/A
+//
+	unsigned int getIndexCountTotal () const;
+
+//
+//  draw
+//
+//  Purpose: To draw this ModelWithShader.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//    <2> !DisplayList::isDisabledForExit()
+//  Returns: N/A
+//  Side Effect: Each mesh in this ModelWithShader is drawn.  If
+//               OBJ_LIBRARY_SHADER_DISPLAY is not #defined,
+//               each mesh is drawn with its Material.  Any
+//               Material that was active before is deactivated
+//               first.
+//
+	void draw () const;
+
+//
+//  drawInstanced
+//
+//  Purpose: To draw several instances of this ModelWithShader
+//           with one draw call per mesh.
+//  Parameter(s):
+//    <1> instance_count: The number of instances to draw
+//  Precondition(s):
+//    <1> isReady()
+//    <2> !DisplayList::isDisabledForExit()
+//  Returns: N/A
+//  Side Effect: Each mesh in this ModelWithShader is drawn
+//               instance_count times with
+//               MeshWithShader::drawInstanced.  Materials are
+//               handled as for draw.  If instance_count is 0,
+//               there is no effect.
+//
+	void drawInstanced (unsigned int instance_count) const;
+
+//
+//  addMaterial
+//
+//  Purpose: To add a material to this ModelWithShader.
+//  Parameter(s):
+//    <1> material: The material to add
+//  Precondition(s): N/A
+//  Returns: The index of the new material.
+//  Side Effect: material is added to this ModelWithShader.
+//
+	unsigned int addMaterial (const MaterialType& material);
+
+//
+//  addMesh
+//
+//  Purpose: To add a mesh to this ModelWithShader.
+//  Parameter(s):
+//    <1> material: The index of the material to draw the mesh
+//                  with
+//    <2> mesh: The mesh to add
+//  Precondition(s):
+//    <1> material < getMaterialCount()
+//    <2> mesh.isInitialized()
+//  Returns: N/A
+//  Side Effect: mesh is added to this ModelWithShader, to be
+//               drawn with material material.  Meshes are drawn
+//               in the order they are added.
+//
+	void addMesh (unsigned int material,
+	              const MeshWithShader& mesh);
+
+//
+//  makeEmpty
+//
+//  Purpose: To remove all materials and meshes from this
+//           ModelWithShader.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This ModelWithShader is set to contain no
+//               materials and no meshes.  Any buffer objects no
+//               longer referred to are deleted.
+//
+	void makeEmpty ();
+
+private:
+//
+//  drawMeshes
+//
+//  Purpose: To draw all the meshes in this ModelWithShader.
+//  Parameter(s):
+//    <1> instance_count: The number of instances to draw
+//    <2> is_instanced: Whether to use instanced drawing
+//  Precondition(s):
+//    <1> isReady()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> is_instanced || instance_count == 1
+//  Returns: N/A
+//  Side Effect: Each mesh is drawn as described for draw and
+//               drawInstanced.
+//
+	void drawMeshes (unsigned int instance_count,
+	                 bool is_instanced) const;
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	//
+	//  MeshAndMaterial
+	//
+	//  A record to store a mesh and the index of the material
+	//    it is drawn with.
+	//
+	struct MeshAndMaterial
+	{
+		unsigned int m_material;
+		MeshWithShader m_mesh;
+	};
+
+private:
+	std::vector<MaterialType> mv_materials;
+	std::vector<MeshAndMaterial> mv_meshes;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -28,25 +28,22 @@
 
 #include "ObjSettings.h"
 
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
-	#include "../GetGlutWithShaders.h"
-#else
-	#include "../GetGlut.h"
-#endif
+#include "../GetGlutWithShaders.h"  // for buffer objects
 
 #include "ObjStringParsing.h"
 #include "DisplayList.h"
+#include "GlCallCounter.h"
 #include "Material.h"
 #include "MtlLibrary.h"
 #include "MtlLibraryManager.h"
 #include "ObjModel.h"
+#include "WeldedMesh.h"
+#include "MeshOptimizer.h"
 
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
-	#include "VertexDataFormat.h"
-	#include "ObjVbo.h"
-	#include "MeshWithShader.h"
-	#include "ModelWithShader.h"
-#endif
+#include "VertexDataFormat.h"
+#include "ObjVbo.h"
+#include "MeshWithShader.h"
+#include "ModelWithShader.h"
 
 using namespace std;
 using namespace ObjLibrary;
@@ -75,6 +72,23 @@ namespace
 	const bool DEBUGGING_VALIDATE      = false || DEBUGGING_LOAD;
 	const bool DEBUGGING_VERTEX_BUFFER = false;
 	const bool DEBUGGING_FACE_SHADERS  = false;
+
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	//
+	//  These send a stored vertex position or normal to
+	//    OpenGL in whatever precision the geometry is stored
+	//    in, so the drawing functions do not have to care
+	//    whether OBJ_LIBRARY_FLOAT_GEOMETRY is defined.
+	//
+	inline void glVertex3v (const float* a_xyz)
+	{	glVertex3fv(a_xyz);	}
+	inline void glVertex3v (const double* a_xyz)
+	{	glVertex3dv(a_xyz);	}
+	inline void glNormal3v (const float* a_xyz)
+	{	glNormal3fv(a_xyz);	}
+	inline void glNormal3v (const double* a_xyz)
+	{	glNormal3dv(a_xyz);	}
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 }
 
 
@@ -98,9 +112,9 @@ void ObjModel :: loadAllTextures ()
 
 ObjModel :: ObjModel ()
 		: mv_material_libraries(),
-		  mv_vertexes(),
-		  mv_texture_coordinates(),
-		  mv_normals(),
+		  m_vertexes(),
+		  m_texture_coordinates(),
+		  m_normals(),
 		  mv_meshes()
 {
 	m_file_name         = DEFAULT_FILE_NAME;
@@ -114,9 +128,9 @@ ObjModel :: ObjModel ()
 
 ObjModel :: ObjModel (const string& filename)
 		: mv_material_libraries(),
-		  mv_vertexes(),
-		  mv_texture_coordinates(),
-		  mv_normals(),
+		  m_vertexes(),
+		  m_texture_coordinates(),
+		  m_normals(),
 		  mv_meshes()
 {
 	assert(ObjStringParsing::isValidFilenameWithPath(filename));
@@ -135,9 +149,9 @@ ObjModel :: ObjModel (const string& filename)
 ObjModel :: ObjModel (const string& filename,
                       const string& logfile)
 		: mv_material_libraries(),
-		  mv_vertexes(),
-		  mv_texture_coordinates(),
-		  mv_normals(),
+		  m_vertexes(),
+		  m_texture_coordinates(),
+		  m_normals(),
 		  mv_meshes()
 {
 	assert(ObjStringParsing::isValidFilenameWithPath(filename));
@@ -157,9 +171,9 @@ ObjModel :: ObjModel (const string& filename,
 ObjModel :: ObjModel (const string& filename,
                       ostream& r_logstream)
 		: mv_material_libraries(),
-		  mv_vertexes(),
-		  mv_texture_coordinates(),
-		  mv_normals(),
+		  m_vertexes(),
+		  m_texture_coordinates(),
+		  m_normals(),
 		  mv_meshes()
 {
 	assert(ObjStringParsing::isValidFilenameWithPath(filename));
@@ -177,9 +191,9 @@ ObjModel :: ObjModel (const string& filename,
 
 ObjModel :: ObjModel (const ObjModel& original)
 		: mv_material_libraries(original.mv_material_libraries),
-		  mv_vertexes(original.mv_vertexes),
-		  mv_texture_coordinates(original.mv_texture_coordinates),
-		  mv_normals(original.mv_normals),
+		  m_vertexes(original.m_vertexes),
+		  m_texture_coordinates(original.m_texture_coordinates),
+		  m_normals(original.m_normals),
 		  mv_meshes(original.mv_meshes)
 {
 	m_file_name         = original.m_file_name;
@@ -195,9 +209,9 @@ ObjModel& ObjModel :: operator= (const ObjModel& original)
 	if(&original != this)
 	{
 		mv_material_libraries = original.mv_material_libraries;
-		mv_vertexes = original.mv_vertexes;
-		mv_texture_coordinates = original.mv_texture_coordinates;
-		mv_normals = original.mv_normals;
+		m_vertexes = original.m_vertexes;
+		m_texture_coordinates = original.m_texture_coordinates;
+		m_normals = original.m_normals;
 		mv_meshes = original.mv_meshes;
 
 		m_file_name         = original.m_file_name;
@@ -239,9 +253,9 @@ bool ObjModel :: isLoadedSuccessfully () const
 bool ObjModel :: isEmpty () const
 {
 	if(!mv_material_libraries.empty()) return false;
-	if(!mv_vertexes.empty()) return false;
-	if(!mv_texture_coordinates.empty()) return false;
-	if(!mv_normals.empty()) return false;
+	if(!m_vertexes.empty()) return false;
+	if(!m_texture_coordinates.empty()) return false;
+	if(!m_normals.empty()) return false;
 	if(!mv_meshes.empty()) return false;
 	return true;
 }
@@ -352,95 +366,116 @@ const MtlLibrary* ObjModel :: getSingleMaterialLibrary () const
 
 unsigned int ObjModel :: getVertexCount () const
 {
-	return mv_vertexes.size();
+	return m_vertexes.size();
 }
 
 double ObjModel :: getVertexX (unsigned int vertex) const
 {
 	assert(vertex < getVertexCount());
 
-	return mv_vertexes[vertex].x;
+	return m_vertexes.getX(vertex);
 }
 
 double ObjModel :: getVertexY (unsigned int vertex) const
 {
 	assert(vertex < getVertexCount());
 
-	return mv_vertexes[vertex].y;
+	return m_vertexes.getY(vertex);
 }
 
 double ObjModel :: getVertexZ (unsigned int vertex) const
 {
 	assert(vertex < getVertexCount());
 
-	return mv_vertexes[vertex].z;
+	return m_vertexes.getZ(vertex);
+}
+
+Vector3 ObjModel :: getVertexPosition (unsigned int vertex) const
+{
+	assert(vertex < getVertexCount());
+
+	return m_vertexes.get(vertex);
 }
 
-const Vector3& ObjModel :: getVertexPosition (unsigned int vertex) const
+const GeometryScalar* ObjModel :: getVertexPositionArray (unsigned int vertex) const
 {
 	assert(vertex < getVertexCount());
 
-	return mv_vertexes[vertex];
+	return m_vertexes.getArray(vertex);
 }
 
 
 unsigned int ObjModel :: getTextureCoordinateCount () const
 {
-	return mv_texture_coordinates.size();
+	return m_texture_coordinates.size();
 }
 
 double ObjModel :: getTextureCoordinateU (unsigned int texture_coordinate) const
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	return mv_texture_coordinates[texture_coordinate].x;
+	return m_texture_coordinates.getX(texture_coordinate);
 }
 
 double ObjModel :: getTextureCoordinateV (unsigned int texture_coordinate) const
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	return mv_texture_coordinates[texture_coordinate].y;
+	return m_texture_coordinates.getY(texture_coordinate);
 }
 
-const Vector2& ObjModel :: getTextureCoordinate (unsigned int texture_coordinate) const
+Vector2 ObjModel :: getTextureCoordinate (unsigned int texture_coordinate) const
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	return mv_texture_coordinates[texture_coordinate];
+	return m_texture_coordinates.get(texture_coordinate);
+}
+
+const GeometryScalar* ObjModel :: getTextureCoordinateArray (unsigned int texture_coordinate) const
+{
+	assert(texture_coordinate < getTextureCoordinateCount());
+
+	return m_texture_coordinates.getArray(texture_coordinate);
 }
 
 unsigned int ObjModel :: getNormalCount () const
 {
-	return mv_normals.size();
+	return m_normals.size();
 }
 
 double ObjModel :: getNormalX (unsigned int normal) const
 {
 	assert(normal < getNormalCount());
 
-	return mv_normals[normal].x;
+	return m_normals.getX(normal);
 }
 
 double ObjModel :: getNormalY (unsigned int normal) const
 {
 	assert(normal < getNormalCount());
 
-	return mv_normals[normal].y;
+	return m_normals.getY(normal);
 }
 
 double ObjModel :: getNormalZ (unsigned int normal) const
 {
 	assert(normal < getNormalCount());
 
-	return mv_normals[normal].z;
+	return m_normals.getZ(normal);
+}
+
+Vector3 ObjModel :: getNormalVector (unsigned int normal) const
+{
+	assert(normal < getNormalCount());
+
+	return m_normals.get(normal);
 }
 
-const Vector3& ObjModel :: getNormalVector (unsigned int normal) const
+const GeometryScalar* ObjModel :: getNormalArray (unsigned int normal) const
 {
 	assert(normal < getNormalCount());
 
-	return mv_normals[normal];
+	return m_normals.getArray(normal);
 }
 
 unsigned int ObjModel :: getMeshCount () const
@@ -778,15 +813,15 @@ void ObjModel :: print (ostream& r_logstream) const
 
 	r_logstream << "  Vertices: " << getVertexCount() << endl;
 	for(unsigned int v = 0; v < getVertexCount(); v++)
-		r_logstream << "    " << setw(6) << v << ": " << mv_vertexes[v] << endl;
+		r_logstream << "    " << setw(6) << v << ": " << m_vertexes.get(v) << endl;
 
 	r_logstream << "  Texture Coordinate Pairs: " << getTextureCoordinateCount() << endl;
 	for(unsigned int t = 0; t < getTextureCoordinateCount(); t++)
-		r_logstream << "    " << setw(6) << t << ": (" << mv_texture_coordinates[t].x << ", " << mv_texture_coordinates[t].y << ")" << endl;
+		r_logstream << "    " << setw(6) << t << ": (" << m_texture_coordinates.getX(t) << ", " << m_texture_coordinates.getY(t) << ")" << endl;
 
 	r_logstream << "  Normals: " << getNormalCount() << endl;
 	for(unsigned int n = 0; n < getNormalCount(); n++)
-		r_logstream << "    " << setw(6) << n << ": " << mv_normals[n] << endl;
+		r_logstream << "    " << setw(6) << n << ": " << m_normals.get(n) << endl;
 
 	r_logstream << "  Meshes: " << getMeshCount() << endl;
 	for(unsigned int m = 0; m < getMeshCount(); m++)
@@ -894,6 +929,15 @@ void ObjModel :: printBadMaterials (ostream& r_logstream) const
 
 
 
+WeldedMesh ObjModel :: getWeldedMesh () const
+{
+	assert(isValid());
+
+	return WeldedMesh(*this);
+}
+
+
+
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
 
 void ObjModel :: draw () const
@@ -1119,7 +1163,7 @@ void ObjModel :: drawVertices (double red, double green, double blue) const
 
 	glBegin(GL_POINTS);
 		for(unsigned int v = 0; v < getVertexCount(); v++)
-			glVertex3dv(mv_vertexes[v].getAsArray());
+			glVertex3v(m_vertexes.getArray(v));
 	glEnd();
 
 	material.deactivate();
@@ -1181,7 +1225,7 @@ void ObjModel :: drawWireframe (double red, double green, double blue) const
 				for(unsigned int v = 0; v < getFaceVertexCount(m, f); v++)
 				{
 					unsigned int vertex = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
-					glVertex3dv(mv_vertexes[vertex].getAsArray());
+					glVertex3v(m_vertexes.getArray(vertex));
 				}
 			glEnd();
 		}
@@ -1302,9 +1346,9 @@ void ObjModel :: drawVertexNormals (double length, double red, double green, dou
 						assert(vertex < getVertexCount());
 						assert(normal < getNormalCount());
 
-						Vector3 normal_end = mv_vertexes[vertex] + mv_normals[normal] * length;
+						Vector3 normal_end = m_vertexes.get(vertex) + m_normals.get(normal) * length;
 
-						glVertex3dv(mv_vertexes[vertex].getAsArray());
+						glVertex3v(m_vertexes.getArray(vertex));
 						glVertex3dv(normal_end.getAsArray());
 					}
 				}
@@ -1374,12 +1418,12 @@ void ObjModel :: drawFaceNormals (double length, double red, double green, doubl
 					unsigned int normal = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
 
 					assert(vertex < getVertexCount());
-					center += mv_vertexes[vertex];
+					center += m_vertexes.get(vertex);
 
 					if(normal != NO_NORMAL)
 					{
 						assert(normal < getNormalCount());
-						face_normal += mv_normals[normal];
+						face_normal += m_normals.get(normal);
 					}
 				}
 
@@ -1532,8 +1576,6 @@ DisplayList ObjModel :: getDisplayListMaterialNone () const
 
 
 
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
-
 ModelWithShader ObjModel :: getModelWithShader () const
 {
 	assert(isValid());
@@ -1546,8 +1588,10 @@ ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
 {
 	assert(isValid());
 
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
 	static const Material MATERIAL_FALLBACK = Material::createSolid("shader_material_fallback",
 	                                                                Vector3(1.0, 0.0, 0.0));
+#endif
 
 	ModelWithShader result;
 
@@ -1563,10 +1607,15 @@ ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
 
 		unsigned int material_index;
 
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
 		if(mv_meshes[m].mp_material == NULL)
 			material_index = result.addMaterial(MATERIAL_FALLBACK.getForShader());
 		else
 			material_index = result.addMaterial(mv_meshes[m].mp_material->getForShader());
+#else
+		// NULL draws with the current state, as in drawMesh
+		material_index = result.addMaterial(mv_meshes[m].mp_material);
+#endif
 
 		// add point sets
 		if(getPointSetCount(m) > 0)
@@ -1606,8 +1655,6 @@ ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
 	return result;
 }
 
-#endif  // OBJ_LIBRARY_SHADER_DISPLAY is defined
-
 
 
 void ObjModel :: save (const string& filename) const
@@ -1669,11 +1716,11 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 	output_file << "#" << endl;
 	output_file << "# " << getFileNameWithPath() << endl;
 	output_file << "#" << endl;
-	if(mv_vertexes.size() > 0)
+	if(m_vertexes.size() > 0)
 		output_file << "# " << getVertexCount() << " vertexes" << endl;
-	if(mv_texture_coordinates.size() > 0)
+	if(m_texture_coordinates.size() > 0)
 		output_file << "# " << getTextureCoordinateCount() << " texture coordinate pairs" << endl;
-	if(mv_normals.size() > 0)
+	if(m_normals.size() > 0)
 		output_file << "# " << getNormalCount() << " vertex normals" << endl;
 	if(mv_meshes.size() > 0)
 	{
@@ -1708,11 +1755,11 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 			cout << "Wrote material libraries" << endl;
 	}
 
-	if(mv_vertexes.size() > 0)
+	if(m_vertexes.size() > 0)
 	{
 		output_file << "# " << getVertexCount() << " vertexes" << endl;
-		for(unsigned int v = 0; v < mv_vertexes.size(); v++)
-			output_file << "v " << mv_vertexes[v].x << " " << mv_vertexes[v].y << " " << mv_vertexes[v].z << endl;
+		for(unsigned int v = 0; v < m_vertexes.size(); v++)
+			output_file << "v " << m_vertexes.getX(v) << " " << m_vertexes.getY(v) << " " << m_vertexes.getZ(v) << endl;
 		output_file << endl;
 		output_file << endl;
 		output_file << endl;
@@ -1721,11 +1768,11 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 			cout << "Wrote vertexes" << endl;
 	}
 
-	if(mv_texture_coordinates.size() > 0)
+	if(m_texture_coordinates.size() > 0)
 	{
 		output_file << "# " << getTextureCoordinateCount() << " texture coordinate pairs" << endl;
-		for(unsigned int t = 0; t < mv_texture_coordinates.size(); t++)
-			output_file << "vt " << mv_texture_coordinates[t].x << " " << mv_texture_coordinates[t].y << endl;
+		for(unsigned int t = 0; t < m_texture_coordinates.size(); t++)
+			output_file << "vt " << m_texture_coordinates.getX(t) << " " << m_texture_coordinates.getY(t) << endl;
 		output_file << endl;
 		output_file << endl;
 		output_file << endl;
@@ -1734,11 +1781,11 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 			cout << "Wrote texture coordinates" << endl;
 	}
 
-	if(mv_normals.size() > 0)
+	if(m_normals.size() > 0)
 	{
 		output_file << "# " << getNormalCount() << " vertex normals" << endl;
-		for(unsigned int n = 0; n < mv_normals.size(); n++)
-			output_file << "vn " << mv_normals[n].x << " " << mv_normals[n].y << " " << mv_normals[n].z << endl;
+		for(unsigned int n = 0; n < m_normals.size(); n++)
+			output_file << "vn " << m_normals.getX(n) << " " << m_normals.getY(n) << " " << m_normals.getZ(n) << endl;
 		output_file << endl;
 		output_file << endl;
 		output_file << endl;
@@ -1845,9 +1892,9 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 void ObjModel :: makeEmpty ()
 {
 	mv_material_libraries.clear();
-	mv_vertexes.clear();
-	mv_texture_coordinates.clear();
-	mv_normals.clear();
+	m_vertexes.clear();
+	m_texture_coordinates.clear();
+	m_normals.clear();
 	mv_meshes.clear();
 
 	m_file_name         = DEFAULT_FILE_NAME;
@@ -2021,10 +2068,10 @@ void ObjModel :: setVertexCount (unsigned int count)
 	if(count < getVertexCount())
 	{
 		m_valid = false;
-		mv_vertexes.resize(count);
+		m_vertexes.resize(count, Vector3::ZERO);
 	}
 	else if(count > getVertexCount())
-		mv_vertexes.resize(count, Vector3::ZERO);
+		m_vertexes.resize(count, Vector3::ZERO);
 
 	assert(invariant());
 }
@@ -2033,7 +2080,7 @@ void ObjModel :: setVertexX (unsigned int vertex, double x)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].x = x;
+	m_vertexes.setX(vertex, x);
 
 	assert(invariant());
 }
@@ -2042,7 +2089,7 @@ void ObjModel :: setVertexY (unsigned int vertex, double y)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].y = y;
+	m_vertexes.setY(vertex, y);
 
 	assert(invariant());
 }
@@ -2051,7 +2098,7 @@ void ObjModel :: setVertexZ (unsigned int vertex, double z)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].z = z;
+	m_vertexes.setZ(vertex, z);
 
 	assert(invariant());
 }
@@ -2060,7 +2107,7 @@ void ObjModel :: setVertexPosition (unsigned int vertex, double x, double y, dou
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].set(x, y, z);
+	m_vertexes.set(vertex, x, y, z);
 
 	assert(invariant());
 }
@@ -2069,7 +2116,7 @@ void ObjModel :: setVertexPosition (unsigned int vertex, const Vector3& position
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex] = position;
+	m_vertexes.set(vertex, position);
 
 	assert(invariant());
 }
@@ -2079,10 +2126,10 @@ void ObjModel :: setTextureCoordinateCount (unsigned int count)
 	if(count < getTextureCoordinateCount())
 	{
 		m_valid = false;
-		mv_texture_coordinates.resize(count);
+		m_texture_coordinates.resize(count, Vector2::ZERO);
 	}
 	else if(count > getTextureCoordinateCount())
-		mv_texture_coordinates.resize(count, Vector2::ZERO);
+		m_texture_coordinates.resize(count, Vector2::ZERO);
 
 	assert(invariant());
 }
@@ -2091,7 +2138,7 @@ void ObjModel :: setTextureCoordinateU (unsigned int texture_coordinate, double
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].x = u;
+	m_texture_coordinates.setX(texture_coordinate, u);
 
 	assert(invariant());
 }
@@ -2099,7 +2146,7 @@ void ObjModel :: setTextureCoordinateV (unsigned int texture_coordinate, double
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].y = v;
+	m_texture_coordinates.setY(texture_coordinate, v);
 
 	assert(invariant());
 }
@@ -2108,8 +2155,8 @@ void ObjModel :: setTextureCoordinate (unsigned int texture_coordinate, double u
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].x = u;
-	mv_texture_coordinates[texture_coordinate].y = v;
+	m_texture_coordinates.setX(texture_coordinate, u);
+	m_texture_coordinates.setY(texture_coordinate, v);
 
 	assert(invariant());
 }
@@ -2118,7 +2165,7 @@ void ObjModel :: setTextureCoordinate (unsigned int texture_coordinate, const Ve
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate] = coordinates;
+	m_texture_coordinates.set(texture_coordinate, coordinates);
 
 	assert(invariant());
 }
@@ -2128,10 +2175,10 @@ void ObjModel :: setNormalCount (unsigned int count)
 	if(count < getNormalCount())
 	{
 		m_valid = false;
-		mv_normals.resize(count);
+		m_normals.resize(count, Vector3::UNIT_Z_PLUS);
 	}
 	else if(count > getNormalCount())
-		mv_normals.resize(count, Vector3::UNIT_Z_PLUS);
+		m_normals.resize(count, Vector3::UNIT_Z_PLUS);
 
 	assert(invariant());
 }
@@ -2141,9 +2188,10 @@ void ObjModel :: setNormalX (unsigned int normal, double x)
 	assert(normal < getNormalCount());
 	assert(x != 0.0 || getNormalY(normal) != 0.0 || getNormalZ(normal) != 0.0);
 
-	mv_normals[normal].x = x;
-	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	Vector3 new_normal = m_normals.get(normal);
+	new_normal.x = x;
+	assert(!new_normal.isZero());
+	m_normals.set(normal, new_normal.getNormalized());
 
 	assert(invariant());
 }
@@ -2153,9 +2201,10 @@ void ObjModel :: setNormalY (unsigned int normal, double y)
 	assert(normal < getNormalCount());
 	assert(getNormalX(normal) != 0.0 || y != 0.0 || getNormalZ(normal) != 0.0);
 
-	mv_normals[normal].y = y;
-	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	Vector3 new_normal = m_normals.get(normal);
+	new_normal.y = y;
+	assert(!new_normal.isZero());
+	m_normals.set(normal, new_normal.getNormalized());
 
 	assert(invariant());
 }
@@ -2165,9 +2214,10 @@ void ObjModel :: setNormalZ (unsigned int normal, double z)
 	assert(normal < getNormalCount());
 	assert(getNormalX(normal) != 0.0 || getNormalY(normal) != 0.0 || z != 0.0);
 
-	mv_normals[normal].z = z;
-	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	Vector3 new_normal = m_normals.get(normal);
+	new_normal.z = z;
+	assert(!new_normal.isZero());
+	m_normals.set(normal, new_normal.getNormalized());
 
 	assert(invariant());
 }
@@ -2177,9 +2227,9 @@ void ObjModel :: setNormalVector (unsigned int normal, double x, double y, doubl
 	assert(normal < getNormalCount());
 	assert(x != 0.0 || y != 0.0 || z != 0.0);
 
-	mv_normals[normal].set(x, y, z);
-	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	Vector3 new_normal(x, y, z);
+	assert(!new_normal.isZero());
+	m_normals.set(normal, new_normal.getNormalized());
 
 	assert(invariant());
 }
@@ -2189,7 +2239,7 @@ void ObjModel :: setNormalVector (unsigned int normal, const Vector3& vector)
 	assert(normal < getNormalCount());
 	assert(!vector.isZero());
 
-	mv_normals[normal] = vector.getNormalized();
+	m_normals.set(normal, vector.getNormalized());
 
 	assert(invariant());
 }
@@ -2360,8 +2410,8 @@ unsigned int ObjModel :: addVertex (double x, double y, double z)
 
 unsigned int ObjModel :: addVertex (const Vector3& position)
 {
-	unsigned int id = mv_vertexes.size();
-	mv_vertexes.push_back(position);
+	unsigned int id = m_vertexes.size();
+	m_vertexes.add(position);
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Vertex #" << (id + 1) << " " << position << endl;
@@ -2377,8 +2427,8 @@ unsigned int ObjModel :: addTextureCoordinate (double u, double v)
 
 unsigned int ObjModel :: addTextureCoordinate (const Vector2& texture_coordinates)
 {
-	unsigned int id = mv_texture_coordinates.size();
-	mv_texture_coordinates.push_back(texture_coordinates);
+	unsigned int id = m_texture_coordinates.size();
+	m_texture_coordinates.add(texture_coordinates);
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Texture Coordinate #" << (id + 1) << " " << texture_coordinates << endl;
@@ -2398,8 +2448,8 @@ unsigned int ObjModel :: addNormal (const Vector3& normal)
 {
 	assert(!normal.isZero());
 
-	unsigned int id = mv_normals.size();
-	mv_normals.push_back(normal.getNormalized());
+	unsigned int id = m_normals.size();
+	m_normals.add(normal.getNormalized());
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Normal #" << (id + 1) << " " << normal << endl;
@@ -2997,6 +3047,167 @@ void ObjModel :: validate ()
 	assert(invariant());
 }
 
+void ObjModel :: optimizeFaceOrder ()
+{
+	assert(isValid());
+
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+	{
+		vector<Face>& rv_faces = mv_meshes[m].mv_faces;
+		if(rv_faces.size() < 2)
+			continue;
+
+		// the welded triangles are in face order, a fan per face
+		vector<unsigned int> v_triangle_to_face;
+		for(unsigned int f = 0; f < rv_faces.size(); f++)
+		{
+			assert(rv_faces[f].mv_vertexes.size() >= 3);
+			for(unsigned int t = 2; t < rv_faces[f].mv_vertexes.size(); t++)
+				v_triangle_to_face.push_back(f);
+		}
+
+		WeldedMesh welded(*this, m);
+		assert(welded.getTriangleCount() == v_triangle_to_face.size());
+
+		vector<unsigned int> v_indexes(welded.getIndexData(),
+		                               welded.getIndexData() + welded.getIndexCount());
+		vector<unsigned int> v_triangle_order = MeshOptimizer::calculateTriangleOrder(
+		                                                  v_indexes, 0, v_indexes.size(),
+		                                                  welded.getVertexCount());
+
+		vector<bool> v_is_placed(rv_faces.size(), false);
+		vector<Face> v_new_faces;
+		v_new_faces.reserve(rv_faces.size());
+		for(unsigned int i = 0; i < v_triangle_order.size(); i++)
+		{
+			unsigned int face = v_triangle_to_face[v_triangle_order[i]];
+			if(!v_is_placed[face])
+			{
+				v_is_placed[face] = true;
+				v_new_faces.push_back(rv_faces[face]);
+			}
+		}
+		assert(v_new_faces.size() == rv_faces.size());
+		rv_faces.swap(v_new_faces);
+	}
+
+	assert(isValid());
+	assert(invariant());
+}
+
+void ObjModel :: optimizeVertexOrder ()
+{
+	assert(isValid());
+
+	//
+	//  List the indexes in the order they are used, and let
+	//    MeshOptimizer number them by first use.  Faces come
+	//    first because they are what is drawn from buffers.
+	//
+
+	vector<unsigned int> v_vertex_uses;
+	vector<unsigned int> v_texture_coordinate_uses;
+	vector<unsigned int> v_normal_uses;
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+		for(unsigned int f = 0; f < mv_meshes[m].mv_faces.size(); f++)
+		{
+			const vector<FaceVertex>& v_face_vertexes = mv_meshes[m].mv_faces[f].mv_vertexes;
+			for(unsigned int v = 0; v < v_face_vertexes.size(); v++)
+			{
+				v_vertex_uses.push_back(v_face_vertexes[v].m_vertex);
+				if(v_face_vertexes[v].m_texture_coordinate != NO_TEXTURE_COORDINATES)
+					v_texture_coordinate_uses.push_back(v_face_vertexes[v].m_texture_coordinate);
+				if(v_face_vertexes[v].m_normal != NO_NORMAL)
+					v_normal_uses.push_back(v_face_vertexes[v].m_normal);
+			}
+		}
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+		for(unsigned int p = 0; p < mv_meshes[m].mv_polylines.size(); p++)
+		{
+			const vector<PolylineVertex>& v_polyline_vertexes = mv_meshes[m].mv_polylines[p].mv_vertexes;
+			for(unsigned int v = 0; v < v_polyline_vertexes.size(); v++)
+			{
+				v_vertex_uses.push_back(v_polyline_vertexes[v].m_vertex);
+				if(v_polyline_vertexes[v].m_texture_coordinate != NO_TEXTURE_COORDINATES)
+					v_texture_coordinate_uses.push_back(v_polyline_vertexes[v].m_texture_coordinate);
+			}
+		}
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+		for(unsigned int p = 0; p < mv_meshes[m].mv_point_sets.size(); p++)
+		{
+			const vector<unsigned int>& v_point_vertexes = mv_meshes[m].mv_point_sets[p].mv_vertexes;
+			v_vertex_uses.insert(v_vertex_uses.end(), v_point_vertexes.begin(), v_point_vertexes.end());
+		}
+
+	vector<unsigned int> v_vertex_remap =
+	        MeshOptimizer::calculateVertexFetchRemap(v_vertex_uses, getVertexCount());
+	vector<unsigned int> v_texture_coordinate_remap =
+	        MeshOptimizer::calculateVertexFetchRemap(v_texture_coordinate_uses, getTextureCoordinateCount());
+	vector<unsigned int> v_normal_remap =
+	        MeshOptimizer::calculateVertexFetchRemap(v_normal_uses, getNormalCount());
+
+	//
+	//  Move the values
+	//
+
+	GeometryArray3<GeometryScalar> new_vertexes = m_vertexes;
+	for(unsigned int v = 0; v < m_vertexes.size(); v++)
+		new_vertexes.set(v_vertex_remap[v], m_vertexes.get(v));
+	m_vertexes = new_vertexes;
+
+	GeometryArray2<GeometryScalar> new_texture_coordinates = m_texture_coordinates;
+	for(unsigned int t = 0; t < m_texture_coordinates.size(); t++)
+		new_texture_coordinates.set(v_texture_coordinate_remap[t], m_texture_coordinates.get(t));
+	m_texture_coordinates = new_texture_coordinates;
+
+	GeometryArray3<GeometryScalar> new_normals = m_normals;
+	for(unsigned int n = 0; n < m_normals.size(); n++)
+		new_normals.set(v_normal_remap[n], m_normals.get(n));
+	m_normals = new_normals;
+
+	//
+	//  Change the indexes to match
+	//
+
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	{
+		Mesh& r_mesh = mv_meshes[m];
+		for(unsigned int f = 0; f < r_mesh.mv_faces.size(); f++)
+		{
+			vector<FaceVertex>& rv_face_vertexes = r_mesh.mv_faces[f].mv_vertexes;
+			for(unsigned int v = 0; v < rv_face_vertexes.size(); v++)
+			{
+				FaceVertex& r_face_vertex = rv_face_vertexes[v];
+				r_face_vertex.m_vertex = v_vertex_remap[r_face_vertex.m_vertex];
+				if(r_face_vertex.m_texture_coordinate != NO_TEXTURE_COORDINATES)
+					r_face_vertex.m_texture_coordinate = v_texture_coordinate_remap[r_face_vertex.m_texture_coordinate];
+				if(r_face_vertex.m_normal != NO_NORMAL)
+					r_face_vertex.m_normal = v_normal_remap[r_face_vertex.m_normal];
+			}
+		}
+		for(unsigned int p = 0; p < r_mesh.mv_polylines.size(); p++)
+		{
+			vector<PolylineVertex>& rv_polyline_vertexes = r_mesh.mv_polylines[p].mv_vertexes;
+			for(unsigned int v = 0; v < rv_polyline_vertexes.size(); v++)
+			{
+				PolylineVertex& r_polyline_vertex = rv_polyline_vertexes[v];
+				r_polyline_vertex.m_vertex = v_vertex_remap[r_polyline_vertex.m_vertex];
+				if(r_polyline_vertex.m_texture_coordinate != NO_TEXTURE_COORDINATES)
+					r_polyline_vertex.m_texture_coordinate = v_texture_coordinate_remap[r_polyline_vertex.m_texture_coordinate];
+			}
+		}
+		for(unsigned int p = 0; p < r_mesh.mv_point_sets.size(); p++)
+		{
+			vector<unsigned int>& rv_point_vertexes = r_mesh.mv_point_sets[p].mv_vertexes;
+			for(unsigned int v = 0; v < rv_point_vertexes.size(); v++)
+				rv_point_vertexes[v] = v_vertex_remap[rv_point_vertexes[v]];
+		}
+	}
+
+	assert(isValid());
+	assert(invariant());
+}
+
 
 
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
@@ -3066,7 +3277,7 @@ void ObjModel :: drawPointSets (unsigned int mesh) const
 				{
 					unsigned int vertex = mv_meshes[mesh].mv_point_sets[p].mv_vertexes[v];
 
-					glVertex3dv(mv_vertexes[vertex].getAsArray());
+					glVertex3v(m_vertexes.getArray(vertex));
 				}
 		glEnd();
 	}
@@ -3088,11 +3299,11 @@ void ObjModel :: drawPolylines (unsigned int mesh) const
 				if(texture_coordinates != NO_TEXTURE_COORDINATES)
 				{
 					// flip texture coordinates to match Maya <|>
-					glTexCoord2d(      mv_texture_coordinates[texture_coordinates].x,
-					             1.0 - mv_texture_coordinates[texture_coordinates].y);
+					glTexCoord2d(      m_texture_coordinates.getX(texture_coordinates),
+					             1.0 - m_texture_coordinates.getY(texture_coordinates));
 				}
 
-				glVertex3dv(mv_vertexes[vertex].getAsArray());
+				glVertex3v(m_vertexes.getArray(vertex));
 			}
 		glEnd();
 	}
@@ -3122,16 +3333,16 @@ void ObjModel :: drawFaces (unsigned int mesh) const
 			unsigned int normal              = mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_normal;
 
 			if(normal != NO_NORMAL)
-				glNormal3dv(mv_normals[normal].getAsArray());
+				glNormal3v(m_normals.getArray(normal));
 
 			if(texture_coordinates != NO_TEXTURE_COORDINATES)
 			{
 				// flip texture coordinates to match Maya <|>
-				glTexCoord2d(      mv_texture_coordinates[texture_coordinates].x,
-				             1.0 - mv_texture_coordinates[texture_coordinates].y);
+				glTexCoord2d(      m_texture_coordinates.getX(texture_coordinates),
+				             1.0 - m_texture_coordinates.getY(texture_coordinates));
 			}
 
-			glVertex3dv(mv_vertexes[vertex].getAsArray());
+			glVertex3v(m_vertexes.getArray(vertex));
 		}
 
 		// end of current trinagle fan
@@ -3148,8 +3359,6 @@ void ObjModel :: drawFaces (unsigned int mesh) const
 
 
 
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
-
 MeshWithShader ObjModel :: getPointSetMeshWithShader (unsigned int mesh) const
 {
 	assert(isValid());
@@ -3282,8 +3491,8 @@ ObjVbo<float> ObjModel :: createPointSetVboVertexOnly (unsigned int mesh) const
 		for(unsigned int i = 0; i < v_vertex_ids.size(); i++)
 		{
 			assert(i < v_vertex_ids.size());
-			assert(v_vertex_ids[i] < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[v_vertex_ids[i]];
+			assert(v_vertex_ids[i] < m_vertexes.size());
+			Vector3 vertex = m_vertexes.get(v_vertex_ids[i]);
 
 			assert(next_point < point_count_total);
 			d_vertexes[next_point].m_x = (float)(vertex.x);
@@ -3322,8 +3531,8 @@ ObjVbo<float> ObjModel :: createPolylineVboVertexOnly (unsigned int mesh,
 	for(unsigned int i = 0; i < v_vertex_ids.size(); i++)
 	{
 		assert(i < v_vertex_ids.size());
-		assert(v_vertex_ids[i].m_vertex < mv_vertexes.size());
-		const Vector3& vertex = mv_vertexes[v_vertex_ids[i].m_vertex];
+		assert(v_vertex_ids[i].m_vertex < m_vertexes.size());
+		Vector3 vertex = m_vertexes.get(v_vertex_ids[i].m_vertex);
 
 		d_vertexes[i].m_x = (float)(vertex.x);
 		d_vertexes[i].m_y = (float)(vertex.y);
@@ -3355,16 +3564,16 @@ ObjVbo<float> ObjModel :: createPolylineVboVertexTextureCoordinate (unsigned int
 	for(unsigned int i = 0; i < v_vertex_ids.size(); i++)
 	{
 		assert(i < v_vertex_ids.size());
-		assert(v_vertex_ids[i].m_vertex < mv_vertexes.size());
-		const Vector3& vertex             = mv_vertexes[v_vertex_ids[i].m_vertex];
+		assert(v_vertex_ids[i].m_vertex < m_vertexes.size());
+		Vector3 vertex             = m_vertexes.get(v_vertex_ids[i].m_vertex);
 
 		d_vertexes[i].m_x = (float)(vertex.x);
 		d_vertexes[i].m_y = (float)(vertex.y);
 		d_vertexes[i].m_z = (float)(vertex.z);
 
-		if(v_vertex_ids[i].m_texture_coordinate < mv_texture_coordinates.size())
+		if(v_vertex_ids[i].m_texture_coordinate < m_texture_coordinates.size())
 		{
-			const Vector2& texture_coordinate = mv_texture_coordinates[v_vertex_ids[i].m_texture_coordinate];
+			Vector2 texture_coordinate = m_texture_coordinates.get(v_vertex_ids[i].m_texture_coordinate);
 
 			// flip texture coordinates to match Maya <|>
 			d_vertexes[i].m_s =        (float)(texture_coordinate.x);
@@ -3407,8 +3616,8 @@ ObjVbo<float> ObjModel :: createFaceVboVertexOnly (unsigned int mesh,
 		{
 			assert(vv_arrangement[i].size() == 1); // cannot be more because all the same
 
-			assert(i < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[i];
+			assert(i < m_vertexes.size());
+			Vector3 vertex = m_vertexes.get(i);
 
 			d_vertexes[next_vertex].m_x = (float)(vertex.x);
 			d_vertexes[next_vertex].m_y = (float)(vertex.y);
@@ -3463,16 +3672,16 @@ ObjVbo<float> ObjModel :: createFaceVboVertexTextureCoordinate (unsigned int mes
 		{
 			const TextureCoordinateAndNormal& element = vv_arrangement[i][j];
 
-			assert(i < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[i];
+			assert(i < m_vertexes.size());
+			Vector3 vertex = m_vertexes.get(i);
 
 			d_vertexes[next_vertex].m_x = (float)(vertex.x);
 			d_vertexes[next_vertex].m_y = (float)(vertex.y);
 			d_vertexes[next_vertex].m_z = (float)(vertex.z);
 
-			if(element.m_texture_coordinate < mv_texture_coordinates.size())
+			if(element.m_texture_coordinate < m_texture_coordinates.size())
 			{
-				const Vector2& texture_coordinate = mv_texture_coordinates[element.m_texture_coordinate];
+				Vector2 texture_coordinate = m_texture_coordinates.get(element.m_texture_coordinate);
 
 				// flip texture coordinates to match Maya <|>
 				d_vertexes[next_vertex].m_s =        (float)(texture_coordinate.x);
@@ -3521,16 +3730,16 @@ ObjVbo<float> ObjModel :: createFaceVboVertexNormal (unsigned int mesh,
 		{
 			const TextureCoordinateAndNormal& element = vv_arrangement[i][j];
 
-			assert(i < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[i];
+			assert(i < m_vertexes.size());
+			Vector3 vertex = m_vertexes.get(i);
 
 			d_vertexes[next_vertex].m_x = (float)(vertex.x);
 			d_vertexes[next_vertex].m_y = (float)(vertex.y);
 			d_vertexes[next_vertex].m_z = (float)(vertex.z);
 
-			if(element.m_normal < mv_normals.size())
+			if(element.m_normal < m_normals.size())
 			{
-				const Vector3& normal = mv_normals[element.m_normal];
+				Vector3 normal = m_normals.get(element.m_normal);
 
 				d_vertexes[next_vertex].m_nx = (float)(normal.x);
 				d_vertexes[next_vertex].m_ny = (float)(normal.y);
@@ -3580,16 +3789,16 @@ ObjVbo<float> ObjModel :: createFaceVboVertexTextureCoordinateNormal (unsigned i
 		{
 			const TextureCoordinateAndNormal& element = vv_arrangement[i][j];
 
-			assert(i < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[i];
+			assert(i < m_vertexes.size());
+			Vector3 vertex = m_vertexes.get(i);
 
 			d_vertexes[next_vertex].m_x = (float)(vertex.x);
 			d_vertexes[next_vertex].m_y = (float)(vertex.y);
 			d_vertexes[next_vertex].m_z = (float)(vertex.z);
 
-			if(element.m_texture_coordinate < mv_texture_coordinates.size())
+			if(element.m_texture_coordinate < m_texture_coordinates.size())
 			{
-				const Vector2& texture_coordinate = mv_texture_coordinates[element.m_texture_coordinate];
+				Vector2 texture_coordinate = m_texture_coordinates.get(element.m_texture_coordinate);
 
 				// flip texture coordinates to match Maya <|>
 				d_vertexes[next_vertex].m_s =        (float)(texture_coordinate.x);
@@ -3602,9 +3811,9 @@ ObjVbo<float> ObjModel :: createFaceVboVertexTextureCoordinateNormal (unsigned i
 				d_vertexes[next_vertex].m_t = (float)(FALLBACK_TEXTURE_COORDINATE.y);
 			}
 
-			if(element.m_normal < mv_normals.size())
+			if(element.m_normal < m_normals.size())
 			{
-				const Vector3& normal = mv_normals[element.m_normal];
+				Vector3 normal = m_normals.get(element.m_normal);
 
 				d_vertexes[next_vertex].m_nx = (float)(normal.x);
 				d_vertexes[next_vertex].m_ny = (float)(normal.y);
@@ -3801,7 +4010,7 @@ void ObjModel :: calculateVertexArrangement (unsigned int mesh,
 	//    mesh.
 	//
 
-	rvv_arrangement.resize(mv_vertexes.size());
+	rvv_arrangement.resize(m_vertexes.size());
 
 	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
 	for(unsigned int f = 0; f < v_faces.size(); f++)
@@ -3868,7 +4077,7 @@ void ObjModel :: calculateVertexArrangement (unsigned int mesh,
 			cout << "\t" << v << ":";
 			if(!rvv_arrangement[v].empty())
 			{
-				cout << "\t" << mv_vertexes[v] << endl;
+				cout << "\t" << m_vertexes.get(v) << endl;
 				for(unsigned int i = 0; i < rvv_arrangement[v].size(); i++)
 				{
 					cout << "\t\t\t(" << rvv_arrangement[v][i].m_texture_coordinate
@@ -3889,8 +4098,6 @@ unsigned int ObjModel :: getVertexArrangementTotalCount (const VertexArrangement
 	return count;
 }
 
-#endif  // OBJ_LIBRARY_SHADER_DISPLAY is defined
-
 
 
 bool ObjModel :: readMaterialLibrary (const string& str, ostream& r_logstream)
@@ -4331,7 +4538,6 @@ bool ObjModel :: invariant () const
 
 
 
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
 ObjModel :: TextureCoordinateAndNormal :: TextureCoordinateAndNormal ()
 		: m_texture_coordinate(0),
 		  m_normal(0)
@@ -4362,7 +4568,6 @@ ObjModel :: TextureCoordinateAndNormal& ObjModel :: TextureCoordinateAndNormal :
 
 	return *this;
 }
-#endif  // OBJ_LIBRARY_SHADER_DISPLAY is defined
 
 
 
@@ -31,6 +31,7 @@
 #include "DisplayList.h"
 #include "Vector3.h"
 #include "Vector2.h"
+#include "GeometryArray.h"
 
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
 	#include "ObjVbo.h"
@@ -44,6 +45,10 @@ namespace ObjLibrary
 {
 
 class Material;
+class WeldedMesh;
+template <typename T> class ObjVbo;
+class MeshWithShader;
+class ModelWithShader;
 
 
 
@@ -488,9 +493,33 @@ public:
 //  Precondition(s):
 //    <1> vertex < getVertexCount()
 //  Returns: The position of vertex vertex in this ObjModel.
+//           The Vector3 is returned by value, because the
+//           position is stored in a GeometryArray3 (see
+//           OBJ_LIBRARY_FLOAT_GEOMETRY in ObjSettings.h).  A
+//           reference to it is only valid until the end of the
+//           statement.
 //  Side Effect: N/A
 //
-	const Vector3& getVertexPosition (
+	Vector3 getVertexPosition (unsigned int vertex) const;
+
+//
+//  getVertexPositionArray
+//
+//  Purpose: To retrieve a pointer to the stored position of the
+//           specified vertex in this ObjModel.
+//  Parameter(s):
+//    <1> vertex: Which vertex
+//  Precondition(s):
+//    <1> vertex < getVertexCount()
+//  Returns: A pointer to an array of 3 GeometryScalars holding
+//           the x, y, and z coordinates of vertex vertex.  The
+//           positions of all vertexes are stored contiguously,
+//           so this pointer may also be used to access the
+//           vertexes after vertex.  The pointer is invalidated
+//           if vertexes are added or removed.
+//  Side Effect: N/A
+//
+	const GeometryScalar* getVertexPositionArray (
 	                             unsigned int vertex) const;
 
 //
@@ -535,10 +564,34 @@ public:
 //  Precondition(s):
 //    <1> texture_coordinate < getTextureCoordinateCount()
 //  Returns: The texture coodinate pair texture_coordinate in
-//           this ObjModel.
+//           this ObjModel.  The Vector2 is returned by value,
+//           because the pair is stored in a GeometryArray2 (see
+//           OBJ_LIBRARY_FLOAT_GEOMETRY in ObjSettings.h).  A
+//           reference to it is only valid until the end of the
+//           statement.
 //  Side Effect: N/A
 //
-	const Vector2& getTextureCoordinate (
+	Vector2 getTextureCoordinate (
+	                 unsigned int texture_coordinate) const;
+
+//
+//  getTextureCoordinateArray
+//
+//  Purpose: To retrieve a pointer to the stored value of the
+//           specified texture coordinate pair in this ObjModel.
+//  Parameter(s):
+//    <1> texture_coordinate: Which texture coordinate pair
+//  Precondition(s):
+//    <1> texture_coordinate < getTextureCoordinateCount()
+//  Returns: A pointer to an array of 2 GeometryScalars holding
+//           the u and v components of texture coordinate pair
+//           texture_coordinate.  All texture coordinate pairs
+//           are stored contiguously.  The pointer is
+//           invalidated if texture coordinate pairs are added
+//           or removed.
+//  Side Effect: N/A
+//
+	const GeometryScalar* getTextureCoordinateArray (
 	                 unsigned int texture_coordinate) const;
 
 //
@@ -581,10 +634,33 @@ public:
 //    <1> normal: Which normal vector
 //  Precondition(s):
 //    <1> normal < getNormalCount()
-//  Returns: Normal vector normal in this ObjModel.
+//  Returns: Normal vector normal in this ObjModel.  The
+//           Vector3 is returned by value, because the normal is
+//           stored in a GeometryArray3 (see
+//           OBJ_LIBRARY_FLOAT_GEOMETRY in ObjSettings.h).  A
+//           reference to it is only valid until the end of the
+//           statement.
+//  Side Effect: N/A
+//
+	Vector3 getNormalVector (unsigned int normal) const;
+
+//
+//  getNormalArray
+//
+//  Purpose: To retrieve a pointer to the stored value of the
+//           specified normal vector in this ObjModel.
+//  Parameter(s):
+//    <1> normal: Which normal vector
+//  Precondition(s):
+//    <1> normal < getNormalCount()
+//  Returns: A pointer to an array of 3 GeometryScalars holding
+//           the x, y, and z components of normal vector normal.
+//           All normal vectors are stored contiguously.  The
+//           pointer is invalidated if normal vectors are added
+//           or removed.
 //  Side Effect: N/A
 //
-	const Vector3& getNormalVector (
+	const GeometryScalar* getNormalArray (
 	                             unsigned int normal) const;
 
 //
@@ -1208,6 +1284,20 @@ public:
 	void printBadMaterials (const std::string& logfile) const;
 	void printBadMaterials (std::ostream& r_logstream) const;
 
+//
+//  getWeldedMesh
+//
+//  Purpose: To generate a WeldedMesh for this ObjModel.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//  Returns: A WeldedMesh containing the faces of this ObjModel
+//           as a single indexed triangle list, with one range
+//           per mesh.
+//  Side Effect: N/A
+//
+	WeldedMesh getWeldedMesh () const;
+
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
 //
 //  draw
@@ -1874,12 +1964,15 @@ public:
 	DisplayList getDisplayListMaterialNone () const;
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
-
 //
 //  getModelWithShader
 //
 //  Purpose: To generate a ModelWithShader for this ObjModel.
+//           The ModelWithShader stores the model in buffer
+//           objects.  If OBJ_LIBRARY_SHADER_DISPLAY is not
+//           #defined, it is drawn with the fixed-function
+//           pipeline and looks the same as the DisplayList
+//           from getDisplayList.
 //  Parameter(s): N/A
 //  Precondition(s):
 //    <1> isValid()
@@ -1916,7 +2009,6 @@ public:
 	ModelWithShader getModelWithShader (
 	                                bool is_texture_coordinates,
 	                                bool is_normals) const;
-#endif  // OBJ_LIBRARY_SHADER_DISPLAY is defined
 
 //
 //  save
@@ -3080,8 +3172,51 @@ public:
 //
 	void validate ();
 
+//
+//  optimizeFaceOrder
+//
+//  Purpose: To reorder the faces in each mesh of this ObjModel
+//           so that they make better use of the graphics card
+//           vertex cache when drawn.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//  Returns: N/A
+//  Side Effect: The faces in each mesh of this ObjModel are
+//               reordered.  The order is calculated with
+//               MeshOptimizer on a WeldedMesh for the mesh, and
+//               each face is placed where its first triangle
+//               ended up.  The faces themselves are unchanged,
+//               so this ObjModel remains valid.  This is slow
+//               and should be done once after loading.
+//
+	void optimizeFaceOrder ();
+
+//
+//  optimizeVertexOrder
+//
+//  Purpose: To renumber the vertexes, texture coordinates, and
+//           normals of this ObjModel so that they are stored in
+//           the order they are first used.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//  Returns: N/A
+//  Side Effect: The vertexes, texture coordinates, and normals
+//               of this ObjModel are reordered to match the
+//               order they are first used by the faces, then
+//               the polylines, and then the point sets.  Any
+//               that are not used are placed at the end, in
+//               their original order.  The indexes in the
+//               faces, polylines, and point sets are changed to
+//               match, so this ObjModel looks the same.  This
+//               should be called after optimizeFaceOrder so
+//               that reading the vertex data for the new face
+//               order is as sequential as possible.
+//
+	void optimizeVertexOrder ();
+
 private:
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
 	//
 	//  TextureCoordinateAndNormal
 	//
@@ -3112,7 +3247,6 @@ private:
 	//
 	typedef std::vector<std::vector<TextureCoordinateAndNormal> >
 	                                          VertexArrangement;
-#endif  // OBJ_LIBRARY_SHADER_DISPLAY is defined
 
 private:
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
@@ -3221,7 +3355,6 @@ private:
 	void drawFaces (unsigned int mesh) const;
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
 //
 //  getPointSetMeshWithShader
 //
@@ -3463,7 +3596,6 @@ private:
 //
 	static unsigned int getVertexArrangementTotalCount (
 	                   const VertexArrangement& vv_arrangement);
-#endif  // OBJ_LIBRARY_SHADER_DISPLAY is defined
 
 //
 //  readMaterialLibrary
@@ -3826,9 +3958,9 @@ private:
 
 private:
 	std::vector<MaterialLibrary> mv_material_libraries;
-	std::vector<Vector3> mv_vertexes;
-	std::vector<Vector2> mv_texture_coordinates;
-	std::vector<Vector3> mv_normals;
+	GeometryArray3<GeometryScalar> m_vertexes;
+	GeometryArray2<GeometryScalar> m_texture_coordinates;
+	GeometryArray3<GeometryScalar> m_normals;
 	std::vector<Mesh> mv_meshes;
 
 	std::string m_file_name;
@@ -117,6 +117,50 @@
 
 
 
+//
+//  An ObjModel can store its vertex positions, texture
+//    coordinates, and normals as either doubles or floats.
+//    Everything is eventually sent to OpenGL as floats, so the
+//    extra precision of doubles is rarely useful.  Storing the
+//    geometry as floats halves the memory (and cache) footprint
+//    of the model data and lets the drawing functions pass the
+//    values to OpenGL without converting them.
+//
+//  OBJ_LIBRARY_FLOAT_GEOMETRY is defined below, so floats are
+//    used by default.  To store the geometry as doubles
+//    instead, comment out the #define.
+//
+//  In either case, getVertexPosition, getTextureCoordinate, and
+//    getNormalVector in ObjModel return a Vector3 or Vector2 by
+//    value, built from the stored values.  They used to return
+//    a const reference, so code that binds the result to a
+//    reference that outlives the statement, or takes its
+//    address, must be changed to keep a copy.  With floats,
+//    the values only have single precision.  The get*Array
+//    functions in ObjModel return pointers to the stored values
+//    in whatever precision is being used (see the
+//    GeometryScalar type).
+//
+#define OBJ_LIBRARY_FLOAT_GEOMETRY
+
+
+
+//
+//  The ObjLibrary can count the OpenGL calls it makes, such as
+//    draws, vertexes, display list calls, and texture binds.
+//    The counts are kept by the GlCallCounter module, which
+//    can split them into zones for different parts of a frame.
+//    Counting adds a small cost to every OpenGL call, so it is
+//    off by default.  Benchmark builds usually define it on
+//    the command line (-DOBJ_LIBRARY_COUNT_GL_CALLS) instead.
+//
+//  To count OpenGL calls, define the macro
+//    OBJ_LIBRARY_COUNT_GL_CALLS.
+//
+//#define OBJ_LIBRARY_COUNT_GL_CALLS
+
+
+
 //
 //  The Vector* classes in the ObjLibrary can interface with the
 //    OpenGL Mathematics (glm) library.  The glm library
@@ -169,11 +213,25 @@
 //  To enable shader-based display, define the macro
 //    OBJ_LIBRARY_SHADER_DISPLAY.
 //
+//  This copy of the ObjLibrary does not include the shader
+//    files (MaterialForShader, ObjShader, and the GLSL files
+//    they load) or glm, so OBJ_LIBRARY_SHADER_DISPLAY cannot
+//    be defined here.  What this copy has instead is a
+//    buffer-object backend alongside the shader path:
+//    ObjModel::getModelWithShader is available without the
+//    macro, and the resulting ModelWithShader keeps the model
+//    in buffer objects and draws it with the fixed pipeline.
+//
 //#define OBJ_LIBRARY_SHADER_DISPLAY
 
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
 	#ifndef OBJ_LIBRARY_GLM_INTERACTION
-		#error "OBJ_LIBRARY_GLM_INTERACTION requires OBJ_LIBRARY_GLM_INTERACTION"
+		#error "OBJ_LIBRARY_SHADER_DISPLAY requires OBJ_LIBRARY_GLM_INTERACTION"
+	#endif
+	#if defined(__has_include)
+		#if !__has_include("MaterialForShader.h") || !__has_include("ObjShader.h")
+			#error "OBJ_LIBRARY_SHADER_DISPLAY requires the ObjLibrary shader files, which are not included"
+		#endif
 	#endif
 #endif
 
@@ -0,0 +1,146 @@
+//
+//  ObjVao.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstddef>	// for NULL
+
+#include "../GetGlutWithShaders.h"
+#include "DisplayList.h"
+#include "ObjVao.h"
+
+using namespace ObjLibrary;
+
+
+
+void ObjVao :: bindNone ()
+{
+	glBindVertexArray(0);
+}
+
+
+
+ObjVao :: ObjVao ()
+		: mp_data(NULL)
+{
+	assert(invariant());
+}
+
+ObjVao :: ObjVao (const ObjVao& original)
+		: mp_data(NULL)
+{
+	copy(original);
+
+	assert(invariant());
+}
+
+ObjVao :: ~ObjVao ()
+{
+	makeEmpty();
+}
+
+ObjVao& ObjVao :: operator= (const ObjVao& original)
+{
+	if(&original != this)
+	{
+		makeEmpty();
+		copy(original);
+	}
+
+	assert(invariant());
+	return *this;
+}
+
+
+
+bool ObjVao :: isEmpty () const
+{
+	return mp_data == NULL;
+}
+
+unsigned int ObjVao :: getName () const
+{
+	assert(!isEmpty());
+
+	return mp_data->m_vao_name;
+}
+
+void ObjVao :: bind () const
+{
+	assert(!isEmpty());
+	assert(!DisplayList::isDisabledForExit());
+
+	glBindVertexArray(mp_data->m_vao_name);
+}
+
+
+
+void ObjVao :: init ()
+{
+	assert(DisplayList::isGlutInitialized());
+	assert(!DisplayList::isDisabledForExit());
+
+	makeEmpty();
+
+	GLuint vao_name;
+	glGenVertexArrays(1, &vao_name);
+
+	mp_data = new InnerData;
+	mp_data->m_vao_name = vao_name;
+	mp_data->m_usages   = 1;
+
+	assert(invariant());
+}
+
+void ObjVao :: makeEmpty ()
+{
+	if(mp_data != NULL)
+	{
+		assert(mp_data->m_usages > 0);
+		mp_data->m_usages--;
+		if(mp_data->m_usages == 0)
+		{
+			if(!DisplayList::isDisabledForExit())
+			{
+				GLuint vao_name = mp_data->m_vao_name;
+				glDeleteVertexArrays(1, &vao_name);
+			}
+			delete mp_data;
+		}
+		mp_data = NULL;
+	}
+
+	assert(isEmpty());
+}
+
+
+
+void ObjVao :: copy (const ObjVao& original)
+{
+	assert(isEmpty());
+
+	mp_data = original.mp_data;
+	if(mp_data != NULL)
+		mp_data->m_usages++;
+}
+
+bool ObjVao :: invariant () const
+{
+	if(mp_data != NULL && mp_data->m_usages == 0) return false;
+	return true;
+}
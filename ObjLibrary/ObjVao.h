@@ -0,0 +1,244 @@
+//
+//  ObjVao.h
+//
+//  A module to encapsulate an OpenGL vertex array object.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_OBJ_VAO_H
+#define OBJ_LIBRARY_OBJ_VAO_H
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  ObjVao
+//
+//  A wrapper class to encapsulate an OpenGL vertex array
+//    object (VAO).  A VAO records which buffer objects supply
+//    each vertex attribute and which buffer object supplies the
+//    indexes, so all of them can be set up again with a single
+//    bind() call.
+//
+//  If an ObjVao is copied, the underlying vertex array object
+//    is not copied.  Instead, both ObjVaos refer to the same
+//    vertex array object, which is not destroyed until the last
+//    reference is removed.  Vertex array objects are deleted on
+//    destruction unless DisplayList::disableAllForExit() has
+//    been called.
+//
+//  Vertex array objects require OpenGL 3.0 or later.
+//
+//  Class Invariant:
+//    <1> mp_data == NULL || mp_data->m_usages > 0
+//
+class ObjVao
+{
+public:
+//
+//  Class Function: bindNone
+//
+//  Purpose: To unbind the current vertex array object, if any.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: No vertex array object is bound.
+//
+	static void bindNone ();
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty ObjVao.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ObjVao is created.  It does not contain
+//               a vertex array object.
+//
+	ObjVao ();
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create an ObjVao referring to the same vertex
+//           array object as another.
+//  Parameter(s):
+//    <1> original: The ObjVao to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ObjVao is created.  It refers to the
+//               same vertex array object as original, if any.
+//
+	ObjVao (const ObjVao& original);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy an ObjVao.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This ObjVao is destroyed.  If it was the last
+//               reference to its vertex array object, the
+//               vertex array object is deleted.
+//
+	~ObjVao ();
+
+//
+//  Assignment Operator
+//
+//  Purpose: To set this ObjVao to refer to the same vertex
+//           array object as another.
+//  Parameter(s):
+//    <1> original: The ObjVao to copy
+//  Precondition(s): N/A
+//  Returns: A reference to this ObjVao.
+//  Side Effect: This ObjVao is set to refer to the same vertex
+//               array object as original.  If it was the last
+//               reference to its previous vertex array object,
+//               that vertex array object is deleted.
+//
+	ObjVao& operator= (const ObjVao& original);
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this ObjVao does not contain a
+//           vertex array object.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this ObjVao is empty.
+//  Side Effect: N/A
+//
+	bool isEmpty () const;
+
+//
+//  getName
+//
+//  Purpose: To determine the OpenGL name of the vertex array
+//           object.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isEmpty()
+//  Returns: The OpenGL name.
+//  Side Effect: N/A
+//
+	unsigned int getName () const;
+
+//
+//  bind
+//
+//  Purpose: To bind the vertex array object for this ObjVao.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isEmpty()
+//    <2> !DisplayList::isDisabledForExit()
+//  Returns: N/A
+//  Side Effect: The vertex array object is bound.  Any vertex
+//               attribute or index buffer changes will be
+//               recorded in it until another vertex array
+//               object is bound.
+//
+	void bind () const;
+
+//
+//  init
+//
+//  Purpose: To set this ObjVao to contain a new vertex array
+//           object.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//  Returns: N/A
+//  Side Effect: A new vertex array object is created and this
+//               ObjVao is set to refer to it.  If this ObjVao
+//               was the last reference to its previous vertex
+//               array object, that vertex array object is
+//               deleted.  The new vertex array object is not
+//               bound.
+//
+	void init ();
+
+//
+//  makeEmpty
+//
+//  Purpose: To remove the vertex array object from this
+//           ObjVao.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This ObjVao is set to be empty.  If it was the
+//               last reference to its vertex array object, the
+//               vertex array object is deleted.
+//
+	void makeEmpty ();
+
+private:
+//
+//  copy
+//
+//  Purpose: To set this ObjVao to refer to the same vertex
+//           array object as another.
+//  Parameter(s):
+//    <1> original: The ObjVao to copy
+//  Precondition(s):
+//    <1> isEmpty()
+//  Returns: N/A
+//  Side Effect: This ObjVao is set to refer to the same vertex
+//               array object as original.
+//
+	void copy (const ObjVao& original);
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	//
+	//  InnerData
+	//
+	//  A record to store the vertex array object name and a
+	//    usage count, shared between all the ObjVaos that
+	//    refer to it.
+	//
+	struct InnerData
+	{
+		unsigned int m_vao_name;
+		unsigned int m_usages;
+	};
+
+private:
+	InnerData* mp_data;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,483 @@
+//
+//  ObjVbo.h
+//
+//  A module to encapsulate an OpenGL buffer object.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_OBJ_VBO_H
+#define OBJ_LIBRARY_OBJ_VBO_H
+
+#include <cassert>
+#include <cstddef>	// for NULL
+
+#include "../GetGlutWithShaders.h"
+#include "DisplayList.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  ObjVbo
+//
+//  A wrapper class template to encapsulate an OpenGL buffer
+//    object (often called a vertex buffer object, or VBO)
+//    holding an array of elements of type T.  The buffer
+//    object lives in video memory, so the data does not have
+//    to be sent to the graphics card every time it is drawn.
+//
+//  If an ObjVbo is copied, the underlying buffer object is not
+//    copied.  Instead, both ObjVbos refer to the same buffer
+//    object, which is not destroyed until the last reference is
+//    removed.  This is the same behaviour as a DisplayList.
+//    Changing the contents through either ObjVbo changes both.
+//
+//  Buffer objects are deleted on destruction unless
+//    DisplayList::disableAllForExit() has been called, in which
+//    case they are left for the operating system to clean up.
+//
+//  The target is normally GL_ARRAY_BUFFER for vertex data or
+//    GL_ELEMENT_ARRAY_BUFFER for indexes.  The usage is
+//    normally GL_STATIC_DRAW for data that is set once and
+//    GL_STREAM_DRAW or GL_DYNAMIC_DRAW for data that changes.
+//
+//  Class Invariant:
+//    <1> mp_data == NULL || mp_data->m_usages > 0
+//
+template <typename T>
+class ObjVbo
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty ObjVbo.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ObjVbo is created.  It does not contain
+//               a buffer object.
+//
+	ObjVbo ()
+			: mp_data(NULL)
+	{
+		assert(invariant());
+	}
+
+//
+//  Constructor
+//
+//  Purpose: To create an ObjVbo containing the specified data.
+//  Parameter(s):
+//    <1> target: The OpenGL buffer target
+//    <2> usage: The OpenGL usage hint
+//    <3> element_count: The number of elements
+//    <4> a_data: The elements
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//    <2> a_data != NULL || element_count == 0
+//  Returns: N/A
+//  Side Effect: A new ObjVbo is created.  It contains a new
+//               buffer object holding the first element_count
+//               elements of a_data.
+//
+	ObjVbo (GLenum target,
+	        GLenum usage,
+	        unsigned int element_count,
+	        const T* a_data)
+			: mp_data(NULL)
+	{
+		assert(DisplayList::isGlutInitialized());
+		assert(a_data != NULL || element_count == 0);
+
+		init(target, usage, element_count, a_data);
+
+		assert(invariant());
+	}
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create an ObjVbo referring to the same buffer
+//           object as another.
+//  Parameter(s):
+//    <1> original: The ObjVbo to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ObjVbo is created.  It refers to the
+//               same buffer object as original, if any.
+//
+	ObjVbo (const ObjVbo& original)
+			: mp_data(NULL)
+	{
+		copy(original);
+
+		assert(invariant());
+	}
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy an ObjVbo.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This ObjVbo is destroyed.  If it was the last
+//               reference to its buffer object, the buffer
+//               object is deleted.
+//
+	~ObjVbo ()
+	{
+		makeEmpty();
+	}
+
+//
+//  Assignment Operator
+//
+//  Purpose: To set this ObjVbo to refer to the same buffer
+//           object as another.
+//  Parameter(s):
+//    <1> original: The ObjVbo to copy
+//  Precondition(s): N/A
+//  Returns: A reference to this ObjVbo.
+//  Side Effect: This ObjVbo is set to refer to the same buffer
+//               object as original.  If it was the last
+//               reference to its previous buffer object, that
+//               buffer object is deleted.
+//
+	ObjVbo& operator= (const ObjVbo& original)
+	{
+		if(&original != this)
+		{
+			makeEmpty();
+			copy(original);
+		}
+
+		assert(invariant());
+		return *this;
+	}
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this ObjVbo does not contain a
+//           buffer object.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this ObjVbo is empty.
+//  Side Effect: N/A
+//
+	bool isEmpty () const
+	{
+		return mp_data == NULL;
+	}
+
+//
+//  getTarget
+//  getUsage
+//  getElementCount
+//  getByteCount
+//  getName
+//
+//  Purpose: To determine the OpenGL target, the usage hint,
+//           the number of elements, the size in bytes, or the
+//           OpenGL name of the buffer object.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isEmpty()
+//  Returns: The requested value.
+//  Side Effect: N/A
+//
+	GLenum getTarget () const
+	{
+		assert(!isEmpty());
+
+		return mp_data->m_target;
+	}
+
+	GLenum getUsage () const
+	{
+		assert(!isEmpty());
+
+		return mp_data->m_usage;
+	}
+
+	unsigned int getElementCount () const
+	{
+		assert(!isEmpty());
+
+		return mp_data->m_element_count;
+	}
+
+	unsigned int getByteCount () const
+	{
+		assert(!isEmpty());
+
+		return mp_data->m_element_count * sizeof(T);
+	}
+
+	GLuint getName () const
+	{
+		assert(!isEmpty());
+
+		return mp_data->m_buffer_name;
+	}
+
+//
+//  bind
+//
+//  Purpose: To bind the buffer object for this ObjVbo to its
+//           target.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isEmpty()
+//    <2> !DisplayList::isDisabledForExit()
+//  Returns: N/A
+//  Side Effect: The buffer object is bound to getTarget().
+//
+	void bind () const
+	{
+		assert(!isEmpty());
+		assert(!DisplayList::isDisabledForExit());
+
+		glBindBuffer(mp_data->m_target, mp_data->m_buffer_name);
+	}
+
+//
+//  Class Function: bindNone
+//
+//  Purpose: To unbind any buffer object from the specified
+//           target.
+//  Parameter(s):
+//    <1> target: The OpenGL buffer target
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: No buffer object is bound to target.
+//
+	static void bindNone (GLenum target)
+	{
+		glBindBuffer(target, 0);
+	}
+
+//
+//  init
+//
+//  Purpose: To set this ObjVbo to contain a new buffer object
+//           holding the specified data.
+//  Parameter(s):
+//    <1> target: The OpenGL buffer target
+//    <2> usage: The OpenGL usage hint
+//    <3> element_count: The number of elements
+//    <4> a_data: The elements
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> a_data != NULL || element_count == 0
+//  Returns: N/A
+//  Side Effect: A new buffer object is created holding the
+//               first element_count elements of a_data, and
+//               this ObjVbo is set to refer to it.  If this
+//               ObjVbo was the last reference to its previous
+//               buffer object, that buffer object is deleted.
+//               The new buffer object is left bound to target.
+//
+	void init (GLenum target,
+	           GLenum usage,
+	           unsigned int element_count,
+	           const T* a_data)
+	{
+		assert(DisplayList::isGlutInitialized());
+		assert(!DisplayList::isDisabledForExit());
+		assert(a_data != NULL || element_count == 0);
+
+		makeEmpty();
+
+		mp_data = new InnerData;
+		mp_data->m_target        = target;
+		mp_data->m_usage         = usage;
+		mp_data->m_element_count = element_count;
+		mp_data->m_usages        = 1;
+
+		glGenBuffers(1, &(mp_data->m_buffer_name));
+		glBindBuffer(target, mp_data->m_buffer_name);
+		glBufferData(target, element_count * sizeof(T), a_data, usage);
+
+		assert(invariant());
+	}
+
+//
+//  update
+//
+//  Purpose: To replace some of the elements in this ObjVbo.
+//  Parameter(s):
+//    <1> a_data: The new elements
+//    <2> first: The index of the first element to replace
+//    <3> count: The number of elements to replace
+//  Precondition(s):
+//    <1> !isEmpty()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> a_data != NULL || count == 0
+//    <4> first + count <= getElementCount()
+//  Returns: N/A
+//  Side Effect: Elements first to first + count - 1 of the
+//               buffer object are set to the first count
+//               elements of a_data.  The buffer object is left
+//               bound to its target.
+//
+	void update (const T* a_data,
+	             unsigned int first,
+	             unsigned int count)
+	{
+		assert(!isEmpty());
+		assert(!DisplayList::isDisabledForExit());
+		assert(a_data != NULL || count == 0);
+		assert(first + count <= getElementCount());
+
+		glBindBuffer(mp_data->m_target, mp_data->m_buffer_name);
+		glBufferSubData(mp_data->m_target, first * sizeof(T), count * sizeof(T), a_data);
+	}
+
+//
+//  replace
+//
+//  Purpose: To replace all the elements in this ObjVbo,
+//           possibly changing the element count.
+//  Parameter(s):
+//    <1> element_count: The new number of elements
+//    <2> a_data: The new elements
+//  Precondition(s):
+//    <1> !isEmpty()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> a_data != NULL || element_count == 0
+//  Returns: N/A
+//  Side Effect: The buffer object is reallocated to hold the
+//               first element_count elements of a_data.  Any
+//               other ObjVbos that refer to the same buffer
+//               object also see the new data.  Reallocating
+//               lets the driver keep using the old storage for
+//               drawing that has not finished yet, so this is
+//               the best way to stream data that changes every
+//               frame.  The buffer object is left bound to its
+//               target.
+//
+	void replace (unsigned int element_count,
+	              const T* a_data)
+	{
+		assert(!isEmpty());
+		assert(!DisplayList::isDisabledForExit());
+		assert(a_data != NULL || element_count == 0);
+
+		mp_data->m_element_count = element_count;
+		glBindBuffer(mp_data->m_target, mp_data->m_buffer_name);
+		glBufferData(mp_data->m_target, element_count * sizeof(T), a_data, mp_data->m_usage);
+	}
+
+//
+//  makeEmpty
+//
+//  Purpose: To remove the buffer object from this ObjVbo.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This ObjVbo is set to be empty.  If it was the
+//               last reference to its buffer object, the
+//               buffer object is deleted.
+//
+	void makeEmpty ()
+	{
+		if(mp_data != NULL)
+		{
+			assert(mp_data->m_usages > 0);
+			mp_data->m_usages--;
+			if(mp_data->m_usages == 0)
+			{
+				if(!DisplayList::isDisabledForExit())
+					glDeleteBuffers(1, &(mp_data->m_buffer_name));
+				delete mp_data;
+			}
+			mp_data = NULL;
+		}
+
+		assert(isEmpty());
+	}
+
+private:
+//
+//  copy
+//
+//  Purpose: To set this ObjVbo to refer to the same buffer
+//           object as another.
+//  Parameter(s):
+//    <1> original: The ObjVbo to copy
+//  Precondition(s):
+//    <1> isEmpty()
+//  Returns: N/A
+//  Side Effect: This ObjVbo is set to refer to the same buffer
+//               object as original.
+//
+	void copy (const ObjVbo& original)
+	{
+		assert(isEmpty());
+
+		mp_data = original.mp_data;
+		if(mp_data != NULL)
+			mp_data->m_usages++;
+	}
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const
+	{
+		if(mp_data != NULL && mp_data->m_usages == 0) return false;
+		return true;
+	}
+
+private:
+	//
+	//  InnerData
+	//
+	//  A record to store information about an OpenGL buffer
+	//    object, shared between all the ObjVbos that refer to
+	//    it.
+	//
+	struct InnerData
+	{
+		GLuint       m_buffer_name;
+		GLenum       m_target;
+		GLenum       m_usage;
+		unsigned int m_element_count;
+		unsigned int m_usages;
+	};
+
+private:
+	InnerData* mp_data;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
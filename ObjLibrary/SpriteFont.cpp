@@ -29,6 +29,7 @@
 
 #include <cassert>
 #include <cctype>
+#include <algorithm>  // for swap
 #include <string>
 #include <iostream>
 #include <vector>
@@ -49,6 +50,7 @@
 #endif
 
 #include "ObjStringParsing.h"
+#include "GlCallCounter.h"
 #include "TextureBmp.h"
 #include "SpriteFont.h"
 
@@ -218,6 +220,62 @@ namespace
 			break;
 		}
 	}
+
+	//
+	//  addGlyphQuad
+	//
+	//  Purpose: To add the corners of a character quad to the
+	//           specified vector.
+	//  Parameter(s):
+	//    <1> rv_vertexes: The vector to add to
+	//    <2> left
+	//    <3> right
+	//    <4> top
+	//    <5> bottom: The edges of the quad, in pixels
+	//    <6> slant_amount: The amount to slant the quad
+	//    <7> left_coord
+	//    <8> right_coord
+	//    <9> top_coord
+	//   <10> bottom_coord: The texture coordinates for the
+	//                      edges of the quad
+	//   <11> a_colour: The colour for the quad
+	//  Precondition(s):
+	//    <1> a_colour != NULL
+	//  Returns: N/A
+	//  Side Effect: Four vertexes are added to rv_vertexes, in
+	//               the same order that drawLineOfText uses.
+	//
+	void addGlyphQuad (vector<SpriteFont::GlyphVertex>& rv_vertexes,
+	                   double left,
+	                   double right,
+	                   double top,
+	                   double bottom,
+	                   int slant_amount,
+	                   float left_coord,
+	                   float right_coord,
+	                   float top_coord,
+	                   float bottom_coord,
+	                   const unsigned char a_colour[4])
+	{
+		assert(a_colour != NULL);
+
+		SpriteFont::GlyphVertex a_corners[4];
+		a_corners[0].m_x = (float)(left  - slant_amount);  a_corners[0].m_y = (float)(bottom);
+		a_corners[0].m_s = left_coord;                     a_corners[0].m_t = bottom_coord;
+		a_corners[1].m_x = (float)(left  + slant_amount);  a_corners[1].m_y = (float)(top);
+		a_corners[1].m_s = left_coord;                     a_corners[1].m_t = top_coord;
+		a_corners[2].m_x = (float)(right + slant_amount);  a_corners[2].m_y = (float)(top);
+		a_corners[2].m_s = right_coord;                    a_corners[2].m_t = top_coord;
+		a_corners[3].m_x = (float)(right - slant_amount);  a_corners[3].m_y = (float)(bottom);
+		a_corners[3].m_s = right_coord;                    a_corners[3].m_t = bottom_coord;
+
+		for(unsigned int c = 0; c < 4; c++)
+		{
+			for(unsigned int i = 0; i < 4; i++)
+				a_corners[c].ma_colour[i] = a_colour[i];
+			rv_vertexes.push_back(a_corners[c]);
+		}
+	}
 #endif
 
 
@@ -425,6 +483,7 @@ SpriteFont :: SpriteFont ()
 #else
 	for(unsigned int i = 0; i < CHARACTER_COUNT_MAX; i++)
 		ma_character_name[i] = 0;
+	m_atlas_name = 0;
 #endif
 
 	for(unsigned int i = 0; i < CHARACTER_COUNT_MAX; i++)
@@ -483,6 +542,8 @@ SpriteFont :: ~SpriteFont ()
 		// glDeleteTextures(GLsizei n, const GLuint *textureNames);
 		glDeleteTextures(m_character_count, ma_character_name);
 	}
+	if(m_atlas_name != 0)
+		glDeleteTextures(1, &m_atlas_name);
 #endif
 }
 
@@ -1003,6 +1064,111 @@ void SpriteFont :: draw (const vector<string>& lines,
 
 
 
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+void SpriteFont :: layoutText (const std::string& str,
+                               unsigned char red,
+                               unsigned char green,
+                               unsigned char blue,
+                               unsigned char alpha,
+                               unsigned int format,
+                               std::vector<GlyphVertex>& rv_vertexes) const
+{
+	assert(isInitialized());
+	assert(isValidFormat(format));
+
+	int  extra_width  = getExtraWidthForFormat(format);
+	bool is_mirror    = ((format & MIRROR) == MIRROR);
+	bool is_8bit_font = is8Bit();
+	int  slant_amount = getSlantAmountForFormat(format, m_character_height);
+	bool is_bold      = ((format & BOLD) == BOLD);
+
+	const unsigned char A_COLOUR[4] = { red, green, blue, alpha };
+
+	// the atlas has the characters in the same layout as the font image
+	float cell_s = 1.0f / TEXTURES_PER_ROW;
+	float cell_t = 1.0f / (m_character_count / TEXTURES_PER_ROW);
+
+	double end_x    = getWidth(str, format);
+	int    offset_x = 0;
+	double y        = 0.0;
+
+	for(unsigned int i = 0; i < str.size(); i++)
+	{
+		unsigned char character = str[i];
+
+		if(character == '\n')
+		{
+			offset_x = 0;
+			y       += getHeight(format);
+		}
+		else if(character == '\t')
+		{
+			int character_width = ma_character_width[character];
+			assert(character_width > 0);
+			offset_x = (1 + offset_x / character_width) * character_width;
+		}
+		else if(is_8bit_font || ((character & 0x80) == 0x00))
+		{
+			// mirrored text is drawn with squares to the left of our curser
+			double left;
+			if(is_mirror)
+				left = end_x - offset_x - m_image_size;
+			else
+				left = offset_x;
+			double right  = left + m_image_size;
+			double bottom = y + m_image_size;
+
+			float cell_left   = (character % TEXTURES_PER_ROW) * cell_s;
+			float cell_right  = cell_left + cell_s;
+			float cell_top    = (character / TEXTURES_PER_ROW) * cell_t;
+			float cell_bottom = cell_top + cell_t;
+			if(is_mirror)
+				swap(cell_left, cell_right);
+
+			addGlyphQuad(rv_vertexes, left, right, y, bottom, slant_amount,
+			             cell_left, cell_right, cell_top, cell_bottom, A_COLOUR);
+
+			// bold text is just normal text twice
+			if(is_bold)
+				addGlyphQuad(rv_vertexes, left + 1, right + 1, y, bottom, slant_amount,
+				             cell_left, cell_right, cell_top, cell_bottom, A_COLOUR);
+
+			offset_x += ma_character_width[character] + extra_width;
+		}
+	}
+}
+
+void SpriteFont :: drawGlyphVertexes (const std::vector<GlyphVertex>& v_vertexes) const
+{
+	assert(isInitialized());
+	assert(v_vertexes.size() % 4 == 0);
+
+	if(v_vertexes.empty())
+		return;
+
+	// the colour comes from the vertexes
+	setUpForDrawing(0.0, 0xFF, 0xFF, 0xFF, 0xFF, PLAIN);
+	glShadeModel(GL_SMOOTH);
+	glBindTexture(GL_TEXTURE_2D, m_atlas_name);
+
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+		GLsizei stride = sizeof(GlyphVertex);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer  (2, GL_FLOAT,         stride, &(v_vertexes[0].m_x));
+		glTexCoordPointer(2, GL_FLOAT,         stride, &(v_vertexes[0].m_s));
+		glColorPointer   (4, GL_UNSIGNED_BYTE, stride,   v_vertexes[0].ma_colour);
+
+		glDrawArrays(GL_QUADS, 0, (GLsizei)(v_vertexes.size()));
+	glPopClientAttrib();
+
+	unsetUpForDrawing();
+}
+#endif
+
+
+
 void SpriteFont :: load (const char* a_image)
 {
 	assert(!isInitialized());
@@ -1143,6 +1309,11 @@ void SpriteFont :: load (const char* a_image,
 #else
 	// set up an array of textures, one for each character
 	glGenTextures(m_character_count, ma_character_name);
+
+	// and one atlas texture with all of them in the same places as in the font image
+	unsigned int atlas_width  = font.getWidth();
+	unsigned int atlas_height = font.getHeight();
+	unsigned char* d_atlas = new unsigned char[atlas_width * atlas_height];
 #endif
 
 	unsigned char* d_tile = new unsigned char[m_image_size * m_image_size];
@@ -1212,6 +1383,10 @@ void SpriteFont :: load (const char* a_image,
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_image_size, m_image_size, 0, GL_ALPHA, GL_UNSIGNED_BYTE, d_tile);
+
+		for(unsigned int y = 0; y < m_image_size; y++)
+			for(unsigned int x = 0; x < m_image_size; x++)
+				d_atlas[(base_y + y) * atlas_width + base_x + x] = d_tile[y * m_image_size + x];
 #endif
 
 		// calculate the character width from the first row
@@ -1232,6 +1407,19 @@ void SpriteFont :: load (const char* a_image,
 	}
 	delete[] d_tile;
 
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	// characters are drawn at their exact size, so they never sample their neighbours
+	glGenTextures(1, &m_atlas_name);
+	glBindTexture(GL_TEXTURE_2D, m_atlas_name);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, atlas_width, atlas_height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, d_atlas);
+	delete[] d_atlas;
+#endif
+
 	setTabWidthToDefault();
 
 	// calculate the font height from the first column of the first character
@@ -1537,6 +1725,9 @@ bool SpriteFont :: invariant () const
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
 	if(m_character_count != 0 && !glIsTexture(m_texture_name))
 		return false;
+#else
+	if(m_character_count != 0 && !glIsTexture(m_atlas_name))
+		return false;
 #endif
 
 	for(unsigned int i = 0; i < m_character_count; i++)
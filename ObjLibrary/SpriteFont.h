@@ -26,6 +26,8 @@
 #include <string>
 #include <vector>
 
+#include "ObjSettings.h"
+
 
 
 namespace ObjLibrary
@@ -95,6 +97,9 @@ namespace ObjLibrary
 //                                FOR 0 <= i < m_character_count
 //    <7> m_character_count == 0 ||
 //        ma_character_width['\t'] > 0
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+//    <8> m_character_count == 0 || glIsTexture(m_atlas_name)
+#endif
 //
 
 class SpriteFont
@@ -164,6 +169,24 @@ public:
 	static const unsigned int DOUBLE_STRIKETHROUGH = 0x200;
 	static const unsigned int RED_STRIKETHROUGH    = 0x300;
 
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+//
+//  GlyphVertex
+//
+//  A record to represent one corner of a character quad, as
+//    calculated by layoutText.  The position is in pixels, the
+//    texture coordinates are for the font atlas texture, and
+//    the colour is (red, green, blue, alpha).  Quads from many
+//    strings can be drawn together with drawGlyphVertexes.
+//
+	struct GlyphVertex
+	{
+		float m_x, m_y;
+		float m_s, m_t;
+		unsigned char ma_colour[4];
+	};
+#endif
+
 //
 //  isGlutInitialized
 //
@@ -997,6 +1020,58 @@ public:
 	           unsigned char alpha,
 	           unsigned int format) const;
 
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+//
+//  layoutText
+//
+//  Purpose: To calculate the character quads for the specified
+//           string without drawing them.
+//  Parameter(s):
+//    <1> str: The string to lay out
+//    <2> red
+//    <3> green
+//    <4> blue: The colour to draw the string with
+//    <5> alpha: The transparency to draw the string with
+//    <6> format: The text format
+//    <7> rv_vertexes: The vector to add the quads to
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> isValidFormat(format)
+//  Returns: N/A
+//  Side Effect: Four GlyphVertexes are added to rv_vertexes
+//               for each character quad in str, as it would be
+//               drawn by draw at position (0, 0).  Underlines
+//               and strikethroughs are not supported (have no
+//               effect).
+//
+	void layoutText (const std::string& str,
+	                 unsigned char red,
+	                 unsigned char green,
+	                 unsigned char blue,
+	                 unsigned char alpha,
+	                 unsigned int format,
+	                 std::vector<GlyphVertex>& rv_vertexes) const;
+
+//
+//  drawGlyphVertexes
+//
+//  Purpose: To draw the specified character quads using this
+//           SpriteFont.
+//  Parameter(s):
+//    <1> v_vertexes: The quads to draw
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> v_vertexes.size() % 4 == 0
+//  Returns: N/A
+//  Side Effect: The quads in v_vertexes are drawn with the font
+//               atlas texture for this SpriteFont using a
+//               single glDrawArrays call.  The quads should have
+//               been calculated with layoutText for this
+//               SpriteFont.
+//
+	void drawGlyphVertexes (const std::vector<GlyphVertex>& v_vertexes) const;
+#endif
+
 //
 //  load
 //
@@ -1221,6 +1296,9 @@ private:
 #else
 	// array of textures, one per character
 	unsigned int ma_character_name[CHARACTER_COUNT_MAX];
+
+	// one texture with all the characters, for drawGlyphVertexes
+	unsigned int m_atlas_name;
 #endif
 
 	unsigned int ma_character_width[CHARACTER_COUNT_MAX];
@@ -0,0 +1,198 @@
+//
+//  SpriteFontBatch.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjSettings.h"
+#include "SpriteFont.h"
+#include "SpriteFontBatch.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+SpriteFontBatch :: SpriteFontBatch (const SpriteFont& font)
+		: mp_font(&font),
+		  m_string_count(0),
+		  m_layout_count(0)
+{
+	assert(invariant());
+}
+
+
+
+unsigned int SpriteFontBatch :: getCachedStringCount () const
+{
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	return 0;
+#else
+	return (unsigned int)(m_cache.size());
+#endif
+}
+
+
+
+void SpriteFontBatch :: add (const std::string& str,
+                             double x,
+                             double y)
+{
+	assert(getFont().isInitialized());
+
+	add(str, x, y, 0xFF, 0xFF, 0xFF, 0xFF, SpriteFont::PLAIN);
+}
+
+void SpriteFontBatch :: add (const std::string& str,
+                             double x,
+                             double y,
+                             unsigned char red,
+                             unsigned char green,
+                             unsigned char blue)
+{
+	assert(getFont().isInitialized());
+
+	add(str, x, y, red, green, blue, 0xFF, SpriteFont::PLAIN);
+}
+
+void SpriteFontBatch :: add (const std::string& str,
+                             double x,
+                             double y,
+                             unsigned char red,
+                             unsigned char green,
+                             unsigned char blue,
+                             unsigned char alpha,
+                             unsigned int format)
+{
+	assert(getFont().isInitialized());
+	assert(SpriteFont::isValidFormat(format));
+
+	m_string_count++;
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	PendingString pending;
+	pending.m_string     = str;
+	pending.m_x          = x;
+	pending.m_y          = y;
+	pending.ma_colour[0] = red;
+	pending.ma_colour[1] = green;
+	pending.ma_colour[2] = blue;
+	pending.ma_colour[3] = alpha;
+	pending.m_format     = format;
+	mv_pending.push_back(pending);
+#else
+	// key is the string followed by the colour and format bytes
+	m_key = str;
+	m_key.push_back('\0');
+	m_key.push_back((char)(red));
+	m_key.push_back((char)(green));
+	m_key.push_back((char)(blue));
+	m_key.push_back((char)(alpha));
+	m_key.push_back((char)(format & 0xFF));
+	m_key.push_back((char)(format >> 8));
+
+	CachedLayout& layout = m_cache[m_key];
+	if(!layout.m_is_used && layout.mv_vertexes.empty())
+	{
+		// new entry (or an empty string, which is cheap anyway)
+		mp_font->layoutText(str, red, green, blue, alpha, format, layout.mv_vertexes);
+		m_layout_count++;
+	}
+	layout.m_is_used = true;
+
+	float offset_x = (float)(x);
+	float offset_y = (float)(y);
+	unsigned int first = (unsigned int)(mv_vertexes.size());
+	mv_vertexes.insert(mv_vertexes.end(), layout.mv_vertexes.begin(), layout.mv_vertexes.end());
+	for(unsigned int i = first; i < mv_vertexes.size(); i++)
+	{
+		mv_vertexes[i].m_x += offset_x;
+		mv_vertexes[i].m_y += offset_y;
+	}
+#endif
+
+	assert(invariant());
+}
+
+void SpriteFontBatch :: draw ()
+{
+	assert(getStringCount() == 0 || getFont().isInitialized());
+	assert(getStringCount() == 0 || SpriteFont::is2dViewSetUp());
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	for(unsigned int i = 0; i < mv_pending.size(); i++)
+	{
+		const PendingString& pending = mv_pending[i];
+		mp_font->draw(pending.m_string, pending.m_x, pending.m_y,
+		              pending.ma_colour[0], pending.ma_colour[1],
+		              pending.ma_colour[2], pending.ma_colour[3],
+		              pending.m_format);
+	}
+	mv_pending.clear();
+#else
+	if(!mv_vertexes.empty())
+		mp_font->drawGlyphVertexes(mv_vertexes);
+	mv_vertexes.clear();
+
+	// forget strings that were not drawn this time
+	for(unordered_map<string, CachedLayout>::iterator it = m_cache.begin(); it != m_cache.end(); )
+	{
+		if(it->second.m_is_used)
+		{
+			it->second.m_is_used = false;
+			++it;
+		}
+		else
+			it = m_cache.erase(it);
+	}
+#endif
+
+	m_string_count = 0;
+
+	assert(invariant());
+}
+
+void SpriteFontBatch :: resetStatistics ()
+{
+	m_layout_count = 0;
+
+	assert(invariant());
+}
+
+void SpriteFontBatch :: clearCache ()
+{
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	m_cache.clear();
+#endif
+
+	assert(invariant());
+}
+
+
+
+bool SpriteFontBatch :: invariant () const
+{
+	if(mp_font == NULL) return false;
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	if(mv_vertexes.size() % 4 != 0) return false;
+#endif
+	return true;
+}
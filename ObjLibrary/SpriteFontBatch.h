@@ -0,0 +1,283 @@
+//
+//  SpriteFontBatch.h
+//
+//  A module to collect many strings of text and draw them
+//    together with a SpriteFont.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SPRITE_FONT_BATCH_H
+#define OBJ_LIBRARY_SPRITE_FONT_BATCH_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjSettings.h"
+#include "SpriteFont.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  SpriteFontBatch
+//
+//  A class to collect strings to draw with a SpriteFont and
+//    then draw all of them at once.  Drawing each string with
+//    SpriteFont::draw binds a texture and makes a glBegin/glEnd
+//    pair for every character, but a SpriteFontBatch draws all
+//    of its strings with one glDrawArrays call.
+//
+//  The character quads for each string are cached, keyed by
+//    the string, colour, and format.  A string that is drawn
+//    the same way every frame is only laid out once and then
+//    copied to the new position.  Cached strings that are not
+//    added again before the next draw are removed, so strings
+//    with changing values do not fill the cache.
+//
+//  Underlines and strikethroughs are not supported (have no
+//    effect).
+//
+//  If OBJ_LIBRARY_SHADER_DISPLAY is #defined, SpriteFont
+//    already draws each string with a single call, so the
+//    strings are just drawn in order with SpriteFont::draw and
+//    nothing is cached.
+//
+//  The SpriteFont is not copied, so it must not be destroyed
+//    while the SpriteFontBatch is in use.
+//
+//  Class Invariant:
+//    <1> mp_font != NULL
+//    <2> mv_vertexes.size() % 4 == 0
+//
+class SpriteFontBatch
+{
+public:
+//
+//  Constructor
+//
+//  Purpose: To create a SpriteFontBatch for the specified
+//           SpriteFont.
+//  Parameter(s):
+//    <1> font: The SpriteFont to draw with
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new SpriteFontBatch is created that draws
+//               with font.  It contains no strings.  font does
+//               not have to be initialized yet.
+//
+	SpriteFontBatch (const SpriteFont& font);
+
+	SpriteFontBatch (const SpriteFontBatch& original) = default;
+	~SpriteFontBatch () = default;
+	SpriteFontBatch& operator= (const SpriteFontBatch& original) = default;
+
+//
+//  getFont
+//
+//  Purpose: To determine which SpriteFont this SpriteFontBatch
+//           draws with.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The SpriteFont.
+//  Side Effect: N/A
+//
+	const SpriteFont& getFont () const
+	{	return *mp_font;	}
+
+//
+//  getStringCount
+//
+//  Purpose: To determine how many strings are waiting to be
+//           drawn.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of strings added since draw was last
+//           called.
+//  Side Effect: N/A
+//
+	unsigned int getStringCount () const
+	{	return m_string_count;	}
+
+//
+//  getCachedStringCount
+//
+//  Purpose: To determine how many string layouts are cached.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of strings with cached character quads.
+//  Side Effect: N/A
+//
+	unsigned int getCachedStringCount () const;
+
+//
+//  getLayoutCount
+//
+//  Purpose: To determine how many strings have been laid out,
+//           rather than copied from the cache, since the
+//           statistics were reset.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of strings laid out.
+//  Side Effect: N/A
+//
+	unsigned int getLayoutCount () const
+	{	return m_layout_count;	}
+
+//
+//  add
+//
+//  Purpose: To add a string to be drawn.
+//  Parameter(s):
+//    <1> str: The string to draw
+//    <2> x
+//    <3> y: The top left corner of the string
+//    <4> red
+//    <5> green
+//    <6> blue: The colour to draw the string with
+//    <7> alpha: The transparency to draw the string with
+//    <8> format: The text format
+//  Precondition(s):
+//    <1> getFont().isInitialized()
+//    <2> SpriteFont::isValidFormat(format)
+//  Returns: N/A
+//  Side Effect: String str is added to be drawn in colour
+//               (red, green, blue, alpha) and with formatting
+//               format at position (x, y), the same as
+//               SpriteFont::draw would draw it.  If no colour
+//               is specified, white is used.  If no format is
+//               specified, PLAIN is used.
+//
+	void add (const std::string& str,
+	          double x,
+	          double y);
+	void add (const std::string& str,
+	          double x,
+	          double y,
+	          unsigned char red,
+	          unsigned char green,
+	          unsigned char blue);
+	void add (const std::string& str,
+	          double x,
+	          double y,
+	          unsigned char red,
+	          unsigned char green,
+	          unsigned char blue,
+	          unsigned char alpha,
+	          unsigned int format);
+
+//
+//  draw
+//
+//  Purpose: To draw all the strings in this SpriteFontBatch.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> getStringCount() == 0 || getFont().isInitialized()
+//    <2> getStringCount() == 0 || SpriteFont::is2dViewSetUp()
+//  Returns: N/A
+//  Side Effect: The strings are drawn in the order they were
+//               added and then removed from this
+//               SpriteFontBatch.  Cached layouts for strings
+//               that were not added since the last draw are
+//               discarded.
+//
+	void draw ();
+
+//
+//  resetStatistics
+//
+//  Purpose: To reset the layout count.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The layout count is set to 0.
+//
+	void resetStatistics ();
+
+//
+//  clearCache
+//
+//  Purpose: To discard all cached string layouts.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The cache is emptied.  This should be called if
+//               the tab width of the SpriteFont is changed.
+//
+	void clearCache ();
+
+private:
+//
+//  Helper Function: invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	//
+	//  PendingString
+	//
+	//  A record to represent a string waiting to be drawn.
+	//
+	struct PendingString
+	{
+		std::string m_string;
+		double m_x;
+		double m_y;
+		unsigned char ma_colour[4];
+		unsigned int m_format;
+	};
+#else
+	//
+	//  CachedLayout
+	//
+	//  A record to represent the character quads for a string
+	//    drawn at position (0, 0).
+	//
+	struct CachedLayout
+	{
+		std::vector<SpriteFont::GlyphVertex> mv_vertexes;
+		bool m_is_used;
+	};
+#endif
+
+	const SpriteFont* mp_font;
+	unsigned int m_string_count;
+	unsigned int m_layout_count;
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	std::vector<PendingString> mv_pending;
+#else
+	std::vector<SpriteFont::GlyphVertex> mv_vertexes;
+	std::unordered_map<std::string, CachedLayout> m_cache;
+	std::string m_key;  // kept to avoid allocating for every string
+#endif
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -26,6 +26,7 @@
 	#include "../GetGlut.h"
 #endif
 
+#include "GlCallCounter.h"
 #include "Texture.h"
 
 #include <iostream>
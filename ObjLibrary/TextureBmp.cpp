@@ -40,6 +40,7 @@
 #endif
 
 #include "ObjStringParsing.h"
+#include "GlCallCounter.h"
 #include "TextureBmp.h"
 
 using namespace std;
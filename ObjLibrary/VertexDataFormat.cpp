@@ -0,0 +1,105 @@
+//
+//  VertexDataFormat.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+
+#include "VertexDataFormat.h"
+
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int POSITION_COMPONENTS           = 3;
+	const unsigned int TEXTURE_COORDINATE_COMPONENTS = 2;
+	const unsigned int NORMAL_COMPONENTS             = 3;
+}
+
+
+
+unsigned int VertexDataFormat :: getFormat (bool is_texture_coordinates,
+                                            bool is_normals)
+{
+	if(is_texture_coordinates)
+	{
+		if(is_normals)
+			return POSITION_TEXTURE_COORDINATE_NORMAL;
+		else
+			return POSITION_TEXTURE_COORDINATE;
+	}
+	else
+	{
+		if(is_normals)
+			return POSITION_NORMAL;
+		else
+			return POSITION_ONLY;
+	}
+}
+
+bool VertexDataFormat :: isTextureCoordinates (unsigned int format)
+{
+	assert(format < COUNT);
+
+	return format == POSITION_TEXTURE_COORDINATE ||
+	       format == POSITION_TEXTURE_COORDINATE_NORMAL;
+}
+
+bool VertexDataFormat :: isNormals (unsigned int format)
+{
+	assert(format < COUNT);
+
+	return format == POSITION_NORMAL ||
+	       format == POSITION_TEXTURE_COORDINATE_NORMAL;
+}
+
+unsigned int VertexDataFormat :: getComponentCount (unsigned int format)
+{
+	assert(format < COUNT);
+
+	unsigned int count = POSITION_COMPONENTS;
+	if(isTextureCoordinates(format))
+		count += TEXTURE_COORDINATE_COMPONENTS;
+	if(isNormals(format))
+		count += NORMAL_COMPONENTS;
+	return count;
+}
+
+unsigned int VertexDataFormat :: getStride (unsigned int format)
+{
+	assert(format < COUNT);
+
+	return getComponentCount(format) * sizeof(float);
+}
+
+unsigned int VertexDataFormat :: getTextureCoordinateOffset (unsigned int format)
+{
+	assert(format < COUNT);
+	assert(isTextureCoordinates(format));
+
+	return POSITION_COMPONENTS * sizeof(float);
+}
+
+unsigned int VertexDataFormat :: getNormalOffset (unsigned int format)
+{
+	assert(format < COUNT);
+	assert(isNormals(format));
+
+	if(isTextureCoordinates(format))
+		return (POSITION_COMPONENTS + TEXTURE_COORDINATE_COMPONENTS) * sizeof(float);
+	else
+		return POSITION_COMPONENTS * sizeof(float);
+}
@@ -0,0 +1,229 @@
+//
+//  VertexDataFormat.h
+//
+//  A module to represent the formats that per-vertex data can be
+//    stored in when it is arranged for a vertex buffer.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_VERTEX_DATA_FORMAT_H
+#define OBJ_LIBRARY_VERTEX_DATA_FORMAT_H
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  VertexDataFormat
+//
+//  A namespace to contain the possible arrangements of
+//    interleaved per-vertex data.  Every format has a position,
+//    and may also have texture coordinates and/or a normal.
+//    The values for a vertex are always stored as floats in the
+//    order position, texture coordinates, normal, with any
+//    unused parts omitted.
+//
+//  There is also a struct for each format that matches its
+//    memory layout.  These can be used to fill in a buffer of
+//    vertex data.
+//
+namespace VertexDataFormat
+{
+//
+//  POSITION_ONLY
+//
+//  Each vertex has a position (x, y, z).
+//
+	const unsigned int POSITION_ONLY = 0;
+
+//
+//  POSITION_TEXTURE_COORDINATE
+//
+//  Each vertex has a position (x, y, z) and texture coordinates
+//    (s, t).
+//
+	const unsigned int POSITION_TEXTURE_COORDINATE = 1;
+
+//
+//  POSITION_NORMAL
+//
+//  Each vertex has a position (x, y, z) and a normal (x, y, z).
+//
+	const unsigned int POSITION_NORMAL = 2;
+
+//
+//  POSITION_TEXTURE_COORDINATE_NORMAL
+//
+//  Each vertex has a position (x, y, z), texture coordinates
+//    (s, t), and a normal (x, y, z).
+//
+	const unsigned int POSITION_TEXTURE_COORDINATE_NORMAL = 3;
+
+//
+//  COUNT
+//
+//  The number of vertex data formats.
+//
+	const unsigned int COUNT = 4;
+
+
+
+//
+//  PositionOnly
+//  PositionTextureCoordinate
+//  PositionNormal
+//  PositionTextureCoordinateNormal
+//
+//  Records with the same memory layout as one vertex in the
+//    corresponding format.
+//
+	struct PositionOnly
+	{
+		float m_x, m_y, m_z;
+	};
+	struct PositionTextureCoordinate
+	{
+		float m_x, m_y, m_z;
+		float m_s, m_t;
+	};
+	struct PositionNormal
+	{
+		float m_x, m_y, m_z;
+		float m_nx, m_ny, m_nz;
+	};
+	struct PositionTextureCoordinateNormal
+	{
+		float m_x, m_y, m_z;
+		float m_s, m_t;
+		float m_nx, m_ny, m_nz;
+	};
+
+
+
+//
+//  getFormat
+//
+//  Purpose: To determine the vertex data format that contains
+//           the specified data.
+//  Parameter(s):
+//    <1> is_texture_coordinates: Whether the format should
+//                                include texture coordinates
+//    <2> is_normals: Whether the format should include normals
+//  Precondition(s): N/A
+//  Returns: The vertex data format that includes a position,
+//           texture coordinates iff is_texture_coordinates is
+//           true, and a normal iff is_normals is true.
+//  Side Effect: N/A
+//
+	unsigned int getFormat (bool is_texture_coordinates,
+	                        bool is_normals);
+
+//
+//  isTextureCoordinates
+//
+//  Purpose: To determine if the specified vertex data format
+//           includes texture coordinates.
+//  Parameter(s):
+//    <1> format: The vertex data format
+//  Precondition(s):
+//    <1> format < COUNT
+//  Returns: Whether format format includes texture coordinates.
+//  Side Effect: N/A
+//
+	bool isTextureCoordinates (unsigned int format);
+
+//
+//  isNormals
+//
+//  Purpose: To determine if the specified vertex data format
+//           includes normals.
+//  Parameter(s):
+//    <1> format: The vertex data format
+//  Precondition(s):
+//    <1> format < COUNT
+//  Returns: Whether format format includes normals.
+//  Side Effect: N/A
+//
+	bool isNormals (unsigned int format);
+
+//
+//  getComponentCount
+//
+//  Purpose: To determine the number of floats used to store
+//           each vertex in the specified vertex data format.
+//  Parameter(s):
+//    <1> format: The vertex data format
+//  Precondition(s):
+//    <1> format < COUNT
+//  Returns: The number of floats per vertex.
+//  Side Effect: N/A
+//
+	unsigned int getComponentCount (unsigned int format);
+
+//
+//  getStride
+//
+//  Purpose: To determine the number of bytes used to store each
+//           vertex in the specified vertex data format.
+//  Parameter(s):
+//    <1> format: The vertex data format
+//  Precondition(s):
+//    <1> format < COUNT
+//  Returns: The number of bytes per vertex.
+//  Side Effect: N/A
+//
+	unsigned int getStride (unsigned int format);
+
+//
+//  getTextureCoordinateOffset
+//
+//  Purpose: To determine where the texture coordinates are
+//           stored within a vertex in the specified vertex data
+//           format.
+//  Parameter(s):
+//    <1> format: The vertex data format
+//  Precondition(s):
+//    <1> format < COUNT
+//    <2> isTextureCoordinates(format)
+//  Returns: The offset in bytes from the start of a vertex to
+//           its texture coordinates.
+//  Side Effect: N/A
+//
+	unsigned int getTextureCoordinateOffset (unsigned int format);
+
+//
+//  getNormalOffset
+//
+//  Purpose: To determine where the normal is stored within a
+//           vertex in the specified vertex data format.
+//  Parameter(s):
+//    <1> format: The vertex data format
+//  Precondition(s):
+//    <1> format < COUNT
+//    <2> isNormals(format)
+//  Returns: The offset in bytes from the start of a vertex to
+//           its normal.
+//  Side Effect: N/A
+//
+	unsigned int getNormalOffset (unsigned int format);
+
+}  // end of namespace VertexDataFormat
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,496 @@
+//
+//  WeldedMesh.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstddef>	// for size_t
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjStringParsing.h"
+#include "VertexDataFormat.h"
+#include "GeometryArray.h"
+#include "MeshOptimizer.h"
+#include "ObjModel.h"
+#include "WeldedMesh.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int SHORT_INDEX_VERTEX_MAX = 0xFFFF + 1;
+
+	const float FALLBACK_TEXTURE_COORDINATE[2] = { 0.0f, 0.0f };
+	const float FALLBACK_NORMAL[3]             = { 0.0f, 0.0f, 1.0f };
+
+	//
+	//  WeldKey
+	//
+	//  A record to represent one (position, texture coordinate,
+	//    normal) combination used by a face vertex.
+	//
+	struct WeldKey
+	{
+		unsigned int m_vertex;
+		unsigned int m_texture_coordinate;
+		unsigned int m_normal;
+
+		bool operator== (const WeldKey& other) const
+		{
+			return m_vertex             == other.m_vertex &&
+			       m_texture_coordinate == other.m_texture_coordinate &&
+			       m_normal             == other.m_normal;
+		}
+	};
+
+	//
+	//  WeldKeyHash
+	//
+	//  A function object to hash a WeldKey.  The indexes are
+	//    mixed with large odd multipliers so that nearby
+	//    combinations land in different buckets.
+	//
+	struct WeldKeyHash
+	{
+		size_t operator() (const WeldKey& key) const
+		{
+			size_t hash = key.m_vertex;
+			hash = hash * 0x9E3779B1u + key.m_texture_coordinate;
+			hash = hash * 0x85EBCA77u + key.m_normal;
+			return hash ^ (hash >> 16);
+		}
+	};
+
+	typedef unordered_map<WeldKey, unsigned int, WeldKeyHash> WeldTable;
+}
+
+
+
+WeldedMesh :: WeldedMesh ()
+		: m_format(VertexDataFormat::POSITION_ONLY),
+		  mv_vertex_data(),
+		  mv_indexes(),
+		  mv_ranges()
+{
+	assert(isEmpty());
+	assert(invariant());
+}
+
+WeldedMesh :: WeldedMesh (const ObjModel& model)
+		: m_format(VertexDataFormat::POSITION_ONLY),
+		  mv_vertex_data(),
+		  mv_indexes(),
+		  mv_ranges()
+{
+	assert(model.isValid());
+
+	init(model);
+
+	assert(invariant());
+}
+
+WeldedMesh :: WeldedMesh (const ObjModel& model, unsigned int mesh)
+		: m_format(VertexDataFormat::POSITION_ONLY),
+		  mv_vertex_data(),
+		  mv_indexes(),
+		  mv_ranges()
+{
+	assert(model.isValid());
+	assert(mesh < model.getMeshCount());
+
+	init(model, mesh);
+
+	assert(invariant());
+}
+
+
+
+bool WeldedMesh :: isEmpty () const
+{
+	return mv_indexes.empty();
+}
+
+unsigned int WeldedMesh :: getFormat () const
+{
+	return m_format;
+}
+
+unsigned int WeldedMesh :: getComponentCount () const
+{
+	return VertexDataFormat::getComponentCount(m_format);
+}
+
+unsigned int WeldedMesh :: getVertexCount () const
+{
+	return mv_vertex_data.size() / getComponentCount();
+}
+
+Vector3 WeldedMesh :: getVertexPosition (unsigned int vertex) const
+{
+	assert(vertex < getVertexCount());
+
+	unsigned int start = vertex * getComponentCount();
+	assert(start + 2 < mv_vertex_data.size());
+	return Vector3(mv_vertex_data[start + 0],
+	               mv_vertex_data[start + 1],
+	               mv_vertex_data[start + 2]);
+}
+
+const float* WeldedMesh :: getVertexData () const
+{
+	assert(!isEmpty());
+
+	return &(mv_vertex_data[0]);
+}
+
+unsigned int WeldedMesh :: getIndexCount () const
+{
+	return mv_indexes.size();
+}
+
+unsigned int WeldedMesh :: getTriangleCount () const
+{
+	return mv_indexes.size() / 3;
+}
+
+unsigned int WeldedMesh :: getIndex (unsigned int index) const
+{
+	assert(index < getIndexCount());
+
+	return mv_indexes[index];
+}
+
+const unsigned int* WeldedMesh :: getIndexData () const
+{
+	assert(!isEmpty());
+
+	return &(mv_indexes[0]);
+}
+
+bool WeldedMesh :: isShortIndexesPossible () const
+{
+	return getVertexCount() <= SHORT_INDEX_VERTEX_MAX;
+}
+
+vector<unsigned short> WeldedMesh :: getShortIndexes () const
+{
+	assert(isShortIndexesPossible());
+
+	vector<unsigned short> v_short_indexes(mv_indexes.size());
+	for(unsigned int i = 0; i < mv_indexes.size(); i++)
+	{
+		assert(mv_indexes[i] < SHORT_INDEX_VERTEX_MAX);
+		v_short_indexes[i] = (unsigned short)(mv_indexes[i]);
+	}
+	return v_short_indexes;
+}
+
+unsigned int WeldedMesh :: getRangeCount () const
+{
+	return mv_ranges.size();
+}
+
+unsigned int WeldedMesh :: getRangeMesh (unsigned int range) const
+{
+	assert(range < getRangeCount());
+
+	return mv_ranges[range].m_mesh;
+}
+
+unsigned int WeldedMesh :: getRangeFirstIndex (unsigned int range) const
+{
+	assert(range < getRangeCount());
+
+	return mv_ranges[range].m_first_index;
+}
+
+unsigned int WeldedMesh :: getRangeIndexCount (unsigned int range) const
+{
+	assert(range < getRangeCount());
+
+	return mv_ranges[range].m_index_count;
+}
+
+double WeldedMesh :: getReuseRatio () const
+{
+	if(getVertexCount() == 0)
+		return 0.0;
+	return (double)(getIndexCount()) / (double)(getVertexCount());
+}
+
+double WeldedMesh :: calculateAcmr (unsigned int cache_size) const
+{
+	assert(cache_size > 0);
+
+	return MeshOptimizer::calculateAcmr(mv_indexes, cache_size);
+}
+
+void WeldedMesh :: print () const
+{
+	print(cout);
+}
+
+void WeldedMesh :: print (const string& logfile) const
+{
+	assert(ObjStringParsing::isValidFilenameWithPath(logfile));
+
+	ofstream logstream(logfile.c_str());
+	print(logstream);
+	logstream.close();
+}
+
+void WeldedMesh :: print (ostream& r_logstream) const
+{
+	r_logstream << "WeldedMesh" << endl;
+	r_logstream << "    " << getVertexCount() << " vertexes ("
+	            << getComponentCount() << " floats each)" << endl;
+	r_logstream << "    " << getIndexCount() << " indexes ("
+	            << getTriangleCount() << " triangles, "
+	            << (isShortIndexesPossible() ? 16 : 32) << "-bit)" << endl;
+	r_logstream << "    " << getRangeCount() << " ranges" << endl;
+	r_logstream << "    " << getReuseRatio() << " indexes per vertex" << endl;
+	r_logstream << "    " << calculateAcmr(MeshOptimizer::DEFAULT_CACHE_SIZE) << " ACMR" << endl;
+}
+
+
+
+void WeldedMesh :: makeEmpty ()
+{
+	m_format = VertexDataFormat::POSITION_ONLY;
+	mv_vertex_data.clear();
+	mv_indexes.clear();
+	mv_ranges.clear();
+
+	assert(isEmpty());
+	assert(invariant());
+}
+
+void WeldedMesh :: init (const ObjModel& model)
+{
+	assert(model.isValid());
+
+	weldMeshes(model, 0, model.getMeshCount());
+
+	assert(getRangeCount() == model.getMeshCount());
+	assert(invariant());
+}
+
+void WeldedMesh :: init (const ObjModel& model, unsigned int mesh)
+{
+	assert(model.isValid());
+	assert(mesh < model.getMeshCount());
+
+	weldMeshes(model, mesh, 1);
+
+	assert(getRangeCount() == 1);
+	assert(invariant());
+}
+
+void WeldedMesh :: optimize ()
+{
+	unsigned int vertex_count    = getVertexCount();
+	unsigned int component_count = getComponentCount();
+
+	for(unsigned int r = 0; r < mv_ranges.size(); r++)
+	{
+		MeshOptimizer::optimizeVertexCache(mv_indexes,
+		                                   mv_ranges[r].m_first_index,
+		                                   mv_ranges[r].m_index_count,
+		                                   vertex_count);
+	}
+
+	vector<unsigned int> v_remap = MeshOptimizer::calculateVertexFetchRemap(mv_indexes, vertex_count);
+	assert(v_remap.size() == vertex_count);
+
+	vector<float> v_new_vertex_data(mv_vertex_data.size());
+	for(unsigned int v = 0; v < vertex_count; v++)
+	{
+		assert(v_remap[v] < vertex_count);
+		unsigned int old_start = v          * component_count;
+		unsigned int new_start = v_remap[v] * component_count;
+		for(unsigned int c = 0; c < component_count; c++)
+			v_new_vertex_data[new_start + c] = mv_vertex_data[old_start + c];
+	}
+	mv_vertex_data.swap(v_new_vertex_data);
+
+	for(unsigned int i = 0; i < mv_indexes.size(); i++)
+		mv_indexes[i] = v_remap[mv_indexes[i]];
+
+	assert(getVertexCount() == vertex_count);
+	assert(invariant());
+}
+
+
+
+void WeldedMesh :: weldMeshes (const ObjModel& model,
+                               unsigned int first_mesh,
+                               unsigned int mesh_count)
+{
+	assert(model.isValid());
+	assert(first_mesh + mesh_count <= model.getMeshCount());
+
+	makeEmpty();
+
+	//
+	//  Decide on the vertex format.  We include texture
+	//    coordinates and normals if any face vertex uses them,
+	//    and count the triangles so we can reserve space.
+	//
+
+	bool is_texture_coordinates = false;
+	bool is_normals             = false;
+	unsigned int triangle_count = 0;
+	for(unsigned int m = first_mesh; m < first_mesh + mesh_count; m++)
+		for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+		{
+			unsigned int face_vertex_count = model.getFaceVertexCount(m, f);
+			assert(face_vertex_count >= 3);
+			triangle_count += face_vertex_count - 2;
+
+			for(unsigned int v = 0; v < face_vertex_count; v++)
+			{
+				if(model.getFaceVertexTextureCoordinates(m, f, v) != ObjModel::NO_TEXTURE_COORDINATES)
+					is_texture_coordinates = true;
+				if(model.getFaceVertexNormal(m, f, v) != ObjModel::NO_NORMAL)
+					is_normals = true;
+			}
+		}
+
+	m_format = VertexDataFormat::getFormat(is_texture_coordinates, is_normals);
+	mv_indexes.reserve(triangle_count * 3);
+	mv_ranges.reserve(mesh_count);
+
+	//
+	//  Weld the face vertexes.  Each face is split into a
+	//    triangle fan around its first vertex, which is the
+	//    same way ObjModel draws it.
+	//
+
+	WeldTable weld_table;
+	weld_table.reserve(triangle_count * 3);
+
+	for(unsigned int m = first_mesh; m < first_mesh + mesh_count; m++)
+	{
+		Range range;
+		range.m_mesh        = m;
+		range.m_first_index = mv_indexes.size();
+
+		for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+		{
+			unsigned int face_vertex_count = model.getFaceVertexCount(m, f);
+			unsigned int a_welded[3];
+
+			for(unsigned int v = 0; v < face_vertex_count; v++)
+			{
+				WeldKey key;
+				key.m_vertex             = model.getFaceVertexIndex(m, f, v);
+				key.m_texture_coordinate = is_texture_coordinates ? model.getFaceVertexTextureCoordinates(m, f, v)
+				                                                  : ObjModel::NO_TEXTURE_COORDINATES;
+				key.m_normal             = is_normals ? model.getFaceVertexNormal(m, f, v)
+				                                      : ObjModel::NO_NORMAL;
+
+				unsigned int next_vertex = getVertexCount();
+				pair<WeldTable::iterator, bool> result = weld_table.insert(make_pair(key, next_vertex));
+				if(result.second)
+				{
+					addVertex(model, key.m_vertex, key.m_texture_coordinate, key.m_normal);
+					assert(getVertexCount() == next_vertex + 1);
+				}
+				unsigned int welded = result.first->second;
+
+				// convert to a triangle fan
+				if(v == 0)
+					a_welded[0] = welded;
+				else if(v == 1)
+					a_welded[2] = welded;
+				else
+				{
+					a_welded[1] = a_welded[2];
+					a_welded[2] = welded;
+					mv_indexes.push_back(a_welded[0]);
+					mv_indexes.push_back(a_welded[1]);
+					mv_indexes.push_back(a_welded[2]);
+				}
+			}
+		}
+
+		range.m_index_count = mv_indexes.size() - range.m_first_index;
+		mv_ranges.push_back(range);
+	}
+
+	assert(getIndexCount() == triangle_count * 3);
+	assert(invariant());
+}
+
+void WeldedMesh :: addVertex (const ObjModel& model,
+                              unsigned int vertex,
+                              unsigned int texture_coordinate,
+                              unsigned int normal)
+{
+	assert(vertex < model.getVertexCount());
+
+	const GeometryScalar* a_position = model.getVertexPositionArray(vertex);
+	mv_vertex_data.push_back((float)(a_position[0]));
+	mv_vertex_data.push_back((float)(a_position[1]));
+	mv_vertex_data.push_back((float)(a_position[2]));
+
+	if(VertexDataFormat::isTextureCoordinates(m_format))
+	{
+		if(texture_coordinate < model.getTextureCoordinateCount())
+		{
+			const GeometryScalar* a_texture_coordinate = model.getTextureCoordinateArray(texture_coordinate);
+
+			// flip texture coordinates to match Maya <|>
+			mv_vertex_data.push_back(       (float)(a_texture_coordinate[0]));
+			mv_vertex_data.push_back(1.0f - (float)(a_texture_coordinate[1]));
+		}
+		else
+		{
+			mv_vertex_data.push_back(FALLBACK_TEXTURE_COORDINATE[0]);
+			mv_vertex_data.push_back(FALLBACK_TEXTURE_COORDINATE[1]);
+		}
+	}
+
+	if(VertexDataFormat::isNormals(m_format))
+	{
+		if(normal < model.getNormalCount())
+		{
+			const GeometryScalar* a_normal = model.getNormalArray(normal);
+			mv_vertex_data.push_back((float)(a_normal[0]));
+			mv_vertex_data.push_back((float)(a_normal[1]));
+			mv_vertex_data.push_back((float)(a_normal[2]));
+		}
+		else
+		{
+			mv_vertex_data.push_back(FALLBACK_NORMAL[0]);
+			mv_vertex_data.push_back(FALLBACK_NORMAL[1]);
+			mv_vertex_data.push_back(FALLBACK_NORMAL[2]);
+		}
+	}
+}
+
+bool WeldedMesh :: invariant () const
+{
+	if(m_format >= VertexDataFormat::COUNT) return false;
+	if(mv_vertex_data.size() % VertexDataFormat::getComponentCount(m_format) != 0) return false;
+	if(mv_indexes.size() % 3 != 0) return false;
+	return true;
+}
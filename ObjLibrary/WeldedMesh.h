@@ -0,0 +1,516 @@
+//
+//  WeldedMesh.h
+//
+//  A module to store the faces of an ObjModel as a single
+//    indexed triangle list.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_WELDED_MESH_H
+#define OBJ_LIBRARY_WELDED_MESH_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector2.h"
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+
+
+
+//
+//  WeldedMesh
+//
+//  A class to store the faces of an ObjModel as an array of
+//    interleaved vertex data and an array of indexes into it.
+//
+//  In an OBJ file, each face vertex refers to a position, a
+//    texture coordinate pair, and a normal separately.  Vertex
+//    buffers, in contrast, only have a single index per vertex.
+//    A WeldedMesh is created by finding every distinct
+//    (position, texture coordinate, normal) combination used by
+//    the faces and storing each one once.  Each face is split
+//    into triangles as a triangle fan, and the resulting
+//    triangles are stored as indexes into the welded vertexes.
+//
+//  The vertex data is stored as floats in one of the formats
+//    in VertexDataFormat.  Texture coordinates and normals are
+//    included if any face in the model uses them; any face
+//    vertex without them gets a placeholder value.  The v
+//    texture coordinate is flipped (v' = 1 - v) to match the
+//    way ObjModel draws.
+//
+//  The triangles for each mesh in the ObjModel are stored
+//    contiguously as a range of indexes.  Point sets and
+//    polylines are not included.
+//
+//  A WeldedMesh does not depend on OpenGL, so it can be created
+//    before the graphics system is initialized and used with
+//    any kind of drawing.
+//
+class WeldedMesh
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new empty WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new WeldedMesh is created with no vertexes
+//               and no triangles.
+//
+	WeldedMesh ();
+
+//
+//  Model Constructor
+//
+//  Purpose: To create a new WeldedMesh containing the faces of
+//           the specified ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//  Precondition(s):
+//    <1> model.isValid()
+//  Returns: N/A
+//  Side Effect: A new WeldedMesh is created containing the
+//               faces of all the meshes in model.  There is one
+//               range for each mesh in model, in order.
+//
+	WeldedMesh (const ObjModel& model);
+
+//
+//  Mesh Constructor
+//
+//  Purpose: To create a new WeldedMesh containing the faces of
+//           one mesh in the specified ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//    <2> mesh: Which mesh in model
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> mesh < model.getMeshCount()
+//  Returns: N/A
+//  Side Effect: A new WeldedMesh is created containing the
+//               faces of mesh mesh of model.  There is one
+//               range.
+//
+	WeldedMesh (const ObjModel& model, unsigned int mesh);
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this WeldedMesh contains no
+//           triangles.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this WeldedMesh is empty.
+//  Side Effect: N/A
+//
+	bool isEmpty () const;
+
+//
+//  getFormat
+//
+//  Purpose: To determine the format of the vertex data in this
+//           WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The vertex data format, as one of the constants in
+//           VertexDataFormat.
+//  Side Effect: N/A
+//
+	unsigned int getFormat () const;
+
+//
+//  getComponentCount
+//
+//  Purpose: To determine the number of floats stored for each
+//           vertex in this WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of floats per vertex.
+//  Side Effect: N/A
+//
+	unsigned int getComponentCount () const;
+
+//
+//  getVertexCount
+//
+//  Purpose: To determine the number of distinct vertexes in
+//           this WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of vertexes.
+//  Side Effect: N/A
+//
+	unsigned int getVertexCount () const;
+
+//
+//  getVertexPosition
+//
+//  Purpose: To determine the position of the specified vertex.
+//  Parameter(s):
+//    <1> vertex: Which vertex
+//  Precondition(s):
+//    <1> vertex < getVertexCount()
+//  Returns: The position of vertex vertex.
+//  Side Effect: N/A
+//
+	Vector3 getVertexPosition (unsigned int vertex) const;
+
+//
+//  getVertexData
+//
+//  Purpose: To retrieve the interleaved vertex data for this
+//           WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isEmpty()
+//  Returns: A pointer to an array of getVertexCount() *
+//           getComponentCount() floats.  The pointer is
+//           invalidated if this WeldedMesh is changed.
+//  Side Effect: N/A
+//
+	const float* getVertexData () const;
+
+//
+//  getIndexCount
+//
+//  Purpose: To determine the number of indexes in this
+//           WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of indexes.  This is always 3 times the
+//           number of triangles.
+//  Side Effect: N/A
+//
+	unsigned int getIndexCount () const;
+
+//
+//  getTriangleCount
+//
+//  Purpose: To determine the number of triangles in this
+//           WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of triangles.
+//  Side Effect: N/A
+//
+	unsigned int getTriangleCount () const;
+
+//
+//  getIndex
+//
+//  Purpose: To retrieve the specified index.
+//  Parameter(s):
+//    <1> index: Which index
+//  Precondition(s):
+//    <1> index < getIndexCount()
+//  Returns: The vertex used by index index.
+//  Side Effect: N/A
+//
+	unsigned int getIndex (unsigned int index) const;
+
+//
+//  getIndexData
+//
+//  Purpose: To retrieve the indexes for this WeldedMesh as
+//           32-bit values.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isEmpty()
+//  Returns: A pointer to an array of getIndexCount() unsigned
+//           ints.  The pointer is invalidated if this
+//           WeldedMesh is changed.
+//  Side Effect: N/A
+//
+	const unsigned int* getIndexData () const;
+
+//
+//  isShortIndexesPossible
+//
+//  Purpose: To determine if the indexes for this WeldedMesh
+//           can be stored as 16-bit values.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether every vertex index fits in an unsigned
+//           short.
+//  Side Effect: N/A
+//
+	bool isShortIndexesPossible () const;
+
+//
+//  getShortIndexes
+//
+//  Purpose: To retrieve the indexes for this WeldedMesh as
+//           16-bit values.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isShortIndexesPossible()
+//  Returns: A vector of getIndexCount() unsigned shorts with
+//           the same values as the indexes.
+//  Side Effect: N/A
+//
+	std::vector<unsigned short> getShortIndexes () const;
+
+//
+//  getRangeCount
+//
+//  Purpose: To determine the number of index ranges in this
+//           WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of ranges.
+//  Side Effect: N/A
+//
+	unsigned int getRangeCount () const;
+
+//
+//  getRangeMesh
+//
+//  Purpose: To determine which mesh of the original ObjModel
+//           the specified range was created from.
+//  Parameter(s):
+//    <1> range: Which range
+//  Precondition(s):
+//    <1> range < getRangeCount()
+//  Returns: The mesh index in the original ObjModel.
+//  Side Effect: N/A
+//
+	unsigned int getRangeMesh (unsigned int range) const;
+
+//
+//  getRangeFirstIndex
+//  getRangeIndexCount
+//
+//  Purpose: To determine the indexes that make up the
+//           specified range.
+//  Parameter(s):
+//    <1> range: Which range
+//  Precondition(s):
+//    <1> range < getRangeCount()
+//  Returns: The first index in range range / the number of
+//           indexes in range range.
+//  Side Effect: N/A
+//
+	unsigned int getRangeFirstIndex (unsigned int range) const;
+	unsigned int getRangeIndexCount (unsigned int range) const;
+
+//
+//  getReuseRatio
+//
+//  Purpose: To determine how much welding reduced the number
+//           of vertexes in this WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The average number of indexes that refer to each
+//           vertex.  Unindexed triangles would have a ratio of
+//           1.0.  If this WeldedMesh is empty, 0.0 is
+//           returned.
+//  Side Effect: N/A
+//
+	double getReuseRatio () const;
+
+//
+//  calculateAcmr
+//
+//  Purpose: To calculate the average cache miss ratio for
+//           drawing this WeldedMesh.
+//  Parameter(s):
+//    <1> cache_size: The number of vertexes in the simulated
+//                    vertex cache
+//  Precondition(s):
+//    <1> cache_size > 0
+//  Returns: The average number of vertexes transformed per
+//           triangle.  See MeshOptimizer for details.
+//  Side Effect: N/A
+//
+	double calculateAcmr (unsigned int cache_size) const;
+
+//
+//  print
+//
+//  Purpose: To print the statistics for this WeldedMesh.
+//  Parameter(s):
+//    <1> logfile: The file to print to
+//    <1> r_logstream: The stream to print to
+//  Precondition(s):
+//    <1> logfile != ""
+//  Returns: N/A
+//  Side Effect: The vertex count, index count, range count,
+//               reuse ratio, and ACMR of this WeldedMesh are
+//               printed
+//               to the standard output / logfile logfile /
+//               r_logstream.
+//
+	void print () const;
+	void print (const std::string& logfile) const;
+	void print (std::ostream& r_logstream) const;
+
+//
+//  makeEmpty
+//
+//  Purpose: To remove all vertexes and triangles from this
+//           WeldedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This WeldedMesh is set to contain no vertexes,
+//               indexes, or ranges.
+//
+	void makeEmpty ();
+
+//
+//  init
+//
+//  Purpose: To set this WeldedMesh to contain the faces of the
+//           specified ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//  Precondition(s):
+//    <1> model.isValid()
+//  Returns: N/A
+//  Side Effect: This WeldedMesh is set to contain the faces of
+//               all the meshes in model.  There is one range
+//               for each mesh in model, in order.  Any previous
+//               contents are lost.
+//
+	void init (const ObjModel& model);
+
+//
+//  init
+//
+//  Purpose: To set this WeldedMesh to contain the faces of one
+//           mesh in the specified ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//    <2> mesh: Which mesh in model
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> mesh < model.getMeshCount()
+//  Returns: N/A
+//  Side Effect: This WeldedMesh is set to contain the faces of
+//               mesh mesh of model.  There is one range.  Any
+//               previous contents are lost.
+//
+	void init (const ObjModel& model, unsigned int mesh);
+
+//
+//  optimize
+//
+//  Purpose: To reorder the triangles and vertexes in this
+//           WeldedMesh so that it draws faster.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The triangles in each range are reordered to
+//               make better use of the vertex cache, and then
+//               the vertexes are renumbered in the order they
+//               are first used.  The ranges still contain the
+//               same triangles.
+//
+	void optimize ();
+
+private:
+//
+//  weldMeshes
+//
+//  Purpose: To set this WeldedMesh to contain the faces of a
+//           sequence of meshes in an ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//    <2> first_mesh: The first mesh in model to include
+//    <3> mesh_count: The number of meshes to include
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> first_mesh + mesh_count <= model.getMeshCount()
+//  Returns: N/A
+//  Side Effect: This WeldedMesh is set to contain the faces of
+//               meshes first_mesh through first_mesh +
+//               mesh_count - 1 of model, with one range for
+//               each mesh.  Any previous contents are lost.
+//
+	void weldMeshes (const ObjModel& model,
+	                 unsigned int first_mesh,
+	                 unsigned int mesh_count);
+
+//
+//  addVertex
+//
+//  Purpose: To add a vertex to the vertex data for this
+//           WeldedMesh.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//    <2> vertex: The position index in model
+//    <3> texture_coordinate: The texture coordinate index in
+//                            model
+//    <4> normal: The normal index in model
+//  Precondition(s):
+//    <1> vertex < model.getVertexCount()
+//  Returns: N/A
+//  Side Effect: The values for the specified vertex are
+//               appended to the vertex data in the format for
+//               this WeldedMesh.
+//
+	void addVertex (const ObjModel& model,
+	                unsigned int vertex,
+	                unsigned int texture_coordinate,
+	                unsigned int normal);
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	//
+	//  Range
+	//
+	//  A record to represent the indexes created from one mesh.
+	//
+	struct Range
+	{
+		unsigned int m_mesh;
+		unsigned int m_first_index;
+		unsigned int m_index_count;
+	};
+
+	unsigned int m_format;
+	std::vector<float> mv_vertex_data;
+	std::vector<unsigned int> mv_indexes;
+	std::vector<Range> mv_ranges;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
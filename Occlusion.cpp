@@ -0,0 +1,127 @@
+//
+//  Occlusion.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Occlusion.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double HALF_PI = 1.57079632679489661923;
+}
+
+
+
+SphereOccluders :: SphereOccluders ()
+		: m_camera(0.0, 0.0, 0.0)
+		, mv_occluders()
+{
+	assert(invariant());
+}
+
+SphereOccluders :: SphereOccluders (const Vector3& camera)
+		: m_camera(camera)
+		, mv_occluders()
+{
+	assert(invariant());
+}
+
+
+
+double SphereOccluders :: calculateAngularRadius (const Vector3& center,
+                                                  double radius) const
+{
+	assert(radius >= 0.0);
+
+	double distance = m_camera.getDistance(center);
+	if(distance <= radius)
+		return HALF_PI;
+	return asin(radius / distance);
+}
+
+bool SphereOccluders :: isSphereHidden (const Vector3& center,
+                                        double radius) const
+{
+	assert(radius >= 0.0);
+
+	Vector3 to_center = center - m_camera;
+	double distance = to_center.getNorm();
+	if(distance <= radius)
+		return false;  // camera is inside target
+
+	double sin_target = radius / distance;
+	double cos_target = sqrt(1.0 - sin_target * sin_target);
+
+	for(unsigned int i = 0; i < mv_occluders.size(); i++)
+	{
+		const Occluder& occluder = mv_occluders[i];
+
+		// <1> target must be entirely behind the occluder
+		if(distance - radius < occluder.m_distance)
+			continue;
+
+		// <2> theta <= occluder angle - target angle
+		if(sin_target > occluder.m_sin_half_angle)
+			continue;  // target looks bigger
+		double cos_difference = occluder.m_cos_half_angle * cos_target +
+		                        occluder.m_sin_half_angle * sin_target;
+		double cos_theta = occluder.m_direction.dotProduct(to_center) / distance;
+		if(cos_theta >= cos_difference)
+			return true;
+	}
+	return false;
+}
+
+
+
+void SphereOccluders :: init (const Vector3& camera)
+{
+	m_camera = camera;
+	mv_occluders.clear();
+
+	assert(invariant());
+}
+
+void SphereOccluders :: addOccluder (const Vector3& center,
+                                     double radius)
+{
+	assert(radius >= 0.0);
+
+	Vector3 to_center = center - m_camera;
+	double distance = to_center.getNorm();
+	if(distance <= radius)
+		return;  // camera is inside occluder
+
+	Occluder occluder;
+	occluder.m_direction      = to_center / distance;
+	occluder.m_distance       = distance;
+	occluder.m_sin_half_angle = radius / distance;
+	occluder.m_cos_half_angle = sqrt(1.0 - occluder.m_sin_half_angle * occluder.m_sin_half_angle);
+	mv_occluders.push_back(occluder);
+
+	assert(invariant());
+}
+
+
+
+bool SphereOccluders :: invariant () const
+{
+	for(unsigned int i = 0; i < mv_occluders.size(); i++)
+	{
+		const Occluder& occluder = mv_occluders[i];
+		if(!occluder.m_direction.isUnit()) return false;
+		if(occluder.m_distance <= 0.0) return false;
+		if(occluder.m_sin_half_angle < 0.0) return false;
+		if(occluder.m_sin_half_angle > 1.0) return false;
+		if(occluder.m_cos_half_angle < 0.0) return false;
+		if(occluder.m_cos_half_angle > 1.0) return false;
+	}
+	return true;
+}
@@ -0,0 +1,145 @@
+//
+//  Occlusion.h
+//
+//  A module to test whether spheres are hidden behind other
+//    spheres.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  SphereOccluders
+//
+//  A class to represent a set of solid spheres that may hide
+//    other objects from a camera.  Each occluder is stored as
+//    the cone it covers as seen from the camera.
+//
+//  A target sphere at distance D and angle theta from the axis
+//    of an occluder of radius R at distance d is hidden if:
+//    <1> D - r >= d
+//    <2> theta + asin(r / D) <= asin(R / d)
+//  The first condition keeps the whole target farther away
+//    than any point of the occluder's silhouette, and the
+//    second keeps it inside the occluder's cone.  The test is
+//    conservative: a target that passes is always hidden, but
+//    targets covered by several occluders together are not
+//    detected.  The second condition is evaluated with the
+//    cosine of the angle difference, so no trigonometric
+//    functions are called per target.
+//
+//  Class Invariant:
+//    <1> mv_occluders[i].m_direction.isUnit() for all i
+//    <2> mv_occluders[i].m_distance > 0.0 for all i
+//    <3> mv_occluders[i].m_sin_half_angle in [0.0, 1.0] for
+//        all i
+//    <4> mv_occluders[i].m_cos_half_angle in [0.0, 1.0] for
+//        all i
+//
+class SphereOccluders
+{
+public:
+	SphereOccluders ();
+	SphereOccluders (const ObjLibrary::Vector3& camera);
+	SphereOccluders (const SphereOccluders& to_copy) = default;
+	~SphereOccluders () = default;
+	SphereOccluders& operator= (const SphereOccluders& to_copy) = default;
+
+//
+//  getCount
+//
+//  Purpose: To determine how many occluders are in this
+//           SphereOccluders.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of occluders.
+//  Side Effect: N/A
+//
+	unsigned int getCount () const
+	{	return (unsigned int)(mv_occluders.size());	}
+
+//
+//  calculateAngularRadius
+//
+//  Purpose: To determine how large the specified sphere
+//           appears from the camera.
+//  Parameter(s):
+//    <1> center: The center of the sphere
+//    <2> radius: The radius of the sphere
+//  Precondition(s):
+//    <1> radius >= 0.0
+//  Returns: The angle in radians between the direction to
+//           center and the edge of the sphere.  If the camera
+//           is inside the sphere, pi / 2 is returned.
+//  Side Effect: N/A
+//
+	double calculateAngularRadius (const ObjLibrary::Vector3& center,
+	                               double radius) const;
+
+//
+//  isSphereHidden
+//
+//  Purpose: To determine if the specified sphere is entirely
+//           hidden by one of the occluders.
+//  Parameter(s):
+//    <1> center: The center of the sphere
+//    <2> radius: The radius of the sphere
+//  Precondition(s):
+//    <1> radius >= 0.0
+//  Returns: Whether there is an occluder that hides the whole
+//           sphere from the camera.
+//  Side Effect: N/A
+//
+	bool isSphereHidden (const ObjLibrary::Vector3& center,
+	                     double radius) const;
+
+//
+//  init
+//
+//  Purpose: To remove all occluders and move the camera.
+//  Parameter(s):
+//    <1> camera: The new camera position
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This SphereOccluders is set to contain no
+//               occluders and use camera camera.
+//
+	void init (const ObjLibrary::Vector3& camera);
+
+//
+//  addOccluder
+//
+//  Purpose: To add a solid sphere that can hide other objects.
+//  Parameter(s):
+//    <1> center: The center of the occluder
+//    <2> radius: The radius of the occluder
+//  Precondition(s):
+//    <1> radius >= 0.0
+//  Returns: N/A
+//  Side Effect: If the camera is outside the sphere, it is
+//               added as an occluder.  Otherwise, there is no
+//               effect.
+//
+	void addOccluder (const ObjLibrary::Vector3& center,
+	                  double radius);
+
+private:
+	bool invariant () const;
+
+private:
+	struct Occluder
+	{
+		ObjLibrary::Vector3 m_direction;
+		double m_distance;
+		double m_sin_half_angle;  // stored instead of the angle
+		double m_cos_half_angle;  //   to avoid trigonometry in the test
+	};
+
+	ObjLibrary::Vector3 m_camera;
+	std::vector<Occluder> mv_occluders;
+};
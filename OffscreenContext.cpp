@@ -0,0 +1,178 @@
+//
+//  OffscreenContext.cpp
+//
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef OFFSCREEN_EGL
+	#include <EGL/egl.h>
+	#include <EGL/eglext.h>
+#endif
+
+#include "GetGlut.h"
+
+#include "OffscreenContext.h"
+
+using namespace std;
+
+
+
+bool OffscreenContext :: isAvailable ()
+{
+#ifdef OFFSCREEN_EGL
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+OffscreenContext :: OffscreenContext ()
+		: mp_display(nullptr)
+		, mp_surface(nullptr)
+		, mp_context(nullptr)
+		, m_width(0)
+		, m_height(0)
+{
+	assert(invariant());
+}
+
+OffscreenContext :: ~OffscreenContext ()
+{
+	destroy();
+}
+
+
+
+bool OffscreenContext :: init (unsigned int width,
+                               unsigned int height)
+{
+	assert(!isInitialized());
+	assert(width  > 0);
+	assert(height > 0);
+
+#ifdef OFFSCREEN_EGL
+	// prefer the surfaceless platform, which does not need a display server
+	EGLDisplay display = EGL_NO_DISPLAY;
+	const char* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	if(client_extensions != nullptr &&
+	   strstr(client_extensions, "EGL_MESA_platform_surfaceless") != nullptr)
+	{
+		PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+			(PFNEGLGETPLATFORMDISPLAYEXTPROC)(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+		if(get_platform_display != nullptr)
+			display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+	if(display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if(display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+	{
+		cerr << "Could not initialize an EGL display" << endl;
+		return false;
+	}
+	mp_display = display;
+
+	static const EGLint A_CONFIG_ATTRIBUTES[] =
+	{
+		EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE,        8,
+		EGL_GREEN_SIZE,      8,
+		EGL_BLUE_SIZE,       8,
+		EGL_ALPHA_SIZE,      8,
+		EGL_DEPTH_SIZE,      24,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint config_count = 0;
+	if(!eglChooseConfig(display, A_CONFIG_ATTRIBUTES, &config, 1, &config_count) ||
+	   config_count < 1)
+	{
+		cerr << "Could not find an EGL config for an OpenGL pbuffer" << endl;
+		destroy();
+		return false;
+	}
+
+	const EGLint A_SURFACE_ATTRIBUTES[] =
+	{
+		EGL_WIDTH,  (EGLint)(width),
+		EGL_HEIGHT, (EGLint)(height),
+		EGL_NONE
+	};
+	EGLSurface surface = eglCreatePbufferSurface(display, config, A_SURFACE_ATTRIBUTES);
+	if(surface == EGL_NO_SURFACE)
+	{
+		cerr << "Could not create a " << width << "x" << height << " EGL pbuffer" << endl;
+		destroy();
+		return false;
+	}
+	mp_surface = surface;
+
+	// the game uses the fixed-function pipeline, so this must be a compatibility context
+	eglBindAPI(EGL_OPENGL_API);
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+	if(context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+	{
+		cerr << "Could not create an OpenGL context with EGL" << endl;
+		if(context != EGL_NO_CONTEXT)
+			eglDestroyContext(display, context);
+		destroy();
+		return false;
+	}
+	mp_context = context;
+	m_width  = width;
+	m_height = height;
+
+	assert(invariant());
+	return true;
+#else
+	cerr << "Offscreen rendering is not available: compile with -DOFFSCREEN_EGL and link with -lEGL" << endl;
+	return false;
+#endif
+}
+
+void OffscreenContext :: readPixels (std::vector<unsigned char>& rv_rgba) const
+{
+	assert(isInitialized());
+
+	rv_rgba.resize(m_width * m_height * 4);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, rv_rgba.data());
+}
+
+
+
+void OffscreenContext :: destroy ()
+{
+#ifdef OFFSCREEN_EGL
+	if(mp_display != nullptr)
+	{
+		EGLDisplay display = (EGLDisplay)(mp_display);
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if(mp_context != nullptr)
+			eglDestroyContext(display, (EGLContext)(mp_context));
+		if(mp_surface != nullptr)
+			eglDestroySurface(display, (EGLSurface)(mp_surface));
+		eglTerminate(display);
+	}
+#endif
+
+	mp_display = nullptr;
+	mp_surface = nullptr;
+	mp_context = nullptr;
+	m_width  = 0;
+	m_height = 0;
+
+	assert(invariant());
+}
+
+bool OffscreenContext :: invariant () const
+{
+	if(isInitialized() != (m_width  > 0)) return false;
+	if(isInitialized() != (m_height > 0)) return false;
+	return true;
+}
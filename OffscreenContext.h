@@ -0,0 +1,137 @@
+//
+//  OffscreenContext.h
+//
+//  A module to render without a window.
+//
+
+#pragma once
+
+#include <vector>
+
+
+
+//
+//  OffscreenContext
+//
+//  A class to represent an OpenGL context that draws to an
+//    offscreen pbuffer instead of a window.  This allows the
+//    game to be drawn where there is no display, such as on a
+//    build server.  The context is created with EGL, and uses
+//    the Mesa surfaceless platform if it is available, so no X
+//    server or GPU is needed.
+//
+//  EGL is only used if OFFSCREEN_EGL is #defined.  Otherwise,
+//    init always fails.  To use this class, compile with
+//    -DOFFSCREEN_EGL and link with -lEGL.  Benchmark builds
+//    should also define OBJ_LIBRARY_COUNT_GL_CALLS so the
+//    report includes the OpenGL call counts.
+//
+//  GLUT is not initialized by this class, so GLUT functions
+//    (including everything in SpriteFont that needs a window)
+//    must not be called while drawing offscreen.
+//
+//  An OffscreenContext cannot be copied because it owns the
+//    context.
+//
+//  Class Invariant:
+//    <1> isInitialized() == (m_width > 0)
+//    <2> isInitialized() == (m_height > 0)
+//
+class OffscreenContext
+{
+public:
+//
+//  Class Function: isAvailable
+//
+//  Purpose: To determine if offscreen contexts were compiled
+//           in.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether OFFSCREEN_EGL was #defined.
+//  Side Effect: N/A
+//
+	static bool isAvailable ();
+
+public:
+	OffscreenContext ();
+	OffscreenContext (const OffscreenContext& to_copy) = delete;
+	~OffscreenContext ();
+	OffscreenContext& operator= (const OffscreenContext& to_copy) = delete;
+
+//
+//  isInitialized
+//
+//  Purpose: To determine if this OffscreenContext has a
+//           context.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the context was created successfully.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{	return mp_context != nullptr;	}
+
+//
+//  getWidth
+//  getHeight
+//
+//  Purpose: To determine the size of the pbuffer.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The width or height in pixels, or 0 if this
+//           OffscreenContext is not initialized.
+//  Side Effect: N/A
+//
+	unsigned int getWidth () const
+	{	return m_width;	}
+	unsigned int getHeight () const
+	{	return m_height;	}
+
+//
+//  init
+//
+//  Purpose: To create the context and make it current.
+//  Parameter(s):
+//    <1> width
+//    <2> height: The size of the pbuffer in pixels
+//  Preconditions:
+//    <1> !isInitialized()
+//    <2> width > 0
+//    <3> height > 0
+//  Returns: Whether the context was created.
+//  Side Effect: A desktop OpenGL context with an RGBA colour
+//               buffer and a depth buffer is created and made
+//               current on this thread.  If this fails, an error
+//               message is printed and this OffscreenContext is
+//               left uninitialized.
+//
+	bool init (unsigned int width,
+	           unsigned int height);
+
+//
+//  readPixels
+//
+//  Purpose: To copy the current image out of the pbuffer.
+//  Parameter(s):
+//    <1> rv_rgba: A vector to fill with the image
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: rv_rgba is replaced with the pixels of the
+//               pbuffer, 4 bytes per pixel, with the bottom row
+//               first.  This waits for drawing to finish.
+//
+	void readPixels (std::vector<unsigned char>& rv_rgba) const;
+
+private:
+	void destroy ();
+	bool invariant () const;
+
+private:
+	// EGL handles are stored as void pointers so this header does not need EGL
+	void* mp_display;
+	void* mp_surface;
+	void* mp_context;
+	unsigned int m_width;
+	unsigned int m_height;
+};
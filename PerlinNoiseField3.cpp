@@ -8,6 +8,15 @@
 #include <cmath>
 #include <climits>
 #include <iostream>
+#include <vector>
+
+#if defined(__AVX512F__)
+	#define PERLIN_NOISE_USE_AVX512
+	#include <immintrin.h>
+#elif defined(__AVX2__)
+	#define PERLIN_NOISE_USE_AVX2
+	#include <immintrin.h>
+#endif
 
 #include "ObjLibrary/Vector3.h"
 
@@ -17,15 +26,372 @@ using namespace std;
 using namespace ObjLibrary;
 namespace
 {
-	const unsigned int DEFAULT_SEED_X1 = 1273472206;
-	const unsigned int DEFAULT_SEED_X2 = 4278162623;
-	const unsigned int DEFAULT_SEED_Y1 = 1440014778;
-	const unsigned int DEFAULT_SEED_Y2 =  524485263;
-	const unsigned int DEFAULT_SEED_Z1 = 2813546167;
-	const unsigned int DEFAULT_SEED_Z2 = 3305132234;
-	const unsigned int DEFAULT_SEED_Q0 = 1498573726;
-	const unsigned int DEFAULT_SEED_Q1 = 3476519523;
-	const unsigned int DEFAULT_SEED_Q2 = 3905844518;
+	const unsigned int FRACTAL_FBM        = 0;
+	const unsigned int FRACTAL_TURBULENCE = 1;
+	const unsigned int FRACTAL_RIDGED     = 2;
+
+#if defined(PERLIN_NOISE_USE_AVX512) || defined(PERLIN_NOISE_USE_AVX2)
+	//
+	//  The batch kernels are written once in terms of these
+	//    wrappers, which use whichever instruction set is being
+	//    compiled for.  FloatN and IntN hold SIMD_WIDTH floats
+	//    or 32-bit integers.
+	//
+#ifdef PERLIN_NOISE_USE_AVX512
+	const unsigned int SIMD_WIDTH = 16;
+	typedef __m512  FloatN;
+	typedef __m512i IntN;
+
+	inline FloatN loadF  (const float* a) { return _mm512_loadu_ps(a); }
+	inline void   storeF (float* a, FloatN v) { _mm512_storeu_ps(a, v); }
+	inline FloatN setF   (float f) { return _mm512_set1_ps(f); }
+	inline FloatN addF   (FloatN a, FloatN b) { return _mm512_add_ps(a, b); }
+	inline FloatN subF   (FloatN a, FloatN b) { return _mm512_sub_ps(a, b); }
+	inline FloatN mulF   (FloatN a, FloatN b) { return _mm512_mul_ps(a, b); }
+	inline FloatN divF   (FloatN a, FloatN b) { return _mm512_div_ps(a, b); }
+	inline FloatN sqrtF  (FloatN a) { return _mm512_sqrt_ps(a); }
+	inline FloatN floorF (FloatN a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	inline IntN   setI   (unsigned int n) { return _mm512_set1_epi32((int)(n)); }
+	inline IntN   addI   (IntN a, IntN b) { return _mm512_add_epi32(a, b); }
+	inline IntN   subI   (IntN a, IntN b) { return _mm512_sub_epi32(a, b); }
+	inline IntN   mulI   (IntN a, IntN b) { return _mm512_mullo_epi32(a, b); }
+	inline IntN   andI   (IntN a, IntN b) { return _mm512_and_si512(a, b); }
+	inline IntN   andNotI(IntN a, IntN b) { return _mm512_andnot_si512(a, b); }
+	inline IntN   orI    (IntN a, IntN b) { return _mm512_or_si512(a, b); }
+	inline IntN   xorI   (IntN a, IntN b) { return _mm512_xor_si512(a, b); }
+	inline IntN   shiftLeft16  (IntN a) { return _mm512_slli_epi32(a, 16); }
+	inline IntN   shiftLeft30  (IntN a) { return _mm512_slli_epi32(a, 30); }
+	inline IntN   shiftRight16 (IntN a) { return _mm512_srli_epi32(a, 16); }
+	inline IntN   truncateToI  (FloatN a) { return _mm512_cvttps_epi32(a); }
+	inline FloatN convertToF   (IntN a) { return _mm512_cvtepi32_ps(a); }
+	inline FloatN castToF (IntN a) { return _mm512_castsi512_ps(a); }
+	inline IntN   castToI (FloatN a) { return _mm512_castps_si512(a); }
+	inline IntN   gatherI (const int*   a, IntN index) { return _mm512_i32gather_epi32(index, a, 4); }
+	inline FloatN gatherF (const float* a, IntN index) { return _mm512_i32gather_ps(index, a, 4); }
+#else
+	const unsigned int SIMD_WIDTH = 8;
+	typedef __m256  FloatN;
+	typedef __m256i IntN;
+
+	inline FloatN loadF  (const float* a) { return _mm256_loadu_ps(a); }
+	inline void   storeF (float* a, FloatN v) { _mm256_storeu_ps(a, v); }
+	inline FloatN setF   (float f) { return _mm256_set1_ps(f); }
+	inline FloatN addF   (FloatN a, FloatN b) { return _mm256_add_ps(a, b); }
+	inline FloatN subF   (FloatN a, FloatN b) { return _mm256_sub_ps(a, b); }
+	inline FloatN mulF   (FloatN a, FloatN b) { return _mm256_mul_ps(a, b); }
+	inline FloatN divF   (FloatN a, FloatN b) { return _mm256_div_ps(a, b); }
+	inline FloatN sqrtF  (FloatN a) { return _mm256_sqrt_ps(a); }
+	inline FloatN floorF (FloatN a) { return _mm256_floor_ps(a); }
+	inline IntN   setI   (unsigned int n) { return _mm256_set1_epi32((int)(n)); }
+	inline IntN   addI   (IntN a, IntN b) { return _mm256_add_epi32(a, b); }
+	inline IntN   subI   (IntN a, IntN b) { return _mm256_sub_epi32(a, b); }
+	inline IntN   mulI   (IntN a, IntN b) { return _mm256_mullo_epi32(a, b); }
+	inline IntN   andI   (IntN a, IntN b) { return _mm256_and_si256(a, b); }
+	inline IntN   andNotI(IntN a, IntN b) { return _mm256_andnot_si256(a, b); }
+	inline IntN   orI    (IntN a, IntN b) { return _mm256_or_si256(a, b); }
+	inline IntN   xorI   (IntN a, IntN b) { return _mm256_xor_si256(a, b); }
+	inline IntN   shiftLeft16  (IntN a) { return _mm256_slli_epi32(a, 16); }
+	inline IntN   shiftLeft30  (IntN a) { return _mm256_slli_epi32(a, 30); }
+	inline IntN   shiftRight16 (IntN a) { return _mm256_srli_epi32(a, 16); }
+	inline IntN   truncateToI  (FloatN a) { return _mm256_cvttps_epi32(a); }
+	inline FloatN convertToF   (IntN a) { return _mm256_cvtepi32_ps(a); }
+	inline FloatN castToF (IntN a) { return _mm256_castsi256_ps(a); }
+	inline IntN   castToI (FloatN a) { return _mm256_castps_si256(a); }
+	inline IntN   gatherI (const int*   a, IntN index) { return _mm256_i32gather_epi32(a, index, 4); }
+	inline FloatN gatherF (const float* a, IntN index) { return _mm256_i32gather_ps(a, index, 4); }
+#endif
+
+	const float TWO_TO_MINUS_32 = 1.0f / 4294967296.0f;
+	const float TWO_PI_F        = 6.28318530718f;
+
+	// bitwise: mask ? a : b, where each mask element is all 0s or all 1s
+	inline IntN selectI (IntN mask, IntN a, IntN b)
+	{
+		return orI(andI(mask, a), andNotI(mask, b));
+	}
+
+	// correctly rounded, like (float)(n) for unsigned n
+	inline FloatN unsignedToF (IntN n)
+	{
+		FloatN high = convertToF(shiftRight16(n));
+		FloatN low  = convertToF(andI(n, setI(0xFFFF)));
+		return addF(mulF(high, setF(65536.0f)), low);  // high part is exact, so only 1 rounding
+	}
+
+	// truncated, like (unsigned int)(f) for 0 <= f <= 2^32
+	inline IntN truncateToUnsigned (FloatN f)
+	{
+		IntN high = truncateToI(mulF(f, setF(1.0f / 65536.0f)));
+		FloatN low = subF(f, mulF(convertToF(high), setF(65536.0f)));  // exact
+		return addI(shiftLeft16(high), truncateToI(low));
+	}
+
+	//
+	//  Calculates the cosine and sine of an angle measured in
+	//    turns (1.0 == 2 * pi radians).  The angle is reduced to
+	//    a quarter turn and the Taylor series are used from
+	//    there.  The error is less than 1.0e-7.
+	//
+	void cosSinTurns (FloatN turns,
+	                  FloatN& r_cos,
+	                  FloatN& r_sin)
+	{
+		FloatN quarter_float = floorF(addF(mulF(turns, setF(4.0f)), setF(0.5f)));
+		IntN   quarter       = truncateToI(quarter_float);
+		FloatN a  = mulF(subF(turns, mulF(quarter_float, setF(0.25f))), setF(TWO_PI_F));
+		FloatN a2 = mulF(a, a);  // a is in [-pi/4, pi/4]
+
+		FloatN sin_a = setF(1.0f / 362880.0f);
+		sin_a = addF(mulF(sin_a, a2), setF(-1.0f / 5040.0f));
+		sin_a = addF(mulF(sin_a, a2), setF( 1.0f / 120.0f));
+		sin_a = addF(mulF(sin_a, a2), setF(-1.0f / 6.0f));
+		sin_a = addF(mulF(sin_a, a2), setF( 1.0f));
+		sin_a = mulF(sin_a, a);
+
+		FloatN cos_a = setF(-1.0f / 3628800.0f);
+		cos_a = addF(mulF(cos_a, a2), setF( 1.0f / 40320.0f));
+		cos_a = addF(mulF(cos_a, a2), setF(-1.0f / 720.0f));
+		cos_a = addF(mulF(cos_a, a2), setF( 1.0f / 24.0f));
+		cos_a = addF(mulF(cos_a, a2), setF(-0.5f));
+		cos_a = addF(mulF(cos_a, a2), setF( 1.0f));
+
+		// odd quarters swap sine and cosine, sign bits come from quarters 1, 2 (cos) and 2, 3 (sin)
+		IntN is_swapped = subI(setI(0), andI(quarter, setI(1)));
+		IntN cos_bits = selectI(is_swapped, castToI(sin_a), castToI(cos_a));
+		IntN sin_bits = selectI(is_swapped, castToI(cos_a), castToI(sin_a));
+		IntN cos_sign = shiftLeft30(andI(addI(quarter, setI(1)), setI(2)));
+		IntN sin_sign = shiftLeft30(andI(quarter, setI(2)));
+		r_cos = castToF(xorI(cos_bits, cos_sign));
+		r_sin = castToF(xorI(sin_bits, sin_sign));
+	}
+
+	inline FloatN fadeN (FloatN n, FloatN& r_derivative)
+	{
+		// (1 - cos(n * pi)) * 0.5, derivative is sin(n * pi) * pi * 0.5
+		FloatN cos_n;
+		FloatN sin_n;
+		cosSinTurns(mulF(n, setF(0.5f)), cos_n, sin_n);
+		r_derivative = mulF(sin_n, setF(3.14159265f * 0.5f));
+		return mulF(subF(setF(1.0f), cos_n), setF(0.5f));
+	}
+
+	inline FloatN interpolateN (FloatN v0, FloatN v1, FloatN fraction)
+	{
+		return addF(mulF(v0, subF(setF(1.0f), fraction)),
+		            mulF(v1, fraction));
+	}
+
+	inline IntN interpolateUnsignedN (IntN v0, IntN v1, FloatN fraction)
+	{
+		return addI(truncateToUnsigned(mulF(unsignedToF(v0), subF(setF(1.0f), fraction))),
+		            truncateToUnsigned(mulF(unsignedToF(v1), fraction)));
+	}
+
+	struct SeedsN
+	{
+		IntN m_x1, m_x2;
+		IntN m_y1, m_y2;
+		IntN m_z1, m_z2;
+		IntN m_q0, m_q1, m_q2;
+		const PermutationTable* mp_table;  // nullptr for HASH_SEEDED
+	};
+
+	// as PermutationTable::hash
+	inline IntN hashN (const PermutationTable& table, IntN x, IntN y, IntN z)
+	{
+		IntN mask = setI(PermutationTable::MASK);
+		IntN hash = gatherI(table.ma_permutation, andI(x, mask));
+		hash = gatherI(table.ma_permutation, addI(hash, andI(y, mask)));
+		return gatherI(table.ma_permutation, addI(hash, andI(z, mask)));
+	}
+
+	inline IntN pseudorandomN (const SeedsN& seeds, IntN x, IntN y, IntN z)
+	{
+		if(seeds.mp_table != nullptr)
+			return gatherI((const int*)(seeds.mp_table->ma_values), hashN(*seeds.mp_table, x, y, z));
+
+		IntN n = addI(addI(mulI(seeds.m_x1, x),
+		                   mulI(seeds.m_y1, y)),
+		                   mulI(seeds.m_z1, z));
+		IntN quad_term = addI(addI(mulI(mulI(seeds.m_q2, n), n),
+		                           mulI(seeds.m_q1, n)),
+		                           seeds.m_q0);
+		return addI(addI(addI(quad_term,
+		                      mulI(seeds.m_x2, x)),
+		                      mulI(seeds.m_y2, y)),
+		                      mulI(seeds.m_z2, z));
+	}
+
+	// as Vector3::getPseudorandomUnitVector, with 1 - z^2 == 4 * seed2 * (1 - seed2)
+	void latticeN (const SeedsN& seeds,
+	               IntN x, IntN y, IntN z,
+	               FloatN& r_lattice_x, FloatN& r_lattice_y, FloatN& r_lattice_z)
+	{
+		if(seeds.mp_table != nullptr)
+		{
+			IntN hash = hashN(*seeds.mp_table, x, y, z);
+			r_lattice_x = gatherF(seeds.mp_table->ma_gradient_x, hash);
+			r_lattice_y = gatherF(seeds.mp_table->ma_gradient_y, hash);
+			r_lattice_z = gatherF(seeds.mp_table->ma_gradient_z, hash);
+			return;
+		}
+
+		IntN one = setI(1);
+		FloatN seed1 = mulF(unsignedToF(pseudorandomN(seeds, x, y, z)), setF(TWO_TO_MINUS_32));
+		FloatN seed2 = mulF(unsignedToF(pseudorandomN(seeds, addI(x, one), addI(y, one), addI(z, one))),
+		                    setF(TWO_TO_MINUS_32));
+
+		FloatN radius_xy = mulF(sqrtF(mulF(seed2, subF(setF(1.0f), seed2))), setF(2.0f));
+		FloatN cos_angle;
+		FloatN sin_angle;
+		cosSinTurns(seed1, cos_angle, sin_angle);
+
+		r_lattice_x = mulF(radius_xy, cos_angle);
+		r_lattice_y = mulF(radius_xy, sin_angle);
+		r_lattice_z = subF(mulF(seed2, setF(2.0f)), setF(1.0f));
+	}
+
+	// a_corners is indexed by (x << 2) | (y << 1) | z
+	inline FloatN trilinearN (const FloatN a_corners[8],
+	                          FloatN x_fade, FloatN y_fade, FloatN z_fade)
+	{
+		FloatN value00 = interpolateN(a_corners[0], a_corners[1], z_fade);
+		FloatN value01 = interpolateN(a_corners[2], a_corners[3], z_fade);
+		FloatN value10 = interpolateN(a_corners[4], a_corners[5], z_fade);
+		FloatN value11 = interpolateN(a_corners[6], a_corners[7], z_fade);
+		FloatN value0  = interpolateN(value00, value01, y_fade);
+		FloatN value1  = interpolateN(value10, value11, y_fade);
+		return interpolateN(value0, value1, x_fade);
+	}
+
+	// finds the lattice cell and fraction for a coordinate
+	inline void cellN (FloatN position, FloatN grid_size,
+	                   IntN& r_cell, FloatN& r_fraction)
+	{
+		FloatN scaled = divF(position, grid_size);
+		r_cell     = truncateToI(floorF(scaled));
+		r_fraction = subF(scaled, convertToF(r_cell));
+	}
+
+	//
+	//  Calculates Perlin noise with an amplitude of 1.0 for
+	//    SIMD_WIDTH points, the same way as
+	//    PerlinNoiseField3::perlinNoiseWithGradient.  If
+	//    is_gradient is true, the derivative with respect to the
+	//    scaled position is stored in the r_gradient parameters.
+	//    Otherwise, they are not changed.
+	//
+	inline FloatN perlinNoiseN (const SeedsN& seeds,
+	                            FloatN grid_size,
+	                            FloatN x, FloatN y, FloatN z,
+	                            bool is_gradient,
+	                            FloatN& r_gradient_x,
+	                            FloatN& r_gradient_y,
+	                            FloatN& r_gradient_z)
+	{
+		IntN a_cell_x[2];
+		IntN a_cell_y[2];
+		IntN a_cell_z[2];
+		FloatN x_frac, y_frac, z_frac;
+		cellN(x, grid_size, a_cell_x[0], x_frac);
+		cellN(y, grid_size, a_cell_y[0], y_frac);
+		cellN(z, grid_size, a_cell_z[0], z_frac);
+		a_cell_x[1] = addI(a_cell_x[0], setI(1));
+		a_cell_y[1] = addI(a_cell_y[0], setI(1));
+		a_cell_z[1] = addI(a_cell_z[0], setI(1));
+
+		FloatN x_fade_derivative, y_fade_derivative, z_fade_derivative;
+		FloatN x_fade = fadeN(x_frac, x_fade_derivative);
+		FloatN y_fade = fadeN(y_frac, y_fade_derivative);
+		FloatN z_fade = fadeN(z_frac, z_fade_derivative);
+
+		// directions are corner - point
+		FloatN a_direction_x[2] = { subF(setF(0.0f), x_frac), subF(setF(1.0f), x_frac) };
+		FloatN a_direction_y[2] = { subF(setF(0.0f), y_frac), subF(setF(1.0f), y_frac) };
+		FloatN a_direction_z[2] = { subF(setF(0.0f), z_frac), subF(setF(1.0f), z_frac) };
+
+		FloatN a_lattice_x[8];
+		FloatN a_lattice_y[8];
+		FloatN a_lattice_z[8];
+		FloatN a_values[8];
+		for(unsigned int c = 0; c < 8; c++)
+		{
+			unsigned int i = (c >> 2) & 0x1;
+			unsigned int j = (c >> 1) & 0x1;
+			unsigned int k = (c     ) & 0x1;
+			latticeN(seeds, a_cell_x[i], a_cell_y[j], a_cell_z[k],
+			         a_lattice_x[c], a_lattice_y[c], a_lattice_z[c]);
+			a_values[c] = addF(addF(mulF(a_lattice_x[c], a_direction_x[i]),
+			                        mulF(a_lattice_y[c], a_direction_y[j])),
+			                        mulF(a_lattice_z[c], a_direction_z[k]));
+		}
+
+		FloatN value00 = interpolateN(a_values[0], a_values[1], z_fade);
+		FloatN value01 = interpolateN(a_values[2], a_values[3], z_fade);
+		FloatN value10 = interpolateN(a_values[4], a_values[5], z_fade);
+		FloatN value11 = interpolateN(a_values[6], a_values[7], z_fade);
+		FloatN value0  = interpolateN(value00, value01, y_fade);
+		FloatN value1  = interpolateN(value10, value11, y_fade);
+		FloatN value   = interpolateN(value0,  value1,  x_fade);
+
+		if(is_gradient)
+		{
+			// change from the interpolation weights
+			FloatN weight_x = mulF(subF(value1, value0), x_fade_derivative);
+			FloatN weight_y = mulF(interpolateN(subF(value01, value00),
+			                                    subF(value11, value10), x_fade), y_fade_derivative);
+			FloatN weight_z = mulF(interpolateN(interpolateN(subF(a_values[1], a_values[0]),
+			                                                 subF(a_values[3], a_values[2]), y_fade),
+			                                    interpolateN(subF(a_values[5], a_values[4]),
+			                                                 subF(a_values[7], a_values[6]), y_fade),
+			                                    x_fade), z_fade_derivative);
+
+			// change from the directions
+			r_gradient_x = subF(weight_x, trilinearN(a_lattice_x, x_fade, y_fade, z_fade));
+			r_gradient_y = subF(weight_y, trilinearN(a_lattice_y, x_fade, y_fade, z_fade));
+			r_gradient_z = subF(weight_z, trilinearN(a_lattice_z, x_fade, y_fade, z_fade));
+		}
+		return value;
+	}
+#endif
+}
+
+
+
+const float PerlinNoiseField3 :: BATCH_TOLERANCE = 1.0e-5f;
+
+unsigned int PerlinNoiseField3 :: getBatchWidth ()
+{
+#if defined(PERLIN_NOISE_USE_AVX512) || defined(PERLIN_NOISE_USE_AVX2)
+	return SIMD_WIDTH;
+#else
+	return 1;
+#endif
+}
+
+
+
+PerlinNoiseField3 :: Octaves :: Octaves ()
+		: m_count(1)
+		, m_lacunarity(2.0f)
+		, m_gain(0.5f)
+		, m_min_grid_size(0.0f)
+		, m_min_amplitude(0.0f)
+{
+}
+
+PerlinNoiseField3 :: Octaves :: Octaves (unsigned int count,
+                                         float lacunarity,
+                                         float gain)
+		: m_count(count)
+		, m_lacunarity(lacunarity)
+		, m_gain(gain)
+		, m_min_grid_size(0.0f)
+		, m_min_amplitude(0.0f)
+{
+	assert(lacunarity > 1.0f);
+	assert(gain > 0.0f);
+	assert(gain < 1.0f);
 }
 
 
@@ -42,6 +408,8 @@ PerlinNoiseField3 :: PerlinNoiseField3 ()
 		, m_seed_q0(DEFAULT_SEED_Q0)
 		, m_seed_q1(DEFAULT_SEED_Q1)
 		, m_seed_q2(DEFAULT_SEED_Q2)
+		, m_hash_mode(HASH_SEEDED)
+		, m_table()
 {
 	assert(invariant());
 }
@@ -59,6 +427,8 @@ PerlinNoiseField3 :: PerlinNoiseField3 (float grid_size,
 		, m_seed_q0(DEFAULT_SEED_Q0)
 		, m_seed_q1(DEFAULT_SEED_Q1)
 		, m_seed_q2(DEFAULT_SEED_Q2)
+		, m_hash_mode(HASH_SEEDED)
+		, m_table()
 {
 	assert(grid_size > 0.0f);
 
@@ -87,6 +457,8 @@ PerlinNoiseField3 :: PerlinNoiseField3 (float grid_size,
 		, m_seed_q0(seed_q0)
 		, m_seed_q1(seed_q1)
 		, m_seed_q2(seed_q2)
+		, m_hash_mode(HASH_SEEDED)
+		, m_table()
 {
 	assert(grid_size > 0.0f);
 
@@ -105,6 +477,33 @@ float PerlinNoiseField3 :: getAmplitude () const
 	return m_amplitude;
 }
 
+unsigned int PerlinNoiseField3 :: getHashMode () const
+{
+	return m_hash_mode;
+}
+
+void PerlinNoiseField3 :: getSeeds (unsigned int a_seeds[SEED_COUNT]) const
+{
+	assert(a_seeds != nullptr);
+
+	a_seeds[0] = m_seed_x1;
+	a_seeds[1] = m_seed_x2;
+	a_seeds[2] = m_seed_y1;
+	a_seeds[3] = m_seed_y2;
+	a_seeds[4] = m_seed_z1;
+	a_seeds[5] = m_seed_z2;
+	a_seeds[6] = m_seed_q0;
+	a_seeds[7] = m_seed_q1;
+	a_seeds[8] = m_seed_q2;
+}
+
+const PermutationTable& PerlinNoiseField3 :: getPermutationTable () const
+{
+	assert(m_hash_mode == HASH_PERMUTATION);
+
+	return m_table;
+}
+
 float PerlinNoiseField3 :: valueNoise (float x, float y, float z) const
 {
 	int x0 = (int)(floor(x / m_grid_size));
@@ -197,6 +596,411 @@ float PerlinNoiseField3 :: perlinNoise (float x, float y, float z) const
 	return value * m_amplitude;
 }
 
+float PerlinNoiseField3 :: perlinNoiseWithGradient (float x, float y, float z,
+                                                   ObjLibrary::Vector3& r_gradient) const
+{
+	int x0 = (int)(floor(x / m_grid_size));
+	int y0 = (int)(floor(y / m_grid_size));
+	int z0 = (int)(floor(z / m_grid_size));
+	int x1 = x0 + 1;
+	int y1 = y0 + 1;
+	int z1 = z0 + 1;
+
+	float x_frac = x / m_grid_size - x0;
+	float y_frac = y / m_grid_size - y0;
+	float z_frac = z / m_grid_size - z0;
+
+	float x_fade = fade(x_frac);
+	float y_fade = fade(y_frac);
+	float z_fade = fade(z_frac);
+
+	Vector3 lattice000 = lattice(x0, y0, z0);
+	Vector3 lattice001 = lattice(x0, y0, z1);
+	Vector3 lattice010 = lattice(x0, y1, z0);
+	Vector3 lattice011 = lattice(x0, y1, z1);
+	Vector3 lattice100 = lattice(x1, y0, z0);
+	Vector3 lattice101 = lattice(x1, y0, z1);
+	Vector3 lattice110 = lattice(x1, y1, z0);
+	Vector3 lattice111 = lattice(x1, y1, z1);
+
+	Vector3 direction000(     - x_frac,      - y_frac,      - z_frac);
+	Vector3 direction001(     - x_frac,      - y_frac, 1.0f - z_frac);
+	Vector3 direction010(     - x_frac, 1.0f - y_frac,      - z_frac);
+	Vector3 direction011(     - x_frac, 1.0f - y_frac, 1.0f - z_frac);
+	Vector3 direction100(1.0f - x_frac,      - y_frac,      - z_frac);
+	Vector3 direction101(1.0f - x_frac,      - y_frac, 1.0f - z_frac);
+	Vector3 direction110(1.0f - x_frac, 1.0f - y_frac,      - z_frac);
+	Vector3 direction111(1.0f - x_frac, 1.0f - y_frac, 1.0f - z_frac);
+
+	float value000 = (float)(lattice000.dotProduct(direction000));
+	float value001 = (float)(lattice001.dotProduct(direction001));
+	float value010 = (float)(lattice010.dotProduct(direction010));
+	float value011 = (float)(lattice011.dotProduct(direction011));
+	float value100 = (float)(lattice100.dotProduct(direction100));
+	float value101 = (float)(lattice101.dotProduct(direction101));
+	float value110 = (float)(lattice110.dotProduct(direction110));
+	float value111 = (float)(lattice111.dotProduct(direction111));
+
+	float value00 = interpolate(value000, value001, z_fade);
+	float value01 = interpolate(value010, value011, z_fade);
+	float value10 = interpolate(value100, value101, z_fade);
+	float value11 = interpolate(value110, value111, z_fade);
+	float value0  = interpolate(value00,  value01,  y_fade);
+	float value1  = interpolate(value10,  value11,  y_fade);
+	float value   = interpolate(value0,   value1,   x_fade);
+
+	// change from the interpolation weights
+	float weight_x = (value1 - value0) * fadeDerivative(x_frac);
+	float weight_y = interpolate(value01 - value00,
+	                             value11 - value10, x_fade) * fadeDerivative(y_frac);
+	float weight_z = interpolate(interpolate(value001 - value000, value011 - value010, y_fade),
+	                             interpolate(value101 - value100, value111 - value110, y_fade),
+	                             x_fade) * fadeDerivative(z_frac);
+
+	// change from the directions, which are all corner - point
+	Vector3 lattice00 = interpolate(lattice000, lattice001, z_fade);
+	Vector3 lattice01 = interpolate(lattice010, lattice011, z_fade);
+	Vector3 lattice10 = interpolate(lattice100, lattice101, z_fade);
+	Vector3 lattice11 = interpolate(lattice110, lattice111, z_fade);
+	Vector3 lattice0  = interpolate(lattice00,  lattice01,  y_fade);
+	Vector3 lattice1  = interpolate(lattice10,  lattice11,  y_fade);
+	Vector3 lattice_weighted = interpolate(lattice0, lattice1, x_fade);
+
+	Vector3 gradient = Vector3(weight_x, weight_y, weight_z) - lattice_weighted;
+	r_gradient = gradient * (m_amplitude / m_grid_size);
+	return value * m_amplitude;
+}
+
+unsigned int PerlinNoiseField3 :: getOctaveCount (const Octaves& octaves) const
+{
+	assert(octaves.m_lacunarity > 1.0f);
+	assert(octaves.m_gain > 0.0f);
+	assert(octaves.m_gain < 1.0f);
+
+	if(octaves.m_count == 0)
+		return 0;
+
+	float total_weight = 0.0f;
+	float weight = 1.0f;
+	for(unsigned int i = 0; i < octaves.m_count; i++)
+	{
+		total_weight += weight;
+		weight *= octaves.m_gain;
+	}
+
+	// the first octave is always used
+	float amplitude_per_weight = fabs(m_amplitude) / total_weight;
+	float grid_size = m_grid_size / octaves.m_lacunarity;
+	weight = octaves.m_gain;
+	unsigned int count = 1;
+	for( ; count < octaves.m_count; count++)
+	{
+		if(grid_size < octaves.m_min_grid_size)
+			break;
+		if(weight * amplitude_per_weight < octaves.m_min_amplitude)
+			break;
+		grid_size /= octaves.m_lacunarity;
+		weight    *= octaves.m_gain;
+	}
+	return count;
+}
+
+float PerlinNoiseField3 :: fbmNoise (float x, float y, float z,
+                                     const Octaves& octaves) const
+{
+	return calculateFractal(x, y, z, octaves, FRACTAL_FBM);
+}
+
+float PerlinNoiseField3 :: turbulenceNoise (float x, float y, float z,
+                                            const Octaves& octaves) const
+{
+	return calculateFractal(x, y, z, octaves, FRACTAL_TURBULENCE);
+}
+
+float PerlinNoiseField3 :: ridgedNoise (float x, float y, float z,
+                                        const Octaves& octaves) const
+{
+	return calculateFractal(x, y, z, octaves, FRACTAL_RIDGED);
+}
+
+void PerlinNoiseField3 :: valueNoiseBatch (const float a_x[],
+                                           const float a_y[],
+                                           const float a_z[],
+                                           unsigned int count,
+                                           float a_results[]) const
+{
+	assert(a_x       != nullptr || count == 0);
+	assert(a_y       != nullptr || count == 0);
+	assert(a_z       != nullptr || count == 0);
+	assert(a_results != nullptr || count == 0);
+
+	unsigned int i = 0;
+
+#if defined(PERLIN_NOISE_USE_AVX512) || defined(PERLIN_NOISE_USE_AVX2)
+	const SeedsN seeds = { setI(m_seed_x1), setI(m_seed_x2),
+	                       setI(m_seed_y1), setI(m_seed_y2),
+	                       setI(m_seed_z1), setI(m_seed_z2),
+	                       setI(m_seed_q0), setI(m_seed_q1), setI(m_seed_q2),
+	                       (m_hash_mode == HASH_PERMUTATION) ? &m_table : nullptr };
+	const FloatN grid_size = setF(m_grid_size);
+	const IntN one = setI(1);
+
+	for( ; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		IntN x0, y0, z0;
+		FloatN x_frac, y_frac, z_frac;
+		cellN(loadF(a_x + i), grid_size, x0, x_frac);
+		cellN(loadF(a_y + i), grid_size, y0, y_frac);
+		cellN(loadF(a_z + i), grid_size, z0, z_frac);
+		IntN x1 = addI(x0, one);
+		IntN y1 = addI(y0, one);
+		IntN z1 = addI(z0, one);
+
+		FloatN x_fade_derivative, y_fade_derivative, z_fade_derivative;  // not needed
+		FloatN x_fade = fadeN(x_frac, x_fade_derivative);
+		FloatN y_fade = fadeN(y_frac, y_fade_derivative);
+		FloatN z_fade = fadeN(z_frac, z_fade_derivative);
+
+		IntN value00 = interpolateUnsignedN(pseudorandomN(seeds, x0, y0, z0),
+		                                    pseudorandomN(seeds, x0, y0, z1), z_fade);
+		IntN value01 = interpolateUnsignedN(pseudorandomN(seeds, x0, y1, z0),
+		                                    pseudorandomN(seeds, x0, y1, z1), z_fade);
+		IntN value10 = interpolateUnsignedN(pseudorandomN(seeds, x1, y0, z0),
+		                                    pseudorandomN(seeds, x1, y0, z1), z_fade);
+		IntN value11 = interpolateUnsignedN(pseudorandomN(seeds, x1, y1, z0),
+		                                    pseudorandomN(seeds, x1, y1, z1), z_fade);
+		IntN value0  = interpolateUnsignedN(value00, value01, y_fade);
+		IntN value1  = interpolateUnsignedN(value10, value11, y_fade);
+		IntN value   = interpolateUnsignedN(value0,  value1,  x_fade);
+
+		FloatN pm1 = subF(mulF(mulF(unsignedToF(value), setF(TWO_TO_MINUS_32)), setF(2.0f)), setF(1.0f));
+		storeF(a_results + i, mulF(pm1, setF(m_amplitude)));
+	}
+#endif
+
+	// any remaining points
+	for( ; i < count; i++)
+		a_results[i] = valueNoise(a_x[i], a_y[i], a_z[i]);
+}
+
+void PerlinNoiseField3 :: perlinNoiseBatch (const float a_x[],
+                                            const float a_y[],
+                                            const float a_z[],
+                                            unsigned int count,
+                                            float a_results[]) const
+{
+	assert(a_x       != nullptr || count == 0);
+	assert(a_y       != nullptr || count == 0);
+	assert(a_z       != nullptr || count == 0);
+	assert(a_results != nullptr || count == 0);
+
+	unsigned int i = 0;
+
+#if defined(PERLIN_NOISE_USE_AVX512) || defined(PERLIN_NOISE_USE_AVX2)
+	const SeedsN seeds = { setI(m_seed_x1), setI(m_seed_x2),
+	                       setI(m_seed_y1), setI(m_seed_y2),
+	                       setI(m_seed_z1), setI(m_seed_z2),
+	                       setI(m_seed_q0), setI(m_seed_q1), setI(m_seed_q2),
+	                       (m_hash_mode == HASH_PERMUTATION) ? &m_table : nullptr };
+	const FloatN grid_size = setF(m_grid_size);
+	const FloatN amplitude = setF(m_amplitude);
+
+	for( ; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		FloatN unused_x, unused_y, unused_z;
+		FloatN value = perlinNoiseN(seeds, grid_size,
+		                            loadF(a_x + i), loadF(a_y + i), loadF(a_z + i),
+		                            false, unused_x, unused_y, unused_z);
+		storeF(a_results + i, mulF(value, amplitude));
+	}
+#endif
+
+	// any remaining points
+	for( ; i < count; i++)
+		a_results[i] = perlinNoise(a_x[i], a_y[i], a_z[i]);
+}
+
+void PerlinNoiseField3 :: perlinNoiseWithGradientBatch (const float a_x[],
+                                                        const float a_y[],
+                                                        const float a_z[],
+                                                        unsigned int count,
+                                                        float a_results[],
+                                                        float a_gradient_x[],
+                                                        float a_gradient_y[],
+                                                        float a_gradient_z[]) const
+{
+	assert(a_x          != nullptr || count == 0);
+	assert(a_y          != nullptr || count == 0);
+	assert(a_z          != nullptr || count == 0);
+	assert(a_results    != nullptr || count == 0);
+	assert(a_gradient_x != nullptr || count == 0);
+	assert(a_gradient_y != nullptr || count == 0);
+	assert(a_gradient_z != nullptr || count == 0);
+
+	unsigned int i = 0;
+
+#if defined(PERLIN_NOISE_USE_AVX512) || defined(PERLIN_NOISE_USE_AVX2)
+	const SeedsN seeds = { setI(m_seed_x1), setI(m_seed_x2),
+	                       setI(m_seed_y1), setI(m_seed_y2),
+	                       setI(m_seed_z1), setI(m_seed_z2),
+	                       setI(m_seed_q0), setI(m_seed_q1), setI(m_seed_q2),
+	                       (m_hash_mode == HASH_PERMUTATION) ? &m_table : nullptr };
+	const FloatN grid_size = setF(m_grid_size);
+	const FloatN amplitude = setF(m_amplitude);
+	const FloatN gradient_scale = setF(m_amplitude / m_grid_size);
+
+	for( ; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		FloatN gradient_x, gradient_y, gradient_z;
+		FloatN value = perlinNoiseN(seeds, grid_size,
+		                            loadF(a_x + i), loadF(a_y + i), loadF(a_z + i),
+		                            true, gradient_x, gradient_y, gradient_z);
+		storeF(a_results    + i, mulF(value,      amplitude));
+		storeF(a_gradient_x + i, mulF(gradient_x, gradient_scale));
+		storeF(a_gradient_y + i, mulF(gradient_y, gradient_scale));
+		storeF(a_gradient_z + i, mulF(gradient_z, gradient_scale));
+	}
+#endif
+
+	// any remaining points
+	for( ; i < count; i++)
+	{
+		Vector3 gradient;
+		a_results[i] = perlinNoiseWithGradient(a_x[i], a_y[i], a_z[i], gradient);
+		a_gradient_x[i] = (float)(gradient.x);
+		a_gradient_y[i] = (float)(gradient.y);
+		a_gradient_z[i] = (float)(gradient.z);
+	}
+}
+
+void PerlinNoiseField3 :: fbmNoiseBatch (const float a_x[],
+                                         const float a_y[],
+                                         const float a_z[],
+                                         unsigned int count,
+                                         const Octaves& octaves,
+                                         float a_results[]) const
+{
+	assert(a_x       != nullptr || count == 0);
+	assert(a_y       != nullptr || count == 0);
+	assert(a_z       != nullptr || count == 0);
+	assert(a_results != nullptr || count == 0);
+
+	for(unsigned int i = 0; i < count; i++)
+		a_results[i] = 0.0f;
+
+	unsigned int octave_count = getOctaveCount(octaves);
+	if(octave_count == 0 || count == 0)
+		return;
+
+	vector<float> v_x(count);
+	vector<float> v_y(count);
+	vector<float> v_z(count);
+	vector<float> v_value(count);
+
+	float total_weight = 0.0f;
+	float weight    = 1.0f;
+	float frequency = 1.0f;
+	for(unsigned int o = 0; o < octave_count; o++)
+	{
+		for(unsigned int i = 0; i < count; i++)
+		{
+			v_x[i] = a_x[i] * frequency;
+			v_y[i] = a_y[i] * frequency;
+			v_z[i] = a_z[i] * frequency;
+		}
+		perlinNoiseBatch(v_x.data(), v_y.data(), v_z.data(), count, v_value.data());
+		for(unsigned int i = 0; i < count; i++)
+			a_results[i] += v_value[i] * weight;
+
+		total_weight += weight;
+		weight    *= octaves.m_gain;
+		frequency *= octaves.m_lacunarity;
+	}
+
+	float scale = 1.0f / total_weight;
+	for(unsigned int i = 0; i < count; i++)
+		a_results[i] *= scale;
+}
+
+void PerlinNoiseField3 :: fbmNoiseWithGradientBatch (const float a_x[],
+                                                     const float a_y[],
+                                                     const float a_z[],
+                                                     unsigned int count,
+                                                     const Octaves& octaves,
+                                                     float a_results[],
+                                                     float a_gradient_x[],
+                                                     float a_gradient_y[],
+                                                     float a_gradient_z[]) const
+{
+	assert(a_x          != nullptr || count == 0);
+	assert(a_y          != nullptr || count == 0);
+	assert(a_z          != nullptr || count == 0);
+	assert(a_results    != nullptr || count == 0);
+	assert(a_gradient_x != nullptr || count == 0);
+	assert(a_gradient_y != nullptr || count == 0);
+	assert(a_gradient_z != nullptr || count == 0);
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		a_results   [i] = 0.0f;
+		a_gradient_x[i] = 0.0f;
+		a_gradient_y[i] = 0.0f;
+		a_gradient_z[i] = 0.0f;
+	}
+
+	unsigned int octave_count = getOctaveCount(octaves);
+	if(octave_count == 0 || count == 0)
+		return;
+
+	// each octave is a batch over all the points
+	vector<float> v_x(count);
+	vector<float> v_y(count);
+	vector<float> v_z(count);
+	vector<float> v_value(count);
+	vector<float> v_gradient_x(count);
+	vector<float> v_gradient_y(count);
+	vector<float> v_gradient_z(count);
+
+	float total_weight = 0.0f;
+	float weight    = 1.0f;
+	float frequency = 1.0f;
+	for(unsigned int o = 0; o < octave_count; o++)
+	{
+		for(unsigned int i = 0; i < count; i++)
+		{
+			v_x[i] = a_x[i] * frequency;
+			v_y[i] = a_y[i] * frequency;
+			v_z[i] = a_z[i] * frequency;
+		}
+		perlinNoiseWithGradientBatch(v_x.data(), v_y.data(), v_z.data(), count,
+		                             v_value.data(),
+		                             v_gradient_x.data(), v_gradient_y.data(), v_gradient_z.data());
+
+		// the gradient is scaled by the frequency because the position was
+		float gradient_weight = weight * frequency;
+		for(unsigned int i = 0; i < count; i++)
+		{
+			a_results   [i] += v_value     [i] * weight;
+			a_gradient_x[i] += v_gradient_x[i] * gradient_weight;
+			a_gradient_y[i] += v_gradient_y[i] * gradient_weight;
+			a_gradient_z[i] += v_gradient_z[i] * gradient_weight;
+		}
+
+		total_weight += weight;
+		weight    *= octaves.m_gain;
+		frequency *= octaves.m_lacunarity;
+	}
+
+	float scale = 1.0f / total_weight;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		a_results   [i] *= scale;
+		a_gradient_x[i] *= scale;
+		a_gradient_y[i] *= scale;
+		a_gradient_z[i] *= scale;
+	}
+}
+
 void PerlinNoiseField3 :: printPerlin (unsigned int print_rows,
                                        unsigned int print_columns,
                                        float interval) const
@@ -288,6 +1092,19 @@ void PerlinNoiseField3 :: setSeeds (unsigned int seed_x1,
 	m_seed_q0 = seed_q0;
 	m_seed_q1 = seed_q1;
 	m_seed_q2 = seed_q2;
+	if(m_hash_mode == HASH_PERMUTATION)
+		buildPermutationTable();
+
+	assert(invariant());
+}
+
+void PerlinNoiseField3 :: setHashMode (unsigned int hash_mode)
+{
+	assert(hash_mode == HASH_SEEDED || hash_mode == HASH_PERMUTATION);
+
+	m_hash_mode = hash_mode;
+	if(m_hash_mode == HASH_PERMUTATION)
+		buildPermutationTable();
 
 	assert(invariant());
 }
@@ -296,16 +1113,14 @@ void PerlinNoiseField3 :: setSeeds (unsigned int seed_x1,
 
 unsigned int PerlinNoiseField3 :: pseudorandom (int x, int y, int z) const
 {
-	unsigned int n = (m_seed_x1 * x) +
-	                 (m_seed_y1 * y) +
-	                 (m_seed_z1 * z);
-	unsigned int quad_term = m_seed_q2 * n * n +
-	                         m_seed_q1 * n     +
-	                         m_seed_q0;
-	return quad_term +
-	       (m_seed_x2 * x) +
-	       (m_seed_y2 * y) +
-	       (m_seed_z2 * z);
+	if(m_hash_mode == HASH_PERMUTATION)
+		return m_table.ma_values[m_table.hash(x, y, z)];
+
+	return PermutationTable::seededHash(m_seed_x1, m_seed_x2,
+	                                    m_seed_y1, m_seed_y2,
+	                                    m_seed_z1, m_seed_z2,
+	                                    m_seed_q0, m_seed_q1, m_seed_q2,
+	                                    x, y, z);
 }
 
 float PerlinNoiseField3 :: unsignedIntTo01 (unsigned int n) const
@@ -326,6 +1141,11 @@ float PerlinNoiseField3 :: fade (float n) const
 	return (1 - cos(n * 3.14159265f)) * 0.5f;
 }
 
+float PerlinNoiseField3 :: fadeDerivative (float n) const
+{
+	return sin(n * 3.14159265f) * 3.14159265f * 0.5f;
+}
+
 unsigned int PerlinNoiseField3 :: interpolate (unsigned int v0,
                                                unsigned int v1,
                                                float fraction) const
@@ -342,14 +1162,78 @@ float PerlinNoiseField3 :: interpolate (float v0,
 	       (v1 *         fraction );
 }
 
+ObjLibrary::Vector3 PerlinNoiseField3 :: interpolate (const ObjLibrary::Vector3& v0,
+                                                      const ObjLibrary::Vector3& v1,
+                                                      float fraction) const
+{
+	return (v0 * (1.0f - fraction)) +
+	       (v1 *         fraction );
+}
+
 ObjLibrary::Vector3 PerlinNoiseField3 :: lattice (int x, int y, int z) const
 {
+	if(m_hash_mode == HASH_PERMUTATION)
+	{
+		unsigned int hash = m_table.hash(x, y, z);
+		return Vector3(m_table.ma_gradient_x[hash],
+		               m_table.ma_gradient_y[hash],
+		               m_table.ma_gradient_z[hash]);
+	}
+
 	unsigned int value1 = pseudorandom(x, y, z);
 	unsigned int value2 = pseudorandom(x + 1, y + 1, z + 1);  //  <|>
 	return Vector3::getPseudorandomUnitVector(unsignedIntTo01(value1),
 	                                          unsignedIntTo01(value2));
 }
 
+void PerlinNoiseField3 :: buildPermutationTable ()
+{
+	m_table = PermutationTable::create(m_seed_x1, m_seed_x2,
+	                                   m_seed_y1, m_seed_y2,
+	                                   m_seed_z1, m_seed_z2,
+	                                   m_seed_q0, m_seed_q1, m_seed_q2);
+}
+
+float PerlinNoiseField3 :: calculateFractal (float x, float y, float z,
+                                             const Octaves& octaves,
+                                             unsigned int shape) const
+{
+	assert(shape == FRACTAL_FBM || shape == FRACTAL_TURBULENCE || shape == FRACTAL_RIDGED);
+
+	unsigned int octave_count = getOctaveCount(octaves);
+	float amplitude = fabs(m_amplitude);
+	if(octave_count == 0 || amplitude == 0.0f)
+		return 0.0f;
+
+	float sum          = 0.0f;
+	float total_weight = 0.0f;
+	float weight    = 1.0f;
+	float frequency = 1.0f;
+	for(unsigned int o = 0; o < octave_count; o++)
+	{
+		float noise = perlinNoise(x * frequency, y * frequency, z * frequency);
+		if(shape == FRACTAL_FBM)
+			sum += noise * weight;
+		else if(shape == FRACTAL_TURBULENCE)
+			sum += fabs(noise) * weight;
+		else
+		{
+			// sharp crests where the noise crosses 0
+			float ridge = amplitude - fabs(noise);
+			sum += ridge * ridge / amplitude * weight;
+		}
+
+		total_weight += weight;
+		weight    *= octaves.m_gain;
+		frequency *= octaves.m_lacunarity;
+	}
+
+	float result = sum / total_weight;
+	if(shape == FRACTAL_RIDGED)
+		result = result * 2.0f - amplitude;  // [0, amplitude] -> [-amplitude, amplitude]
+	return result;
+}
+
 void PerlinNoiseField3 :: printValue (float value) const
 {
 	assert(value >= -1.0f);
@@ -375,5 +1259,6 @@ void PerlinNoiseField3 :: printValue (float value) const
 bool PerlinNoiseField3 :: invariant () const
 {
 	if(m_grid_size <= 0.0) return false;
+	if(m_hash_mode != HASH_SEEDED && m_hash_mode != HASH_PERMUTATION) return false;
 	return true;
 }
@@ -8,6 +8,7 @@
 
 #include "ObjLibrary/Vector3.h"
 
+#include "PermutationTable.h"
 
 
 //
@@ -15,11 +16,100 @@
 //
 //  A class to calculate 3D value noise and Perlin noise.
 //
+//  Noise can be calculated one point at a time, or for many
+//    points at once with valueNoiseBatch and perlinNoiseBatch.
+//    The batch functions take arrays of floats and use AVX-512
+//    (16 points at a time) or AVX2 (8 points at a time) when
+//    the compiler is targeting them, e.g. with -mavx2 or
+//    -march=native.  Otherwise, they call the single-point
+//    functions for each point.
+//
+//  The SIMD kernels calculate in float with polynomial
+//    approximations of sine and cosine, instead of the double
+//    lattice vectors and library cosine used by the single-point
+//    functions.  Their results match the single-point functions
+//    within BATCH_TOLERANCE * getAmplitude(), and their
+//    gradients match within BATCH_TOLERANCE * getAmplitude() /
+//    getGridSize().  The lattice cells and pseudorandom values
+//    are calculated exactly the same way, so the error does not
+//    grow with distance from the origin.
+//
+//  Fractal noise is the sum of several octaves of Perlin noise,
+//    each with its frequency multiplied by the lacunarity and its
+//    amplitude multiplied by the gain.  It is divided by the
+//    total amplitude of the octaves used, so it has the same
+//    range as the noise it is built from.  Octaves can be
+//    skipped if they would be too small to show, usually
+//    because they are finer than the vertex spacing of the mesh
+//    being deformed.  See Octaves.
+//
+//  Lattice points are hashed in one of two ways.  By default
+//    (HASH_SEEDED), the nine seeds are combined with
+//    multiplications for every lattice point, and the lattice
+//    vector is calculated from the hash with trigonometry.  With
+//    HASH_PERMUTATION, the seeds are used once to build a
+//    PermutationTable, and each lattice point is 3 table lookups.
+//    This is faster, but the noise is different and repeats
+//    every PermutationTable::SIZE cells.  The batch functions
+//    support both modes.
+//
+//  InstancedAsteroids repeats perlinNoise, getOctaveCount, and
+//    fbmNoise in GLSL.  It takes the seeds, hash mode, and
+//    permutation table from here, but a change to how those
+//    are used must also be made there.
+//
 //  Class Invariant:
 //    <1> m_grid_size > 0.0
+//    <2> m_hash_mode == HASH_SEEDED ||
+//        m_hash_mode == HASH_PERMUTATION
 //
 class PerlinNoiseField3
 {
+public:
+	static const float BATCH_TOLERANCE;
+	static unsigned int getBatchWidth ();
+
+	static const unsigned int HASH_SEEDED      = 0;
+	static const unsigned int HASH_PERMUTATION = 1;
+
+	static const unsigned int SEED_COUNT = 9;
+
+	static const unsigned int DEFAULT_SEED_X1 = 1273472206;
+	static const unsigned int DEFAULT_SEED_X2 = 4278162623;
+	static const unsigned int DEFAULT_SEED_Y1 = 1440014778;
+	static const unsigned int DEFAULT_SEED_Y2 =  524485263;
+	static const unsigned int DEFAULT_SEED_Z1 = 2813546167;
+	static const unsigned int DEFAULT_SEED_Z2 = 3305132234;
+	static const unsigned int DEFAULT_SEED_Q0 = 1498573726;
+	static const unsigned int DEFAULT_SEED_Q1 = 3476519523;
+	static const unsigned int DEFAULT_SEED_Q2 = 3905844518;
+
+	//
+	//  Octaves
+	//
+	//  A record to specify the octaves for fractal noise.  Octave
+	//    i has a grid size of grid_size / lacunarity^i and an
+	//    amplitude of amplitude * gain^i.  Octaves after the first
+	//    are skipped if their grid size is less than
+	//    m_min_grid_size, or if their amplitude is less than
+	//    m_min_amplitude after the total is scaled to the noise
+	//    amplitude.  Since the gain is less than 1, all octaves
+	//    after a skipped octave are also skipped.
+	//
+	struct Octaves
+	{
+		unsigned int m_count;
+		float m_lacunarity;     // > 1.0
+		float m_gain;           // > 0.0 and < 1.0
+		float m_min_grid_size;  // 0.0 to never skip for size
+		float m_min_amplitude;  // 0.0 to never skip for amplitude
+
+		Octaves ();
+		Octaves (unsigned int count,
+		         float lacunarity,
+		         float gain);
+	};
+
 public:
 	PerlinNoiseField3 ();
 	PerlinNoiseField3 (float grid_size,
@@ -41,8 +131,59 @@ public:
 
 	float getGridSize () const;
 	float getAmplitude () const;
+	unsigned int getHashMode () const;
+	// x1, x2, y1, y2, z1, z2, q0, q1, q2
+	void getSeeds (unsigned int a_seeds[SEED_COUNT]) const;
+	// only filled in for HASH_PERMUTATION
+	const PermutationTable& getPermutationTable () const;
 	float valueNoise (float x, float y, float z) const;
 	float perlinNoise (float x, float y, float z) const;
+	// same value as perlinNoise, r_gradient is set to its derivative
+	float perlinNoiseWithGradient (float x, float y, float z,
+	                               ObjLibrary::Vector3& r_gradient) const;
+
+	unsigned int getOctaveCount (const Octaves& octaves) const;
+	float fbmNoise (float x, float y, float z,
+	                const Octaves& octaves) const;
+	float turbulenceNoise (float x, float y, float z,
+	                       const Octaves& octaves) const;
+	float ridgedNoise (float x, float y, float z,
+	                   const Octaves& octaves) const;
+
+	// a_x[i], a_y[i], a_z[i] -> a_results[i] for i < count
+	void valueNoiseBatch (const float a_x[],
+	                      const float a_y[],
+	                      const float a_z[],
+	                      unsigned int count,
+	                      float a_results[]) const;
+	void perlinNoiseBatch (const float a_x[],
+	                       const float a_y[],
+	                       const float a_z[],
+	                       unsigned int count,
+	                       float a_results[]) const;
+	void perlinNoiseWithGradientBatch (const float a_x[],
+	                                   const float a_y[],
+	                                   const float a_z[],
+	                                   unsigned int count,
+	                                   float a_results[],
+	                                   float a_gradient_x[],
+	                                   float a_gradient_y[],
+	                                   float a_gradient_z[]) const;
+	void fbmNoiseBatch (const float a_x[],
+	                    const float a_y[],
+	                    const float a_z[],
+	                    unsigned int count,
+	                    const Octaves& octaves,
+	                    float a_results[]) const;
+	void fbmNoiseWithGradientBatch (const float a_x[],
+	                                const float a_y[],
+	                                const float a_z[],
+	                                unsigned int count,
+	                                const Octaves& octaves,
+	                                float a_results[],
+	                                float a_gradient_x[],
+	                                float a_gradient_y[],
+	                                float a_gradient_z[]) const;
 
 	void printPerlin (unsigned int print_rows,
 	                  unsigned int print_columns,
@@ -50,6 +191,8 @@ public:
 
 	void setGridSize (float grid_size);
 	void setAmplitude (float amplitude);
+	// HASH_PERMUTATION builds the table from the current seeds
+	void setHashMode (unsigned int hash_mode);
 	void setSeeds (unsigned int seed_x1,
 	               unsigned int seed_x2,
 	               unsigned int seed_y1,
@@ -66,13 +209,21 @@ private:
 	float unsignedIntTo01 (unsigned int n) const;
 	float unsignedIntToPM1 (unsigned int n) const;
 	float fade (float n) const;
+	float fadeDerivative (float n) const;
 	unsigned int interpolate (unsigned int v0,
 	                          unsigned int v1,
 	                          float fraction) const;
 	float interpolate (float v0,
 	                   float v1,
 	                   float fraction) const;
+	ObjLibrary::Vector3 interpolate (const ObjLibrary::Vector3& v0,
+	                                 const ObjLibrary::Vector3& v1,
+	                                 float fraction) const;
 	ObjLibrary::Vector3 lattice (int x, int y, int z) const;
+	void buildPermutationTable ();
+	float calculateFractal (float x, float y, float z,
+	                        const Octaves& octaves,
+	                        unsigned int shape) const;
 	void printValue (float value) const;
 	bool invariant () const;
 
@@ -88,4 +239,6 @@ private:
 	unsigned int m_seed_q0;
 	unsigned int m_seed_q1;
 	unsigned int m_seed_q2;
+	unsigned int m_hash_mode;
+	PermutationTable m_table;  // only used for HASH_PERMUTATION
 };
@@ -0,0 +1,228 @@
+//
+//  PermutationTable.h
+//
+//  A module to hash lattice points with lookup tables.
+//
+
+#pragma once
+
+
+
+//
+//  PermutationTable
+//
+//  A record to store the tables for the classic permutation
+//    hash used by Perlin noise.  A lattice point (x, y, z) is
+//    hashed by looking up each coordinate in turn in a
+//    permutation of [0, SIZE).  The hash then selects a
+//    precalculated pseudorandom value and a precalculated unit
+//    lattice vector, so no multiplications or trigonometry are
+//    needed per lattice point.  The noise repeats every SIZE
+//    cells along each axis.
+//
+//  The tables are calculated from the same nine seeds as
+//    PerlinNoiseField3 uses.  Everything is constexpr, so a
+//    table for seeds known at compile time can be calculated by
+//    the compiler (see DefaultPerlinNoiseField3).  The same
+//    seeds always produce the same table, whether it is
+//    calculated at compile time or run time.
+//
+struct PermutationTable
+{
+	static const unsigned int SIZE = 256;
+	static const unsigned int MASK = SIZE - 1;
+
+	// each entry is stored twice so sums of entries need no wrapping
+	int ma_permutation[SIZE * 2];
+	unsigned int ma_values[SIZE];
+	float ma_gradient_x[SIZE];
+	float ma_gradient_y[SIZE];
+	float ma_gradient_z[SIZE];
+
+//
+//  hash
+//
+//  Purpose: To determine the table entry for a lattice point.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The lattice point
+//  Preconditions: N/A
+//  Returns: The index into ma_values and the gradient tables
+//           for lattice point (x, y, z).  The index is in
+//           [0, SIZE).
+//  Side Effect: N/A
+//
+	constexpr unsigned int hash (int x, int y, int z) const
+	{
+		return ma_permutation[ma_permutation[ma_permutation[x & MASK] + (y & MASK)] + (z & MASK)];
+	}
+
+//
+//  seededHash
+//
+//  Purpose: To calculate the multiplicative hash of a lattice
+//           point that PerlinNoiseField3 uses by default.
+//  Parameter(s):
+//    <1> seed_x1
+//    <2> seed_x2
+//    <3> seed_y1
+//    <4> seed_y2
+//    <5> seed_z1
+//    <6> seed_z2
+//    <7> seed_q0
+//    <8> seed_q1
+//    <9> seed_q2: The seeds
+//    <10> x
+//    <11> y
+//    <12> z: The lattice point
+//  Preconditions: N/A
+//  Returns: The pseudorandom value for lattice point (x, y, z).
+//  Side Effect: N/A
+//
+	static constexpr unsigned int seededHash (unsigned int seed_x1,
+	                                          unsigned int seed_x2,
+	                                          unsigned int seed_y1,
+	                                          unsigned int seed_y2,
+	                                          unsigned int seed_z1,
+	                                          unsigned int seed_z2,
+	                                          unsigned int seed_q0,
+	                                          unsigned int seed_q1,
+	                                          unsigned int seed_q2,
+	                                          int x, int y, int z)
+	{
+		unsigned int n = (seed_x1 * x) +
+		                 (seed_y1 * y) +
+		                 (seed_z1 * z);
+		unsigned int quad_term = seed_q2 * n * n +
+		                         seed_q1 * n     +
+		                         seed_q0;
+		return quad_term +
+		       (seed_x2 * x) +
+		       (seed_y2 * y) +
+		       (seed_z2 * z);
+	}
+
+//
+//  create
+//
+//  Purpose: To calculate the tables for a set of seeds.
+//  Parameter(s):
+//    <1> seed_x1
+//    <2> seed_x2
+//    <3> seed_y1
+//    <4> seed_y2
+//    <5> seed_z1
+//    <6> seed_z2
+//    <7> seed_q0
+//    <8> seed_q1
+//    <9> seed_q2: The seeds
+//  Preconditions: N/A
+//  Returns: A PermutationTable for the seeds.  The
+//           permutation is a Fisher-Yates shuffle driven by
+//           seededHash, and the lattice vectors are distributed
+//           evenly over the unit sphere the same way as
+//           Vector3::getPseudorandomUnitVector.
+//  Side Effect: N/A
+//
+	static constexpr PermutationTable create (unsigned int seed_x1,
+	                                          unsigned int seed_x2,
+	                                          unsigned int seed_y1,
+	                                          unsigned int seed_y2,
+	                                          unsigned int seed_z1,
+	                                          unsigned int seed_z2,
+	                                          unsigned int seed_q0,
+	                                          unsigned int seed_q1,
+	                                          unsigned int seed_q2)
+	{
+		PermutationTable table = {};
+
+		for(unsigned int i = 0; i < SIZE; i++)
+			table.ma_permutation[i] = (int)(i);
+		for(unsigned int i = SIZE - 1; i > 0; i--)
+		{
+			unsigned int j = seededHash(seed_x1, seed_x2, seed_y1, seed_y2, seed_z1, seed_z2,
+			                            seed_q0, seed_q1, seed_q2, 0, 0, (int)(i)) % (i + 1);
+			int swapped = table.ma_permutation[i];
+			table.ma_permutation[i] = table.ma_permutation[j];
+			table.ma_permutation[j] = swapped;
+		}
+		for(unsigned int i = 0; i < SIZE; i++)
+			table.ma_permutation[i + SIZE] = table.ma_permutation[i];
+
+		for(unsigned int i = 0; i < SIZE; i++)
+		{
+			table.ma_values[i] = seededHash(seed_x1, seed_x2, seed_y1, seed_y2, seed_z1, seed_z2,
+			                                seed_q0, seed_q1, seed_q2, 0, (int)(i), 0);
+
+			double seed1 = seededHash(seed_x1, seed_x2, seed_y1, seed_y2, seed_z1, seed_z2,
+			                          seed_q0, seed_q1, seed_q2, (int)(i), 0, 0) / 4294967295.0;
+			double seed2 = seededHash(seed_x1, seed_x2, seed_y1, seed_y2, seed_z1, seed_z2,
+			                          seed_q0, seed_q1, seed_q2, (int)(i) + 1, 1, 1) / 4294967295.0;
+			double z = seed2 * 2.0 - 1.0;
+			double radius_xy = squareRoot(1.0 - z * z);
+			table.ma_gradient_x[i] = (float)(radius_xy * cosTurns(seed1));
+			table.ma_gradient_y[i] = (float)(radius_xy * sinTurns(seed1));
+			table.ma_gradient_z[i] = (float)(z);
+		}
+		return table;
+	}
+
+//
+//  squareRoot
+//  cosTurns
+//  sinTurns
+//
+//  Purpose: To calculate square roots, cosines, and sines in a
+//           constant expression, where the <cmath> functions
+//           cannot be used.  Angles are measured in turns
+//           (1.0 == 2 * pi radians).
+//  Parameter(s):
+//    <1> n: The value
+//    <1> turns: The angle
+//  Preconditions:
+//    <1> n >= 0.0 && n <= 1.0
+//    <1> turns >= 0.0 && turns <= 1.0
+//  Returns: The square root of n, or the cosine or sine of
+//           turns, to within double rounding error.
+//  Side Effect: N/A
+//
+	static constexpr double squareRoot (double n)
+	{
+		if(n <= 0.0)
+			return 0.0;
+
+		// Newton's method converges from above
+		double root = 1.0;
+		for(unsigned int i = 0; i < 64; i++)
+			root = (root + n / root) * 0.5;
+		return root;
+	}
+
+	static constexpr double cosTurns (double turns)
+	{
+		// cos(a + pi) == -cos(a), with a in [-pi, pi] for the Taylor series
+		double a = (turns - 0.5) * 6.283185307179586476925286766559;
+		double term = 1.0;
+		double sum  = 1.0;
+		for(unsigned int i = 2; i < 60; i += 2)
+		{
+			term *= -a * a / (i * (i - 1));
+			sum  += term;
+		}
+		return -sum;
+	}
+
+	static constexpr double sinTurns (double turns)
+	{
+		double a = (turns - 0.5) * 6.283185307179586476925286766559;
+		double term = a;
+		double sum  = a;
+		for(unsigned int i = 3; i < 60; i += 2)
+		{
+			term *= -a * a / (i * (i - 1));
+			sum  += term;
+		}
+		return -sum;
+	}
+};
@@ -0,0 +1,160 @@
+//
+//  PngWriter.cpp
+//
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "PngWriter.h"
+
+using namespace std;
+
+
+
+namespace
+{
+	const unsigned int STORED_BLOCK_MAX = 0xFFFF;  // largest uncompressed deflate block
+	const uint32_t ADLER_MODULUS = 65521;
+
+	uint32_t ga_crc_table[256];
+	bool g_is_crc_table_ready = false;
+
+	void initCrcTable ()
+	{
+		for(uint32_t n = 0; n < 256; n++)
+		{
+			uint32_t c = n;
+			for(unsigned int k = 0; k < 8; k++)
+			{
+				if(c & 1)
+					c = 0xEDB88320u ^ (c >> 1);
+				else
+					c = c >> 1;
+			}
+			ga_crc_table[n] = c;
+		}
+		g_is_crc_table_ready = true;
+	}
+
+	uint32_t calculateCrc (const unsigned char* a_bytes,
+	                       size_t count)
+	{
+		assert(g_is_crc_table_ready);
+		assert(a_bytes != NULL);
+
+		uint32_t crc = 0xFFFFFFFFu;
+		for(size_t i = 0; i < count; i++)
+			crc = ga_crc_table[(crc ^ a_bytes[i]) & 0xFF] ^ (crc >> 8);
+		return crc ^ 0xFFFFFFFFu;
+	}
+
+	void appendBigEndian (vector<unsigned char>& rv_bytes,
+	                      uint32_t value)
+	{
+		rv_bytes.push_back((unsigned char)(value >> 24));
+		rv_bytes.push_back((unsigned char)(value >> 16));
+		rv_bytes.push_back((unsigned char)(value >>  8));
+		rv_bytes.push_back((unsigned char)(value      ));
+	}
+
+	void appendChunk (vector<unsigned char>& rv_file,
+	                  const char* type,
+	                  const vector<unsigned char>& v_data)
+	{
+		assert(type != NULL);
+
+		appendBigEndian(rv_file, (uint32_t)(v_data.size()));
+		size_t crc_start = rv_file.size();  // CRC covers the type and data
+		rv_file.insert(rv_file.end(), type, type + 4);
+		rv_file.insert(rv_file.end(), v_data.begin(), v_data.end());
+
+		uint32_t crc = calculateCrc(rv_file.data() + crc_start, rv_file.size() - crc_start);
+		appendBigEndian(rv_file, crc);
+	}
+
+}  // end of anonymous namespace
+
+
+
+bool writePng (const std::string& filename,
+               unsigned int width,
+               unsigned int height,
+               const std::vector<unsigned char>& v_rgba,
+               bool is_bottom_up)
+{
+	assert(width  > 0);
+	assert(height > 0);
+	assert(v_rgba.size() == (size_t)(width) * height * 4);
+
+	if(!g_is_crc_table_ready)
+		initCrcTable();
+
+	// each row starts with filter type 0 (none)
+	size_t row_bytes = (size_t)(width) * 4;
+	vector<unsigned char> v_raw;
+	v_raw.reserve((row_bytes + 1) * height);
+	for(unsigned int y = 0; y < height; y++)
+	{
+		unsigned int source_row = is_bottom_up ? (height - 1 - y) : y;
+		const unsigned char* p_row = v_rgba.data() + source_row * row_bytes;
+		v_raw.push_back(0);
+		v_raw.insert(v_raw.end(), p_row, p_row + row_bytes);
+	}
+
+	// zlib stream of stored (uncompressed) deflate blocks
+	vector<unsigned char> v_zlib;
+	v_zlib.reserve(v_raw.size() + v_raw.size() / STORED_BLOCK_MAX * 5 + 16);
+	v_zlib.push_back(0x78);  // deflate, 32K window
+	v_zlib.push_back(0x01);  // no preset dictionary, check bits
+	size_t position = 0;
+	do
+	{
+		size_t length = v_raw.size() - position;
+		if(length > STORED_BLOCK_MAX)
+			length = STORED_BLOCK_MAX;
+		bool is_final = (position + length == v_raw.size());
+
+		v_zlib.push_back(is_final ? 1 : 0);
+		v_zlib.push_back((unsigned char)(length     ));
+		v_zlib.push_back((unsigned char)(length >> 8));
+		v_zlib.push_back((unsigned char)(~length     ));
+		v_zlib.push_back((unsigned char)(~length >> 8));
+		v_zlib.insert(v_zlib.end(), v_raw.begin() + position, v_raw.begin() + position + length);
+		position += length;
+	}
+	while(position < v_raw.size());
+
+	uint32_t adler_a = 1;
+	uint32_t adler_b = 0;
+	for(size_t i = 0; i < v_raw.size(); i++)
+	{
+		adler_a = (adler_a + v_raw[i]) % ADLER_MODULUS;
+		adler_b = (adler_b + adler_a)  % ADLER_MODULUS;
+	}
+	appendBigEndian(v_zlib, (adler_b << 16) | adler_a);
+
+	// header: size, 8 bits per channel, RGBA, default compression/filter, no interlace
+	vector<unsigned char> v_header;
+	appendBigEndian(v_header, width);
+	appendBigEndian(v_header, height);
+	v_header.push_back(8);
+	v_header.push_back(6);
+	v_header.push_back(0);
+	v_header.push_back(0);
+	v_header.push_back(0);
+
+	static const unsigned char A_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	vector<unsigned char> v_file(A_SIGNATURE, A_SIGNATURE + 8);
+	appendChunk(v_file, "IHDR", v_header);
+	appendChunk(v_file, "IDAT", v_zlib);
+	appendChunk(v_file, "IEND", vector<unsigned char>());
+
+	ofstream output(filename.c_str(), ios::binary);
+	if(!output)
+		return false;
+	output.write((const char*)(v_file.data()), v_file.size());
+	return (bool)(output);
+}
@@ -0,0 +1,42 @@
+//
+//  PngWriter.h
+//
+//  A module to save images as PNG files.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+
+//
+//  writePng
+//
+//  Purpose: To save an RGBA image as a PNG file.
+//  Parameter(s):
+//    <1> filename: The name of the file to write
+//    <2> width
+//    <3> height: The size of the image in pixels
+//    <4> v_rgba: The pixels, 4 bytes per pixel, row by row
+//    <5> is_bottom_up: Whether the first row in v_rgba is the
+//                      bottom of the image, as returned by
+//                      glReadPixels
+//  Precondition(s):
+//    <1> width > 0
+//    <2> height > 0
+//    <3> v_rgba.size() == width * height * 4
+//  Returns: Whether the file was written successfully.
+//  Side Effect: The image is written to filename, replacing
+//               any existing file.  The image data is stored
+//               without compression, so the files are large but
+//               quick to write, and identical images always
+//               give identical files.
+//
+
+bool writePng (const std::string& filename,
+               unsigned int width,
+               unsigned int height,
+               const std::vector<unsigned char>& v_rgba,
+               bool is_bottom_up);
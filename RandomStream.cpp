@@ -0,0 +1,158 @@
+//
+//  RandomStream.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#include "ObjLibrary/Vector3.h"
+#include "RandomStream.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	// keep keys for seeds, streams, and substreams apart
+	const uint64_t SEED_SALT      = 0x243F6A8885A308D3ull;
+	const uint64_t STREAM_SALT    = 0x13198A2E03707344ull;
+	const uint64_t SUBSTREAM_SALT = 0xA4093822299F31D0ull;
+
+	const double TWO_PI = 6.283185307179586;
+
+	// top 53 bits, so every double in [0, 1) is equally likely
+	inline double toUnitInterval (uint64_t value)
+	{
+		return (double)(value >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	// same construction as Vector3::getPseudorandomUnitVector
+	inline Vector3 toUnitVector (double u, double v)
+	{
+		double z      = u * 2.0 - 1.0;
+		double radius = sqrt(1.0 - z * z);
+		double angle  = v * TWO_PI;
+		return Vector3(cos(angle) * radius, sin(angle) * radius, z);
+	}
+
+}  // end of anonymous namespace
+
+
+
+uint64_t RandomStream :: mix (uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+
+
+RandomStream :: RandomStream ()
+		: RandomStream(0, 0)
+{
+}
+
+RandomStream :: RandomStream (uint64_t seed)
+		: RandomStream(seed, 0)
+{
+}
+
+RandomStream :: RandomStream (uint64_t seed,
+                              uint64_t stream)
+		: m_key(mix(mix(seed + SEED_SALT) ^ mix(stream + STREAM_SALT)))
+		, m_counter(0)
+{
+}
+
+
+
+RandomStream RandomStream :: getSubstream (uint64_t index) const
+{
+	RandomStream substream;
+	substream.m_key = mix(m_key ^ mix(index + SUBSTREAM_SALT));
+	return substream;
+}
+
+uint64_t RandomStream :: getValueAt (uint64_t counter) const
+{
+	return mix(m_key + (counter + 1) * GOLDEN_GAMMA);
+}
+
+
+
+uint64_t RandomStream :: next ()
+{
+	uint64_t value = getValueAt(m_counter);
+	m_counter++;
+	return value;
+}
+
+double RandomStream :: random01 ()
+{
+	return toUnitInterval(next());
+}
+
+double RandomStream :: random2 (double min_value,
+                                double max_value)
+{
+	assert(min_value <= max_value);
+
+	return min_value + random01() * (max_value - min_value);
+}
+
+Vector3 RandomStream :: randomUnitVector ()
+{
+	double u = random01();
+	double v = random01();
+	return toUnitVector(u, v);
+}
+
+Vector3 RandomStream :: randomSphereVector ()
+{
+	Vector3 direction = randomUnitVector();
+	return direction * cbrt(random01());
+}
+
+void RandomStream :: random01Batch (double a_results[],
+                                    unsigned int count)
+{
+	assert(a_results != nullptr || count == 0);
+
+	// no dependency between iterations, so this vectorizes
+	uint64_t base = m_key + (m_counter + 1) * GOLDEN_GAMMA;
+	for(unsigned int i = 0; i < count; i++)
+		a_results[i] = toUnitInterval(mix(base + i * GOLDEN_GAMMA));
+	m_counter += count;
+}
+
+void RandomStream :: randomUnitVectorBatch (Vector3 a_results[],
+                                            unsigned int count)
+{
+	assert(a_results != nullptr || count == 0);
+
+	uint64_t base = m_key + (m_counter + 1) * GOLDEN_GAMMA;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		uint64_t position = base + (uint64_t)(i) * 2 * GOLDEN_GAMMA;
+		a_results[i] = toUnitVector(toUnitInterval(mix(position)),
+		                            toUnitInterval(mix(position + GOLDEN_GAMMA)));
+	}
+	m_counter += (uint64_t)(count) * 2;
+}
+
+void RandomStream :: randomSphereVectorBatch (Vector3 a_results[],
+                                              unsigned int count)
+{
+	assert(a_results != nullptr || count == 0);
+
+	uint64_t base = m_key + (m_counter + 1) * GOLDEN_GAMMA;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		uint64_t position = base + (uint64_t)(i) * 3 * GOLDEN_GAMMA;
+		Vector3 direction = toUnitVector(toUnitInterval(mix(position)),
+		                                 toUnitInterval(mix(position + GOLDEN_GAMMA)));
+		a_results[i] = direction * cbrt(toUnitInterval(mix(position + 2 * GOLDEN_GAMMA)));
+	}
+	m_counter += (uint64_t)(count) * 3;
+}
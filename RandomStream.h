@@ -0,0 +1,221 @@
+//
+//  RandomStream.h
+//
+//  A module to generate reproducible random numbers.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  RandomStream
+//
+//  A class to generate a stream of pseudorandom numbers that
+//    depends only on a key and a position (the counter), not on
+//    anything global.  Value i of a stream is the SplitMix64
+//    mixing function applied to key + (i + 1) * GOLDEN_GAMMA,
+//    so values can be calculated in any order and by any
+//    thread.  Each RandomStream should only be used by one
+//    thread at a time, but different RandomStreams can be used
+//    at once.
+//
+//  A RandomStream can be split into numbered substreams with
+//    getSubstream.  Each substream has its own key, mixed from
+//    the parent key and the substream number.  If entity i is
+//    generated from substream i of a world stream, its values
+//    do not depend on how many values the other entities used,
+//    what order they were generated in, or which thread
+//    generated them.
+//
+//  This is not a cryptographic generator.
+//
+class RandomStream
+{
+public:
+	static const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+//
+//  Class Function: mix
+//
+//  Purpose: To scramble a 64-bit value.
+//  Parameter(s):
+//    <1> value: The value to scramble
+//  Preconditions: N/A
+//  Returns: The SplitMix64 finalizer of value.  Every bit of
+//           the result depends on every bit of value.
+//  Side Effect: N/A
+//
+	static uint64_t mix (uint64_t value);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a RandomStream with seed 0.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new RandomStream is created for seed 0 and
+//               stream 0, starting at counter 0.
+//
+	RandomStream ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a RandomStream for a seed.
+//  Parameter(s):
+//    <1> seed: The seed
+//    <2> stream: Which stream for the seed, 0 if omitted
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new RandomStream is created for stream
+//               stream of seed seed, starting at counter 0.
+//               Nearby seeds and streams give unrelated values.
+//
+	RandomStream (uint64_t seed);
+	RandomStream (uint64_t seed,
+	              uint64_t stream);
+
+	RandomStream (const RandomStream& to_copy) = default;
+	~RandomStream () = default;
+	RandomStream& operator= (const RandomStream& to_copy) = default;
+
+//
+//  getCounter
+//
+//  Purpose: To determine how many values have been used from
+//           this RandomStream.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The counter for the next value.
+//  Side Effect: N/A
+//
+	uint64_t getCounter () const
+	{	return m_counter;	}
+
+//
+//  getSubstream
+//
+//  Purpose: To create an independent stream from this
+//           RandomStream.
+//  Parameter(s):
+//    <1> index: Which substream
+//  Preconditions: N/A
+//  Returns: Substream index of this RandomStream, starting at
+//           counter 0.  The substream depends on the key of
+//           this RandomStream and index, but not on its
+//           counter.
+//  Side Effect: N/A
+//
+	RandomStream getSubstream (uint64_t index) const;
+
+//
+//  getValueAt
+//
+//  Purpose: To calculate a value anywhere in this RandomStream.
+//  Parameter(s):
+//    <1> counter: The position of the value
+//  Preconditions: N/A
+//  Returns: The 64-bit value at position counter.
+//  Side Effect: N/A
+//
+	uint64_t getValueAt (uint64_t counter) const;
+
+//
+//  next
+//
+//  Purpose: To generate a 64-bit value.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The value at the current counter.
+//  Side Effect: The counter is advanced by 1.
+//
+	uint64_t next ();
+
+//
+//  random01
+//
+//  Purpose: To generate a random number in [0, 1).
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: A uniformly distributed value with 53 random
+//           bits.  It may be 0.0, but not 1.0.
+//  Side Effect: The counter is advanced by 1.
+//
+	double random01 ();
+
+//
+//  random2
+//
+//  Purpose: To generate a random number in an interval.
+//  Parameter(s):
+//    <1> min_value: The lower bound
+//    <2> max_value: The upper bound
+//  Preconditions:
+//    <1> min_value <= max_value
+//  Returns: A uniformly distributed value in
+//           [min_value, max_value).
+//  Side Effect: The counter is advanced by 1.
+//
+	double random2 (double min_value,
+	                double max_value);
+
+//
+//  randomUnitVector
+//
+//  Purpose: To generate a random direction.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: A unit vector uniformly distributed over the
+//           sphere.
+//  Side Effect: The counter is advanced by 2.
+//
+	ObjLibrary::Vector3 randomUnitVector ();
+
+//
+//  randomSphereVector
+//
+//  Purpose: To generate a random point in a sphere.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: A vector uniformly distributed in the unit ball.
+//  Side Effect: The counter is advanced by 3.  Unlike
+//               Vector3::getRandomSphereVector, no values are
+//               rejected, so the counter always advances by
+//               the same amount.
+//
+	ObjLibrary::Vector3 randomSphereVector ();
+
+//
+//  random01Batch
+//  randomUnitVectorBatch
+//  randomSphereVectorBatch
+//
+//  Purpose: To generate many random values at once.
+//  Parameter(s):
+//    <1> a_results: The array to fill
+//    <2> count: The number of values to generate
+//  Preconditions:
+//    <1> a_results != nullptr || count == 0
+//  Returns: N/A
+//  Side Effect: a_results[i] is set for i < count.  The values
+//               and the final counter are the same as calling
+//               the single-value function count times.
+//
+	void random01Batch (double a_results[],
+	                    unsigned int count);
+	void randomUnitVectorBatch (ObjLibrary::Vector3 a_results[],
+	                            unsigned int count);
+	void randomSphereVectorBatch (ObjLibrary::Vector3 a_results[],
+	                              unsigned int count);
+
+private:
+	uint64_t m_key;
+	uint64_t m_counter;
+};
@@ -0,0 +1,245 @@
+//
+//  RenderQueue.cpp
+//
+
+#include "GetGlutWithShaders.h"  // must be first
+
+#include <cassert>
+#include <cstdint>
+#include <algorithm>  // for fill
+#include <cstring>  // for memcpy
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjLibrary/GlCallCounter.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/MeshWithShader.h"
+
+#include "RenderStateCache.h"
+#include "RenderQueue.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int MATRIX_SIZE = 16;
+
+	const unsigned int DIGIT_BITS   = 8;
+	const unsigned int DIGIT_VALUES = 1u << DIGIT_BITS;
+	const unsigned int DIGIT_COUNT  = 64 / DIGIT_BITS;
+
+	const unsigned int DEPTH_SHIFT    = 0;
+	const unsigned int MATERIAL_SHIFT = DEPTH_SHIFT    + RenderQueue::DEPTH_BITS;
+	const unsigned int TEXTURE_SHIFT  = MATERIAL_SHIFT + RenderQueue::MATERIAL_BITS;
+	const unsigned int PROGRAM_SHIFT  = TEXTURE_SHIFT  + RenderQueue::TEXTURE_BITS;
+
+	const unsigned int TEXTURE_MAX  = (1u << RenderQueue::TEXTURE_BITS)  - 1;
+	const unsigned int MATERIAL_MAX = (1u << RenderQueue::MATERIAL_BITS) - 1;
+
+	// non-negative floats sort the same as their bit patterns
+	uint32_t getDepthBits (double depth)
+	{
+		float depth_float = (depth > 0.0) ? (float)(depth) : 0.0f;
+		uint32_t bits;
+		memcpy(&bits, &depth_float, sizeof(bits));
+		return bits;
+	}
+
+	void drawItemMesh (const MeshWithShader& mesh, const double a_matrix[])
+	{
+		glPushMatrix();
+			glMultMatrixd(a_matrix);
+			mesh.draw();
+		glPopMatrix();
+	}
+}
+
+
+
+RenderQueue :: RenderQueue ()
+		: mv_items()
+		, mv_keys()
+		, mv_order()
+		, m_is_sorted(true)
+		, mv_sort_keys()
+		, mv_sort_keys_other()
+		, mv_order_other()
+		, mv_digit_counts(DIGIT_VALUES * DIGIT_COUNT)
+		, m_texture_numbers()
+		, m_material_numbers()
+{
+	assert(invariant());
+}
+
+
+
+uint64_t RenderQueue :: getSortKey (unsigned int index) const
+{
+	assert(isSorted());
+	assert(index < getItemCount());
+
+	return mv_keys[mv_order[index]];
+}
+
+void RenderQueue :: submit (RenderStateCache& r_cache) const
+{
+	assert(isSorted());
+
+	for(unsigned int i = 0; i < mv_order.size(); i++)
+	{
+		const Item& item = mv_items[mv_order[i]];
+		assert(item.mp_mesh != nullptr);
+
+		r_cache.activateMaterial(item.mp_material);
+		drawItemMesh(*item.mp_mesh, item.ma_matrix);
+
+		// same as ObjModel::drawMeshMaterial
+		if(item.mp_material != nullptr && item.mp_material->isSeperateSpecular())
+		{
+			r_cache.reset();
+			item.mp_material->activateSeperateSpecular();
+			drawItemMesh(*item.mp_mesh, item.ma_matrix);
+			Material::deactivate();
+		}
+	}
+	r_cache.reset();
+}
+
+
+
+void RenderQueue :: clear ()
+{
+	mv_items.clear();
+	mv_keys.clear();
+	mv_order.clear();
+	m_is_sorted = true;
+
+	assert(invariant());
+}
+
+void RenderQueue :: add (const ObjLibrary::MeshWithShader& mesh,
+                         const ObjLibrary::Material* p_material,
+                         const double a_matrix[],
+                         double depth,
+                         unsigned int program)
+{
+	assert(mesh.isInitialized());
+	assert(a_matrix != nullptr);
+	assert(program <= PROGRAM_MAX);
+
+	Item item;
+	item.mp_mesh     = &mesh;
+	item.mp_material = p_material;
+	for(unsigned int i = 0; i < MATRIX_SIZE; i++)
+		item.ma_matrix[i] = a_matrix[i];
+	mv_items.push_back(item);
+
+	uint64_t key = ((uint64_t)(program)                       << PROGRAM_SHIFT)  |
+	               ((uint64_t)(getTextureNumber (p_material)) << TEXTURE_SHIFT)  |
+	               ((uint64_t)(getMaterialNumber(p_material)) << MATERIAL_SHIFT) |
+	               ((uint64_t)(getDepthBits(depth))           << DEPTH_SHIFT);
+	mv_keys.push_back(key);
+	m_is_sorted = false;
+
+	assert(invariant());
+}
+
+void RenderQueue :: sort ()
+{
+	unsigned int count = (unsigned int)(mv_keys.size());
+
+	mv_sort_keys = mv_keys;
+	mv_sort_keys_other.resize(count);
+	mv_order.resize(count);
+	mv_order_other.resize(count);
+	for(unsigned int i = 0; i < count; i++)
+		mv_order[i] = i;
+
+	// count every digit in one pass over the keys
+	vector<unsigned int>& rv_counts = mv_digit_counts;
+	assert(rv_counts.size() == DIGIT_VALUES * DIGIT_COUNT);
+	std::fill(rv_counts.begin(), rv_counts.end(), 0);
+	for(unsigned int i = 0; i < count; i++)
+	{
+		uint64_t key = mv_sort_keys[i];
+		for(unsigned int d = 0; d < DIGIT_COUNT; d++)
+			rv_counts[d * DIGIT_VALUES + ((key >> (d * DIGIT_BITS)) & (DIGIT_VALUES - 1))]++;
+	}
+
+	// least significant digit first, so each pass is stable
+	for(unsigned int d = 0; d < DIGIT_COUNT; d++)
+	{
+		unsigned int shift = d * DIGIT_BITS;
+		unsigned int* a_counts = rv_counts.data() + d * DIGIT_VALUES;
+
+		// skip digits that are the same for every item
+		if(count == 0 || a_counts[(mv_sort_keys[0] >> shift) & (DIGIT_VALUES - 1)] == count)
+			continue;
+
+		unsigned int total = 0;
+		for(unsigned int v = 0; v < DIGIT_VALUES; v++)
+		{
+			unsigned int digit_count = a_counts[v];
+			a_counts[v] = total;
+			total += digit_count;
+		}
+
+		for(unsigned int i = 0; i < count; i++)
+		{
+			unsigned int digit = (mv_sort_keys[i] >> shift) & (DIGIT_VALUES - 1);
+			unsigned int destination = a_counts[digit]++;
+			mv_sort_keys_other[destination] = mv_sort_keys[i];
+			mv_order_other    [destination] = mv_order[i];
+		}
+		mv_sort_keys.swap(mv_sort_keys_other);
+		mv_order    .swap(mv_order_other);
+	}
+
+	m_is_sorted = true;
+
+	assert(invariant());
+}
+
+
+
+unsigned int RenderQueue :: getTextureNumber (const ObjLibrary::Material* p_material)
+{
+	if(p_material == nullptr || !p_material->isDiffuseMap())
+		return 0;
+
+	const string& filename = p_material->getDiffuseMapFilename();
+	unordered_map<string, unsigned int>::const_iterator found = m_texture_numbers.find(filename);
+	if(found != m_texture_numbers.end())
+		return found->second;
+
+	// 0 is for no texture, and any extras share the last number
+	unsigned int number = (unsigned int)(m_texture_numbers.size()) + 1;
+	if(number > TEXTURE_MAX)
+		number = TEXTURE_MAX;
+	m_texture_numbers[filename] = number;
+	return number;
+}
+
+unsigned int RenderQueue :: getMaterialNumber (const ObjLibrary::Material* p_material)
+{
+	if(p_material == nullptr)
+		return 0;
+
+	unordered_map<const Material*, unsigned int>::const_iterator found = m_material_numbers.find(p_material);
+	if(found != m_material_numbers.end())
+		return found->second;
+
+	unsigned int number = (unsigned int)(m_material_numbers.size()) + 1;
+	if(number > MATERIAL_MAX)
+		number = MATERIAL_MAX;
+	m_material_numbers[p_material] = number;
+	return number;
+}
+
+bool RenderQueue :: invariant () const
+{
+	if(mv_keys.size() != mv_items.size()) return false;
+	if(m_is_sorted && mv_order.size() != mv_items.size()) return false;
+	return true;
+}
@@ -0,0 +1,212 @@
+//
+//  RenderQueue.h
+//
+//  A module to collect meshes to draw and draw them in an
+//    order that minimizes OpenGL state changes.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/MeshWithShader.h"
+
+#include "RenderStateCache.h"
+
+
+
+//
+//  RenderQueue
+//
+//  A class to collect meshes to draw during a frame and then
+//    draw them sorted by their OpenGL state.  Each item has a
+//    64-bit sort key, made of these fields from most to least
+//    significant:
+//    <1> program (PROGRAM_BITS): chosen by the caller
+//    <2> texture (TEXTURE_BITS): the diffuse map of the
+//                                Material
+//    <3> material (MATERIAL_BITS): the Material
+//    <4> depth (32 bits): the distance from the camera
+//  Items with the same state are therefore drawn together, and
+//    front to back within each state, which helps the depth
+//    test reject hidden fragments early.
+//
+//  The keys are sorted with a least-significant-digit radix
+//    sort on 8-bit digits.  All the digit counts are found in
+//    one pass over the keys, and digits that are the same for
+//    every item are skipped, so a frame with only a few
+//    materials needs about 5 of the 8 passes.
+//
+//  The items are drawn through a RenderStateCache, so a
+//    Material is only activated when it changes.  The queue is
+//    only suitable for opaque meshes, as transparent ones must
+//    be drawn back to front.
+//
+//  The texture and material numbers are assigned the first
+//    time each is seen and kept until the RenderQueue is
+//    destroyed, so the order is the same from frame to frame.
+//
+//  Class Invariant:
+//    <1> mv_keys.size() == mv_items.size()
+//    <2> !m_is_sorted || mv_order.size() == mv_items.size()
+//
+class RenderQueue
+{
+public:
+	static const unsigned int PROGRAM_BITS  =  4;
+	static const unsigned int TEXTURE_BITS  = 12;
+	static const unsigned int MATERIAL_BITS = 16;
+	static const unsigned int DEPTH_BITS    = 32;
+
+	static const unsigned int PROGRAM_MAX = (1u << PROGRAM_BITS) - 1;
+
+public:
+	RenderQueue ();
+	RenderQueue (const RenderQueue& to_copy) = default;
+	~RenderQueue () = default;
+	RenderQueue& operator= (const RenderQueue& to_copy) = default;
+
+//
+//  getItemCount
+//
+//  Purpose: To determine how many items are in this
+//           RenderQueue.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of items added since clear was last
+//           called.
+//  Side Effect: N/A
+//
+	unsigned int getItemCount () const
+	{	return (unsigned int)(mv_items.size());	}
+
+//
+//  isSorted
+//
+//  Purpose: To determine if this RenderQueue has been sorted.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether sort has been called since the last item
+//           was added.
+//  Side Effect: N/A
+//
+	bool isSorted () const
+	{	return m_is_sorted;	}
+
+//
+//  getSortKey
+//
+//  Purpose: To determine the sort key for the specified item.
+//  Parameter(s):
+//    <1> index: Which item, in sorted order
+//  Precondition(s):
+//    <1> isSorted()
+//    <2> index < getItemCount()
+//  Returns: The sort key for the item that will be drawn in
+//           position index.
+//  Side Effect: N/A
+//
+	uint64_t getSortKey (unsigned int index) const;
+
+//
+//  submit
+//
+//  Purpose: To draw all the items in this RenderQueue.
+//  Parameter(s):
+//    <1> r_cache: The RenderStateCache to activate Materials
+//                 through
+//  Precondition(s):
+//    <1> isSorted()
+//  Returns: N/A
+//  Side Effect: Each item is drawn in sorted order with its
+//               Material and transformation.  The Material
+//               activations are counted in r_cache.  Afterwards,
+//               no Material is active.
+//
+	void submit (RenderStateCache& r_cache) const;
+
+//
+//  clear
+//
+//  Purpose: To remove all items from this RenderQueue.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This RenderQueue is set to contain no items.
+//               The texture and material numbers are kept.
+//
+	void clear ();
+
+//
+//  add
+//
+//  Purpose: To add a mesh to be drawn.
+//  Parameter(s):
+//    <1> mesh: The mesh to draw
+//    <2> p_material: The Material to draw it with, or nullptr
+//                    to draw with no Material
+//    <3> a_matrix: The column-major transformation matrix for
+//                  the mesh, as 16 values
+//    <4> depth: The distance from the camera to the mesh
+//    <5> program: The program field of the sort key
+//  Precondition(s):
+//    <1> mesh.isInitialized()
+//    <2> a_matrix != nullptr
+//    <3> program <= PROGRAM_MAX
+//  Returns: N/A
+//  Side Effect: An item is added for mesh.  mesh and p_material
+//               are not copied, so they must not be destroyed
+//               before the item is drawn.  This RenderQueue is
+//               marked as not sorted.
+//
+	void add (const ObjLibrary::MeshWithShader& mesh,
+	          const ObjLibrary::Material* p_material,
+	          const double a_matrix[],
+	          double depth,
+	          unsigned int program = 0);
+
+//
+//  sort
+//
+//  Purpose: To sort the items in this RenderQueue by their
+//           sort keys.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The drawing order is set to increasing sort
+//               key.  Items with equal keys are drawn in the
+//               order they were added.
+//
+	void sort ();
+
+private:
+	unsigned int getTextureNumber (const ObjLibrary::Material* p_material);
+	unsigned int getMaterialNumber (const ObjLibrary::Material* p_material);
+	bool invariant () const;
+
+private:
+	struct Item
+	{
+		const ObjLibrary::MeshWithShader* mp_mesh;
+		const ObjLibrary::Material* mp_material;
+		double ma_matrix[16];
+	};
+
+	std::vector<Item> mv_items;
+	std::vector<uint64_t> mv_keys;
+	std::vector<unsigned int> mv_order;
+	bool m_is_sorted;
+
+	// kept to avoid allocating every frame
+	std::vector<uint64_t> mv_sort_keys;
+	std::vector<uint64_t> mv_sort_keys_other;
+	std::vector<unsigned int> mv_order_other;
+	std::vector<unsigned int> mv_digit_counts;
+
+	std::unordered_map<std::string, unsigned int> m_texture_numbers;
+	std::unordered_map<const ObjLibrary::Material*, unsigned int> m_material_numbers;
+};
@@ -0,0 +1,67 @@
+//
+//  RenderStateCache.cpp
+//
+
+#include <cassert>
+
+#include "ObjLibrary/Material.h"
+
+#include "RenderStateCache.h"
+
+using namespace ObjLibrary;
+
+
+
+RenderStateCache :: RenderStateCache ()
+		: mp_active_material(nullptr)
+		, m_request_count(0)
+		, m_activation_count(0)
+{
+	assert(invariant());
+}
+
+
+
+void RenderStateCache :: activateMaterial (const ObjLibrary::Material* p_material)
+{
+	m_request_count++;
+	if(p_material == mp_active_material)
+	{
+		assert(invariant());
+		return;
+	}
+
+	if(Material::isMaterialActive())
+		Material::deactivate();
+	if(p_material != nullptr)
+		p_material->activate();
+	mp_active_material = p_material;
+	m_activation_count++;
+
+	assert(invariant());
+}
+
+void RenderStateCache :: reset ()
+{
+	if(Material::isMaterialActive())
+		Material::deactivate();
+	mp_active_material = nullptr;
+
+	assert(invariant());
+}
+
+void RenderStateCache :: resetStatistics ()
+{
+	m_request_count    = 0;
+	m_activation_count = 0;
+
+	assert(invariant());
+}
+
+
+
+bool RenderStateCache :: invariant () const
+{
+	if(m_activation_count > m_request_count) return false;
+	return true;
+}
@@ -0,0 +1,124 @@
+//
+//  RenderStateCache.h
+//
+//  A module to avoid redundant OpenGL material changes.
+//
+
+#pragma once
+
+#include "ObjLibrary/Material.h"
+
+
+
+//
+//  RenderStateCache
+//
+//  A class to remember which Material is active so that
+//    activating the same Material again can be skipped.
+//    Material::activate pushes the OpenGL attributes and sets
+//    the colours and textures, and Material::deactivate pops
+//    them, so the savings add up quickly when many meshes are
+//    drawn with the same Material in a row.
+//
+//  All Material changes must go through the RenderStateCache
+//    between the first call to activateMaterial and the next
+//    call to reset.  Otherwise, the cached state will be wrong.
+//
+//  Statistics are kept of how many activations were requested
+//    and how many were actually performed.
+//
+//  Class Invariant:
+//    <1> m_activation_count <= m_request_count
+//
+class RenderStateCache
+{
+public:
+	RenderStateCache ();
+	RenderStateCache (const RenderStateCache& to_copy) = default;
+	~RenderStateCache () = default;
+	RenderStateCache& operator= (const RenderStateCache& to_copy) = default;
+
+//
+//  getActiveMaterial
+//
+//  Purpose: To determine which Material the cache believes is
+//           active.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The active Material, or nullptr if no Material is
+//           active.
+//  Side Effect: N/A
+//
+	const ObjLibrary::Material* getActiveMaterial () const
+	{	return mp_active_material;	}
+
+//
+//  getRequestCount
+//  getActivationCount
+//  getSavedCount
+//
+//  Purpose: To determine how many Material changes were
+//           requested, how many were performed, and how many
+//           were skipped as redundant since the statistics were
+//           last reset.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of changes.
+//  Side Effect: N/A
+//
+	unsigned int getRequestCount () const
+	{	return m_request_count;	}
+	unsigned int getActivationCount () const
+	{	return m_activation_count;	}
+	unsigned int getSavedCount () const
+	{	return m_request_count - m_activation_count;	}
+
+//
+//  activateMaterial
+//
+//  Purpose: To make the specified Material active.
+//  Parameter(s):
+//    <1> p_material: The Material, or nullptr to draw with
+//                    the OpenGL state from before any Material
+//                    was activated
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If p_material is already active, there is no
+//               effect except to update the statistics.
+//               Otherwise, the active Material is deactivated
+//               and p_material is activated.
+//
+	void activateMaterial (const ObjLibrary::Material* p_material);
+
+//
+//  reset
+//
+//  Purpose: To deactivate any active Material.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If a Material is active, it is deactivated.
+//               The statistics are not changed.
+//
+	void reset ();
+
+//
+//  resetStatistics
+//
+//  Purpose: To set the statistics to zero.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The request and activation counts are set to
+//               0.
+//
+	void resetStatistics ();
+
+private:
+	bool invariant () const;
+
+private:
+	const ObjLibrary::Material* mp_active_material;
+	unsigned int m_request_count;
+	unsigned int m_activation_count;
+};
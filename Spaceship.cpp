@@ -8,12 +8,14 @@
 
 #include <cassert>
 #include <cmath>
+#include <vector>
 
 #include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/DisplayList.h"
 
 #include "CoordinateSystem.h"
+#include "DebugDraw.h"
 #include "Entity.h"
 
 using namespace ObjLibrary;
@@ -80,30 +82,39 @@ void Spaceship :: setupFollowCamera (double back_distance,
 	camera.setupCamera();
 }
 
-void Spaceship :: drawPath (const Entity& black_hole,
+void Spaceship :: drawPath (DebugDraw& r_debug_draw,
+                            const Entity& black_hole,
                             unsigned int point_count,
                             const ObjLibrary::Vector3& colour) const
 {
 	assert(isInitialized());
 
+	if(point_count < 2)
+		return;
+
 	Spaceship future = *this;
 
-	glBegin(GL_LINE_STRIP);
-		glColor3d(colour.x, colour.y, colour.z);
-		glVertex3d(future.getPosition().x, future.getPosition().y, future.getPosition().z);
+	// collect the points first so the DebugDraw is only locked once
+	std::vector<Vector3> v_points;
+	std::vector<Vector3> v_colours;
+	v_points .reserve(point_count);
+	v_colours.reserve(point_count);
+	v_points .push_back(future.getPosition());
+	v_colours.push_back(colour);
+
+	for(unsigned int i = 1; i < point_count; i++)
+	{
+		double distance   = black_hole.getPosition().getDistance(getPosition());
+		double delta_time = sqrt(distance) / 25.0;
 
-		for(unsigned int i = 1; i < point_count; i++)
-		{
-			double distance   = black_hole.getPosition().getDistance(getPosition());
-			double delta_time = sqrt(distance) / 25.0;
+		future.updatePhysics(delta_time, black_hole);
 
-			future.updatePhysics(delta_time, black_hole);
+		double fraction = sqrt(1.0 - (double)(i) / point_count);
+		v_points .push_back(future.getPosition());
+		v_colours.push_back(colour * fraction);
+	}
 
-			double fraction = sqrt(1.0 - (double)(i) / point_count);
-			glColor3d(colour.x * fraction, colour.y * fraction, colour.z * fraction);
-			glVertex3d(future.getPosition().x, future.getPosition().y, future.getPosition().z);
-		}
-	glEnd();
+	r_debug_draw.addLineStrip(v_points, v_colours);
 }
 
 
@@ -12,6 +12,7 @@
 #include "ObjLibrary/DisplayList.h"
 
 #include "CoordinateSystem.h"
+#include "DebugDraw.h"
 #include "Entity.h"
 
 
@@ -149,18 +150,21 @@ public:
 //           if it is only affected by gravity from the
 //           specified black hole.
 //  Parameter(s):
-//    <1> black_hole: The black hole
-//    <2> point_count: How many points ahead to display
-//    <3> colour: How colour of the path
+//    <1> r_debug_draw: The DebugDraw to add the path to
+//    <2> black_hole: The black hole
+//    <3> point_count: How many points ahead to display
+//    <4> colour: How colour of the path
 //  Preconditions:
 //    <1> isInitialized()
 //  Returns: N/A
-//  Side Effect: A path of point_count vertexes is displayed for
-//               this Spaceship is displayed.  It will start
-//               with a colour of colour and then fade to black
-//               at the end.
-//
-	void drawPath (const Entity& black_hole,
+//  Side Effect: A path of point_count vertexes for this
+//               Spaceship is added to r_debug_draw.  It will
+//               start with a colour of colour and then fade to
+//               black at the end.  The path is displayed when
+//               r_debug_draw is flushed.
+//
+	void drawPath (DebugDraw& r_debug_draw,
+	               const Entity& black_hole,
 	               unsigned int point_count,
 	               const ObjLibrary::Vector3& colour) const;
 
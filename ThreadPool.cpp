@@ -0,0 +1,177 @@
+//
+//  ThreadPool.cpp
+//
+
+#include <cassert>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+
+
+ThreadPool :: ThreadPool ()
+		: mv_threads()
+		, m_mutex()
+		, m_work_ready()
+		, m_state_changed()
+		, mp_task(nullptr)
+		, m_task_count(0)
+		, m_next_task(0)
+		, m_done_count(0)
+		, m_active_count(0)
+		, m_generation(0)
+		, m_is_stopping(false)
+{
+	startThreads(0);
+
+	assert(invariant());
+}
+
+ThreadPool :: ThreadPool (unsigned int thread_count)
+		: mv_threads()
+		, m_mutex()
+		, m_work_ready()
+		, m_state_changed()
+		, mp_task(nullptr)
+		, m_task_count(0)
+		, m_next_task(0)
+		, m_done_count(0)
+		, m_active_count(0)
+		, m_generation(0)
+		, m_is_stopping(false)
+{
+	startThreads(thread_count);
+
+	assert(invariant());
+}
+
+ThreadPool :: ~ThreadPool ()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_work_ready.notify_all();
+	for(unsigned int i = 0; i < mv_threads.size(); i++)
+		mv_threads[i].join();
+}
+
+
+
+unsigned int ThreadPool :: getThreadCount () const
+{
+	return (unsigned int)(mv_threads.size()) + 1;
+}
+
+void ThreadPool :: runTasks (unsigned int task_count,
+                             const std::function<void (unsigned int)>& task)
+{
+	if(task_count == 0)
+		return;
+	if(mv_threads.empty())
+	{
+		for(unsigned int i = 0; i < task_count; i++)
+			task(i);
+		return;
+	}
+
+	{
+		unique_lock<mutex> lock(m_mutex);
+
+		// a worker that woke late for the last batch may still be looking for tasks
+		m_state_changed.wait(lock, [this] () { return m_active_count == 0; });
+
+		mp_task      = &task;
+		m_task_count = task_count;
+		m_next_task  = 0;
+		m_done_count = 0;
+		m_generation++;
+	}
+	m_work_ready.notify_all();
+
+	runAvailableTasks();
+
+	unique_lock<mutex> lock(m_mutex);
+	m_state_changed.wait(lock, [this] () { return m_done_count == m_task_count &&
+	                                              m_active_count == 0; });
+	mp_task      = nullptr;
+	m_task_count = 0;
+	m_done_count = 0;
+
+	assert(invariant());
+}
+
+
+
+void ThreadPool :: startThreads (unsigned int thread_count)
+{
+	assert(mv_threads.empty());
+
+	if(thread_count == 0)
+		thread_count = thread::hardware_concurrency();
+
+	// the thread calling runTasks is one of the threads
+	for(unsigned int i = 1; i < thread_count; i++)
+		mv_threads.push_back(thread(&ThreadPool::runWorker, this));
+}
+
+void ThreadPool :: runWorker ()
+{
+	unsigned int generation = 0;
+
+	unique_lock<mutex> lock(m_mutex);
+	while(true)
+	{
+		m_work_ready.wait(lock, [this, generation] () { return m_is_stopping ||
+		                                                       m_generation != generation; });
+		if(m_is_stopping)
+			return;
+		generation = m_generation;
+		m_active_count++;
+
+		lock.unlock();
+		runAvailableTasks();
+		lock.lock();
+
+		assert(m_active_count > 0);
+		m_active_count--;
+		if(m_active_count == 0)
+			m_state_changed.notify_all();
+	}
+}
+
+void ThreadPool :: runAvailableTasks ()
+{
+	unsigned int run_count = 0;
+	while(true)
+	{
+		unsigned int task = m_next_task++;
+		if(task >= m_task_count)
+			break;
+		assert(mp_task != nullptr);
+		(*mp_task)(task);
+		run_count++;
+	}
+
+	if(run_count > 0)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_done_count += run_count;
+		if(m_done_count == m_task_count)
+			m_state_changed.notify_all();
+	}
+}
+
+bool ThreadPool :: invariant () const
+{
+	if(m_active_count > mv_threads.size()) return false;
+	if(m_done_count > m_task_count) return false;
+	return true;
+}
@@ -0,0 +1,140 @@
+//
+//  ThreadPool.h
+//
+//  A module to run independent tasks on several threads.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+//
+//  ThreadPool
+//
+//  A class to run batches of independent tasks on a fixed set
+//    of worker threads.  The threads are created once, when the
+//    ThreadPool is created, and wait for work between batches.
+//
+//  The tasks in a batch are numbered, and each task is run
+//    exactly once, on any thread.  The thread that calls
+//    runTasks also runs tasks, and it does not return until the
+//    whole batch is finished.  A task that writes its result to
+//    a slot chosen by its number therefore produces the same
+//    results no matter how many threads there are.
+//
+//  Tasks must not call runTasks on the same ThreadPool, and
+//    must not make OpenGL calls, which are only allowed on the
+//    thread that owns the context.
+//
+//  Class Invariant:
+//    <1> m_active_count <= mv_threads.size()
+//    <2> m_done_count <= m_task_count
+//
+class ThreadPool
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a ThreadPool with one thread per
+//           hardware thread.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new ThreadPool is created.  The calling
+//               thread counts as one of the threads, so one
+//               fewer worker thread is started.
+//
+	ThreadPool ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a ThreadPool with the specified number of
+//           threads.
+//  Parameter(s):
+//    <1> thread_count: The number of threads to run tasks on,
+//                      including the thread calling runTasks,
+//                      or 0 for one per hardware thread
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new ThreadPool is created with
+//               thread_count - 1 worker threads.  If
+//               thread_count is 1, tasks are run on the calling
+//               thread.
+//
+	ThreadPool (unsigned int thread_count);
+
+	ThreadPool (const ThreadPool& to_copy) = delete;
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this ThreadPool.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The worker threads are stopped and joined.
+//
+	~ThreadPool ();
+
+	ThreadPool& operator= (const ThreadPool& to_copy) = delete;
+
+//
+//  getThreadCount
+//
+//  Purpose: To determine how many threads run tasks.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of worker threads plus 1 for the
+//           calling thread.
+//  Side Effect: N/A
+//
+	unsigned int getThreadCount () const;
+
+//
+//  runTasks
+//
+//  Purpose: To run a batch of tasks.
+//  Parameter(s):
+//    <1> task_count: The number of tasks
+//    <2> task: The function to run for each task
+//  Preconditions:
+//    <1> runTasks is not already running on this ThreadPool
+//  Returns: N/A
+//  Side Effect: task(i) is called once for each i in
+//               [0, task_count), spread over the threads in
+//               this ThreadPool.  This function returns when
+//               all the calls have finished.
+//
+	void runTasks (unsigned int task_count,
+	               const std::function<void (unsigned int)>& task);
+
+private:
+	void startThreads (unsigned int thread_count);
+	void runWorker ();
+	void runAvailableTasks ();
+	bool invariant () const;
+
+private:
+	std::vector<std::thread> mv_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_work_ready;
+	std::condition_variable m_state_changed;
+
+	// all guarded by m_mutex, except m_next_task
+	const std::function<void (unsigned int)>* mp_task;
+	unsigned int m_task_count;
+	std::atomic<unsigned int> m_next_task;
+	unsigned int m_done_count;
+	unsigned int m_active_count;
+	unsigned int m_generation;
+	bool m_is_stopping;
+};
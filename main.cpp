@@ -4,27 +4,52 @@
 
 #include <cassert>
 #include <cctype>  // for toupper
+#include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <vector>
 #include <algorithm>  // for min/max
+#include <cmath>
 #include <chrono>
+#include <string>
+#include <fstream>
+#include <atomic>
 
-#include "GetGlut.h"
+#include "GetGlutWithShaders.h"  // must be before anything that includes gl.h
 #include "Sleep.h"
 
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/WeldedMesh.h"
+#include "ObjLibrary/MeshOptimizer.h"
+#include "ObjLibrary/MeshSimplifier.h"
 #include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/GlCallCounter.h"
 #include "ObjLibrary/SpriteFont.h"
+#include "ObjLibrary/SpriteFontBatch.h"
 
 #include "Gravity.h"
 #include "CoordinateSystem.h"
 #include "PerlinNoiseField3.h"
+#include "DefaultPerlinNoiseField3.h"
 #include "Entity.h"
 #include "BlackHole.h"
 #include "Asteroid.h"
+#include "AsteroidLodMeshes.h"
 #include "Spaceship.h"
+#include "Frustum.h"
+#include "Occlusion.h"
+#include "InstancedAsteroids.h"
+#include "AsteroidImpostors.h"
+#include "RenderStateCache.h"
+#include "RenderQueue.h"
+#include "DebugDraw.h"
+#include "OffscreenContext.h"
+#include "PngWriter.h"
+#include "ThreadPool.h"
+#include "RandomStream.h"
+#include "MeshCache.h"
+#include "Icosphere.h"
 
 using namespace std;
 using namespace chrono;
@@ -32,12 +57,22 @@ using namespace ObjLibrary;
 
 void initDisplay ();
 void loadModels ();
+void loadFont ();
+void initInstancedAsteroids ();
+void initImpostors ();
+void initGlCallZones ();
+void optimizeModel (ObjModel& r_model, const string& name);
 void initEntities ();
 void initAsteroids ();
 void initPlayer ();
 double getCircularOrbitSpeed (double distance);
 void initTime ();
 
+int runBenchmark (int argc, char* argv[]);
+void setBenchmarkCamera (unsigned int frame);
+int runNoiseBenchmark (int argc, char* argv[]);
+int runIcosphereBenchmark (int argc, char* argv[]);
+
 unsigned char fixShift (unsigned char key);
 void keyboardDown (unsigned char key, int x, int y);
 void keyboardUp (unsigned char key, int x, int y);
@@ -49,9 +84,12 @@ void handleInput (double delta_time);
 void updatePhysics (double delta_time);
 
 void reshape (int w, int h);
+void setViewport (int w, int h);
 void display ();
+void drawScene ();
 void drawSkybox ();
 void drawEntities (bool is_show_debug);
+void addOccluders (SphereOccluders& occluders);
 void drawOverlays ();
 
 namespace
@@ -59,6 +97,7 @@ namespace
 	int window_width  = 640;
 	int window_height = 480;
 	SpriteFont font;
+	SpriteFontBatch g_text_batch(font);  // all overlay text is drawn at once
 
 	const unsigned int KEY_PRESSED_COUNT = 0x100 + 5;
 	const unsigned int KEY_PRESSED_RIGHT = 0x100 + 0;
@@ -84,6 +123,9 @@ namespace
 
 	bool g_is_paused     = false;
 	bool g_is_show_debug = false;
+	bool g_is_instanced  = false;
+	bool g_is_impostors  = false;
+	bool g_is_report_optimization = false;  // print the ACMR for each model, set by the benchmarks
 
 	const unsigned int ASTEROID_COUNT = 100;
 
@@ -102,27 +144,85 @@ namespace
 
 	static const unsigned int ASTEROID_MODEL_COUNT = 25;
 	ObjModel ga_asteroid_models[ASTEROID_MODEL_COUNT];
+	uint64_t ga_asteroid_model_hashes[ASTEROID_MODEL_COUNT];  // for the mesh cache keys
 
 	vector<Asteroid> gv_asteroids;
-
+	vector<unsigned int> gv_asteroid_model_indexes;
+	ThreadPool g_thread_pool;  // for building asteroid models
+	MeshCache g_mesh_cache;    // asteroid models from earlier runs
+	string g_mesh_cache_directory;  // empty to not use the mesh cache
+	const uint64_t MESH_CACHE_BYTES = 256 * 1024 * 1024;
+	const uint64_t WORLD_SEED = 409;
+	unsigned int g_world_count = 0;  // each world uses its own stream of WORLD_SEED
+	InstancedAsteroids g_instanced_asteroids;
+	AsteroidImpostors g_impostors;
+	RenderQueue g_render_queue;
+	RenderStateCache g_render_state_cache;
+
+	DebugDraw g_debug_draw;
+
+	const double  CAMERA_FIELD_OF_VIEW  =   60.0;  // degrees, vertical
+	const double  IMPOSTOR_DISTANCE     = 3000.0;  // asteroids further than this are drawn as quads
+	const unsigned int IMPOSTOR_TILE_SIZE      = 64;
+	const unsigned int IMPOSTOR_TILES_PER_SIDE = 32;
 	const double  CAMERA_BACK_DISTANCE  =   20.0;
 	const double  CAMERA_UP_DISTANCE    =    5.0;
 	const double  PLAYER_START_DISTANCE = 1000.0;
 	const Vector3 PLAYER_START_FORWARD(1.0, 0.0, 0.0);
 	Spaceship g_player;
 
-
-
-	double random01 ()
-	{
-		return rand() / (RAND_MAX + 1.0);
-	}
-
-	double random2 (double min_value, double max_value)
+	unsigned int g_asteroids_drawn          = 0;
+	unsigned int g_asteroid_triangles_drawn = 0;
+	unsigned int g_asteroid_draw_calls      = 0;
+	unsigned int g_entities_drawn           = 0;
+	unsigned int g_entities_total           = 0;
+	unsigned int g_entities_occluded        = 0;
+	unsigned int g_impostors_drawn          = 0;
+	unsigned int g_impostors_refreshed      = 0;
+
+	// zones for counting OpenGL calls, set in initGlCallZones
+	unsigned int g_gl_zone_skybox     = GlCallCounter::ZONE_OTHER;
+	unsigned int g_gl_zone_asteroids  = GlCallCounter::ZONE_OTHER;
+	unsigned int g_gl_zone_impostors  = GlCallCounter::ZONE_OTHER;
+	unsigned int g_gl_zone_player     = GlCallCounter::ZONE_OTHER;
+	unsigned int g_gl_zone_debug      = GlCallCounter::ZONE_OTHER;
+	unsigned int g_gl_zone_black_hole = GlCallCounter::ZONE_OTHER;
+	unsigned int g_gl_zone_overlay    = GlCallCounter::ZONE_OTHER;
+
+	// bounding spheres for frustum culling, refilled every frame
+	float ga_cull_x     [ASTEROID_COUNT];
+	float ga_cull_y     [ASTEROID_COUNT];
+	float ga_cull_z     [ASTEROID_COUNT];
+	float ga_cull_radius[ASTEROID_COUNT];
+	bool  ga_is_visible [ASTEROID_COUNT];
+
+	// offscreen benchmark, run with --benchmark
+	const unsigned int BENCHMARK_LOOP_FRAMES = 720;  // one trip around the path
+	const double BENCHMARK_PATH_RADIUS = DISK_RADIUS * 0.5;  // middle of the asteroid shell
+	const double BENCHMARK_PATH_HEIGHT = DISK_RADIUS * 0.1;
+	const double BENCHMARK_PERCENTILE  = 0.95;
+	const float NOISE_BENCHMARK_RANGE  = 1000.0f;  // points are in a cube this many grid cells across
+	const unsigned int ICOSPHERE_BENCHMARK_ASTEROIDS = 20;
+
+
+
+	void printTimeSummary (const string& name, vector<double> v_milliseconds)
 	{
-		assert(min_value <= max_value);
-
-		return min_value + random01() * (max_value - min_value);
+		assert(!v_milliseconds.empty());
+
+		sort(v_milliseconds.begin(), v_milliseconds.end());
+		double total = 0.0;
+		for(unsigned int i = 0; i < v_milliseconds.size(); i++)
+			total += v_milliseconds[i];
+		unsigned int percentile_index = (unsigned int)(v_milliseconds.size() * BENCHMARK_PERCENTILE);
+		if(percentile_index >= v_milliseconds.size())
+			percentile_index = (unsigned int)(v_milliseconds.size() - 1);
+
+		cout << "# " << name << " ms: mean " << fixed << setprecision(3)
+		     << (total / v_milliseconds.size())
+		     << ", 95th percentile " << v_milliseconds[percentile_index]
+		     << ", max " << v_milliseconds.back() << endl;
+		cout.unsetf(ios::fixed);
 	}
 
 }  // end of anonymous namespace
@@ -131,12 +231,25 @@ namespace
 
 int main (int argc, char* argv[])
 {
+	for(int i = 1; i < argc; i++)
+		if(string(argv[i]) == "--benchmark")
+			return runBenchmark(argc, argv);
+		else if(string(argv[i]) == "--noise-benchmark")
+			return runNoiseBenchmark(argc, argv);
+		else if(string(argv[i]) == "--icosphere-benchmark")
+			return runIcosphereBenchmark(argc, argv);
+		else if(string(argv[i]) == "--mesh-cache" && i + 1 < argc)
+			g_mesh_cache_directory = argv[++i];
+
 	glutInitWindowSize(640, 480);
 	glutInitWindowPosition(0, 0);
 
 	glutInit(&argc, argv);
 	glutInitDisplayMode(GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGB);
 	glutCreateWindow("CS 409 Assignment 3 Solution");
+#if defined(_WIN32) || defined(__WIN32__)
+	loadGlExtensions();  // needs the window to exist
+#endif
 	glutKeyboardFunc(keyboardDown);
 	glutKeyboardUpFunc(keyboardUp);
 	glutSpecialFunc(specialDown);
@@ -149,10 +262,16 @@ int main (int argc, char* argv[])
 	//pnf.printPerlin(40, 60, 0.1f);
 
 	initDisplay();
+	initGlCallZones();
 	loadModels();
+	loadFont();
+	initInstancedAsteroids();
+	initImpostors();
 	initEntities();
 	initTime();  // should be last
 
+	glutPostRedisplay();
+
 	glutMainLoop();
 
 	return 1;
@@ -167,8 +286,6 @@ void initDisplay ()
 	glEnable(GL_CULL_FACE);
 	//glEnable(GL_BLEND);
 	//glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // additive blending
-
-	glutPostRedisplay();
 }
 
 void loadModels ()
@@ -178,7 +295,10 @@ void loadModels ()
 
 	g_skybox_display_list  = ObjModel(path + "Skybox.obj")     .getDisplayList();
 	g_disk_display_list    = ObjModel(path + "Disk.obj")       .getDisplayList();
-	g_player_display_list  = ObjModel(path + "Sagittarius.obj").getDisplayList();
+
+	ObjModel player_model(path + "Sagittarius.obj");
+	optimizeModel(player_model, "Sagittarius.obj");
+	g_player_display_list = player_model.getDisplayList();
 
 	assert(ASTEROID_MODEL_COUNT <= 26);  // only 26 letters to use
 	for(unsigned m = 0; m < ASTEROID_MODEL_COUNT; m++)
@@ -187,15 +307,82 @@ void loadModels ()
 		assert(filename[8] == 'A');
 		filename[8] = 'A' + m;
 		ga_asteroid_models[m].load(path + filename);
+		optimizeModel(ga_asteroid_models[m], filename);
+		ga_asteroid_model_hashes[m] = MeshCache::hashModel(ga_asteroid_models[m]);
 	}
 
-	font.load(path + "Font.bmp");
+	// without the cache, the models are just generated every time
+	if(!g_mesh_cache.isOpen() && !g_mesh_cache_directory.empty())
+		g_mesh_cache.open(g_mesh_cache_directory, MESH_CACHE_BYTES);
+}
+
+void loadFont ()
+{
+	// change this to an absolute path on Mac computers
+	font.load("Models/Font.bmp");
+}
+
+void initInstancedAsteroids ()
+{
+	if(!InstancedAsteroids::isSupported())
+	{
+		cout << "Instanced asteroids need OpenGL 3.3, using display lists" << endl;
+		return;
+	}
+
+	g_instanced_asteroids.init(ga_asteroid_models, ASTEROID_MODEL_COUNT);
+	g_is_instanced = g_instanced_asteroids.isInitialized();
+}
+
+void initImpostors ()
+{
+	if(!AsteroidImpostors::isSupported())
+	{
+		cout << "Asteroid impostors need OpenGL 3.0, drawing all asteroids as meshes" << endl;
+		return;
+	}
+
+	g_impostors.init(IMPOSTOR_TILE_SIZE, IMPOSTOR_TILES_PER_SIDE);
+	g_is_impostors = g_impostors.isInitialized();
+}
+
+void initGlCallZones ()
+{
+	g_gl_zone_skybox     = GlCallCounter::getZone("skybox");
+	g_gl_zone_asteroids  = GlCallCounter::getZone("asteroids");
+	g_gl_zone_impostors  = GlCallCounter::getZone("impostors");
+	g_gl_zone_player     = GlCallCounter::getZone("player");
+	g_gl_zone_debug      = GlCallCounter::getZone("debug lines");
+	g_gl_zone_black_hole = GlCallCounter::getZone("black hole");
+	g_gl_zone_overlay    = GlCallCounter::getZone("overlay");
+}
+
+void optimizeModel (ObjModel& r_model, const string& name)
+{
+	// reorder once at load so every display list and buffer built from the model benefits
+	if(!g_is_report_optimization)
+	{
+		r_model.optimizeFaceOrder();
+		r_model.optimizeVertexOrder();
+		return;
+	}
+
+	double acmr_before = r_model.getWeldedMesh().calculateAcmr(MeshOptimizer::DEFAULT_CACHE_SIZE);
+	r_model.optimizeFaceOrder();
+	r_model.optimizeVertexOrder();
+	double acmr_after  = r_model.getWeldedMesh().calculateAcmr(MeshOptimizer::DEFAULT_CACHE_SIZE);
+
+	cout << "# " << name << ": ACMR " << fixed << setprecision(3)
+	     << acmr_before << " -> " << acmr_after << endl;
+	cout.unsetf(ios::fixed);
 }
 
 void initEntities ()
 {
 	// remove existing entities (if any)
 	gv_asteroids.clear();
+	gv_asteroid_model_indexes.clear();
+	g_impostors.invalidateAll();  // tiles are for the old asteroids
 
 	// create new entities
 	g_black_hole = BlackHole(Vector3::ZERO, BLACK_HOLE_MASS,
@@ -217,34 +404,94 @@ void initAsteroids ()
 	static const double INNER_FRACTION_MIN = 0.1;
 	static const double INNER_FRACTION_MAX = 0.5;
 
+	//
+	//  Asteroid a uses substream a of the world stream, so it
+	//    does not depend on the other asteroids or on which
+	//    thread builds it.
+	//
+
+	RandomStream world(WORLD_SEED, g_world_count);
+	g_world_count++;
+
 	for(unsigned a = 0; a < ASTEROID_COUNT; a++)
 	{
+		unsigned int model_index = a % ASTEROID_MODEL_COUNT;
+		assert(model_index < ASTEROID_MODEL_COUNT);
+		assert(!ga_asteroid_models[model_index].isEmpty());
+		gv_asteroid_model_indexes.push_back(model_index);
+	}
+	assert(gv_asteroid_model_indexes.size() == ASTEROID_COUNT);
+
+	// choose, then load or build the models, in parallel and each into its own slot
+	vector<Vector3> v_positions(ASTEROID_COUNT);
+	vector<Vector3> v_velocities(ASTEROID_COUNT);
+	vector<double> v_inner_radii(ASTEROID_COUNT);
+	vector<double> v_outer_radii(ASTEROID_COUNT);
+	vector<Asteroid::RandomParameters> v_parameters(ASTEROID_COUNT);
+	vector<vector<ObjModel>> vv_models(ASTEROID_COUNT);  // one model each, as the cache stores them
+	atomic<unsigned int> cached_count(0);
+	g_thread_pool.runTasks(ASTEROID_COUNT, [&] (unsigned int a)
+	{
+		RandomStream random = world.getSubstream(a);
+
 		// choose a random position in a thick shell around the black hole
-		double distance = random2(DISTANCE_MIN, DISTANCE_MAX);
-		Vector3 position = Vector3::getRandomUnitVector() * distance;
+		double distance = random.random2(DISTANCE_MIN, DISTANCE_MAX);
+		Vector3 position = random.randomUnitVector() * distance;
 
 		// choose starting velocity
 		double speed_circle = getCircularOrbitSpeed(distance);
-		double speed_factor = random2(SPEED_FACTOR_MIN, SPEED_FACTOR_MAX);
+		double speed_factor = random.random2(SPEED_FACTOR_MIN, SPEED_FACTOR_MAX);
 		double speed = speed_circle * speed_factor;
-		Vector3 velocity = Vector3::getRandomUnitVector().getRejection(position);  // tangent to gravity
+		Vector3 velocity = random.randomUnitVector().getRejection(position);  // tangent to gravity
 		assert(!velocity.isZero());
 		velocity.setNorm(speed);
 
 		// mostly smaller asteroids
-		double outer_radius = min(random2(OUTER_RADIUS_MIN, OUTER_RADIUS_MAX),
-		                          random2(OUTER_RADIUS_MIN, OUTER_RADIUS_MAX));
+		double outer_radius_a = random.random2(OUTER_RADIUS_MIN, OUTER_RADIUS_MAX);
+		double outer_radius_b = random.random2(OUTER_RADIUS_MIN, OUTER_RADIUS_MAX);
+		double outer_radius   = min(outer_radius_a, outer_radius_b);
 
-		double inner_fraction = random2(INNER_FRACTION_MIN, INNER_FRACTION_MAX);
+		double inner_fraction = random.random2(INNER_FRACTION_MIN, INNER_FRACTION_MAX);
 		double inner_radius   = outer_radius * inner_fraction;
 
-		unsigned int model_index = a % ASTEROID_MODEL_COUNT;
-		assert(model_index < ASTEROID_MODEL_COUNT);
-		assert(!ga_asteroid_models[model_index].isEmpty());
+		v_positions  [a] = position;
+		v_velocities [a] = velocity;
+		v_inner_radii[a] = inner_radius;
+		v_outer_radii[a] = outer_radius;
+		v_parameters [a] = Asteroid::chooseRandomParameters(random);
+
+		unsigned int model_index = gv_asteroid_model_indexes[a];
+		const ObjModel& base_model = ga_asteroid_models[model_index];
+		uint64_t cache_key = Asteroid::getModelCacheKey(ga_asteroid_model_hashes[model_index],
+		                                                inner_radius, outer_radius,
+		                                                v_parameters[a].m_noise_offset);
+		if(g_mesh_cache.load(cache_key, base_model, vv_models[a]) &&
+		   vv_models[a].size() == 1)
+		{
+			cached_count++;
+		}
+		else
+		{
+			vv_models[a].assign(1, Asteroid::createModel(base_model,
+			                                             inner_radius, outer_radius,
+			                                             v_parameters[a].m_noise_offset));
+			g_mesh_cache.store(cache_key, vv_models[a]);
+		}
+	});
+	if(g_mesh_cache.isOpen())
+	{
+		cout << "Loaded " << cached_count << " of " << ASTEROID_COUNT
+		     << " asteroid models from the mesh cache" << endl;
+	}
 
-		gv_asteroids.push_back(Asteroid(position, velocity,
-		                                inner_radius, outer_radius,
-		                                ga_asteroid_models[model_index]));
+	// OpenGL calls must be made on this thread
+	for(unsigned a = 0; a < ASTEROID_COUNT; a++)
+	{
+		gv_asteroids.push_back(Asteroid(v_positions[a], v_velocities[a],
+		                                v_inner_radii[a], v_outer_radii[a],
+		                                v_parameters[a],
+		                                ga_asteroid_models[gv_asteroid_model_indexes[a]],
+		                                vv_models[a][0]));
 	}
 	assert(gv_asteroids.size() == ASTEROID_COUNT);
 }
@@ -288,6 +535,357 @@ void initTime ()
 
 
 
+int runBenchmark (int argc, char* argv[])
+{
+	static const char USAGE[] = "Usage: --benchmark FRAMES [--size WIDTHxHEIGHT] [--csv FILE]"
+	                            " [--png PREFIX] [--no-instancing] [--no-impostors]"
+	                            " [--mesh-cache DIRECTORY]";
+
+	unsigned int frame_count = 0;
+	int width  = window_width;
+	int height = window_height;
+	string csv_filename;
+	string png_prefix;
+	bool is_allow_instancing = true;
+	bool is_allow_impostors  = true;
+	for(int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		bool is_value_next = (i + 1 < argc);
+		if(argument == "--benchmark" && is_value_next)
+			frame_count = (unsigned int)(atoi(argv[++i]));
+		else if(argument == "--size" && is_value_next)
+		{
+			char separator = '\0';
+			istringstream size_stream(argv[++i]);
+			size_stream >> width >> separator >> height;
+			if(!size_stream || separator != 'x')
+				width = 0;
+		}
+		else if(argument == "--csv" && is_value_next)
+			csv_filename = argv[++i];
+		else if(argument == "--png" && is_value_next)
+			png_prefix = argv[++i];
+		else if(argument == "--no-instancing")
+			is_allow_instancing = false;
+		else if(argument == "--no-impostors")
+			is_allow_impostors = false;
+		else if(argument == "--mesh-cache" && is_value_next)
+			g_mesh_cache_directory = argv[++i];
+		else
+			frame_count = 0;
+	}
+	if(frame_count == 0 || width < 1 || height < 1)
+	{
+		cerr << USAGE << endl;
+		return 1;
+	}
+
+	// no window, so GLUT and the font are not used
+	OffscreenContext context;
+	if(!context.init(width, height))
+		return 1;
+	g_is_report_optimization = true;
+	initDisplay();
+	initGlCallZones();
+	loadModels();
+	initInstancedAsteroids();
+	initImpostors();
+	initEntities();
+	g_is_instanced = g_is_instanced && is_allow_instancing;
+	g_is_impostors = g_is_impostors && is_allow_impostors;
+	setViewport(width, height);
+
+	ofstream csv_file;
+	if(!csv_filename.empty())
+	{
+		csv_file.open(csv_filename.c_str());
+		if(!csv_file)
+		{
+			cerr << "Could not open \"" << csv_filename << "\"" << endl;
+			return 1;
+		}
+	}
+	ostream& csv = csv_filename.empty() ? cout : csv_file;
+	csv << "frame,submit_ms,frame_ms,asteroids,impostors,impostor_refreshes,"
+	       "draw_calls,material_changes,triangles,"
+	       "gl_calls,gl_draws,gl_vertexes,gl_list_calls,gl_texture_binds" << endl;
+
+	vector<GlCallCounts> v_zone_totals(GlCallCounter::getZoneCount());
+	vector<double> v_submit_milliseconds;
+	vector<double> v_frame_milliseconds;
+	vector<unsigned char> v_pixels;
+	for(unsigned int f = 0; f < frame_count; f++)
+	{
+		// fixed time steps, so every run draws the same frames
+		updatePhysics(SECONDS_PER_PHYSICS);
+		setBenchmarkCamera(f);
+
+		steady_clock::time_point start_time = steady_clock::now();
+		drawScene();
+		steady_clock::time_point submit_time = steady_clock::now();
+		glFinish();
+		steady_clock::time_point end_time = steady_clock::now();
+
+		double submit_milliseconds = duration<double, milli>(submit_time - start_time).count();
+		double frame_milliseconds  = duration<double, milli>(end_time    - start_time).count();
+		v_submit_milliseconds.push_back(submit_milliseconds);
+		v_frame_milliseconds .push_back(frame_milliseconds);
+
+		GlCallCounter::endFrame();
+		for(unsigned int z = 0; z < v_zone_totals.size(); z++)
+			v_zone_totals[z].add(GlCallCounter::getLastFrameCounts(z));
+		GlCallCounts gl_total = GlCallCounter::getLastFrameTotal();
+
+		csv << f << "," << fixed << setprecision(4)
+		    << submit_milliseconds << "," << frame_milliseconds << ","
+		    << g_asteroids_drawn << "," << g_impostors_drawn << "," << g_impostors_refreshed << ","
+		    << g_asteroid_draw_calls << "," << g_render_state_cache.getActivationCount() << ","
+		    << g_asteroid_triangles_drawn << ","
+		    << gl_total.m_call_count << "," << gl_total.m_draw_count << "," << gl_total.m_vertex_count << ","
+		    << gl_total.m_list_call_count << "," << gl_total.m_texture_bind_count << endl;
+		csv.unsetf(ios::fixed);
+
+		if(!png_prefix.empty())
+		{
+			ostringstream png_filename;
+			png_filename << png_prefix << setw(4) << setfill('0') << f << ".png";
+			context.readPixels(v_pixels);
+			if(!writePng(png_filename.str(), width, height, v_pixels, true))
+			{
+				cerr << "Could not write \"" << png_filename.str() << "\"" << endl;
+				return 1;
+			}
+		}
+	}
+
+	cout << "# " << frame_count << " frames at " << width << "x" << height
+	     << ", instancing " << (g_is_instanced ? "on" : "off")
+	     << ", impostors "  << (g_is_impostors ? "on" : "off") << endl;
+	printTimeSummary("submit", v_submit_milliseconds);
+	printTimeSummary("frame",  v_frame_milliseconds);
+	if(!GlCallCounter::isEnabled())
+		cout << "# GL calls not counted: compile with -DOBJ_LIBRARY_COUNT_GL_CALLS" << endl;
+	else
+	{
+		for(unsigned int z = 0; z < v_zone_totals.size(); z++)
+		{
+			const GlCallCounts& totals = v_zone_totals[z];
+			double per_frame = 1.0 / frame_count;
+			cout << "# GL calls per frame in " << GlCallCounter::getZoneName(z) << ": "
+			     << fixed << setprecision(1)
+			     << totals.m_call_count         * per_frame << " ("
+			     << totals.m_draw_count         * per_frame << " draws, "
+			     << totals.m_vertex_count       * per_frame << " vertexes, "
+			     << totals.m_list_call_count    * per_frame << " lists, "
+			     << totals.m_texture_bind_count * per_frame << " binds)" << endl;
+			cout.unsetf(ios::fixed);
+		}
+	}
+
+	// the shape is the only geometry each asteroid has; the levels of detail are shared
+	size_t shape_bytes = 0;
+	size_t full_bytes  = 0;  // float positions and normals
+	size_t shared_bytes = 0;
+	vector<const AsteroidLodMeshes*> v_lod_meshes;
+	for(unsigned int a = 0; a < gv_asteroids.size(); a++)
+	{
+		const AsteroidShape& shape = gv_asteroids[a].getShape();
+		shape_bytes += shape.getMemoryUsed();
+		full_bytes  += shape.getVertexCount() * 6 * sizeof(float);
+
+		const AsteroidLodMeshes* p_lod_meshes = &gv_asteroids[a].getLodMeshes();
+		if(find(v_lod_meshes.begin(), v_lod_meshes.end(), p_lod_meshes) == v_lod_meshes.end())
+		{
+			v_lod_meshes.push_back(p_lod_meshes);
+			shared_bytes += p_lod_meshes->getMemoryUsed();
+		}
+	}
+	cout << "# Asteroid geometry bytes per asteroid: " << shape_bytes / gv_asteroids.size()
+	     << " (full vertex data " << full_bytes / gv_asteroids.size() << ")" << endl;
+	cout << "# Shared asteroid LOD bytes: " << shared_bytes << " for "
+	     << v_lod_meshes.size() << " base models" << endl;
+	return 0;
+}
+
+void setBenchmarkCamera (unsigned int frame)
+{
+	static const double TWO_PI = 2.0 * 3.14159265358979;
+
+	// a loop around the black hole through the asteroids, bobbing
+	//  up and down so the disk is not always seen edge-on
+	double angle = TWO_PI * (frame % BENCHMARK_LOOP_FRAMES) / BENCHMARK_LOOP_FRAMES;
+	Vector3 position( cos(angle)       * BENCHMARK_PATH_RADIUS,
+	                  sin(angle * 3.0) * BENCHMARK_PATH_HEIGHT,
+	                  sin(angle)       * BENCHMARK_PATH_RADIUS);
+	Vector3 tangent (-sin(angle)             * BENCHMARK_PATH_RADIUS,
+	                  cos(angle * 3.0) * 3.0 * BENCHMARK_PATH_HEIGHT,
+	                  cos(angle)             * BENCHMARK_PATH_RADIUS);
+	Vector3 forward = tangent.getNormalized();
+	Vector3 up      = Vector3::UNIT_Y_PLUS.getRejection(forward).getNormalized();
+
+	CoordinateSystem& r_coords = g_player.getCoordinateSystem();
+	r_coords.setPosition(position);
+	r_coords.setOrientation(forward, up);
+	g_player.setVelocity(forward * getCircularOrbitSpeed(BENCHMARK_PATH_RADIUS));
+}
+
+int runNoiseBenchmark (int argc, char* argv[])
+{
+	unsigned int point_count = 0;
+	if(argc == 3 && string(argv[1]) == "--noise-benchmark")
+		point_count = (unsigned int)(atoi(argv[2]));
+	if(point_count == 0)
+	{
+		cerr << "Usage: --noise-benchmark POINTS" << endl;
+		return 1;
+	}
+
+	vector<float> v_x(point_count);
+	vector<float> v_y(point_count);
+	vector<float> v_z(point_count);
+	vector<float> v_results(point_count);
+	RandomStream random(WORLD_SEED);
+	vector<double> v_random(point_count * 3);
+	random.random01Batch(v_random.data(), point_count * 3);
+	for(unsigned int i = 0; i < point_count; i++)
+	{
+		v_x[i] = (float)((v_random[i * 3 + 0] - 0.5) * NOISE_BENCHMARK_RANGE);
+		v_y[i] = (float)((v_random[i * 3 + 1] - 0.5) * NOISE_BENCHMARK_RANGE);
+		v_z[i] = (float)((v_random[i * 3 + 2] - 0.5) * NOISE_BENCHMARK_RANGE);
+	}
+
+	PerlinNoiseField3 seeded(1.0f, 1.0f);
+	steady_clock::time_point table_start = steady_clock::now();
+	PerlinNoiseField3 permutation(1.0f, 1.0f);
+	permutation.setHashMode(PerlinNoiseField3::HASH_PERMUTATION);
+	double table_milliseconds = duration<double, milli>(steady_clock::now() - table_start).count();
+	DefaultPerlinNoiseField3 compiled(1.0f, 1.0f);
+
+	static const unsigned int TEST_COUNT = 8;
+	static const char* A_TEST_NAMES[TEST_COUNT] =
+	{
+		"value noise, seeded hash",
+		"value noise, permutation table",
+		"value noise, compile-time table",
+		"Perlin noise, seeded hash",
+		"Perlin noise, permutation table",
+		"Perlin noise, compile-time table",
+		"Perlin noise batch, seeded hash",
+		"Perlin noise batch, permutation table",
+	};
+
+	cout << "# " << point_count << " points, batch width " << PerlinNoiseField3::getBatchWidth()
+	     << ", permutation table built in " << fixed << setprecision(3) << table_milliseconds << " ms" << endl;
+	for(unsigned int t = 0; t < TEST_COUNT; t++)
+	{
+		steady_clock::time_point start_time = steady_clock::now();
+		switch(t)
+		{
+		case 0: for(unsigned int i = 0; i < point_count; i++) v_results[i] = seeded     .valueNoise(v_x[i], v_y[i], v_z[i]); break;
+		case 1: for(unsigned int i = 0; i < point_count; i++) v_results[i] = permutation.valueNoise(v_x[i], v_y[i], v_z[i]); break;
+		case 2: for(unsigned int i = 0; i < point_count; i++) v_results[i] = compiled   .valueNoise(v_x[i], v_y[i], v_z[i]); break;
+		case 3: for(unsigned int i = 0; i < point_count; i++) v_results[i] = seeded     .perlinNoise(v_x[i], v_y[i], v_z[i]); break;
+		case 4: for(unsigned int i = 0; i < point_count; i++) v_results[i] = permutation.perlinNoise(v_x[i], v_y[i], v_z[i]); break;
+		case 5: for(unsigned int i = 0; i < point_count; i++) v_results[i] = compiled   .perlinNoise(v_x[i], v_y[i], v_z[i]); break;
+		case 6: seeded     .perlinNoiseBatch(v_x.data(), v_y.data(), v_z.data(), point_count, v_results.data()); break;
+		case 7: permutation.perlinNoiseBatch(v_x.data(), v_y.data(), v_z.data(), point_count, v_results.data()); break;
+		}
+		double milliseconds = duration<double, milli>(steady_clock::now() - start_time).count();
+
+		// the checksum keeps the calculations from being optimized away
+		double checksum = 0.0;
+		for(unsigned int i = 0; i < point_count; i++)
+			checksum += v_results[i];
+		cout << "# " << A_TEST_NAMES[t] << ": " << milliseconds << " ms, "
+		     << (point_count / milliseconds / 1000.0) << " million points/s, checksum " << checksum << endl;
+	}
+	cout.unsetf(ios::fixed);
+	return 0;
+}
+
+int runIcosphereBenchmark (int argc, char* argv[])
+{
+	int subdivisions = -1;
+	if(argc == 3 && string(argv[1]) == "--icosphere-benchmark")
+		subdivisions = atoi(argv[2]);
+	if(subdivisions < 0 || subdivisions > (int)(ICOSPHERE_SUBDIVISIONS_MAX))
+	{
+		cerr << "Usage: --icosphere-benchmark SUBDIVISIONS (0 to "
+		     << ICOSPHERE_SUBDIVISIONS_MAX << ")" << endl;
+		return 1;
+	}
+
+	// the same random asteroids for both generators
+	RandomStream world(WORLD_SEED);
+	vector<double> v_inner_radii;
+	vector<double> v_outer_radii;
+	vector<Vector3> v_noise_offsets;
+	for(unsigned int a = 0; a < ICOSPHERE_BENCHMARK_ASTEROIDS; a++)
+	{
+		RandomStream random = world.getSubstream(a);
+		double outer_radius = random.random2(50.0, 400.0);
+		v_outer_radii  .push_back(outer_radius);
+		v_inner_radii  .push_back(outer_radius * random.random2(0.1, 0.5));
+		v_noise_offsets.push_back(Asteroid::chooseRandomParameters(random).m_noise_offset);
+	}
+
+	steady_clock::time_point sphere_start = steady_clock::now();
+	vector<ObjModel> v_base_levels = createIcosphereLevels((unsigned int)(subdivisions),
+	                                                       Asteroid::LOD_COUNT);
+	double sphere_milliseconds = duration<double, milli>(steady_clock::now() - sphere_start).count();
+	unsigned int sphere_triangles = 0;
+	for(unsigned int i = 0; i < v_base_levels.size(); i++)
+		sphere_triangles += MeshSimplifier::getTriangleCount(v_base_levels[i]);
+	cout << "# icosphere levels from " << subdivisions << " subdivisions: "
+	     << sphere_triangles << " triangles in " << fixed << setprecision(3)
+	     << sphere_milliseconds << " ms, "
+	     << (sphere_triangles / sphere_milliseconds / 1000.0) << " million triangles/s" << endl;
+	cout.unsetf(ios::fixed);
+
+	ObjModel obj_base("Models/AsteroidA.obj");
+	optimizeModel(obj_base, "AsteroidA.obj");
+
+	static const unsigned int TEST_COUNT = 2;
+	static const char* A_TEST_NAMES[TEST_COUNT] =
+	{
+		"icosphere deformed per level",
+		"OBJ model deformed and simplified",
+	};
+	for(unsigned int t = 0; t < TEST_COUNT; t++)
+	{
+		unsigned int triangle_count = 0;
+		steady_clock::time_point start_time = steady_clock::now();
+		for(unsigned int a = 0; a < ICOSPHERE_BENCHMARK_ASTEROIDS; a++)
+		{
+			vector<ObjModel> v_lod_models;
+			if(t == 0)
+			{
+				v_lod_models = Asteroid::createIcosphereLodObjModels(v_base_levels,
+				                                                     v_inner_radii[a], v_outer_radii[a],
+				                                                     v_noise_offsets[a]);
+			}
+			else
+			{
+				v_lod_models = Asteroid::createLodObjModels(obj_base,
+				                                            v_inner_radii[a], v_outer_radii[a],
+				                                            v_noise_offsets[a]);
+			}
+			for(unsigned int i = 0; i < v_lod_models.size(); i++)
+				triangle_count += MeshSimplifier::getTriangleCount(v_lod_models[i]);
+		}
+		double milliseconds = duration<double, milli>(steady_clock::now() - start_time).count();
+
+		cout << "# " << A_TEST_NAMES[t] << ": " << ICOSPHERE_BENCHMARK_ASTEROIDS << " asteroids, "
+		     << triangle_count << " triangles in " << fixed << setprecision(3) << milliseconds << " ms, "
+		     << (triangle_count / milliseconds / 1000.0) << " million triangles/s" << endl;
+		cout.unsetf(ios::fixed);
+	}
+	return 0;
+}
+
+
+
 unsigned char fixShift (unsigned char key)
 {
 	switch(key)
@@ -459,6 +1057,18 @@ void handleInput (double delta_time)
 		g_is_show_debug = !g_is_show_debug;
 		key_pressed['t'] = false;  // only once per keypress
 	}
+	if(key_pressed['i'])
+	{
+		if(g_instanced_asteroids.isInitialized())
+			g_is_instanced = !g_is_instanced;
+		key_pressed['i'] = false;  // only once per keypress
+	}
+	if(key_pressed['o'])
+	{
+		if(g_impostors.isInitialized())
+			g_is_impostors = !g_is_impostors;
+		key_pressed['o'] = false;  // only once per keypress
+	}
 	// 'u' is handled in update
 	// 'y' is handled in draw
 	if(key_pressed[KEY_PRESSED_END])
@@ -480,6 +1090,12 @@ void updatePhysics (double delta_time)
 
 
 void reshape (int w, int h)
+{
+	setViewport(w, h);
+	glutPostRedisplay();
+}
+
+void setViewport (int w, int h)
 {
 	glViewport (0, 0, w, h);
 
@@ -488,13 +1104,26 @@ void reshape (int w, int h)
 
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
-	gluPerspective(60, (GLdouble)w / (GLdouble)h, 1.0, 100000.0);
+	gluPerspective(CAMERA_FIELD_OF_VIEW, (GLdouble)w / (GLdouble)h, 1.0, 100000.0);
 	glMatrixMode(GL_MODELVIEW);
-
-	glutPostRedisplay();
 }
 
 void display ()
+{
+	drawScene();
+	drawOverlays();
+
+	if(key_pressed['y'])
+		sleep(SIMULATE_SLOW_SECONDS);  // simulate slow drawing
+
+	// send the current image to the screen - any drawing after here will not display
+	glutSwapBuffers();
+
+	// the overlay for the next frame shows the calls for this one
+	GlCallCounter::endFrame();
+}
+
+void drawScene ()
 {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	// clear the screen - any drawing before here will not display
@@ -503,31 +1132,20 @@ void display ()
 	g_player.setupFollowCamera(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
 	// camera is set up - any drawing before here will display incorrectly
 
+	// world axes, drawn with the other debug lines
+	static const Vector3 AXES_ORIGIN(0.0, 1.0, 0.0);
+	g_debug_draw.addLine(AXES_ORIGIN, Vector3(1000.0,    1.0,    0.0), Vector3(1.0, 0.0, 0.0));
+	g_debug_draw.addLine(AXES_ORIGIN, Vector3(   0.0, 1000.0,    0.0), Vector3(0.0, 0.0, 0.0));
+	g_debug_draw.addLine(AXES_ORIGIN, Vector3(   0.0,    1.0, 1000.0), Vector3(0.0, 0.0, 1.0));
+
 	drawSkybox();  // has to be first
 	drawEntities(g_is_show_debug);
-	drawOverlays();
-
-	glBegin(GL_LINES);
-		glColor3d(1.0, 0.0, 0.0);
-		glVertex3d(0.0, 1.0, 0.0);
-		glVertex3d(1000.0, 1.0, 0.0);
-		glColor3d(0.0, 0.0, 0.0);
-		glVertex3d(0.0, 1.0, 0.0);
-		glVertex3d(0.0, 1000.0, 0.0);
-		glColor3d(0.0, 0.0, 1.0);
-		glVertex3d(0.0, 1.0, 0.0);
-		glVertex3d(0.0, 1.0, 1000.0);
-	glEnd();
-
-	if(key_pressed['y'])
-		sleep(SIMULATE_SLOW_SECONDS);  // simulate slow drawing
-
-	// send the current image to the screen - any drawing after here will not display
-	glutSwapBuffers();
 }
 
 void drawSkybox ()
 {
+	GlCallZone zone(g_gl_zone_skybox);
+
 	glPushMatrix();
 		Vector3 camera = g_player.getFollowCameraPosition(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
 		glTranslated(camera.x, camera.y, camera.z);
@@ -542,28 +1160,199 @@ void drawSkybox ()
 void drawEntities (bool is_show_debug)
 {
 	static const Vector3 PLAYER_COLOUR(0.0, 0.0, 1.0);
+	static const double  AXES_EXTRA_LENGTH = 50.0;
 
-	const Vector3& player_position = g_player.getPosition();
-	for(unsigned a = 0; a < gv_asteroids.size(); a++)
+	// screen pixels covered by one radian at the middle of the view
+	const double HALF_FIELD_OF_VIEW = CAMERA_FIELD_OF_VIEW * 0.5 * 3.14159265358979 / 180.0;
+	double pixels_per_radian = (window_height * 0.5) / tan(HALF_FIELD_OF_VIEW);
+	Vector3 camera = g_player.getFollowCameraPosition(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
+
+	// the modelview matrix only holds the camera here
+	Frustum frustum;
+	frustum.initFromOpenGL();
+
+	assert(gv_asteroids.size() == ASTEROID_COUNT);
+	for(unsigned a = 0; a < ASTEROID_COUNT; a++)
 	{
 		const Asteroid& asteroid = gv_asteroids[a];
-		asteroid.draw();
+		const Vector3& position = asteroid.getPosition();
+		ga_cull_x[a] = (float)(position.x);
+		ga_cull_y[a] = (float)(position.y);
+		ga_cull_z[a] = (float)(position.z);
+		ga_cull_radius[a] = (float)(asteroid.getRadius());
+		if(is_show_debug)
+			ga_cull_radius[a] += (float)(AXES_EXTRA_LENGTH);
+	}
+	g_entities_drawn = frustum.calculateSphereVisibility(ga_cull_x, ga_cull_y, ga_cull_z,
+	                                                     ga_cull_radius, ASTEROID_COUNT,
+	                                                     ga_is_visible);
+	g_entities_total = ASTEROID_COUNT;
+
+	// skip asteroids entirely behind the black hole or a big asteroid
+	SphereOccluders occluders(camera);
+	addOccluders(occluders);
+	g_entities_occluded = 0;
+	for(unsigned a = 0; a < ASTEROID_COUNT; a++)
+		if(ga_is_visible[a] && occluders.isSphereHidden(gv_asteroids[a].getPosition(), ga_cull_radius[a]))
+		{
+			ga_is_visible[a] = false;
+			g_entities_drawn--;
+			g_entities_occluded++;
+		}
+
+	GlCallCounter::pushZone(g_gl_zone_asteroids);
+	g_asteroids_drawn          = 0;
+	g_asteroid_triangles_drawn = 0;
+	g_asteroid_draw_calls      = 0;
+	g_render_state_cache.resetStatistics();
+	if(g_is_instanced)
+	{
+		g_instanced_asteroids.clearInstances();
+	}
+	else
+	{
+		g_render_queue.clear();
+		AsteroidLodMeshes::clearStreamBuffers();
+	}
+	g_impostors.clearQuads();
+	for(unsigned a = 0; a < ASTEROID_COUNT; a++)
+	{
+		if(!ga_is_visible[a])
+			continue;
+
+		Asteroid& asteroid = gv_asteroids[a];
+		asteroid.updateLod(camera, pixels_per_radian);
+		if(!asteroid.isLodHidden())
+		{
+			g_asteroids_drawn++;
+
+			// distant asteroids are drawn as quads with the other impostors
+			bool is_impostor = g_is_impostors &&
+			                   camera.getDistance(asteroid.getPosition()) > IMPOSTOR_DISTANCE &&
+			                   g_impostors.add(a, asteroid, camera, g_player.getUp());
+			if(!is_impostor)
+			{
+				if(g_is_instanced)
+					g_instanced_asteroids.addInstance(gv_asteroid_model_indexes[a], asteroid);
+				else
+				{
+					asteroid.addToRenderQueue(g_render_queue, camera);
+					g_asteroid_triangles_drawn += asteroid.getLodTriangleCount();
+				}
+			}
+		}
 
 		if(is_show_debug)
-			asteroid.drawAxes(asteroid.getRadius() + 50.0);
+			asteroid.drawAxes(g_debug_draw, asteroid.getRadius() + AXES_EXTRA_LENGTH);
+	}
+	if(g_is_instanced)
+	{
+		g_asteroid_triangles_drawn = g_instanced_asteroids.getTriangleCount();
+		g_asteroid_draw_calls      = g_instanced_asteroids.getDrawCallCount();
+		g_instanced_asteroids.draw();
+	}
+	else
+	{
+		// group the meshes by material to skip redundant material changes
+		g_render_queue.sort();
+		g_render_queue.submit(g_render_state_cache);
+		g_asteroid_draw_calls = g_render_queue.getItemCount();
+	}
+	GlCallCounter::popZone();
+
+	g_impostors_drawn     = g_impostors.getQuadCount();
+	g_impostors_refreshed = g_impostors.getRefreshCount();
+	if(g_impostors_drawn > 0)
+	{
+		g_asteroid_triangles_drawn += g_impostors_drawn * 2;
+		g_asteroid_draw_calls++;
+		GlCallZone zone(g_gl_zone_impostors);
+		g_impostors.draw();
 	}
 
 	if(g_player.isAlive())
 	{
-		g_player.draw();
-		g_player.drawPath(g_black_hole, 1000, PLAYER_COLOUR);
+		g_entities_total++;
+		if(frustum.isSphereVisible(g_player.getPosition(), g_player.getRadius()))
+		{
+			GlCallZone zone(g_gl_zone_player);
+			g_player.draw();
+			g_entities_drawn++;
+		}
+		g_player.drawPath(g_debug_draw, g_black_hole, 1000, PLAYER_COLOUR);
+	}
+
+	// all debugging lines in one draw call
+	GlCallCounter::pushZone(g_gl_zone_debug);
+	g_debug_draw.flush();
+	GlCallCounter::popZone();
+
+	// the accretion disk is much bigger than the black hole itself
+	g_entities_total++;
+	if(frustum.isSphereVisible(g_black_hole.getPosition(), max(g_black_hole.getRadius(), DISK_RADIUS)))
+	{
+		GlCallZone zone(g_gl_zone_black_hole);
+		g_black_hole.draw();  // must be last
+		g_entities_drawn++;
 	}
+}
+
+void addOccluders (SphereOccluders& occluders)
+{
+	// only a few asteroids are worth testing against
+	static const unsigned int OCCLUDER_ASTEROID_COUNT = 4;
+	// faces between vertexes can dip slightly inside the inner radius
+	static const double OCCLUDER_INNER_RADIUS_FACTOR = 0.9;
+	static const double OCCLUDER_ANGLE_MIN = 0.05;  // radians
+
+	occluders.addOccluder(g_black_hole.getPosition(), g_black_hole.getRadius());
+
+	// keep the asteroids that look biggest, largest first
+	unsigned int a_best_index[OCCLUDER_ASTEROID_COUNT];
+	double       a_best_angle[OCCLUDER_ASTEROID_COUNT];
+	unsigned int best_count = 0;
+	for(unsigned a = 0; a < ASTEROID_COUNT; a++)
+	{
+		if(!ga_is_visible[a])
+			continue;
+
+		const Asteroid& asteroid = gv_asteroids[a];
+		double radius = asteroid.getInnerRadius() * OCCLUDER_INNER_RADIUS_FACTOR;
+		double angle  = occluders.calculateAngularRadius(asteroid.getPosition(), radius);
+		if(angle < OCCLUDER_ANGLE_MIN)
+			continue;
 
-	g_black_hole.draw();  // must be last
+		unsigned int slot = best_count;
+		while(slot > 0 && a_best_angle[slot - 1] < angle)
+		{
+			if(slot < OCCLUDER_ASTEROID_COUNT)
+			{
+				a_best_index[slot] = a_best_index[slot - 1];
+				a_best_angle[slot] = a_best_angle[slot - 1];
+			}
+			slot--;
+		}
+		if(slot < OCCLUDER_ASTEROID_COUNT)
+		{
+			a_best_index[slot] = a;
+			a_best_angle[slot] = angle;
+			if(best_count < OCCLUDER_ASTEROID_COUNT)
+				best_count++;
+		}
+	}
+
+	for(unsigned int i = 0; i < best_count; i++)
+	{
+		const Asteroid& asteroid = gv_asteroids[a_best_index[i]];
+		occluders.addOccluder(asteroid.getPosition(),
+		                      asteroid.getInnerRadius() * OCCLUDER_INNER_RADIUS_FACTOR);
+	}
 }
 
 void drawOverlays ()
 {
+	GlCallZone zone(g_gl_zone_overlay);
+
 	SpriteFont::setUp2dView(window_width, window_height);
 
 	system_clock::time_point current_time = system_clock::now();
@@ -577,7 +1366,7 @@ void drawOverlays ()
 
 	stringstream smoothed_frame_rate_ss;
 	smoothed_frame_rate_ss << "Frame rate:\t" << setprecision(3) << average_frame_rate;
-	font.draw(smoothed_frame_rate_ss.str(), 16, 16);
+	g_text_batch.add(smoothed_frame_rate_ss.str(), 16, 16);
 
 	// update frame rate values
 
@@ -593,7 +1382,58 @@ void drawOverlays ()
 
 	stringstream smoothed_update_rate_ss;
 	smoothed_update_rate_ss << "Update rate:\t" << setprecision(3) << average_update_rate;
-	font.draw(smoothed_update_rate_ss.str(), 16, 40);
+	g_text_batch.add(smoothed_update_rate_ss.str(), 16, 40);
+
+	// display asteroid level-of-detail statistics
+
+	stringstream asteroids_ss;
+	asteroids_ss << "Asteroids:\t" << g_asteroids_drawn << " / " << gv_asteroids.size()
+	             << " (" << g_asteroid_triangles_drawn << " triangles, "
+	             << g_asteroid_draw_calls << " draw calls)";
+	g_text_batch.add(asteroids_ss.str(), 16, 64);
+
+	stringstream entities_ss;
+	entities_ss << "Entities:\t" << g_entities_drawn << " / " << g_entities_total << " in view, "
+	            << g_entities_occluded << " occluded";
+	g_text_batch.add(entities_ss.str(), 16, 88);
+
+	stringstream materials_ss;
+	materials_ss << "Materials:\t" << g_render_state_cache.getActivationCount() << " activated, "
+	             << g_render_state_cache.getSavedCount() << " saved";
+	g_text_batch.add(materials_ss.str(), 16, 112);
+
+	stringstream impostors_ss;
+	impostors_ss << "Impostors:\t" << g_impostors_drawn << " drawn, "
+	             << g_impostors_refreshed << " refreshed";
+	g_text_batch.add(impostors_ss.str(), 16, 136);
+
+	// display OpenGL calls for the last frame
+
+	GlCallCounts gl_total = GlCallCounter::getLastFrameTotal();
+	stringstream gl_calls_ss;
+	if(!GlCallCounter::isEnabled())
+		gl_calls_ss << "GL calls:\tnot counted";
+	else
+	{
+		gl_calls_ss << "GL calls:\t" << gl_total.m_call_count << " (" << gl_total.m_draw_count << " draws, "
+		            << gl_total.m_vertex_count << " vertexes, " << gl_total.m_list_call_count << " lists, "
+		            << gl_total.m_texture_bind_count << " binds)";
+	}
+	g_text_batch.add(gl_calls_ss.str(), 16, 160);
+
+	if(g_is_show_debug && GlCallCounter::isEnabled())
+	{
+		int y = 184;
+		for(unsigned int z = 0; z < GlCallCounter::getZoneCount(); z++)
+		{
+			const GlCallCounts& counts = GlCallCounter::getLastFrameCounts(z);
+			stringstream gl_zone_ss;
+			gl_zone_ss << "  " << GlCallCounter::getZoneName(z) << ":\t" << counts.m_call_count
+			           << " (" << counts.m_draw_count << " draws, " << counts.m_vertex_count << " vertexes)";
+			g_text_batch.add(gl_zone_ss.str(), 16, y);
+			y += 24;
+		}
+	}
 
 	// display control keys
 
@@ -601,11 +1441,18 @@ void drawOverlays ()
 	unsigned char byte_t = g_is_show_debug  ? 0x00 : 0xFF;
 	unsigned char byte_y = key_pressed['y'] ? 0x00 : 0xFF;
 	unsigned char byte_u = key_pressed['u'] ? 0x00 : 0xFF;
-
-	font.draw("[G]:\tAccelerate time",  window_width - 256,  16, byte_g, 0xFF, byte_g);
-	font.draw("[T]:\tToggle debugging", window_width - 256,  48, byte_t, 0xFF, byte_t);
-	font.draw("[Y]:\tSlow display",     window_width - 256,  80, byte_y, 0xFF, byte_y);
-	font.draw("[U]:\tSlow physics",     window_width - 256, 112, byte_u, 0xFF, byte_u);
+	unsigned char byte_i = g_is_instanced   ? 0x00 : 0xFF;
+	unsigned char byte_o = g_is_impostors   ? 0x00 : 0xFF;
+
+	g_text_batch.add("[G]:\tAccelerate time",  window_width - 256,  16, byte_g, 0xFF, byte_g);
+	g_text_batch.add("[T]:\tToggle debugging", window_width - 256,  48, byte_t, 0xFF, byte_t);
+	g_text_batch.add("[Y]:\tSlow display",     window_width - 256,  80, byte_y, 0xFF, byte_y);
+	g_text_batch.add("[U]:\tSlow physics",     window_width - 256, 112, byte_u, 0xFF, byte_u);
+	g_text_batch.add("[I]:\tInstancing",       window_width - 256, 144, byte_i, 0xFF, byte_i);
+	g_text_batch.add("[O]:\tImpostors",        window_width - 256, 176, byte_o, 0xFF, byte_o);
+
+	// the key help lines are the same every frame, so they are only laid out once
+	g_text_batch.draw();
 
 	SpriteFont::unsetUp2dView();
 }